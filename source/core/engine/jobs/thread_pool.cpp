@@ -0,0 +1,234 @@
+#include "pch.h"
+
+#include "thread_pool.h"
+
+
+namespace eng
+{
+    static thread_local uint32_t s_workerSlot = UINT32_MAX;
+
+
+    ThreadPool::~ThreadPool()
+    {
+        Destroy();
+    }
+
+
+    ThreadPool& ThreadPool::Create(uint32_t threadCount)
+    {
+        if (IsCreated()) {
+            CORE_LOG_WARN("Recreation of thread pool");
+            Destroy();
+        }
+
+        if (threadCount == 0) {
+            const uint32_t hwThreadCount = std::thread::hardware_concurrency();
+            threadCount = hwThreadCount > 1 ? hwThreadCount - 1 : 1;
+        }
+
+        m_stopRequested = false;
+        m_nextQueueIdx = 0;
+
+        // Queues must exist before workers start stealing from them
+        m_queues.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i) {
+            m_queues.emplace_back(std::make_unique<WorkerQueue>());
+        }
+
+        m_threads.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i) {
+            m_threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+        }
+
+        return *this;
+    }
+
+
+    ThreadPool& ThreadPool::Destroy()
+    {
+        if (!IsCreated()) {
+            return *this;
+        }
+
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stopRequested = true;
+        }
+        m_taskAvailableCV.notify_all();
+
+        for (std::thread& thread : m_threads) {
+            thread.join();
+        }
+
+        m_threads.clear();
+        m_queues.clear();
+        m_queuedTaskCount = 0;
+        m_activeTaskCount = 0;
+
+        return *this;
+    }
+
+
+    ThreadPool& ThreadPool::Submit(Task&& task)
+    {
+        CORE_ASSERT(IsCreated());
+
+        const uint32_t queueIdx = s_workerSlot < GetThreadCount() ? s_workerSlot : m_nextQueueIdx.fetch_add(1) % GetThreadCount();
+        WorkerQueue& queue = *m_queues[queueIdx];
+
+        {
+            // Queued count is increased under the sleep mutex, so workers going to sleep never miss the task
+            std::scoped_lock lock(m_mutex, queue.mutex);
+
+            queue.tasks.emplace_back(std::move(task));
+
+            ++m_queuedTaskCount;
+            ++m_activeTaskCount;
+        }
+        m_taskAvailableCV.notify_one();
+
+        return *this;
+    }
+
+
+    ThreadPool& ThreadPool::WaitIdle()
+    {
+        CORE_ASSERT(IsCreated());
+        CORE_ASSERT_MSG(s_workerSlot == UINT32_MAX, "WaitIdle() can't be called from worker thread");
+
+        std::unique_lock lock(m_mutex);
+        m_idleCV.wait(lock, [this]() { return m_activeTaskCount == 0; });
+
+        return *this;
+    }
+
+
+    ThreadPool& ThreadPool::ParallelFor(size_t count, const ParallelForFunc& func)
+    {
+        CORE_ASSERT(IsCreated());
+        CORE_ASSERT_MSG(s_workerSlot == UINT32_MAX, "ParallelFor() can't be called from worker thread");
+
+        if (count == 0) {
+            return *this;
+        }
+
+        struct SlotRange
+        {
+            std::atomic<size_t> next = 0;
+            size_t end = 0;
+        };
+
+        const uint32_t slotCount = GetWorkerSlotCount();
+
+        // Contiguous ranges keep neighbour indices on one thread. Indices are still handed out one by one,
+        // so slot which finished its range can steal from the others at any moment
+        std::vector<SlotRange> ranges(slotCount);
+
+        for (uint32_t i = 0; i < slotCount; ++i) {
+            ranges[i].next = count * i / slotCount;
+            ranges[i].end = count * (i + 1) / slotCount;
+        }
+
+        uint32_t runningWorkerCount = 0;
+
+        std::mutex doneMutex;
+        std::condition_variable doneCV;
+
+        auto ProcessIndices = [&](uint32_t slot) {
+            for (uint32_t offset = 0; offset < slotCount; ++offset) {
+                SlotRange& range = ranges[(slot + offset) % slotCount];
+
+                for (size_t i = range.next.fetch_add(1); i < range.end; i = range.next.fetch_add(1)) {
+                    func(i, slot);
+                }
+            }
+        };
+
+        const uint32_t helperCount = static_cast<uint32_t>(std::min<size_t>(count - 1, GetThreadCount()));
+        runningWorkerCount = helperCount;
+
+        for (uint32_t i = 0; i < helperCount; ++i) {
+            Submit([&]() {
+                ProcessIndices(s_workerSlot);
+
+                // Decrement under the lock, otherwise calling thread may leave the function and destroy sync objects before notification
+                std::scoped_lock lock(doneMutex);
+                
+                if (--runningWorkerCount == 0) {
+                    doneCV.notify_one();
+                }
+            });
+        }
+
+        // Calling thread always uses the last slot
+        ProcessIndices(GetThreadCount());
+
+        std::unique_lock lock(doneMutex);
+        doneCV.wait(lock, [&]() { return runningWorkerCount == 0; });
+
+        return *this;
+    }
+
+
+    void ThreadPool::WorkerLoop(uint32_t slot)
+    {
+        s_workerSlot = slot;
+
+        while (true) {
+            Task task;
+
+            if (!TryPopTask(slot, task)) {
+                std::unique_lock lock(m_mutex);
+                m_taskAvailableCV.wait(lock, [this]() { return m_stopRequested || m_queuedTaskCount > 0; });
+
+                if (m_stopRequested && m_queuedTaskCount == 0) {
+                    return;
+                }
+
+                continue;
+            }
+
+            task();
+
+            {
+                std::scoped_lock lock(m_mutex);
+                --m_activeTaskCount;
+
+                if (m_activeTaskCount == 0) {
+                    m_idleCV.notify_all();
+                }
+            }
+        }
+    }
+
+
+    // Own deque is popped from the back, victims are robbed from the front, so owner and thieves rarely contend for the same task
+    bool ThreadPool::TryPopTask(uint32_t slot, Task& outTask)
+    {
+        const uint32_t queueCount = GetThreadCount();
+
+        for (uint32_t offset = 0; offset < queueCount; ++offset) {
+            WorkerQueue& queue = *m_queues[(slot + offset) % queueCount];
+            
+            std::scoped_lock lock(queue.mutex);
+
+            if (queue.tasks.empty()) {
+                continue;
+            }
+
+            if (offset == 0) {
+                outTask = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                outTask = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+
+            m_queuedTaskCount.fetch_sub(1);
+
+            return true;
+        }
+
+        return false;
+    }
+}
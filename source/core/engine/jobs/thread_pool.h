@@ -0,0 +1,91 @@
+#pragma once
+
+#include "core/core.h"
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <memory>
+
+
+namespace eng
+{
+    // Work stealing thread pool. Every worker owns task deque: it pops its own tasks from the back (the most recently pushed,
+    // which data is still in cache) and steals from the front of other deques when its own one is empty.
+    // ParallelFor splits index range into contiguous per slot ranges, and slots which finished their range steal indices from others
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void()>;
+
+        // Called for each index of [0, count) range. The second argument is worker slot index in [0, GetWorkerSlotCount()),
+        // which can be used to address per thread scratch data
+        using ParallelForFunc = std::function<void(size_t index, uint32_t slot)>;
+
+    public:
+        ENG_DECL_CLASS_NO_COPIABLE(ThreadPool);
+        ENG_DECL_CLASS_NO_MOVABLE(ThreadPool);
+
+        ThreadPool() = default;
+        ~ThreadPool();
+
+        // 0 means hardware concurrency minus one (calling thread also participates in ParallelFor)
+        ThreadPool& Create(uint32_t threadCount = 0);
+        ThreadPool& Destroy();
+
+        // Task submitted from worker thread is pushed into its own deque, otherwise deques are chosen in round robin
+        ThreadPool& Submit(Task&& task);
+
+        // Blocks until all submitted tasks are finished
+        ThreadPool& WaitIdle();
+
+        // Blocks until func is called for every index. Calling thread helps with the work
+        ThreadPool& ParallelFor(size_t count, const ParallelForFunc& func);
+
+        uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_threads.size()); }
+
+        // Worker threads plus calling thread
+        uint32_t GetWorkerSlotCount() const { return GetThreadCount() + 1; }
+
+        bool IsCreated() const { return !m_threads.empty(); }
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+    private:
+        void WorkerLoop(uint32_t slot);
+
+        bool TryPopTask(uint32_t slot, Task& outTask);
+
+    private:
+        std::vector<std::thread> m_threads;
+        // Allocated separately, since mutex isn't movable
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+
+        // Guards sleeping and idle state only. Tasks are guarded by mutexes of their deques
+        std::mutex m_mutex;
+        std::condition_variable m_taskAvailableCV;
+        std::condition_variable m_idleCV;
+
+        std::atomic<uint32_t> m_nextQueueIdx = 0;
+
+        std::atomic<size_t> m_queuedTaskCount = 0; // Pushed, but not popped yet. Decreased under deque mutex only
+        size_t m_activeTaskCount = 0;              // Pushed, but not finished yet
+        bool m_stopRequested = false;
+    };
+
+
+    ENG_FORCE_INLINE ThreadPool& GetThreadPool()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+}
@@ -26,4 +26,105 @@ namespace eng
 
         return true;
     }
-}
\ No newline at end of file
+
+
+    MappedFile::MappedFile(const std::filesystem::path& filepath)
+    {
+        Open(filepath);
+    }
+
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this == &other) {
+            return *this;
+        }
+
+        Close();
+
+        std::swap(m_pFileHandle, other.m_pFileHandle);
+        std::swap(m_pMappingHandle, other.m_pMappingHandle);
+        std::swap(m_pData, other.m_pData);
+        std::swap(m_size, other.m_size);
+
+        return *this;
+    }
+
+
+#if defined(ENG_OS_WINDOWS)
+    bool MappedFile::Open(const std::filesystem::path& filepath)
+    {
+        Close();
+
+        HANDLE hFile = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        
+        if (hFile == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize = {};
+        
+        if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(hFile);
+            return false;
+        }
+
+        HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        
+        if (hMapping == nullptr) {
+            CloseHandle(hFile);
+            return false;
+        }
+
+        const void* pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+        
+        if (pData == nullptr) {
+            CloseHandle(hMapping);
+            CloseHandle(hFile);
+            return false;
+        }
+
+        m_pFileHandle = hFile;
+        m_pMappingHandle = hMapping;
+        m_pData = static_cast<const uint8_t*>(pData);
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+
+        return true;
+    }
+
+
+    void MappedFile::Close()
+    {
+        if (m_pData) {
+            UnmapViewOfFile(m_pData);
+        }
+
+        if (m_pMappingHandle) {
+            CloseHandle(static_cast<HANDLE>(m_pMappingHandle));
+        }
+
+        if (m_pFileHandle) {
+            CloseHandle(static_cast<HANDLE>(m_pFileHandle));
+        }
+
+        m_pFileHandle = nullptr;
+        m_pMappingHandle = nullptr;
+        m_pData = nullptr;
+        m_size = 0;
+    }
+#else
+    #error Unsupported OS type!
+#endif
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "core/core.h"
+
 #include <vector>
 #include <filesystem>
 
@@ -9,4 +11,35 @@ namespace eng
     enum class FileOpenMode { BINARY, TEXT };
     
     bool ReadFile(std::vector<uint8_t>& buffer, const std::filesystem::path& filepath, FileOpenMode mode = FileOpenMode::BINARY);
+
+
+    // Read only view of whole file content mapped into process address space
+    class MappedFile
+    {
+    public:
+        ENG_DECL_CLASS_NO_COPIABLE(MappedFile);
+
+        MappedFile() = default;
+        MappedFile(const std::filesystem::path& filepath);
+
+        ~MappedFile();
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        bool Open(const std::filesystem::path& filepath);
+        void Close();
+
+        const uint8_t* GetData() const { return m_pData; }
+        size_t GetSize() const { return m_size; }
+
+        bool IsOpened() const { return m_pData != nullptr; }
+
+    private:
+        void* m_pFileHandle = nullptr;
+        void* m_pMappingHandle = nullptr;
+
+        const uint8_t* m_pData = nullptr;
+        size_t m_size = 0;
+    };
 }
@@ -0,0 +1,129 @@
+#include "pch.h"
+
+#include "file_watcher.h"
+
+
+namespace fs = std::filesystem;
+
+
+namespace eng
+{
+    FileWatcher::~FileWatcher()
+    {
+        Destroy();
+    }
+
+
+    FileWatcher& FileWatcher::Create(std::span<const fs::path> dirs, Callback&& callback, std::chrono::milliseconds pollInterval)
+    {
+        if (IsCreated()) {
+            CORE_LOG_WARN("Recreation of file watcher");
+            Destroy();
+        }
+
+        CORE_ASSERT(!dirs.empty());
+        CORE_ASSERT(callback);
+
+        m_dirs.assign(dirs.begin(), dirs.end());
+        m_callback = std::move(callback);
+        m_pollInterval = pollInterval;
+        m_stopRequested = false;
+
+        // Initial snapshot is taken on the calling thread, so changes made right after creation aren't missed
+        std::vector<fs::path> changedFiles;
+        CollectChangedFiles(changedFiles);
+
+        m_thread = std::thread(&FileWatcher::WatcherLoop, this);
+
+        return *this;
+    }
+
+
+    FileWatcher& FileWatcher::Destroy()
+    {
+        if (!IsCreated()) {
+            return *this;
+        }
+
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stopRequested = true;
+        }
+        m_stopCV.notify_all();
+
+        m_thread.join();
+
+        m_dirs.clear();
+        m_fileTimes.clear();
+        m_callback = nullptr;
+
+        return *this;
+    }
+
+
+    void FileWatcher::WatcherLoop()
+    {
+        std::vector<fs::path> changedFiles;
+
+        while (true) {
+            {
+                std::unique_lock lock(m_mutex);
+
+                if (m_stopCV.wait_for(lock, m_pollInterval, [this]() { return m_stopRequested; })) {
+                    return;
+                }
+            }
+
+            changedFiles.clear();
+            CollectChangedFiles(changedFiles);
+
+            if (!changedFiles.empty()) {
+                m_callback(changedFiles);
+            }
+        }
+    }
+
+
+    void FileWatcher::CollectChangedFiles(std::vector<fs::path>& changedFiles)
+    {
+        FileTimeMap fileTimes;
+
+        // Editors can replace files while they are iterated, so all errors are ignored and file is picked up on the next poll
+        std::error_code error;
+
+        for (const fs::path& dir : m_dirs) {
+            for (fs::recursive_directory_iterator it(dir, error), end; !error && it != end; it.increment(error)) {
+                if (!it->is_regular_file(error)) {
+                    continue;
+                }
+
+                const fs::file_time_type time = it->last_write_time(error);
+
+                if (error) {
+                    error.clear();
+                    continue;
+                }
+
+                fileTimes[it->path()] = time;
+            }
+
+            error.clear();
+        }
+
+        for (const auto& [path, time] : fileTimes) {
+            const auto prevIt = m_fileTimes.find(path);
+
+            if (prevIt == m_fileTimes.cend() || prevIt->second != time) {
+                changedFiles.emplace_back(path);
+            }
+        }
+
+        for (const auto& [path, time] : m_fileTimes) {
+            if (!fileTimes.contains(path)) {
+                changedFiles.emplace_back(path);
+            }
+        }
+
+        m_fileTimes = std::move(fileTimes);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "core/core.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <span>
+#include <map>
+#include <chrono>
+#include <filesystem>
+
+
+namespace eng
+{
+    // Polls last write time of all files in watched directories (recursively) on its own thread.
+    // Callback is called on the watcher thread with the list of files which were modified, added or removed since the previous poll
+    class FileWatcher
+    {
+    public:
+        using Callback = std::function<void(std::span<const std::filesystem::path> changedFiles)>;
+
+    public:
+        ENG_DECL_CLASS_NO_COPIABLE(FileWatcher);
+        ENG_DECL_CLASS_NO_MOVABLE(FileWatcher);
+
+        FileWatcher() = default;
+        ~FileWatcher();
+
+        FileWatcher& Create(std::span<const std::filesystem::path> dirs, Callback&& callback, std::chrono::milliseconds pollInterval = std::chrono::milliseconds(500));
+        FileWatcher& Destroy();
+
+        bool IsCreated() const { return m_thread.joinable(); }
+
+    private:
+        void WatcherLoop();
+
+        void CollectChangedFiles(std::vector<std::filesystem::path>& changedFiles);
+
+    private:
+        using FileTimeMap = std::map<std::filesystem::path, std::filesystem::file_time_type>;
+
+        std::vector<std::filesystem::path> m_dirs;
+        FileTimeMap m_fileTimes;
+
+        Callback m_callback;
+        std::chrono::milliseconds m_pollInterval = {};
+
+        std::thread m_thread;
+
+        std::mutex m_mutex;
+        std::condition_variable m_stopCV;
+        bool m_stopRequested = false;
+    };
+}
@@ -0,0 +1,35 @@
+#include "pch.h"
+
+#include "process.h"
+
+#include <cstdio>
+
+
+namespace eng
+{
+#if defined(ENG_OS_WINDOWS)
+    int ExecuteCommand(const std::string& command, std::string& output)
+    {
+        output.clear();
+
+        // cmd.exe strips the outer quotes, so command with quoted executable path must be quoted once more
+        const std::string shellCommand = "\"" + command + " 2>&1\"";
+
+        FILE* pPipe = _popen(shellCommand.c_str(), "r");
+
+        if (pPipe == nullptr) {
+            return -1;
+        }
+
+        std::array<char, 512> buffer = {};
+
+        while (fgets(buffer.data(), buffer.size(), pPipe) != nullptr) {
+            output += buffer.data();
+        }
+
+        return _pclose(pPipe);
+    }
+#else
+    #error Unsupported OS type!
+#endif
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "core/core.h"
+
+#include <string>
+
+
+namespace eng
+{
+    // Runs command in system shell and blocks until it's finished. Stdout and stderr are written to output.
+    // Returns process exit code or -1 if process couldn't be started
+    int ExecuteCommand(const std::string& command, std::string& output);
+}
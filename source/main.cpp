@@ -11,8 +11,14 @@
     #define ENG_DEBUG_DRAW_ENABLED
 #endif
 
+#ifndef ENG_BUILD_RELEASE
+    #define ENG_SHADER_HOT_RELOAD_ENABLED
+#endif
+
 
 #include "core/platform/file/file.h"
+#include "core/platform/file/file_watcher.h"
+#include "core/platform/process/process.h"
 #include "core/utils/timer.h"
 
 #include "core/math/transform.h"
@@ -23,8 +29,8 @@
 #include "render/core/vulkan/vk_phys_device.h"
 #include "render/core/vulkan/vk_device.h"
 #include "render/core/vulkan/vk_swapchain.h"
-#include "render/core/vulkan/vk_fence.h"
 #include "render/core/vulkan/vk_semaphore.h"
+#include "render/core/vulkan/vk_gpu_progress_tracker.h"
 #include "render/core/vulkan/vk_cmd.h"
 #include "render/core/vulkan/vk_buffer.h"
 #include "render/core/vulkan/vk_texture.h"
@@ -33,9 +39,18 @@
 #include "render/core/vulkan/vk_query.h"
 
 #include "render/core/vulkan/vk_memory.h"
+#include "render/core/vulkan/vk_upload_manager.h"
+
+#include "render/core/texture/ktx2.h"
+#include "render/core/texture/bc_encoder.h"
+
+#include "render/core/render_graph/render_graph.h"
+#include "render/core/render_graph/transient_texture_allocator.h"
+#include "render/core/render_graph/secondary_cmd_buffer_allocator.h"
 
 #include "core/engine/camera/camera.h"
 #include "core/engine/profiler/cpu_profiler.h"
+#include "core/engine/jobs/thread_pool.h"
 
 #include "render/core/vulkan/vk_profiler.h"
 
@@ -86,6 +101,20 @@ struct GPU_Frustum
 
 static const uint COMMON_CSM_CASCADE_COUNT = 3;
 
+static const uint COMMON_VSM_LEVEL_COUNT = COMMON_CSM_CASCADE_COUNT;
+static const uint COMMON_VSM_PAGE_SIZE = 128;
+static const uint COMMON_VSM_VIRTUAL_PAGE_COUNT = 128;
+static const uint COMMON_VSM_VIRTUAL_SIZE = COMMON_VSM_PAGE_SIZE * COMMON_VSM_VIRTUAL_PAGE_COUNT;
+static const uint COMMON_VSM_PHYS_PAGE_COUNT_X = 32;
+static const uint COMMON_VSM_PHYS_PAGE_COUNT = COMMON_VSM_PHYS_PAGE_COUNT_X * COMMON_VSM_PHYS_PAGE_COUNT_X;
+static const uint COMMON_VSM_PAGE_TABLE_SIZE = COMMON_VSM_LEVEL_COUNT * COMMON_VSM_VIRTUAL_PAGE_COUNT * COMMON_VSM_VIRTUAL_PAGE_COUNT;
+
+static const uint COMMON_LIGHT_CLUSTER_COUNT_X = 16;
+static const uint COMMON_LIGHT_CLUSTER_COUNT_Y = 9;
+static const uint COMMON_LIGHT_CLUSTER_COUNT_Z = 24;
+static const uint COMMON_LIGHT_CLUSTER_COUNT = COMMON_LIGHT_CLUSTER_COUNT_X * COMMON_LIGHT_CLUSTER_COUNT_Y * COMMON_LIGHT_CLUSTER_COUNT_Z;
+static const uint COMMON_LIGHT_CLUSTER_MAX_LIGHT_COUNT = 128;
+
 
 enum GPU_GeomMatType : uint
 {
@@ -127,6 +156,8 @@ struct GPU_MeshLOD
 {
     uint firstIndex;
     uint indexCount;
+    float error; // Accumulated simplification error relative to LOD 0 in mesh local space units
+    uint padding;
 };
 
 
@@ -340,6 +371,7 @@ struct GPU_CommonCSMData
     float4 cascadeZNear;
     float4 cascadeZFar;
     float4 cascadeWorldUnitsPerPixel;
+    float4 cascadeGeomLodPixelThresholds; // Max simplification error in shadow map texels for LOD selection
 
     float cascadeBlendThresholdCoef;
     uint  filterDiskSampleCount;
@@ -353,6 +385,51 @@ struct GPU_CommonCSMData
 };
 
 
+struct GPU_CommonVSMData
+{
+    float4x4 levelViewProjMatrices[COMMON_VSM_LEVEL_COUNT];
+
+    int4 levelPageOffsets[COMMON_VSM_LEVEL_COUNT];      // xy - absolute coords of the first level page. Only xy are used
+    int4 levelDynamicPageRects[COMMON_VSM_LEVEL_COUNT]; // Absolute coords of pages touched by dynamic geometry in current or previous frame. Empty if x > z
+
+    float4 levelWorldUnitsPerTexel;
+
+    float depthRange;       // Distance between near and far planes of levels in world units. The same for all levels
+    uint  invalidLevelMask; // Levels which pages are all released in current frame
+    uint  frameNumber;
+    uint  padding;
+};
+
+
+enum GPU_PunctualLightType : uint32_t
+{
+    PUNCTUAL_LIGHT_TYPE_POINT,
+    PUNCTUAL_LIGHT_TYPE_SPOT,
+
+    PUNCTUAL_LIGHT_TYPE_COUNT
+};
+
+
+struct GPU_PunctualLight
+{
+    float3 wpos;
+    float  range;     // Light doesn't affect surfaces farther than range
+
+    float3 color;     // Premultiplied by intensity
+    GPU_PunctualLightType type;
+
+    float3 direction; // Spot light direction
+    float  spotAngleScale;  // Spot cone attenuation is saturate(dot(direction, L) * spotAngleScale + spotAngleOffset)
+
+    float  spotAngleOffset;
+    uint   padding_0;
+    uint   padding_1;
+    uint   padding_2;
+};
+
+static_assert(sizeof(GPU_PunctualLight) == 64);
+
+
 struct GPU_CommonCBData
 {
     GPU_Frustum mainCamFrustum;
@@ -379,10 +456,21 @@ struct GPU_CommonCBData
     float3 sunLightDir;
     uint sunLightColor;
 
+    float3 cullingCamWPos;
+    float  cullingCamProjScale; // Size in pixels of unit length at unit distance from culling camera
+
+    float geomLodPixelThreshold; // Max simplification error in pixels for main view LOD selection
+    uint  firstDynamicInstID;    // Static instances go first in instance buffer. Dynamic ones aren't cached in CSM static cache
+    uint  punctualLightCount;
+    uint  padding_2;
+
     GPU_CommonCSMData csmData;
+    GPU_CommonVSMData vsmData;
 };
 
 static_assert(sizeof(GPU_CommonCSMData::cascadeDistances) >= sizeof(float[COMMON_CSM_CASCADE_COUNT]));
+static_assert(sizeof(GPU_CommonVSMData::levelWorldUnitsPerTexel) >= sizeof(float[COMMON_VSM_LEVEL_COUNT]));
+static_assert(COMMON_VSM_PHYS_PAGE_COUNT <= 0xFFFF, "Physical page ID must fit into VSM_PAGE_PHYS_ID_MASK");
 
 
 struct GPU_CommonDbgCBData
@@ -436,7 +524,19 @@ enum GPU_GeomQueue
 };
 
 
-static const uint CSM_BUFFER_COUNT = COMMON_CSM_CASCADE_COUNT * GEOM_QUEUE_COUNT;
+// CSM visible instance entries store cascade index in high bits. See GeomCSMPackVisInst()
+static const uint GEOM_CSM_VIS_INST_CASCADE_OFFSET = 30;
+static const uint GEOM_CSM_VIS_INST_CASCADE_BITS = 2;
+
+static_assert(COMMON_CSM_CASCADE_COUNT <= (1u << GEOM_CSM_VIS_INST_CASCADE_BITS), "CSM cascade index doesn't fit packed visible instance entry");
+
+
+enum GPU_GeomCullingPhase : uint32_t
+{
+    GEOM_CULLING_PHASE_EARLY,
+    GEOM_CULLING_PHASE_LATE,
+    GEOM_CULLING_PHASE_COUNT
+};
 
 
 struct GPU_GeomBatch
@@ -451,18 +551,54 @@ struct GPU_GeomBatch
 struct GPU_GeomCullingPerDrawData
 {
     uint hzbMipsCount;
+    GPU_GeomCullingPhase phase;
+};
+
+
+enum GPU_GeomBatchStage : uint32_t
+{
+    GEOM_BATCH_STAGE_BIN_INSTANCES,
+    GEOM_BATCH_STAGE_EMIT_BATCHES,
+    GEOM_BATCH_STAGE_SCATTER_INSTANCES,
+
+    GEOM_BATCH_STAGE_EMIT_SORTED_BATCHES,
+
+    GEOM_BATCH_STAGE_COUNT
 };
 
 
 struct GPU_GeomBatchPerDrawData
 {
-    uint padding;
+    GPU_GeomBatchStage stage;
+    uint isCSMPass; // Visible instance queue contains packed (instance ID, cascade) entries
+    uint binCount;
+    GPU_GeomMatType sortedMatType;    // Used by EMIT_SORTED_BATCHES stage only
+    GPU_GeomCullingPhase sortedPhase; // Used by EMIT_SORTED_BATCHES stage only
+};
+
+
+enum GPU_RadixSortStage : uint32_t
+{
+    RADIX_SORT_STAGE_SETUP,
+    RADIX_SORT_STAGE_BUILD_HISTOGRAMS,
+    RADIX_SORT_STAGE_SCAN_HISTOGRAMS,
+    RADIX_SORT_STAGE_SCATTER,
+
+    RADIX_SORT_STAGE_COUNT
+};
+
+
+struct GPU_RadixSortPerDrawData
+{
+    GPU_RadixSortStage stage;
+    uint bitOffset;
+    uint maxElemCount;
 };
 
 
 struct GPU_GeomDrawCmdGenPerDrawData
 {
-    uint padding;
+    GPU_GeomCullingPhase phase;
 };
 
 
@@ -474,16 +610,58 @@ struct GPU_ZPassPerDrawData
 
 struct GPU_HzbGenPerDrawData
 {
-    uint2 srcMipResolution;
-    uint2 dstMipResolution;
-    uint  dstMipIdx;
+    uint2 depthResolution;
+    uint  mipCount;
+    uint  groupCount;
+};
+
+
+// Static geometry is rendered into cached cascades only when they are invalidated, dynamic one is rendered every frame on top of them
+enum GPU_CsmGeomType : uint32_t
+{
+    CSM_GEOM_TYPE_STATIC,
+    CSM_GEOM_TYPE_DYNAMIC,
+    CSM_GEOM_TYPE_COUNT
 };
 
 
+static const uint CSM_BUFFER_COUNT = CSM_GEOM_TYPE_COUNT * GEOM_QUEUE_COUNT;
+
+
 struct GPU_CsmPerDrawData
 {
-    uint cascadeIdx;
     GPU_GeomQueue queue;
+    GPU_CsmGeomType geomType;
+    uint staticCacheUpdateMask; // Cascades which static cache is rebuilt in current frame
+};
+
+
+enum GPU_VsmPagesStage : uint32_t
+{
+    VSM_PAGES_STAGE_RESET,
+    VSM_PAGES_STAGE_MARK,
+    VSM_PAGES_STAGE_RELEASE,
+    VSM_PAGES_STAGE_ALLOCATE,
+    VSM_PAGES_STAGE_CLEAR,
+
+    VSM_PAGES_STAGE_COUNT
+};
+
+
+struct GPU_VsmPagesPerDrawData
+{
+    GPU_VsmPagesStage stage;
+};
+
+
+enum DeferredLightingTileClass : uint32_t
+{
+    DEFERRED_LIGHTING_TILE_CLASS_UNSHADOWED,
+    DEFERRED_LIGHTING_TILE_CLASS_SINGLE_CASCADE,
+    DEFERRED_LIGHTING_TILE_CLASS_GENERAL,
+    DEFERRED_LIGHTING_TILE_CLASS_PCSS,
+
+    DEFERRED_LIGHTING_TILE_CLASS_COUNT
 };
 
 
@@ -574,6 +752,32 @@ static constexpr const char* GEOM_QUEUE_DBG_NAMES[] = {
 static_assert(GEOM_QUEUE_COUNT == _countof(GEOM_QUEUE_DBG_NAMES));
 
 
+static constexpr const char* GEOM_CULLING_PHASE_DBG_NAMES[] = {
+    "Early",
+    "Late",
+};
+
+static_assert(GEOM_CULLING_PHASE_COUNT == _countof(GEOM_CULLING_PHASE_DBG_NAMES));
+
+
+static constexpr const char* CSM_GEOM_TYPE_DBG_NAMES[] = {
+    "STATIC",
+    "DYNAMIC",
+};
+
+static_assert(CSM_GEOM_TYPE_COUNT == _countof(CSM_GEOM_TYPE_DBG_NAMES));
+
+
+static constexpr const char* DEFERRED_LIGHTING_TILE_CLASS_DBG_NAMES[] = {
+    "UNSHADOWED",
+    "SINGLE_CASCADE",
+    "GENERAL",
+    "PCSS",
+};
+
+static_assert(DEFERRED_LIGHTING_TILE_CLASS_COUNT == _countof(DEFERRED_LIGHTING_TILE_CLASS_DBG_NAMES));
+
+
 static constexpr const char* COMMON_SAMPLERS_DBG_NAMES[] = {
     "NEAREST_REPEAT",
     "NEAREST_MIRRORED_REPEAT",
@@ -630,6 +834,8 @@ enum PassID : uint32_t
 {
     PASS_ID_COMMON,
 
+    PASS_ID_RADIX_SORT,
+
     PASS_ID_GEOM_CULLING,
     PASS_ID_GEOM_BATCHING,
     PASS_ID_GEOM_DRAW_CMD_GEN,
@@ -642,9 +848,14 @@ enum PassID : uint32_t
     PASS_ID_CSM_GEOM_BATCHING,
     PASS_ID_CSM_GEOM_DRAW_CMD_GEN,
     PASS_ID_CSM_RENDER,
+
+    PASS_ID_VSM_PAGES,
+    PASS_ID_VSM_RENDER,
     
     PASS_ID_GBUFFER,
     
+    PASS_ID_LIGHT_CULLING,
+    PASS_ID_DEFERRED_LIGHTING_CLASSIFY,
     PASS_ID_DEFERRED_LIGHTING,
     
     PASS_ID_SKYBOX,
@@ -670,6 +881,8 @@ enum PassID : uint32_t
 static constexpr const char* PASS_DBG_NAME[] = {
     "PASS_ID_COMMON",
 
+    "PASS_ID_RADIX_SORT",
+
     "PASS_ID_GEOM_CULLING",
     "PASS_ID_GEOM_BATCHING",
     "PASS_ID_GEOM_DRAW_CMD_GEN",
@@ -682,9 +895,14 @@ static constexpr const char* PASS_DBG_NAME[] = {
     "PASS_ID_CSM_GEOM_BATCHING",
     "PASS_ID_CSM_GEOM_DRAW_CMD_GEN",
     "PASS_ID_CSM_RENDER",
+
+    "PASS_ID_VSM_PAGES",
+    "PASS_ID_VSM_RENDER",
     
     "PASS_ID_GBUFFER",
     
+    "PASS_ID_LIGHT_CULLING",
+    "PASS_ID_DEFERRED_LIGHTING_CLASSIFY",
     "PASS_ID_DEFERRED_LIGHTING",
     
     "PASS_ID_SKYBOX",
@@ -712,6 +930,8 @@ enum DescSetID : uint32_t
     DESC_SET_ID_COMMON,
 
     DESC_SET_ID_GEOM_CULLING,
+    DESC_SET_ID_GEOM_RADIX_SORT_EVEN_PASS,
+    DESC_SET_ID_GEOM_RADIX_SORT_ODD_PASS,
     DESC_SET_ID_GEOM_BATCHING_OPAQUE,
     DESC_SET_ID_GEOM_BATCHING_AKILL,   
     DESC_SET_ID_GEOM_DRAW_CMD_GEN_OPAQUE,
@@ -723,23 +943,24 @@ enum DescSetID : uint32_t
     DESC_SET_ID_HZB_GEN,
 
     DESC_SET_ID_CSM_GEOM_CULLING,
-    DESC_SET_ID_CSM_GEOM_BATCHING_OPAQUE_CASCADE_0,
-    DESC_SET_ID_CSM_GEOM_BATCHING_OPAQUE_CASCADE_1,
-    DESC_SET_ID_CSM_GEOM_BATCHING_OPAQUE_CASCADE_2,
-    DESC_SET_ID_CSM_GEOM_BATCHING_AKILL_CASCADE_0,
-    DESC_SET_ID_CSM_GEOM_BATCHING_AKILL_CASCADE_1,
-    DESC_SET_ID_CSM_GEOM_BATCHING_AKILL_CASCADE_2,
-    DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_OPAQUE_CASCADE_0,
-    DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_OPAQUE_CASCADE_1,
-    DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_OPAQUE_CASCADE_2,
-    DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_AKILL_CASCADE_0,
-    DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_AKILL_CASCADE_1,
-    DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_AKILL_CASCADE_2,
+    DESC_SET_ID_CSM_GEOM_BATCHING_STATIC_OPAQUE,
+    DESC_SET_ID_CSM_GEOM_BATCHING_STATIC_AKILL,
+    DESC_SET_ID_CSM_GEOM_BATCHING_DYNAMIC_OPAQUE,
+    DESC_SET_ID_CSM_GEOM_BATCHING_DYNAMIC_AKILL,
+    DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_STATIC_OPAQUE,
+    DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_STATIC_AKILL,
+    DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_DYNAMIC_OPAQUE,
+    DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_DYNAMIC_AKILL,
     DESC_SET_ID_CSM_RENDER,
 
+    DESC_SET_ID_VSM_PAGES,
+    DESC_SET_ID_VSM_RENDER,
+
     DESC_SET_ID_GBUFFER_OPAQUE,
     DESC_SET_ID_GBUFFER_AKILL,
     
+    DESC_SET_ID_LIGHT_CULLING,
+    DESC_SET_ID_DEFERRED_LIGHTING_CLASSIFY,
     DESC_SET_ID_DEFERRED_LIGHTING,
     
     DESC_SET_ID_SKYBOX,
@@ -766,6 +987,8 @@ static constexpr const char* DESC_SET_DBG_NAME[] = {
     "DESC_SET_ID_COMMON",
 
     "DESC_SET_ID_GEOM_CULLING",
+    "DESC_SET_ID_GEOM_RADIX_SORT_EVEN_PASS",
+    "DESC_SET_ID_GEOM_RADIX_SORT_ODD_PASS",
     "DESC_SET_ID_GEOM_BATCHING_OPAQUE",
     "DESC_SET_ID_GEOM_BATCHING_AKILL", 
     "DESC_SET_ID_GEOM_DRAW_CMD_GEN_OPAQUE",
@@ -777,23 +1000,24 @@ static constexpr const char* DESC_SET_DBG_NAME[] = {
     "DESC_SET_ID_HZB_GEN",
 
     "DESC_SET_ID_CSM_GEOM_CULLING",
-    "DESC_SET_ID_CSM_GEOM_BATCHING_OPAQUE_CASCADE_0",
-    "DESC_SET_ID_CSM_GEOM_BATCHING_OPAQUE_CASCADE_1",
-    "DESC_SET_ID_CSM_GEOM_BATCHING_OPAQUE_CASCADE_2",
-    "DESC_SET_ID_CSM_GEOM_BATCHING_AKILL_CASCADE_0",
-    "DESC_SET_ID_CSM_GEOM_BATCHING_AKILL_CASCADE_1",
-    "DESC_SET_ID_CSM_GEOM_BATCHING_AKILL_CASCADE_2",
-    "DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_OPAQUE_CASCADE_0",
-    "DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_OPAQUE_CASCADE_1",
-    "DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_OPAQUE_CASCADE_2",
-    "DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_AKILL_CASCADE_0",
-    "DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_AKILL_CASCADE_1",
-    "DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_AKILL_CASCADE_2",
+    "DESC_SET_ID_CSM_GEOM_BATCHING_STATIC_OPAQUE",
+    "DESC_SET_ID_CSM_GEOM_BATCHING_STATIC_AKILL",
+    "DESC_SET_ID_CSM_GEOM_BATCHING_DYNAMIC_OPAQUE",
+    "DESC_SET_ID_CSM_GEOM_BATCHING_DYNAMIC_AKILL",
+    "DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_STATIC_OPAQUE",
+    "DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_STATIC_AKILL",
+    "DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_DYNAMIC_OPAQUE",
+    "DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_DYNAMIC_AKILL",
     "DESC_SET_ID_CSM_RENDER",
 
+    "DESC_SET_ID_VSM_PAGES",
+    "DESC_SET_ID_VSM_RENDER",
+
     "DESC_SET_ID_GBUFFER_OPAQUE",
     "DESC_SET_ID_GBUFFER_AKILL",
     
+    "DESC_SET_ID_LIGHT_CULLING",
+    "DESC_SET_ID_DEFERRED_LIGHTING_CLASSIFY",
     "DESC_SET_ID_DEFERRED_LIGHTING",
     
     "DESC_SET_ID_SKYBOX",
@@ -830,12 +1054,19 @@ static constexpr size_t COMMON_INST_BUFFER_DESCRIPTOR_SLOT = 10;
 static constexpr size_t COMMON_DEPTH_DESCRIPTOR_SLOT = 11;
 static constexpr size_t COMMON_HZB_DESCRIPTOR_SLOT = 12;
 
-static constexpr size_t GEOM_CULL_VIS_INST_ID_QUEUES_UAV_DESCRIPTOR_SLOT = 0;
-static constexpr size_t GEOM_CULL_VIS_INST_ID_QUEUE_SIZES_UAV_DESCRIPTOR_SLOT = 1;
-static constexpr size_t GEOM_CULL_VIS_SORT_KEYS_UAV_DESCRIPTOR_SLOT = 2;
-static constexpr size_t GEOM_CULL_VIS_SORT_KEYS_COUNTER_UAV_DESCRIPTOR_SLOT = 3;
-static constexpr size_t GEOM_CULL_VIS_GEOM_IDS_UAV_DESCRIPTOR_SLOT = 4;
-static constexpr size_t GEOM_CULL_PER_GEOM_MAT_TYPE_COUNTERS_UAV_DESCRIPTOR_SLOT = 5;
+static constexpr size_t RADIX_SORT_SRC_KEYS_DESCRIPTOR_SLOT = 0;
+static constexpr size_t RADIX_SORT_SRC_PAYLOADS_DESCRIPTOR_SLOT = 1;
+static constexpr size_t RADIX_SORT_DST_KEYS_UAV_DESCRIPTOR_SLOT = 2;
+static constexpr size_t RADIX_SORT_DST_PAYLOADS_UAV_DESCRIPTOR_SLOT = 3;
+static constexpr size_t RADIX_SORT_ELEM_COUNT_DESCRIPTOR_SLOT = 4;
+static constexpr size_t RADIX_SORT_HISTOGRAMS_UAV_DESCRIPTOR_SLOT = 5;
+static constexpr size_t RADIX_SORT_DISPATCH_ARGS_UAV_DESCRIPTOR_SLOT = 6;
+
+static constexpr size_t GEOM_CULL_VIS_SORT_KEYS_UAV_DESCRIPTOR_SLOT = 0;
+static constexpr size_t GEOM_CULL_VIS_SORT_KEYS_COUNTER_UAV_DESCRIPTOR_SLOT = 1;
+static constexpr size_t GEOM_CULL_VIS_GEOM_IDS_UAV_DESCRIPTOR_SLOT = 2;
+static constexpr size_t GEOM_CULL_PER_GEOM_MAT_TYPE_COUNTERS_UAV_DESCRIPTOR_SLOT = 3;
+static constexpr size_t GEOM_CULL_INST_VISIBILITY_UAV_DESCRIPTOR_SLOT = 4;
 
 static constexpr size_t GEOM_BATCH_VIS_INST_ID_QUEUE_DESCRIPTOR_SLOT = 0;
 static constexpr size_t GEOM_BATCH_VIS_INST_ID_QUEUE_SIZE_DESCRIPTOR_SLOT = 1;
@@ -843,6 +1074,11 @@ static constexpr size_t GEOM_BATCH_BATCH_QUEUE_UAV_DESCRIPTOR_SLOT = 2;
 static constexpr size_t GEOM_BATCH_BATCH_QUEUE_SIZE_UAV_DESCRIPTOR_SLOT = 3;
 static constexpr size_t GEOM_BATCH_SORTED_VIS_INST_ID_QUEUE_UAV_DESCRIPTOR_SLOT = 4;
 static constexpr size_t GEOM_BATCH_SORTED_VIS_INST_ID_QUEUE_SIZE_UAV_DESCRIPTOR_SLOT = 5;
+static constexpr size_t GEOM_BATCH_BIN_COUNTERS_UAV_DESCRIPTOR_SLOT = 6;
+static constexpr size_t GEOM_BATCH_BIN_OFFSETS_UAV_DESCRIPTOR_SLOT = 7;
+static constexpr size_t GEOM_BATCH_INST_BINS_UAV_DESCRIPTOR_SLOT = 8;
+static constexpr size_t GEOM_BATCH_SORTED_KEYS_DESCRIPTOR_SLOT = 9;
+static constexpr size_t GEOM_BATCH_PER_GEOM_MAT_TYPE_COUNTERS_DESCRIPTOR_SLOT = 10;
 
 static constexpr size_t GEOM_DRAW_CMD_GEN_BATCH_QUEUE_DESCRIPTOR_SLOT = 0;
 static constexpr size_t GEOM_DRAW_CMD_GEN_BATCH_QUEUE_SIZE_DESCRIPTOR_SLOT = 1;
@@ -850,15 +1086,39 @@ static constexpr size_t GEOM_DRAW_CMD_GEN_CMD_QUEUE_UAV_DESCRIPTOR_SLOT = 2;
 
 static constexpr size_t ZPASS_INST_ID_QUEUE_DESCRIPTOR_SLOT = 0;
 
-static constexpr size_t HZB_SRC_MIPS_DESCRIPTOR_SLOT = 0;
+static constexpr size_t HZB_DEPTH_DESCRIPTOR_SLOT = 0;
 static constexpr size_t HZB_DST_MIPS_UAV_DESCRIPTOR_SLOT = 1;
+static constexpr size_t HZB_SPD_COUNTER_UAV_DESCRIPTOR_SLOT = 2;
 
 static constexpr size_t CSM_VIS_INST_ID_QUEUES_UAV_DESCRIPTOR_SLOT = 0;
 static constexpr size_t CSM_VIS_INST_ID_QUEUE_SIZES_UAV_DESCRIPTOR_SLOT = 1;
 static constexpr size_t CSM_INST_ID_QUEUE_DESCRIPTOR_SLOT = 2;
+static constexpr size_t CSM_VSM_DIRTY_PAGE_RECTS_DESCRIPTOR_SLOT = 3;
+
+static constexpr size_t VSM_PAGES_PAGE_TABLE_UAV_DESCRIPTOR_SLOT = 0;
+static constexpr size_t VSM_PAGES_PHYS_PAGE_LAST_USED_FRAME_UAV_DESCRIPTOR_SLOT = 1;
+static constexpr size_t VSM_PAGES_FREE_LIST_UAV_DESCRIPTOR_SLOT = 2;
+static constexpr size_t VSM_PAGES_FREE_LIST_COUNTER_UAV_DESCRIPTOR_SLOT = 3;
+static constexpr size_t VSM_PAGES_DIRTY_LIST_UAV_DESCRIPTOR_SLOT = 4;
+static constexpr size_t VSM_PAGES_CLEAR_DISPATCH_ARGS_UAV_DESCRIPTOR_SLOT = 5;
+static constexpr size_t VSM_PAGES_DIRTY_PAGE_RECTS_UAV_DESCRIPTOR_SLOT = 6;
+static constexpr size_t VSM_PAGES_PHYS_POOL_UAV_DESCRIPTOR_SLOT = 7;
+
+static constexpr size_t VSM_PAGE_TABLE_DESCRIPTOR_SLOT = 4;
+static constexpr size_t VSM_PHYS_POOL_UAV_DESCRIPTOR_SLOT = 5;
 
 static constexpr size_t GBUFFER_INST_ID_QUEUE_DESCRIPTOR_SLOT = 0;
 
+static constexpr size_t LIGHT_CULLING_LIGHTS_DESCRIPTOR_SLOT = 0;
+static constexpr size_t LIGHT_CULLING_CLUSTER_LIGHT_COUNTS_UAV_DESCRIPTOR_SLOT = 1;
+static constexpr size_t LIGHT_CULLING_CLUSTER_LIGHT_INDICES_UAV_DESCRIPTOR_SLOT = 2;
+
+static constexpr size_t DEFERRED_LIGHTING_CLASSIFY_DEPTH_DESCRIPTOR_SLOT = 0;
+static constexpr size_t DEFERRED_LIGHTING_CLASSIFY_GBUFFER_NORMAL_DESCRIPTOR_SLOT = 1;
+static constexpr size_t DEFERRED_LIGHTING_CLASSIFY_TILE_LIST_UAV_DESCRIPTOR_SLOT = 2;
+static constexpr size_t DEFERRED_LIGHTING_CLASSIFY_DISPATCH_ARGS_UAV_DESCRIPTOR_SLOT = 3;
+static constexpr size_t DEFERRED_LIGHTING_CLASSIFY_CSM_DESCRIPTOR_SLOT = 4;
+
 static constexpr size_t DEFERRED_LIGHTING_GBUFFER_0_DESCRIPTOR_SLOT = 0;
 static constexpr size_t DEFERRED_LIGHTING_GBUFFER_1_DESCRIPTOR_SLOT = 1;
 static constexpr size_t DEFERRED_LIGHTING_GBUFFER_2_DESCRIPTOR_SLOT = 2;
@@ -868,6 +1128,13 @@ static constexpr size_t DEFERRED_LIGHTING_IRRADIANCE_MAP_DESCRIPTOR_SLOT = 5;
 static constexpr size_t DEFERRED_LIGHTING_PREFILTERED_ENV_MAP_DESCRIPTOR_SLOT = 6;
 static constexpr size_t DEFERRED_LIGHTING_BRDF_LUT_DESCRIPTOR_SLOT = 7;
 static constexpr size_t DEFERRED_LIGHTING_CSM_DESCRIPTOR_SLOT = 8;
+static constexpr size_t DEFERRED_LIGHTING_VSM_PAGE_TABLE_DESCRIPTOR_SLOT = 9;
+static constexpr size_t DEFERRED_LIGHTING_VSM_PHYS_POOL_DESCRIPTOR_SLOT = 10;
+static constexpr size_t DEFERRED_LIGHTING_PUNCTUAL_LIGHTS_DESCRIPTOR_SLOT = 11;
+static constexpr size_t DEFERRED_LIGHTING_CLUSTER_LIGHT_COUNTS_DESCRIPTOR_SLOT = 12;
+static constexpr size_t DEFERRED_LIGHTING_CLUSTER_LIGHT_INDICES_DESCRIPTOR_SLOT = 13;
+static constexpr size_t DEFERRED_LIGHTING_OUTPUT_UAV_DESCRIPTOR_SLOT = 14;
+static constexpr size_t DEFERRED_LIGHTING_TILE_LIST_DESCRIPTOR_SLOT = 15;
 
 static constexpr size_t POST_PROCESSING_INPUT_COLOR_DESCRIPTOR_SLOT = 0;
 
@@ -904,6 +1171,7 @@ static constexpr size_t DBG_RT_VIEW_COLOR_16F_DESCRIPTOR_SLOT = 11;
 
 
 static constexpr uint32_t CSM_CASCADE_RT_SIZE = 2048;
+static constexpr uint32_t CSM_ROUND_ROBIN_FIRST_CASCADE = 1; // Cascades starting from this one are refitted one per frame in round robin order
 
 static constexpr uint32_t COMMON_MATERIAL_TEXTURES_COUNT = 128;
 
@@ -925,6 +1193,14 @@ static constexpr size_t GBUFFER_RT_COUNT = 4;
 static constexpr size_t CUBEMAP_FACE_COUNT = 6;
 
 static constexpr size_t STAGING_BUFFER_SIZE  = 256 * 1024 * 1024; // 256 MB
+static constexpr size_t TEXTURE_STREAMING_MEMORY_BUDGET = 512 * 1024 * 1024; // 512 MB
+
+// Must be incremented when material texture encoding is changed, so compressed textures cached before are rebaked
+static constexpr uint32_t MATERIAL_TEXTURE_CACHE_VERSION = 1;
+static constexpr std::string_view MATERIAL_TEXTURE_SOURCE_HASH_KEY = "VkEngineSourceHash";
+
+static constexpr uint32_t FRAMES_IN_FLIGHT_COUNT = 2;
+static_assert(FRAMES_IN_FLIGHT_COUNT > 0);
 
 static constexpr glm::uint COMMON_MAX_GEOM_LOD_COUNT = 6;
 
@@ -937,11 +1213,30 @@ static constexpr glm::uvec2 COMMON_BRDF_INTEGRATION_LUT_SIZE = glm::uvec2(512);
 
 static constexpr uint32_t HZB_MAX_MIP_COUNT = 12;
 
+static constexpr uint32_t RADIX_SORT_CS_GROUP_SIZE = 128;
+static constexpr uint32_t RADIX_SORT_KEYS_PER_THREAD = 16;
+static constexpr uint32_t RADIX_SORT_BLOCK_SIZE = RADIX_SORT_CS_GROUP_SIZE * RADIX_SORT_KEYS_PER_THREAD;
+static constexpr uint32_t RADIX_SORT_DIGIT_BITS = 8;
+static constexpr uint32_t RADIX_SORT_DIGIT_COUNT = 1 << RADIX_SORT_DIGIT_BITS;
+static constexpr uint32_t RADIX_SORT_KEY_BITS = 64;
+
 static constexpr uint32_t GEOM_CULLING_CS_GROUP_SIZE = 1024;
 static constexpr uint32_t GEOM_BATCH_CS_GROUP_SIZE = 1024;
 static constexpr uint32_t GEOM_DRAW_CMD_GEN_CS_GROUP_SIZE = 512;
 
 static constexpr uint32_t HZB_BUILD_CS_GROUP_SIZE = 16;
+static constexpr uint32_t HZB_SPD_TILE_SIZE = 64;
+
+static constexpr uint32_t VSM_PAGES_CS_GROUP_SIZE = 8;
+static constexpr uint32_t VSM_PHYS_POOL_SIZE = COMMON_VSM_PHYS_PAGE_COUNT_X * COMMON_VSM_PAGE_SIZE; // 4096 x 4096 R32_UINT, 64 MB
+static constexpr float VSM_LEVEL_RADIUS_SCALE = float(COMMON_VSM_VIRTUAL_PAGE_COUNT) / float(COMMON_VSM_VIRTUAL_PAGE_COUNT - 1); // Reserves one page for snapping
+static constexpr float VSM_DEPTH_RANGE_MARGIN = 10.f; // World units added to scene depth range in light space
+static constexpr glm::int4 VSM_EMPTY_PAGE_RECT = glm::int4(INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN);
+
+static constexpr uint32_t LIGHT_CULLING_CS_GROUP_SIZE = 64;
+static constexpr uint32_t DEFERRED_LIGHTING_TILE_SIZE = 8;
+// Lights without range are limited to distance where their intensity falls below this value
+static constexpr float PUNCTUAL_LIGHT_MIN_INTENSITY = 0.01f;
 
 static constexpr uint32_t DESC_SET_PER_FRAME = 0;
 static constexpr uint32_t DESC_SET_PER_DRAW = 1;
@@ -978,6 +1273,7 @@ static constexpr std::array CSM_CASCADE_COLORS = {
 };
 
 static_assert(std::size(CSM_CASCADE_DISTANCES) == COMMON_CSM_CASCADE_COUNT);
+static_assert(CSM_ROUND_ROBIN_FIRST_CASCADE < COMMON_CSM_CASCADE_COUNT);
 static_assert(std::size(CSM_CASCADE_COLORS) == COMMON_CSM_CASCADE_COUNT);
 
 
@@ -1053,25 +1349,46 @@ public:
             Unload();
         }
 
-        const std::string strPath = filepath.string();
+        // Maps file once instead of reopening it for every stb header probe and decoding
+        const eng::MappedFile file(filepath);
+        
+        if (!file.IsOpened()) {
+            return false;
+        }
+
+        return Load(file.GetData(), file.GetSize());
+    }
+
+    bool Load(const void* pMemory, size_t size)
+    {
+        if (IsLoaded()) {
+            Unload();
+        }
+
+        CORE_ASSERT(pMemory != nullptr);
+        CORE_ASSERT(size > 0);
+
+        const stbi_uc* pBytes = static_cast<const stbi_uc*>(pMemory);
+        const int bytesCount = static_cast<int>(size);
 
         int width = 0;
         int height = 0;
         int channels = 0;
 
-        const int result = stbi_info(strPath.c_str(), &width, &height, &channels);
-        CORE_ASSERT(result == 1);
+        if (stbi_info_from_memory(pBytes, bytesCount, &width, &height, &channels) != 1) {
+            return false;
+        }
 
         const bool isRGB = channels == 3;
 
-        if (stbi_is_16_bit(strPath.c_str())) {
-            m_pData = stbi_load_16(strPath.c_str(), &width, &height, &channels, isRGB ? 4 : 0);
+        if (stbi_is_16_bit_from_memory(pBytes, bytesCount)) {
+            m_pData = stbi_load_16_from_memory(pBytes, bytesCount, &width, &height, &channels, isRGB ? 4 : 0);
             m_type = ComponentType::UINT16;
-        } else if (stbi_is_hdr(strPath.c_str())) {
-            m_pData = stbi_loadf(strPath.c_str(), &width, &height, &channels, isRGB ? 4 : 0);
+        } else if (stbi_is_hdr_from_memory(pBytes, bytesCount)) {
+            m_pData = stbi_loadf_from_memory(pBytes, bytesCount, &width, &height, &channels, isRGB ? 4 : 0);
             m_type = ComponentType::FLOAT;
         } else {
-            m_pData = stbi_load(strPath.c_str(), &width, &height, &channels, isRGB ? 4 : 0);
+            m_pData = stbi_load_from_memory(pBytes, bytesCount, &width, &height, &channels, isRGB ? 4 : 0);
             m_type = ComponentType::UINT8;
         }
 
@@ -1091,7 +1408,8 @@ public:
         return true;
     }
 
-    bool Load(const void* pMemory, size_t size)
+    // Decodes any LDR or 16 bit image into 4 channel 8 bit one, which is expected by block compression encoders
+    bool LoadRGBA8(const void* pMemory, size_t size)
     {
         if (IsLoaded()) {
             Unload();
@@ -1104,16 +1422,7 @@ public:
         int height = 0;
         int channels = 0;
 
-        if (stbi_is_16_bit_from_memory((const stbi_uc*)pMemory, size)) {
-            m_pData = stbi_load_16_from_memory((const stbi_uc*)pMemory, size, &width, &height, &channels, 0);
-            m_type = ComponentType::UINT16;
-        } else if (stbi_is_hdr_from_memory((const stbi_uc*)pMemory, size)) {
-            m_pData = stbi_loadf_from_memory((const stbi_uc*)pMemory, size, &width, &height, &channels, 0);
-            m_type = ComponentType::FLOAT;
-        } else {
-            m_pData = stbi_load_from_memory((const stbi_uc*)pMemory, size, &width, &height, &channels, 0);
-            m_type = ComponentType::UINT8;
-        }
+        m_pData = stbi_load_from_memory(static_cast<const stbi_uc*>(pMemory), static_cast<int>(size), &width, &height, &channels, 4);
 
         if (!m_pData) {
             return false;
@@ -1121,14 +1430,47 @@ public:
 
         m_width = width;
         m_height = height;
-        m_channels = channels;
+        m_channels = 4;
         m_mipsCount = CalcMipsCount(m_width, m_height);
+        m_type = ComponentType::UINT8;
 
         m_format = EvaluateFormat(m_channels, m_type);
 
         return true;
     }
 
+    static bool IsHDR(const void* pMemory, size_t size)
+    {
+        return stbi_is_hdr_from_memory(static_cast<const stbi_uc*>(pMemory), static_cast<int>(size));
+    }
+
+    // Returns size of decoded mip 0 in bytes using only image header. Returns 0 if format is unknown
+    static size_t EstimateDecodedSize(const void* pMemory, size_t size)
+    {
+        const stbi_uc* pBytes = static_cast<const stbi_uc*>(pMemory);
+        const int bytesCount = static_cast<int>(size);
+
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+
+        if (stbi_info_from_memory(pBytes, bytesCount, &width, &height, &channels) != 1) {
+            return 0;
+        }
+
+        ComponentType type = ComponentType::UINT8;
+
+        if (stbi_is_16_bit_from_memory(pBytes, bytesCount)) {
+            type = ComponentType::UINT16;
+        } else if (stbi_is_hdr_from_memory(pBytes, bytesCount)) {
+            type = ComponentType::FLOAT;
+        }
+
+        channels = channels == 3 ? 4 : channels;
+
+        return size_t(width) * size_t(height) * size_t(channels) * COMP_TYPE_SIZE_IN_BYTES[static_cast<size_t>(type)];
+    }
+
     void Unload()
     {
         if (!IsLoaded()) {
@@ -1273,27 +1615,41 @@ static vkn::Swapchain& s_vkSwapchain = vkn::GetSwapchain();
 static vkn::CmdPool s_commonCmdPool;
 
 static vkn::CmdBuffer* s_pImmediateSubmitCmdBuffer;
-static vkn::Fence      s_immediateSubmitFinishedFence;
+
+// Every submission to the main queue signals the next value, so completion of frames and immediate submits is checked without fences
+static vkn::GPUProgressTracker s_mainQueueProgress;
 
 static std::vector<vkn::Semaphore> s_renderFinishedSemaphores;
-static vkn::Semaphore  s_presentFinishedSemaphore;
-static vkn::Fence      s_renderFinishedFence;
-static vkn::CmdBuffer* s_pRenderCmdBuffer;
+static std::array<vkn::Semaphore, FRAMES_IN_FLIGHT_COUNT>  s_presentFinishedSemaphores;
+static std::array<uint64_t, FRAMES_IN_FLIGHT_COUNT>        s_renderFinishedValues = {};
+static std::array<vkn::CmdBuffer*, FRAMES_IN_FLIGHT_COUNT> s_pRenderCmdBuffers;
+
+// Parallel passes of the render graph are recorded into them. Reset once the frame in flight is finished by GPU
+static std::array<eng::SecondaryCmdBufferAllocator, FRAMES_IN_FLIGHT_COUNT> s_secondaryCmdBufferAllocators;
+static constexpr uint16_t SECONDARY_CMD_BUFFER_COUNT_PER_THREAD = 16;
 
-static vkn::Buffer s_commonStagingBuffer;
+// Rebuilt every frame. Keeps the last compiled DAG for debug UI
+static eng::RenderGraph s_renderGraph;
+// Barrier stats of the last recorded render command buffer
+static vkn::CmdBuffer::BarrierStats s_renderBarrierStats;
+
+static vkn::UploadManager s_uploadManager;
 
 static std::array<vkn::DescriptorSetLayout, PASS_ID_COUNT> s_descSetLayouts;
 
 static std::array<vkn::PSOLayout, PASS_ID_COUNT> s_PSOLayouts;
 static std::array<vkn::PSO,       PASS_ID_COUNT> s_PSOs;
+// Deferred lighting permutation per tile class. They share PASS_ID_DEFERRED_LIGHTING layout
+static std::array<vkn::PSO,       DEFERRED_LIGHTING_TILE_CLASS_COUNT> s_deferredLightingPSOs;
 
-static vkn::DescriptorBuffer s_descriptorBuffer;
+// Each frame in flight owns its own copy of descriptor sets since some of them reference per frame resources (const buffers, debug draw buffers)
+static std::array<vkn::DescriptorBuffer, FRAMES_IN_FLIGHT_COUNT> s_descriptorBuffers;
 
 static std::array<vkn::Buffer, COMMON_GEOM_STREAM_COUNT> s_geomStreamBuffers;
 static vkn::Buffer s_geomIndexBuffer;
 
-static vkn::Buffer s_commonConstBuffer;
-static vkn::Buffer s_commonDbgConstBuffer;
+static std::array<vkn::Buffer, FRAMES_IN_FLIGHT_COUNT> s_commonConstBuffers;
+static std::array<vkn::Buffer, FRAMES_IN_FLIGHT_COUNT> s_commonDbgConstBuffers;
 
 static vkn::Buffer s_commonMeshLODBuffer;
 static vkn::Buffer s_commonMeshBuffer;
@@ -1301,15 +1657,26 @@ static vkn::Buffer s_commonMaterialBuffer;
 static vkn::Buffer s_commonInstBuffer;
 
 
-static std::array<vkn::Buffer, GEOM_QUEUE_COUNT> s_visGeomIDQueueBuffer;
-static std::array<vkn::Buffer, GEOM_QUEUE_COUNT> s_visGeomIDQueueSizeBuffer;
-
 static vkn::Buffer s_geomCullVisSortKeysBuffer;
 static vkn::Buffer s_geomCullVisSortKeysCounterBuffer;
 static vkn::Buffer s_geomCullVisGeomIDsBuffer;
 static vkn::Buffer s_geomCullPerGeomMatTypeCountersBuffer;
 
+// Visibility history for two-phase occlusion culling. Must be reset when it becomes invalid (e.g. on first frame)
+static vkn::Buffer s_geomCullInstVisibilityBuffer;
+static bool s_geomCullInstVisibilityResetRequired = true;
+
+// Ping-pong buffers of visible instances radix sort. Sorted data ends up in the culling output buffers
+static vkn::Buffer s_geomRadixSortTmpKeysBuffer;
+static vkn::Buffer s_geomRadixSortTmpGeomIDsBuffer;
+
+// Radix sort scratch data. It's shared by all sorts since they are executed sequentially
+static vkn::Buffer s_radixSortHistogramsBuffer;
+static vkn::Buffer s_radixSortDispatchArgsBuffer;
+static uint32_t    s_radixSortMaxElemCount = 0;
 
+
+// Every culling phase has its own region of s_cpuInstData.size() elements in main view queues and own element in their size buffers
 static std::array<vkn::Buffer, GEOM_QUEUE_COUNT> s_geomBatchQueueBuffer;
 static std::array<vkn::Buffer, GEOM_QUEUE_COUNT> s_geomBatchQueueSizeBuffer;
 
@@ -1318,22 +1685,49 @@ static std::array<vkn::Buffer, GEOM_QUEUE_COUNT> s_sortedVisGeomIDQueueSizeBuffe
 
 static std::array<vkn::Buffer, GEOM_QUEUE_COUNT> s_geomDrawCmdQueueBuffer;
 
+// Batching scratch data. It's shared by all views since their batching passes are executed sequentially
+static vkn::Buffer s_geomBatchBinCountersBuffer;
+static vkn::Buffer s_geomBatchBinOffsetsBuffer;
+static vkn::Buffer s_geomBatchInstBinsBuffer;
+
+
+// CSM Data. Queues of every geometry type and queue contain entries of all cascades
+static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, CSM_GEOM_TYPE_COUNT> s_csmVisGeomIDQueueBuffers;
+static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, CSM_GEOM_TYPE_COUNT> s_csmVisGeomIDQueueSizeBuffers;
+
+static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, CSM_GEOM_TYPE_COUNT> s_csmGeomBatchQueueBuffers;
+static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, CSM_GEOM_TYPE_COUNT> s_csmGeomBatchQueueSizeBuffers;
 
-// CSM Data
-static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, COMMON_CSM_CASCADE_COUNT> s_csmVisGeomIDQueueBuffers;
-static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, COMMON_CSM_CASCADE_COUNT> s_csmVisGeomIDQueueSizeBuffers;
+static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, CSM_GEOM_TYPE_COUNT> s_csmSortedVisGeomIDQueueBuffers;
+static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, CSM_GEOM_TYPE_COUNT> s_csmSortedVisGeomIDQueueSizeBuffers;
 
-static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, COMMON_CSM_CASCADE_COUNT> s_csmGeomBatchQueueBuffers;
-static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, COMMON_CSM_CASCADE_COUNT> s_csmGeomBatchQueueSizeBuffers;
+static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, CSM_GEOM_TYPE_COUNT> s_csmGeomDrawCmdQueueBuffers;
 
-static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, COMMON_CSM_CASCADE_COUNT> s_csmSortedVisGeomIDQueueBuffers;
-static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, COMMON_CSM_CASCADE_COUNT> s_csmSortedVisGeomIDQueueSizeBuffers;
+static vkn::Texture     s_csmRT;
+static vkn::TextureView s_csmRTViewArray; // Used both for layered rendering of all cascades and sampling
 
-static std::array<std::array<vkn::Buffer, GEOM_QUEUE_COUNT>, COMMON_CSM_CASCADE_COUNT> s_csmGeomDrawCmdQueueBuffers;
+// Static geometry depth of every cascade. Cascade is copied into s_csmRT when it's rebuilt or when dynamic geometry is rendered on top of it
+static vkn::Texture     s_csmStaticCacheRT;
+static vkn::TextureView s_csmStaticCacheRTViewArray;
 
-static vkn::Texture                                           s_csmRT;
-static vkn::TextureView                                       s_csmRTViewArray;
-static std::array<vkn::TextureView, COMMON_CSM_CASCADE_COUNT> s_csmRTViews;
+
+// VSM Data. Levels reuse CSM culling, batching and draw command queues
+static vkn::Buffer s_vsmPageTableBuffer;
+static vkn::Buffer s_vsmPhysPageLastUsedFrameBuffer;
+static vkn::Buffer s_vsmFreeListBuffer;
+static vkn::Buffer s_vsmFreeListCounterBuffer;
+static vkn::Buffer s_vsmDirtyListBuffer;
+static vkn::Buffer s_vsmClearDispatchArgsBuffer;
+static vkn::Buffer s_vsmDirtyPageRectsBuffer;
+
+static vkn::Texture     s_vsmPhysPool;
+static vkn::TextureView s_vsmPhysPoolView;
+
+
+// Punctual lights are binned into main camera clusters every frame. Every cluster has fixed size region in the indices buffer
+static vkn::Buffer s_punctualLightBuffer;
+static vkn::Buffer s_lightClusterLightCountsBuffer;
+static vkn::Buffer s_lightClusterLightIndicesBuffer;
 
 
 static std::vector<vkn::Texture>     s_commonMaterialTextures;
@@ -1345,12 +1739,25 @@ static std::vector<vkn::Sampler> s_commonCmpSamplers;
 static std::array<std::vector<uint32_t>, COMMON_GEOM_STREAM_COUNT> s_cpuGeomStreamBuffers;
 static std::vector<IndexType> s_cpuGeomIndexBuffer;
 
-static std::vector<TextureLoadData> s_cpuTexturesData;
+// Geometry data which is only uploaded to GPU. Points either into CPU buffers or into mapped scene cache file
+struct SceneGeomUploadData
+{
+    std::array<std::span<const uint32_t>, COMMON_GEOM_STREAM_COUNT> streams;
+    std::span<const IndexType> indices;
+    std::span<const GPU_MeshLOD> lods;
+};
+
+static SceneGeomUploadData s_sceneGeomUploadData;
+
+// Kept mapped until scene geometry is uploaded
+static eng::MappedFile s_sceneCacheFile;
+
 
 static std::vector<GPU_MeshLOD>      s_cpuMeshLODData;
 static std::vector<GPU_Mesh>         s_cpuMeshData;
 static std::vector<GPU_GeomMaterial> s_cpuMaterialData;
 static std::vector<GPU_GeomInst>     s_cpuInstData;
+static std::vector<GPU_PunctualLight> s_cpuPunctualLightData;
 
 
 static std::vector<GPU_DbgLineData>     s_dbgLineDataCPU;
@@ -1359,10 +1766,10 @@ static std::vector<GPU_DbgTriangleData> s_dbgTriangleDataCPU;
 static std::vector<glm::uint> s_dbgLineVertexDataCPU;
 static std::vector<glm::uint> s_dbgTriangleVertexDataCPU;
 
-static vkn::Buffer s_dbgLineDataGPU;
-static vkn::Buffer s_dbgTriangleDataGPU;
-static vkn::Buffer s_dbgLineVertexDataGPU;
-static vkn::Buffer s_dbgTriangleVertexDataGPU;
+static std::array<vkn::Buffer, FRAMES_IN_FLIGHT_COUNT> s_dbgLineDataGPU;
+static std::array<vkn::Buffer, FRAMES_IN_FLIGHT_COUNT> s_dbgTriangleDataGPU;
+static std::array<vkn::Buffer, FRAMES_IN_FLIGHT_COUNT> s_dbgLineVertexDataGPU;
+static std::array<vkn::Buffer, FRAMES_IN_FLIGHT_COUNT> s_dbgTriangleVertexDataGPU;
 
 
 static vkn::Texture     s_skyboxTexture;
@@ -1393,13 +1800,46 @@ static vkn::TextureView s_colorRTView8U;
 static vkn::Texture     s_colorRT16F;
 static vkn::TextureView s_colorRTView16F;
 
+// Content of G-buffer, depth and color RTs isn't needed between frames, so RTs which lifetimes don't overlap share memory
+static eng::TransientTextureAllocator s_transientRTAllocator;
+
 static vkn::Texture                  s_HZB;
 static vkn::TextureView              s_HZBView;
 static std::vector<vkn::TextureView> s_HZBMipViews;
 
-static vkn::ComputePSOBuilder s_computePSOBuilder;
-static vkn::GraphicsPSOBuilder s_graphicsPSOBuilder;
-static std::vector<uint8_t> s_shaderCodeBuffer;
+// Counter of HZB generation groups which finished their tiles. Shader resets it after use, so it's cleared only after creation
+static vkn::Buffer s_hzbSpdCounterBuffer;
+static bool        s_hzbSpdCounterResetRequired = true;
+
+// Every tile class has its own region of screen tile count elements in tile list and own GPU_CmdDispatchIndirect
+static vkn::Buffer s_deferredLightingTileListBuffer;
+static vkn::Buffer s_deferredLightingDispatchArgsBuffer;
+
+// Loaded from disk at startup and saved back at shutdown, so driver doesn't recompile unchanged PSOs on every launch
+static vkn::PSOCache s_PSOCache;
+
+// Scratch data of PSO creation job. Jobs are run in parallel, so every worker slot has its own builders and SPIR-V buffer
+struct PSOBuildContext
+{
+    vkn::ComputePSOBuilder  computePSOBuilder;
+    vkn::GraphicsPSOBuilder graphicsPSOBuilder;
+    std::vector<uint8_t>    shaderCodeBuffer;
+};
+
+// Shader names are SPIR-V filenames in shaders output dir. Shader hot reload uses them to find PSOs which must be rebuilt
+struct PSOBuildJob
+{
+    std::vector<std::string_view> shaderNames;
+    std::function<void(PSOBuildContext& ctx, std::span<const fs::path> shaderPaths)> build;
+};
+
+#ifdef ENG_SHADER_HOT_RELOAD_ENABLED
+static eng::FileWatcher s_shaderFileWatcher;
+
+// Names of SPIR-V files recompiled on the watcher thread, which aren't applied to PSOs yet
+static std::mutex               s_reloadedShaderNamesMutex;
+static std::vector<std::string> s_reloadedShaderNames;
+#endif
 
 static eng::DbgUI s_dbgUI;
 
@@ -1407,9 +1847,25 @@ static eng::Camera s_mainCamera;
 static glm::float3 s_mainCameraVel = ZEROF3;
 static bool s_mainCameraLoaded = false;
 
+// Scene camera which main camera is initialized with. Kept to be stored in the scene cache
+struct SceneCameraData
+{
+    glm::float4x4 transform;
+    float yfov;
+    float xmag;
+    float ymag;
+    float znear;
+    float zfar;
+    uint32_t isPerspective;
+};
+
+static SceneCameraData s_mainCameraData = {};
+
 static std::array<eng::Camera, COMMON_CSM_CASCADE_COUNT> s_csmCameras;
 static std::array<float, COMMON_CSM_CASCADE_COUNT> s_csmCascadeWorldUnitsPerTexel;
 
+static uint32_t s_geomFirstDynamicInstID = 0; // Static instances go first in s_cpuInstData
+
 static eng::Camera s_fixedCullCamera;
 
 static std::array<glm::float4x4, COMMON_CSM_CASCADE_COUNT> s_fixedCamCsmInvViewProjMatr;
@@ -1426,9 +1882,13 @@ static int32_t s_dbgOutputRTCascadeIndex = 0;
 static uint32_t s_nextImageIdx = 0;
 
 static int32_t s_forcedGeomLOD = -1;
+static float s_geomLodPixelThreshold = 1.f;
+static std::array<float, COMMON_CSM_CASCADE_COUNT> s_csmGeomLodPixelThresholds = { 1.f, 1.5f, 2.f };
 
 static size_t s_frameNumber = 0;
 static float s_frameTime = M3D_EPS;
+static uint32_t s_frameInFlightIdx = 0;
+static float s_frameFenceWaitTime = 0.f; // CPU time spent on waiting for GPU to release current frame in flight resources
 static bool s_swapchainRecreateRequired = false;
 static bool s_flyCameraMode = false;
 static bool s_cullingTestMode = false;
@@ -1465,6 +1925,44 @@ struct CsmPcssSettings
     bool randomRotationEnabled = false;
 } s_csmPcssSettings;
 
+// State which static cache of cascade was built with. Cascade cache is rebuilt when any of it changes
+struct CsmStaticCacheState
+{
+    glm::float4x4 viewProjMatr = glm::float4x4(0.f);
+    float geomLodPixelThreshold = 0.f;
+    int32_t forcedGeomLOD = -1;
+    bool isWireframe = false;
+    bool isValid = false;
+};
+
+static std::array<CsmStaticCacheState, COMMON_CSM_CASCADE_COUNT> s_csmStaticCacheStates;
+static uint32_t s_csmStaticCacheUpdateMask = 0; // Cascades which static cache is rebuilt in current frame
+
+static bool s_csmCascadesFitted = false;
+
+// State which VSM level pages were rendered with. All level pages are released when any of it changes
+struct VsmLevelState
+{
+    float halfSize = 0.f;
+    float geomLodPixelThreshold = 0.f;
+    int32_t forcedGeomLOD = -1;
+    bool isWireframe = false;
+};
+
+static std::array<eng::Camera, COMMON_VSM_LEVEL_COUNT> s_vsmLevelCameras;
+static std::array<glm::int2, COMMON_VSM_LEVEL_COUNT> s_vsmLevelPageOffsets;
+static std::array<float, COMMON_VSM_LEVEL_COUNT> s_vsmLevelWorldUnitsPerTexel;
+static std::array<glm::int4, COMMON_VSM_LEVEL_COUNT> s_vsmLevelDynamicPageRects;     // Absolute page coords touched by dynamic geometry in current frame
+static std::array<glm::int4, COMMON_VSM_LEVEL_COUNT> s_vsmLevelDynamicPageRectsPrev; // The same for previous frame. Pages left by dynamic geometry must be redrawn too
+static std::array<VsmLevelState, COMMON_VSM_LEVEL_COUNT> s_vsmLevelStates;
+static uint32_t s_vsmInvalidLevelMask = 0;
+
+static glm::float3 s_vsmSceneCenterLS = ZEROF3; // Scene AABB center in light space. Levels share its depth, so static pages stay valid while camera moves
+static float s_vsmDepthRange = 0.f;
+
+static bool s_vsmResetRequired = true;
+static bool s_vsmWasEnabled = false;
+
 static float s_mainCameraSpeed = 0.02f;
 
 #ifdef ENG_DEBUG_UI_ENABLED
@@ -1478,6 +1976,8 @@ static float s_mainCameraSpeed = 0.02f;
     static bool s_isCSMCascadeBlendEnabled = true;
     static bool s_isCSMFilterRandomOffsetEnabled = false;
     static bool s_isCSMPCSSEnabled = true;
+    static bool s_isCSMStaticCacheEnabled = true;
+    static bool s_isVSMEnabled = true;
 
     static GPU_DbgTonemapPreset s_tonemappingPreset = DBG_TONEMAP_PRESET_ACES;
     static GPU_DbgCsmPCFPreset s_csmPCFPreset = DBG_CSM_PCF_PRESET_POISSON_DISK;
@@ -1497,6 +1997,8 @@ static float s_mainCameraSpeed = 0.02f;
     static constexpr bool s_isCSMCascadeBlendEnabled = true;
     static constexpr bool s_isCSMFilterRandomOffsetEnabled = false;
     static constexpr bool s_isCSMPCSSEnabled = true;
+    static constexpr bool s_isCSMStaticCacheEnabled = true;
+    static constexpr bool s_isVSMEnabled = true;
 
     static constexpr GPU_DbgTonemapPreset s_tonemappingPreset = DBG_TONEMAP_PRESET_ACES;
     static constexpr GPU_DbgCsmPCFPreset s_csmPCFPreset = DBG_CSM_PCF_PRESET_POISSON_DISK;
@@ -1817,9 +2319,37 @@ static constexpr VkIndexType GetVkIndexType()
 }
 
 
-static uint32_t CSMGetBufferIndex(uint32_t cascade, GPU_GeomQueue queue)
+// Every instance gets one CSM visible instance entry per cascade it is visible in
+static size_t CSMGetVisInstQueueCapacity(GPU_CsmGeomType geomType)
+{
+    const size_t instCount = geomType == CSM_GEOM_TYPE_STATIC ? s_geomFirstDynamicInstID : s_cpuInstData.size() - s_geomFirstDynamicInstID;
+    
+    // Scene can have no dynamic instances, but empty buffers can't be created
+    return glm::max<size_t>(COMMON_CSM_CASCADE_COUNT * instCount, 1);
+}
+
+
+static DescSetID CSMGetGeomBatchingDescSetID(GPU_CsmGeomType geomType, GPU_GeomQueue queue)
+{
+    return (DescSetID)(DESC_SET_ID_CSM_GEOM_BATCHING_STATIC_OPAQUE + geomType * GEOM_QUEUE_COUNT + queue);
+}
+
+
+static DescSetID CSMGetGeomDrawCmdGenDescSetID(GPU_CsmGeomType geomType, GPU_GeomQueue queue)
+{
+    return (DescSetID)(DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_STATIC_OPAQUE + geomType * GEOM_QUEUE_COUNT + queue);
+}
+
+
+static uint32_t CSMGetBufferIndex(GPU_CsmGeomType geomType, GPU_GeomQueue queue)
+{
+    return geomType * GEOM_QUEUE_COUNT + queue;
+}
+
+
+static bool CSMHasDynamicInstances()
 {
-    return glm::clamp(cascade, 0u, COMMON_CSM_CASCADE_COUNT - 1) * GEOM_QUEUE_COUNT + queue;
+    return s_geomFirstDynamicInstID < s_cpuInstData.size();
 }
 
 
@@ -1847,16 +2377,22 @@ static void SetWireframeMode(vkn::CmdBuffer& cmdBuffer, bool isWireframed)
 template <typename Func, typename... Args>
 static void ImmediateSubmitQueue(vkn::Queue& queue, Func func, Args&&... args)
 {   
-    s_immediateSubmitFinishedFence.Reset();
+    CORE_ASSERT_MSG(&queue == &s_vkDevice.GetQueue(), "Main queue progress tracker is signaled only by main queue submissions");
+
     s_pImmediateSubmitCmdBuffer->Reset();
 
     s_pImmediateSubmitCmdBuffer->Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
         func(*s_pImmediateSubmitCmdBuffer, std::forward<Args>(args)...);
     s_pImmediateSubmitCmdBuffer->End();
 
-    queue.Submit(*s_pImmediateSubmitCmdBuffer, &s_immediateSubmitFinishedFence);
+    vkn::QueueTimelineSyncData finishedData = {};
+    finishedData.pSemaphore = &s_mainQueueProgress.GetSemaphore();
+    finishedData.value = s_mainQueueProgress.AcquireSignalValue();
+    finishedData.stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+    queue.Submit(*s_pImmediateSubmitCmdBuffer, finishedData);
 
-    s_immediateSubmitFinishedFence.WaitFor(10'000'000'000);
+    s_mainQueueProgress.WaitFor(finishedData.value, 10'000'000'000);
 }
 
 
@@ -2029,19 +2565,29 @@ static void CreateCommonCmdPool()
     cmdPoolCreateInfo.pDevice = &s_vkDevice;
     cmdPoolCreateInfo.queueFamilyIndex = s_vkDevice.GetQueue().GetFamilyIndex();
     cmdPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    cmdPoolCreateInfo.size = 2;
+    cmdPoolCreateInfo.size = 1 + FRAMES_IN_FLIGHT_COUNT; // Immediate submit + render cmd buffer per frame in flight
     
     s_commonCmdPool.Create(cmdPoolCreateInfo);
     s_vkDevice.SetObjDebugName(s_commonCmdPool, "COMMON_CMD_POOL");
 }
 
 
+static void CreateSecondaryCmdBufferAllocators()
+{
+    for (uint32_t i = 0; i < FRAMES_IN_FLIGHT_COUNT; ++i) {
+        s_secondaryCmdBufferAllocators[i].Create(&s_vkDevice, s_vkDevice.GetQueue().GetFamilyIndex(), 
+            eng::GetThreadPool().GetWorkerSlotCount(), SECONDARY_CMD_BUFFER_COUNT_PER_THREAD);
+    }
+}
+
+
 static void CreateImmediateSubmitObjects()
 {
     s_pImmediateSubmitCmdBuffer = s_commonCmdPool.AllocCmdBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
     s_vkDevice.SetObjDebugName(*s_pImmediateSubmitCmdBuffer, "IMMEDIATE_CMD_BUFFER");
 
-    s_immediateSubmitFinishedFence.Create(&s_vkDevice);
+    s_mainQueueProgress.Create(&s_vkDevice);
+    s_vkDevice.SetObjDebugName(s_mainQueueProgress.GetSemaphore(), "MAIN_QUEUE_PROGRESS_SEMAPHORE");
 }
 
 
@@ -2057,6 +2603,13 @@ static void CreateVkPhysAndLogicalDevices()
     s_vkPhysDevice.Create(physDeviceCreateInfo);
     CORE_ASSERT(s_vkPhysDevice.IsCreated()); 
 
+    // All VSM levels are rasterized into one attachmentless virtual viewport
+    const VkPhysicalDeviceLimits& limits = s_vkPhysDevice.GetProperties().properties.limits;
+    CORE_ASSERT_MSG(limits.maxFramebufferWidth >= COMMON_VSM_VIRTUAL_SIZE && limits.maxFramebufferHeight >= COMMON_VSM_VIRTUAL_SIZE,
+        "Device doesn't support %u x %u framebuffer required by VSM", COMMON_VSM_VIRTUAL_SIZE, COMMON_VSM_VIRTUAL_SIZE);
+    CORE_ASSERT_MSG(limits.maxViewportDimensions[0] >= COMMON_VSM_VIRTUAL_SIZE && limits.maxViewportDimensions[1] >= COMMON_VSM_VIRTUAL_SIZE,
+        "Device doesn't support %u x %u viewport required by VSM", COMMON_VSM_VIRTUAL_SIZE, COMMON_VSM_VIRTUAL_SIZE);
+
     constexpr std::array deviceExtensions = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
         VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME,
@@ -2109,6 +2662,10 @@ static void CreateVkPhysAndLogicalDevices()
 
     features12.drawIndirectCount = VK_TRUE;
 
+    features12.timelineSemaphore = VK_TRUE; // GPU progress of queues and upload batches is tracked with timeline semaphore values
+
+    features12.shaderOutputLayer = VK_TRUE; // Used by layered CSM rendering to route cascades into RT layers from vertex shader
+
     features12.descriptorIndexing = VK_TRUE;
     features12.descriptorBindingPartiallyBound = VK_TRUE;
     features12.runtimeDescriptorArray = VK_TRUE;
@@ -2123,9 +2680,11 @@ static void CreateVkPhysAndLogicalDevices()
     features2.pNext = &features11;
     features2.features.samplerAnisotropy = VK_TRUE;
     features2.features.vertexPipelineStoresAndAtomics = VK_TRUE;
+    features2.features.fragmentStoresAndAtomics = VK_TRUE; // VSM depth is written into physical pool with atomics
     features2.features.wideLines = VK_TRUE;
     features2.features.fillModeNonSolid = VK_TRUE;
     features2.features.shaderInt64 = VK_TRUE;
+    features2.features.textureCompressionBC = VK_TRUE; // Material textures are block compressed
 
     vkn::DeviceCreateInfo deviceCreateInfo = {};
     deviceCreateInfo.pPhysDevice = &s_vkPhysDevice;
@@ -2143,29 +2702,22 @@ static void CreateVkPhysAndLogicalDevices()
 }
 
 
-static void CreateCommonStagingBuffer()
+static void CreateUploadManager()
 {
-    vkn::AllocationInfo stagingBufAllocInfo = {};
-    stagingBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
-    stagingBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+    vkn::UploadManagerCreateInfo uploadManagerCreateInfo = {};
+    uploadManagerCreateInfo.pDevice = &s_vkDevice;
+    // Copies are executed on dedicated transfer queue if device has one, so they can overlap with graphics work
+    uploadManagerCreateInfo.pQueue = &s_vkDevice.GetTransferQueue();
+    uploadManagerCreateInfo.pOwnerQueue = &s_vkDevice.GetQueue();
+    uploadManagerCreateInfo.stagingBufferSize = STAGING_BUFFER_SIZE;
 
-    vkn::BufferCreateInfo stagingBufCreateInfo = {};
-    stagingBufCreateInfo.pDevice = &s_vkDevice;
-    stagingBufCreateInfo.size = STAGING_BUFFER_SIZE;
-    stagingBufCreateInfo.usage = VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_SRC_BIT;
-    stagingBufCreateInfo.pAllocInfo = &stagingBufAllocInfo;
-
-    s_commonStagingBuffer.Create(stagingBufCreateInfo);
-    s_vkDevice.SetObjDebugName(s_commonStagingBuffer, "COMMON_STAGING_BUFFER");
+    s_uploadManager.Create(uploadManagerCreateInfo);
+    CORE_ASSERT(s_uploadManager.IsCreated());
 }
 
 
-static void CreateGBufferRTs()
+static void CreateTransientRTs()
 {
-    vkn::AllocationInfo rtAllocInfo = {};
-    rtAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
-    rtAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-
     vkn::TextureCreateInfo rtCreateInfo = {};
     rtCreateInfo.pDevice = &s_vkDevice;
     rtCreateInfo.type = VK_IMAGE_TYPE_2D;
@@ -2176,161 +2728,72 @@ static void CreateGBufferRTs()
     rtCreateInfo.arrayLayers = 1;
     rtCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     rtCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    rtCreateInfo.pAllocInfo = &rtAllocInfo;
 
-    VkComponentMapping mapping = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
-    
-    VkImageSubresourceRange subresourceRange = {};
-    subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    subresourceRange.baseMipLevel = 0;
-    subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
-    subresourceRange.baseArrayLayer = 0;
-    subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+    static constexpr std::array<VkFormat, GBUFFER_RT_COUNT> GBUFFER_RT_FORMATS = {
+        VK_FORMAT_R8G8B8A8_UNORM,
+        VK_FORMAT_R16G16B16A16_SNORM,
+        VK_FORMAT_R8G8B8A8_UNORM,
+        VK_FORMAT_R8G8B8A8_UNORM,
+    };
 
+    for (size_t i = 0; i < GBUFFER_RT_COUNT; ++i) {
+        rtCreateInfo.format = GBUFFER_RT_FORMATS[i];
+        rtCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 
-    vkn::Texture& gbuffRT0 = s_gbufferRTs[0];
-    vkn::TextureView& gbuffRT0View = s_gbufferRTViews[0];
+        s_transientRTAllocator.AddTexture(s_gbufferRTs[i], rtCreateInfo);
+    }
 
     rtCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
     rtCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 
-    gbuffRT0.Create(rtCreateInfo);
-    s_vkDevice.SetObjDebugName(gbuffRT0, "COMMON_GBUFFER_0");
-
-    gbuffRT0View.Create(gbuffRT0, mapping, subresourceRange);
-    s_vkDevice.SetObjDebugName(gbuffRT0View, "COMMON_GBUFFER_0_VIEW");
+    s_transientRTAllocator.AddTexture(s_colorRT8U, rtCreateInfo);
 
+    rtCreateInfo.format = VK_FORMAT_R16G16B16A16_SFLOAT;
+    rtCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 
-    vkn::Texture& gbuffRT1 = s_gbufferRTs[1];
-    vkn::TextureView& gbuffRT1View = s_gbufferRTViews[1];
+    s_transientRTAllocator.AddTexture(s_colorRT16F, rtCreateInfo);
 
-    rtCreateInfo.format = VK_FORMAT_R16G16B16A16_SNORM;
-    rtCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    rtCreateInfo.format = VK_FORMAT_D32_SFLOAT;
+    rtCreateInfo.usage = 
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | 
+        VK_IMAGE_USAGE_SAMPLED_BIT | 
+        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | 
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
-    gbuffRT1.Create(rtCreateInfo);
-    s_vkDevice.SetObjDebugName(gbuffRT1, "COMMON_GBUFFER_1");
+    s_transientRTAllocator.AddTexture(s_depthRT, rtCreateInfo);
 
-    gbuffRT1View.Create(gbuffRT1, mapping, subresourceRange);
-    s_vkDevice.SetObjDebugName(gbuffRT1View, "COMMON_GBUFFER_1_VIEW");
+    // Content of transient RTs is discarded by render graph on their first access in the frame, so they aren't initialized here
+    s_transientRTAllocator.Allocate();
 
 
-    vkn::Texture& gbuffRT2 = s_gbufferRTs[2];
-    vkn::TextureView& gbuffRT2View = s_gbufferRTViews[2];
+    VkComponentMapping mapping = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
+    
+    VkImageSubresourceRange subresourceRange = {};
+    subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    subresourceRange.baseMipLevel = 0;
+    subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+    subresourceRange.baseArrayLayer = 0;
+    subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
 
-    rtCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
-    rtCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    for (size_t i = 0; i < GBUFFER_RT_COUNT; ++i) {
+        s_vkDevice.SetObjDebugName(s_gbufferRTs[i], "COMMON_GBUFFER_%zu", i);
 
-    gbuffRT2.Create(rtCreateInfo);
-    s_vkDevice.SetObjDebugName(gbuffRT2, "COMMON_GBUFFER_2");
+        s_gbufferRTViews[i].Create(s_gbufferRTs[i], mapping, subresourceRange);
+        s_vkDevice.SetObjDebugName(s_gbufferRTViews[i], "COMMON_GBUFFER_%zu_VIEW", i);
+    }
 
-    gbuffRT2View.Create(gbuffRT2, mapping, subresourceRange);
-    s_vkDevice.SetObjDebugName(gbuffRT2View, "COMMON_GBUFFER_2_VIEW");
-
-
-    vkn::Texture& gbuffRT3 = s_gbufferRTs[3];
-    vkn::TextureView& gbuffRT3View = s_gbufferRTViews[3];
-
-    rtCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
-    rtCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-
-    gbuffRT3.Create(rtCreateInfo);
-    s_vkDevice.SetObjDebugName(gbuffRT3, "COMMON_GBUFFER_3");
-
-    gbuffRT3View.Create(gbuffRT3, mapping, subresourceRange);
-    s_vkDevice.SetObjDebugName(gbuffRT3View, "COMMON_GBUFFER_3_VIEW");
-}
-
-
-static void CreateColorRTs()
-{
-    vkn::AllocationInfo rtAllocInfo = {};
-    rtAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
-    rtAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-
-    vkn::TextureCreateInfo rtCreateInfo = {};
-    rtCreateInfo.pDevice = &s_vkDevice;
-    rtCreateInfo.type = VK_IMAGE_TYPE_2D;
-    rtCreateInfo.extent = VkExtent3D{s_pWnd->GetWidth(), s_pWnd->GetHeight(), 1};
-    rtCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    rtCreateInfo.flags = 0;
-    rtCreateInfo.mipLevels = 1;
-    rtCreateInfo.arrayLayers = 1;
-    rtCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-    rtCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    rtCreateInfo.pAllocInfo = &rtAllocInfo;
-
-    VkComponentMapping mapping = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
-    
-    VkImageSubresourceRange subresourceRange = {};
-    subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    subresourceRange.baseMipLevel = 0;
-    subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
-    subresourceRange.baseArrayLayer = 0;
-    subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
-
-    rtCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
-    rtCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-
-    s_colorRT8U.Create(rtCreateInfo);
-    s_vkDevice.SetObjDebugName(s_colorRT8U, "COMMON_COLOR_RT_U8");
+    s_vkDevice.SetObjDebugName(s_colorRT8U, "COMMON_COLOR_RT_U8");
 
     s_colorRTView8U.Create(s_colorRT8U, mapping, subresourceRange);
     s_vkDevice.SetObjDebugName(s_colorRTView8U, "COMMON_COLOR_RT_VIEW_U8");
 
-
-    rtCreateInfo.format = VK_FORMAT_R16G16B16A16_SFLOAT;
-    rtCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-
-    s_colorRT16F.Create(rtCreateInfo);
     s_vkDevice.SetObjDebugName(s_colorRT16F, "COMMON_COLOR_RT_16F");
 
     s_colorRTView16F.Create(s_colorRT16F, mapping, subresourceRange);
     s_vkDevice.SetObjDebugName(s_colorRTView16F, "COMMON_COLOR_RT_VIEW_16F");
 
-
-    ImmediateSubmitQueue(s_vkDevice.GetQueue(), [&](vkn::CmdBuffer& cmdBuffer){
-        cmdBuffer.BeginBarrierList()
-            .AddTextureBarrier(s_colorRT16F, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_IMAGE_ASPECT_COLOR_BIT)
-        .Push();
-    });
-}
-
-
-static void CreateDepthRT()
-{
-    vkn::AllocationInfo rtAllocInfo = {};
-    rtAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
-    rtAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-
-    vkn::TextureCreateInfo rtCreateInfo = {};
-    rtCreateInfo.pDevice = &s_vkDevice;
-    rtCreateInfo.type = VK_IMAGE_TYPE_2D;
-    rtCreateInfo.extent = VkExtent3D{s_pWnd->GetWidth(), s_pWnd->GetHeight(), 1};
-    rtCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    rtCreateInfo.flags = 0;
-    rtCreateInfo.mipLevels = 1;
-    rtCreateInfo.arrayLayers = 1;
-    rtCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-    rtCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    rtCreateInfo.pAllocInfo = &rtAllocInfo;
-
-    VkComponentMapping mapping = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
-    
-    VkImageSubresourceRange subresourceRange = {};
     subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-    subresourceRange.baseMipLevel = 0;
-    subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
-    subresourceRange.baseArrayLayer = 0;
-    subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
-
-    rtCreateInfo.format = VK_FORMAT_D32_SFLOAT;
-    rtCreateInfo.usage = 
-        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | 
-        VK_IMAGE_USAGE_SAMPLED_BIT | 
-        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | 
-        VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
-    s_depthRT.Create(rtCreateInfo);
     s_vkDevice.SetObjDebugName(s_depthRT, "COMMON_DEPTH_RT");
     
     s_depthRTView.Create(s_depthRT, mapping, subresourceRange);
@@ -2350,36 +2813,35 @@ static void CreateDepthRT()
 
     s_depthRTColorView.Create(depthColorViewCreateInfo);
     s_vkDevice.SetObjDebugName(s_depthRTColorView, "COMMON_DEPTH_RT_COLOR_VIEW");
+}
 
-    ImmediateSubmitQueue(s_vkDevice.GetQueue(), [&](vkn::CmdBuffer& cmdBuffer) {
-        cmdBuffer
-            .BeginBarrierList()
-                .AddTextureBarrier(s_depthRT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, 
-                    VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_ASPECT_DEPTH_BIT)
-            .Push();
 
-        vkn::TextureClearInfo clear = {};
+static void DestroyTransientRTs()
+{
+    for (size_t i = 0; i < GBUFFER_RT_COUNT; ++i) {
+        s_gbufferRTViews[i].Destroy();
+        s_gbufferRTs[i].Destroy();
+    }
 
-    #ifdef ENG_REVERSED_Z
-        clear.depth = 0.f;
-    #else
-        clear.depth = 1.f;
-    #endif
+    s_depthRTColorView.Destroy();
+    s_depthRTView.Destroy();
+    s_depthRT.Destroy();
 
-        vkn::TextureClearRange range = {};
-        range.baseMipLevel = 0;
-        range.levelCount = 1;
-        range.baseArrayLayer = 0;
-        range.layerCount = 1;
+    s_colorRTView16F.Destroy();
+    s_colorRT16F.Destroy();
 
-        cmdBuffer.CmdClearTexture(s_depthRT, clear, range);
-    });
+    s_colorRTView8U.Destroy();
+    s_colorRT8U.Destroy();
+
+    s_transientRTAllocator.Destroy();
 }
 
 
 static void CreateHZB()
 {
-    const VkExtent3D extent = {s_pWnd->GetWidth(), s_pWnd->GetHeight(), 1};
+    // Single pass HZB generation reduces whole tiles, so mip 0 is padded to tile size multiple. Padding is filled with border depth
+    const glm::uvec2 tileCount = (glm::uvec2(s_pWnd->GetWidth(), s_pWnd->GetHeight()) + HZB_SPD_TILE_SIZE - 1u) / HZB_SPD_TILE_SIZE;
+    const VkExtent3D extent = { tileCount.x * HZB_SPD_TILE_SIZE, tileCount.y * HZB_SPD_TILE_SIZE, 1 };
 
     const uint32_t mipsCount = glm::floor(glm::log2((float)glm::max(extent.width, extent.height))) + 1;
     CORE_ASSERT(mipsCount <= HZB_MAX_MIP_COUNT);
@@ -2400,11 +2862,7 @@ static void CreateHZB()
     rtCreateInfo.pAllocInfo = &rtAllocInfo;
 
     rtCreateInfo.format = VK_FORMAT_R32_SFLOAT;
-    rtCreateInfo.usage = 
-        VK_IMAGE_USAGE_SAMPLED_BIT | 
-        VK_IMAGE_USAGE_STORAGE_BIT |
-        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | 
-        VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    rtCreateInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
     rtCreateInfo.mipLevels = mipsCount;
 
     s_HZB.Create(rtCreateInfo);
@@ -2432,40 +2890,75 @@ static void CreateHZB()
         s_HZBMipViews[mip].Create(s_HZB, mapping, subresourceRange);
         s_vkDevice.SetObjDebugName(s_HZBMipViews[mip], "HZB_MIP_%u", mip);
     }
+
+    s_hzbSpdCounterBuffer.Create(
+        &s_vkDevice,
+        sizeof(glm::uint),
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT,
+        rtAllocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_hzbSpdCounterBuffer, "HZB_SPD_COUNTER_BUFFER");
+
+    s_hzbSpdCounterResetRequired = true;
+}
+
+
+static void CreateDeferredLightingTileBuffers()
+{
+    vkn::AllocationInfo allocInfo = {};
+    allocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    const glm::uvec2 tileCount = glm::uvec2(
+        ceil(s_pWnd->GetWidth() / (float)DEFERRED_LIGHTING_TILE_SIZE), 
+        ceil(s_pWnd->GetHeight() / (float)DEFERRED_LIGHTING_TILE_SIZE)
+    );
+
+    s_deferredLightingTileListBuffer.Create(
+        &s_vkDevice, 
+        DEFERRED_LIGHTING_TILE_CLASS_COUNT * tileCount.x * tileCount.y * sizeof(glm::uint), 
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_deferredLightingTileListBuffer, "DEFERRED_LIGHTING_TILE_LIST_BUFFER");
+
+    s_deferredLightingDispatchArgsBuffer.Create(
+        &s_vkDevice, 
+        DEFERRED_LIGHTING_TILE_CLASS_COUNT * sizeof(GPU_CmdDispatchIndirect), 
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, 
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_deferredLightingDispatchArgsBuffer, "DEFERRED_LIGHTING_DISPATCH_ARGS_BUFFER");
+
+    // Group counts Y and Z are always 1. Only X ones are cleared every frame
+    ImmediateSubmitQueue(s_vkDevice.GetQueue(), [&](vkn::CmdBuffer& cmdBuffer){
+        cmdBuffer.CmdFillBuffer(s_deferredLightingDispatchArgsBuffer, 1);
+    });
 }
 
 
 static void CreateDynamicRenderTargets()
 {
-    CreateGBufferRTs();
-    CreateColorRTs();
-    CreateDepthRT();
+    CreateTransientRTs();
     CreateHZB();
+    CreateDeferredLightingTileBuffers();
 }
 
 
 static void DestroyDynamicRenderTargets()
 {
-    for (size_t i = 0; i < GBUFFER_RT_COUNT; ++i) {
-        s_gbufferRTViews[i].Destroy();
-        s_gbufferRTs[i].Destroy();
-    }
-
-    s_depthRTColorView.Destroy();
-    s_depthRTView.Destroy();
-    s_depthRT.Destroy();
-
-    s_colorRTView16F.Destroy();
-    s_colorRT16F.Destroy();
-
-    s_colorRTView8U.Destroy();
-    s_colorRT8U.Destroy();
+    DestroyTransientRTs();
 
     for (vkn::TextureView& mip : s_HZBMipViews) {
         mip.Destroy();
     }
     s_HZBView.Destroy();
     s_HZB.Destroy();
+
+    s_hzbSpdCounterBuffer.Destroy();
+
+    s_deferredLightingTileListBuffer.Destroy();
+    s_deferredLightingDispatchArgsBuffer.Destroy();
 }
 
 
@@ -2585,45 +3078,30 @@ static void CreateSkybox(std::span<fs::path> faceDataPaths)
     s_skyboxTextureView.Create(viewCreateInfo);
     s_vkDevice.SetObjDebugName(s_skyboxTextureView, "COMMON_SKY_BOX_VIEW");
 
-    for (size_t i = 0; i < CUBEMAP_FACE_COUNT; ++i) {
-        const TextureLoadData& loadData = faceLoadDatas[i];
-
-        void* pData = s_commonStagingBuffer.Map();
-        memcpy(pData, loadData.GetData(), loadData.GetMemorySize());
-        s_commonStagingBuffer.Unmap();
-
-        ImmediateSubmitQueue(s_vkDevice.GetQueue(), [&](vkn::CmdBuffer& cmdBuffer) {
-            cmdBuffer
-                .BeginBarrierList()
-                    .AddTextureBarrier(s_skyboxTexture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, 
-                        VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 0, 1)
-                .Push();
+    s_uploadManager.GetCmdBuffer()
+        .BeginBarrierList()
+            .AddTextureBarrier(s_skyboxTexture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, 
+                VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 0, 1)
+        .Push();
 
-            const uint32_t faceIdx = i;
+    for (uint32_t faceIdx = 0; faceIdx < CUBEMAP_FACE_COUNT; ++faceIdx) {
+        const TextureLoadData& loadData = faceLoadDatas[faceIdx];
+        s_uploadManager.UploadTexture(s_skyboxTexture, loadData.GetData(), loadData.GetMemorySize(), 0, faceIdx);
+    }
 
-            vkn::BufferToTextureCopyInfo copyInfo = {};
-            copyInfo.texSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            copyInfo.texSubresource.mipLevel = 0;
-            copyInfo.texSubresource.baseArrayLayer = faceIdx;
-            copyInfo.texSubresource.layerCount = 1;
-            copyInfo.texExtent = s_skyboxTexture.GetSize();
+    // Blits aren't supported by transfer queue
+    vkn::CmdBuffer& cmdBuffer = s_uploadManager.GetOwnerCmdBuffer();
 
-            cmdBuffer.CmdCopyBuffer(s_commonStagingBuffer, s_skyboxTexture, copyInfo);
-        });
+    for (uint32_t layerIdx = 0; layerIdx < s_skyboxTexture.GetLayerCount(); ++layerIdx) {
+        GenerateTextureMipmaps(cmdBuffer, s_skyboxTexture, faceLoadDatas[layerIdx], layerIdx);
     }
 
-    ImmediateSubmitQueue(s_vkDevice.GetQueue(), [&](vkn::CmdBuffer& cmdBuffer) {
-        for (uint32_t layerIdx = 0; layerIdx < s_skyboxTexture.GetLayerCount(); ++layerIdx) {
-            GenerateTextureMipmaps(cmdBuffer, s_skyboxTexture, faceLoadDatas[layerIdx], layerIdx);
-        }
-
-        cmdBuffer
-            .BeginBarrierList()
-                .AddTextureBarrier(s_skyboxTexture, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 
-                    VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
-                    VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
-            .Push();
-    });
+    cmdBuffer
+        .BeginBarrierList()
+            .AddTextureBarrier(s_skyboxTexture, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
+                VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+        .Push();
 
     CORE_LOG_INFO("Skybox loading finished: %f ms", timer.End().GetDuration<float, std::milli>());
 }
@@ -2638,11 +3116,11 @@ static void CreateSyncObjects()
         s_renderFinishedSemaphores[i].Create(&s_vkDevice);
         s_vkDevice.SetObjDebugName(s_renderFinishedSemaphores[i], "RND_FINISH_SEMAPHORE_%zu", i);
     }
-    s_presentFinishedSemaphore.Create(&s_vkDevice);
-    s_vkDevice.SetObjDebugName(s_presentFinishedSemaphore, "PRESENT_FINISH_SEMAPHORE");
 
-    s_renderFinishedFence.Create(&s_vkDevice);
-    s_vkDevice.SetObjDebugName(s_renderFinishedFence, "RND_FINISH_FENCE");
+    for (uint32_t i = 0; i < FRAMES_IN_FLIGHT_COUNT; ++i) {
+        s_presentFinishedSemaphores[i].Create(&s_vkDevice);
+        s_vkDevice.SetObjDebugName(s_presentFinishedSemaphores[i], "PRESENT_FINISH_SEMAPHORE_%u", i);
+    }
 }
 
 
@@ -2823,8 +3301,10 @@ static void CreateDbgDrawResources()
         allocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
         allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
     
-        s_dbgLineDataGPU.Create(&s_vkDevice, MAX_DBG_LINE_COUNT * sizeof(GPU_DbgLineData), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
-        s_vkDevice.SetObjDebugName(s_dbgLineDataGPU, "DBG_DRAW_LINE_DATA_BUFFER");
+        for (uint32_t i = 0; i < FRAMES_IN_FLIGHT_COUNT; ++i) {
+            s_dbgLineDataGPU[i].Create(&s_vkDevice, MAX_DBG_LINE_COUNT * sizeof(GPU_DbgLineData), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
+            s_vkDevice.SetObjDebugName(s_dbgLineDataGPU[i], "DBG_DRAW_LINE_DATA_BUFFER_%u", i);
+        }
     }
 
     {
@@ -2834,8 +3314,10 @@ static void CreateDbgDrawResources()
         allocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
         allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
     
-        s_dbgLineVertexDataGPU.Create(&s_vkDevice, DBG_LINE_VERTEX_BUFFER_SIZE, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
-        s_vkDevice.SetObjDebugName(s_dbgLineVertexDataGPU, "DBG_DRAW_LINE_VERT_BUFFER");
+        for (uint32_t i = 0; i < FRAMES_IN_FLIGHT_COUNT; ++i) {
+            s_dbgLineVertexDataGPU[i].Create(&s_vkDevice, DBG_LINE_VERTEX_BUFFER_SIZE, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
+            s_vkDevice.SetObjDebugName(s_dbgLineVertexDataGPU[i], "DBG_DRAW_LINE_VERT_BUFFER_%u", i);
+        }
     }
 
     {
@@ -2845,8 +3327,10 @@ static void CreateDbgDrawResources()
         allocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
         allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
     
-        s_dbgTriangleDataGPU.Create(&s_vkDevice, MAX_DBG_TRIANGLE_COUNT * sizeof(GPU_DbgTriangleData), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
-        s_vkDevice.SetObjDebugName(s_dbgTriangleDataGPU, "DBG_DRAW_TRIANGLE_DATA_BUFFER");
+        for (uint32_t i = 0; i < FRAMES_IN_FLIGHT_COUNT; ++i) {
+            s_dbgTriangleDataGPU[i].Create(&s_vkDevice, MAX_DBG_TRIANGLE_COUNT * sizeof(GPU_DbgTriangleData), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
+            s_vkDevice.SetObjDebugName(s_dbgTriangleDataGPU[i], "DBG_DRAW_TRIANGLE_DATA_BUFFER_%u", i);
+        }
     }
 
     {
@@ -2856,8 +3340,10 @@ static void CreateDbgDrawResources()
         allocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
         allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
     
-        s_dbgTriangleVertexDataGPU.Create(&s_vkDevice, DBG_TRIANGLE_VERTEX_BUFFER_SIZE, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
-        s_vkDevice.SetObjDebugName(s_dbgTriangleVertexDataGPU, "DBG_DRAW_TRIANGLE_VERT_BUFFER");
+        for (uint32_t i = 0; i < FRAMES_IN_FLIGHT_COUNT; ++i) {
+            s_dbgTriangleVertexDataGPU[i].Create(&s_vkDevice, DBG_TRIANGLE_VERTEX_BUFFER_SIZE, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
+            s_vkDevice.SetObjDebugName(s_dbgTriangleVertexDataGPU[i], "DBG_DRAW_TRIANGLE_VERT_BUFFER_%u", i);
+        }
     }
 #endif
 }
@@ -2907,6 +3393,30 @@ static void CreateCommonDescriptorSetLayout()
 }
 
 
+static void CreateRadixSortDescriptorSetLayout()
+{
+    vkn::DescriptorSetLayoutCreateInfo createInfo = {};
+
+    createInfo.pDevice = &s_vkDevice;
+    createInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
+    std::array descriptors = {
+        vkn::DescriptorInfo::Create(RADIX_SORT_SRC_KEYS_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(RADIX_SORT_SRC_PAYLOADS_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(RADIX_SORT_DST_KEYS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(RADIX_SORT_DST_PAYLOADS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(RADIX_SORT_ELEM_COUNT_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(RADIX_SORT_HISTOGRAMS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(RADIX_SORT_DISPATCH_ARGS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+    };
+
+    createInfo.descriptorInfos = descriptors;
+
+    s_descSetLayouts[PASS_ID_RADIX_SORT].Create(createInfo);
+    s_vkDevice.SetObjDebugName(s_descSetLayouts[PASS_ID_RADIX_SORT], "RADIX_SORT_DESCRIPTOR_SET_LAYOUT");
+}
+
+
 static void CreateGeomCullingDescriptorSetLayout()
 {
     vkn::DescriptorSetLayoutCreateInfo createInfo = {};
@@ -2916,12 +3426,11 @@ static void CreateGeomCullingDescriptorSetLayout()
     // createInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
 
     std::array descriptors = {
-        vkn::DescriptorInfo::Create(GEOM_CULL_VIS_INST_ID_QUEUES_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, GEOM_QUEUE_COUNT, VK_SHADER_STAGE_COMPUTE_BIT),
-        vkn::DescriptorInfo::Create(GEOM_CULL_VIS_INST_ID_QUEUE_SIZES_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, GEOM_QUEUE_COUNT, VK_SHADER_STAGE_COMPUTE_BIT),
         vkn::DescriptorInfo::Create(GEOM_CULL_VIS_SORT_KEYS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
         vkn::DescriptorInfo::Create(GEOM_CULL_VIS_SORT_KEYS_COUNTER_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
         vkn::DescriptorInfo::Create(GEOM_CULL_VIS_GEOM_IDS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
         vkn::DescriptorInfo::Create(GEOM_CULL_PER_GEOM_MAT_TYPE_COUNTERS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(GEOM_CULL_INST_VISIBILITY_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
     };
 
     createInfo.descriptorInfos = descriptors;
@@ -2946,6 +3455,11 @@ static void CreateGeomBatchingDescriptorSetLayout()
         vkn::DescriptorInfo::Create(GEOM_BATCH_BATCH_QUEUE_SIZE_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
         vkn::DescriptorInfo::Create(GEOM_BATCH_SORTED_VIS_INST_ID_QUEUE_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, GEOM_QUEUE_COUNT, VK_SHADER_STAGE_COMPUTE_BIT),
         vkn::DescriptorInfo::Create(GEOM_BATCH_SORTED_VIS_INST_ID_QUEUE_SIZE_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(GEOM_BATCH_BIN_COUNTERS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(GEOM_BATCH_BIN_OFFSETS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(GEOM_BATCH_INST_BINS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(GEOM_BATCH_SORTED_KEYS_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(GEOM_BATCH_PER_GEOM_MAT_TYPE_COUNTERS_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
     };
 
     createInfo.descriptorInfos = descriptors;
@@ -3004,8 +3518,9 @@ static void CreateHZBGenDescriptorSetLayout()
     // createInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
 
     std::array descriptors = {
-        vkn::DescriptorInfo::Create(HZB_SRC_MIPS_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, HZB_MAX_MIP_COUNT, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(HZB_DEPTH_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
         vkn::DescriptorInfo::Create(HZB_DST_MIPS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, HZB_MAX_MIP_COUNT, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(HZB_SPD_COUNTER_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
     };
 
     createInfo.descriptorInfos = descriptors;
@@ -3026,6 +3541,7 @@ static void CreateCSMGeomCullingDescriptorSetLayout()
     std::array descriptors = {
         vkn::DescriptorInfo::Create(CSM_VIS_INST_ID_QUEUES_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, CSM_BUFFER_COUNT, VK_SHADER_STAGE_COMPUTE_BIT),
         vkn::DescriptorInfo::Create(CSM_VIS_INST_ID_QUEUE_SIZES_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, CSM_BUFFER_COUNT, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(CSM_VSM_DIRTY_PAGE_RECTS_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
     };
 
     createInfo.descriptorInfos = descriptors;
@@ -3054,6 +3570,53 @@ static void CreateCSMRenderDescriptorSetLayout()
 }
 
 
+static void CreateVSMPagesDescriptorSetLayout()
+{
+    vkn::DescriptorSetLayoutCreateInfo createInfo = {};
+
+    createInfo.pDevice = &s_vkDevice;
+    createInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+    // createInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+
+    std::array descriptors = {
+        vkn::DescriptorInfo::Create(VSM_PAGES_PAGE_TABLE_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(VSM_PAGES_PHYS_PAGE_LAST_USED_FRAME_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(VSM_PAGES_FREE_LIST_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(VSM_PAGES_FREE_LIST_COUNTER_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(VSM_PAGES_DIRTY_LIST_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(VSM_PAGES_CLEAR_DISPATCH_ARGS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(VSM_PAGES_DIRTY_PAGE_RECTS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(VSM_PAGES_PHYS_POOL_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+    };
+
+    createInfo.descriptorInfos = descriptors;
+
+    s_descSetLayouts[PASS_ID_VSM_PAGES].Create(createInfo);
+    s_vkDevice.SetObjDebugName(s_descSetLayouts[PASS_ID_VSM_PAGES], "VSM_PAGES_DESCRIPTOR_SET_LAYOUT");
+}
+
+
+static void CreateVSMRenderDescriptorSetLayout()
+{
+    vkn::DescriptorSetLayoutCreateInfo createInfo = {};
+
+    createInfo.pDevice = &s_vkDevice;
+    createInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+    // createInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+
+    std::array descriptors = {
+        vkn::DescriptorInfo::Create(CSM_INST_ID_QUEUE_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, CSM_BUFFER_COUNT, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT),
+        vkn::DescriptorInfo::Create(VSM_PAGE_TABLE_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT),
+        vkn::DescriptorInfo::Create(VSM_PHYS_POOL_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_FRAGMENT_BIT),
+    };
+
+    createInfo.descriptorInfos = descriptors;
+
+    s_descSetLayouts[PASS_ID_VSM_RENDER].Create(createInfo);
+    s_vkDevice.SetObjDebugName(s_descSetLayouts[PASS_ID_VSM_RENDER], "VSM_RENDER_SET_LAYOUT");
+}
+
+
 static void CreateGBufferDescriptorSetLayout()
 {
     vkn::DescriptorSetLayoutCreateInfo createInfo = {};
@@ -3073,6 +3636,50 @@ static void CreateGBufferDescriptorSetLayout()
 }
 
 
+static void CreateLightCullingDescriptorSetLayout()
+{
+    vkn::DescriptorSetLayoutCreateInfo createInfo = {};
+
+    createInfo.pDevice = &s_vkDevice;
+    createInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+    // createInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+
+    std::array descriptors = {
+        vkn::DescriptorInfo::Create(LIGHT_CULLING_LIGHTS_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(LIGHT_CULLING_CLUSTER_LIGHT_COUNTS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(LIGHT_CULLING_CLUSTER_LIGHT_INDICES_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+    };
+
+    createInfo.descriptorInfos = descriptors;
+
+    s_descSetLayouts[PASS_ID_LIGHT_CULLING].Create(createInfo);
+    s_vkDevice.SetObjDebugName(s_descSetLayouts[PASS_ID_LIGHT_CULLING], "LIGHT_CULLING_DESCRIPTOR_SET_LAYOUT");
+}
+
+
+static void CreateDeferredLightingClassifyDescriptorSetLayout()
+{
+    vkn::DescriptorSetLayoutCreateInfo createInfo = {};
+
+    createInfo.pDevice = &s_vkDevice;
+    createInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+    // createInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+
+    std::array descriptors = {
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_CLASSIFY_DEPTH_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_CLASSIFY_GBUFFER_NORMAL_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_CLASSIFY_TILE_LIST_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_CLASSIFY_DISPATCH_ARGS_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_CLASSIFY_CSM_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+    };
+
+    createInfo.descriptorInfos = descriptors;
+
+    s_descSetLayouts[PASS_ID_DEFERRED_LIGHTING_CLASSIFY].Create(createInfo);
+    s_vkDevice.SetObjDebugName(s_descSetLayouts[PASS_ID_DEFERRED_LIGHTING_CLASSIFY], "DEFERRED_LIGHTING_CLASSIFY_DESCRIPTOR_SET_LAYOUT");
+}
+
+
 static void CreateDeferredLightingDescriptorSetLayout()
 {
     vkn::DescriptorSetLayoutCreateInfo createInfo = {};
@@ -3082,15 +3689,22 @@ static void CreateDeferredLightingDescriptorSetLayout()
     // createInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
 
     std::array descriptors = {
-        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_GBUFFER_0_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_FRAGMENT_BIT),
-        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_GBUFFER_1_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_FRAGMENT_BIT),
-        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_GBUFFER_2_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_FRAGMENT_BIT),
-        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_GBUFFER_3_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_FRAGMENT_BIT),
-        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_DEPTH_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_FRAGMENT_BIT),
-        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_IRRADIANCE_MAP_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_FRAGMENT_BIT),
-        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_PREFILTERED_ENV_MAP_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_FRAGMENT_BIT),
-        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_BRDF_LUT_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_FRAGMENT_BIT),
-        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_CSM_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_FRAGMENT_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_GBUFFER_0_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_GBUFFER_1_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_GBUFFER_2_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_GBUFFER_3_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_DEPTH_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_IRRADIANCE_MAP_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_PREFILTERED_ENV_MAP_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_BRDF_LUT_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_CSM_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_VSM_PAGE_TABLE_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_VSM_PHYS_POOL_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_PUNCTUAL_LIGHTS_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_CLUSTER_LIGHT_COUNTS_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_CLUSTER_LIGHT_INDICES_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_OUTPUT_UAV_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        vkn::DescriptorInfo::Create(DEFERRED_LIGHTING_TILE_LIST_DESCRIPTOR_SLOT, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
     };
 
     createInfo.descriptorInfos = descriptors;
@@ -3301,6 +3915,9 @@ static void CreateDescriptorBuffer()
     layouts[DESC_SET_ID_COMMON] = &s_descSetLayouts[PASS_ID_COMMON];
 
     layouts[DESC_SET_ID_GEOM_CULLING] = &s_descSetLayouts[PASS_ID_GEOM_CULLING];
+
+    layouts[DESC_SET_ID_GEOM_RADIX_SORT_EVEN_PASS] = &s_descSetLayouts[PASS_ID_RADIX_SORT];
+    layouts[DESC_SET_ID_GEOM_RADIX_SORT_ODD_PASS]  = &s_descSetLayouts[PASS_ID_RADIX_SORT];
     
     layouts[DESC_SET_ID_GEOM_BATCHING_OPAQUE] = &s_descSetLayouts[PASS_ID_GEOM_BATCHING];
     layouts[DESC_SET_ID_GEOM_BATCHING_AKILL]  = &s_descSetLayouts[PASS_ID_GEOM_BATCHING];
@@ -3314,23 +3931,24 @@ static void CreateDescriptorBuffer()
     layouts[DESC_SET_ID_HZB_GEN] = &s_descSetLayouts[PASS_ID_HZB_GEN];
 
     layouts[DESC_SET_ID_CSM_GEOM_CULLING] = &s_descSetLayouts[PASS_ID_CSM_GEOM_CULLING],
-    layouts[DESC_SET_ID_CSM_GEOM_BATCHING_OPAQUE_CASCADE_0] = &s_descSetLayouts[PASS_ID_GEOM_BATCHING],
-    layouts[DESC_SET_ID_CSM_GEOM_BATCHING_OPAQUE_CASCADE_1] = &s_descSetLayouts[PASS_ID_GEOM_BATCHING],
-    layouts[DESC_SET_ID_CSM_GEOM_BATCHING_OPAQUE_CASCADE_2] = &s_descSetLayouts[PASS_ID_GEOM_BATCHING],
-    layouts[DESC_SET_ID_CSM_GEOM_BATCHING_AKILL_CASCADE_0]  = &s_descSetLayouts[PASS_ID_GEOM_BATCHING],
-    layouts[DESC_SET_ID_CSM_GEOM_BATCHING_AKILL_CASCADE_1]  = &s_descSetLayouts[PASS_ID_GEOM_BATCHING],
-    layouts[DESC_SET_ID_CSM_GEOM_BATCHING_AKILL_CASCADE_2]  = &s_descSetLayouts[PASS_ID_GEOM_BATCHING],
-    layouts[DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_OPAQUE_CASCADE_0] = &s_descSetLayouts[PASS_ID_GEOM_DRAW_CMD_GEN],
-    layouts[DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_OPAQUE_CASCADE_1] = &s_descSetLayouts[PASS_ID_GEOM_DRAW_CMD_GEN],
-    layouts[DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_OPAQUE_CASCADE_2] = &s_descSetLayouts[PASS_ID_GEOM_DRAW_CMD_GEN],
-    layouts[DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_AKILL_CASCADE_0]  = &s_descSetLayouts[PASS_ID_GEOM_DRAW_CMD_GEN],
-    layouts[DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_AKILL_CASCADE_1]  = &s_descSetLayouts[PASS_ID_GEOM_DRAW_CMD_GEN],
-    layouts[DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_AKILL_CASCADE_2]  = &s_descSetLayouts[PASS_ID_GEOM_DRAW_CMD_GEN],
+    layouts[DESC_SET_ID_CSM_GEOM_BATCHING_STATIC_OPAQUE]  = &s_descSetLayouts[PASS_ID_GEOM_BATCHING],
+    layouts[DESC_SET_ID_CSM_GEOM_BATCHING_STATIC_AKILL]   = &s_descSetLayouts[PASS_ID_GEOM_BATCHING],
+    layouts[DESC_SET_ID_CSM_GEOM_BATCHING_DYNAMIC_OPAQUE] = &s_descSetLayouts[PASS_ID_GEOM_BATCHING],
+    layouts[DESC_SET_ID_CSM_GEOM_BATCHING_DYNAMIC_AKILL]  = &s_descSetLayouts[PASS_ID_GEOM_BATCHING],
+    layouts[DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_STATIC_OPAQUE]  = &s_descSetLayouts[PASS_ID_GEOM_DRAW_CMD_GEN],
+    layouts[DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_STATIC_AKILL]   = &s_descSetLayouts[PASS_ID_GEOM_DRAW_CMD_GEN],
+    layouts[DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_DYNAMIC_OPAQUE] = &s_descSetLayouts[PASS_ID_GEOM_DRAW_CMD_GEN],
+    layouts[DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_DYNAMIC_AKILL]  = &s_descSetLayouts[PASS_ID_GEOM_DRAW_CMD_GEN],
     layouts[DESC_SET_ID_CSM_RENDER] = &s_descSetLayouts[PASS_ID_CSM_RENDER],
 
+    layouts[DESC_SET_ID_VSM_PAGES] = &s_descSetLayouts[PASS_ID_VSM_PAGES];
+    layouts[DESC_SET_ID_VSM_RENDER] = &s_descSetLayouts[PASS_ID_VSM_RENDER];
+
     layouts[DESC_SET_ID_GBUFFER_OPAQUE] = &s_descSetLayouts[PASS_ID_GBUFFER];
     layouts[DESC_SET_ID_GBUFFER_AKILL]  = &s_descSetLayouts[PASS_ID_GBUFFER];
     
+    layouts[DESC_SET_ID_LIGHT_CULLING] = &s_descSetLayouts[PASS_ID_LIGHT_CULLING];
+    layouts[DESC_SET_ID_DEFERRED_LIGHTING_CLASSIFY] = &s_descSetLayouts[PASS_ID_DEFERRED_LIGHTING_CLASSIFY];
     layouts[DESC_SET_ID_DEFERRED_LIGHTING] = &s_descSetLayouts[PASS_ID_DEFERRED_LIGHTING];
     
     layouts[DESC_SET_ID_SKYBOX] = &s_descSetLayouts[PASS_ID_SKYBOX];
@@ -3353,7 +3971,9 @@ static void CreateDescriptorBuffer()
         CORE_ASSERT_MSG(layouts[i] && layouts[i]->IsCreated(), "Descriptor Set Layout %s is not created", DESC_SET_DBG_NAME[i]);
     }
 
-    s_descriptorBuffer.Create(&s_vkDevice, layouts).SetDebugName("COMMON_DESCRIPTOR_BUFFER");
+    for (uint32_t i = 0; i < FRAMES_IN_FLIGHT_COUNT; ++i) {
+        s_descriptorBuffers[i].Create(&s_vkDevice, layouts).SetDebugName("COMMON_DESCRIPTOR_BUFFER_%u", i);
+    }
 }
 
 
@@ -3361,6 +3981,8 @@ static void CreateDescriptorSets()
 {
     CreateCommonDescriptorSetLayout();
 
+    CreateRadixSortDescriptorSetLayout();
+
     CreateGeomCullingDescriptorSetLayout();
     CreateGeomBatchingDescriptorSetLayout();
     CreateGeomDrawCmdGenDescriptorSetLayout();
@@ -3372,8 +3994,13 @@ static void CreateDescriptorSets()
     CreateCSMGeomCullingDescriptorSetLayout();
     CreateCSMRenderDescriptorSetLayout();
 
+    CreateVSMPagesDescriptorSetLayout();
+    CreateVSMRenderDescriptorSetLayout();
+
     CreateGBufferDescriptorSetLayout();
     
+    CreateLightCullingDescriptorSetLayout();
+    CreateDeferredLightingClassifyDescriptorSetLayout();
     CreateDeferredLightingDescriptorSetLayout();
     
     CreatePostProcessingDescriptorSetLayout();
@@ -3410,6 +4037,21 @@ static void CreateGeomCullingPipelineLayout()
 }
 
 
+static void CreateRadixSortPipelineLayout()
+{
+    VkPushConstantRange pushConstRange = { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GPU_RadixSortPerDrawData) };
+
+    const vkn::DescriptorSetLayout* layoutPtrs[DESC_SET_TOTAL_COUNT] = {};
+    layoutPtrs[DESC_SET_PER_FRAME] = &s_descSetLayouts[PASS_ID_COMMON];
+    layoutPtrs[DESC_SET_PER_DRAW] = &s_descSetLayouts[PASS_ID_RADIX_SORT];
+
+    vkn::PSOLayout& layout = s_PSOLayouts[PASS_ID_RADIX_SORT];
+    
+    layout.Create(&s_vkDevice, layoutPtrs, std::span(&pushConstRange, 1));
+    s_vkDevice.SetObjDebugName(layout, "RADIX_SORT_PIPELINE_LAYOUT");
+}
+
+
 static void CreateGeomBatchingPipelineLayout()
 {
     VkPushConstantRange pushConstRange = { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GPU_GeomBatchPerDrawData) };
@@ -3500,6 +4142,36 @@ static void CreateCSMRenderPipelineLayout()
 }
 
 
+static void CreateVSMPagesPipelineLayout()
+{
+    const vkn::DescriptorSetLayout* layoutPtrs[DESC_SET_TOTAL_COUNT] = {};
+    layoutPtrs[DESC_SET_PER_FRAME] = &s_descSetLayouts[PASS_ID_COMMON];
+    layoutPtrs[DESC_SET_PER_DRAW] = &s_descSetLayouts[PASS_ID_VSM_PAGES];
+
+    VkPushConstantRange pushConstRange = { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GPU_VsmPagesPerDrawData) };
+
+    vkn::PSOLayout& layout = s_PSOLayouts[PASS_ID_VSM_PAGES];
+
+    layout.Create(&s_vkDevice, layoutPtrs, std::span(&pushConstRange, 1));
+    s_vkDevice.SetObjDebugName(layout, "VSM_PAGES_PIPELINE_LAYOUT");
+}
+
+
+static void CreateVSMRenderPipelineLayout()
+{
+    const vkn::DescriptorSetLayout* layoutPtrs[DESC_SET_TOTAL_COUNT] = {};
+    layoutPtrs[DESC_SET_PER_FRAME] = &s_descSetLayouts[PASS_ID_COMMON];
+    layoutPtrs[DESC_SET_PER_DRAW] = &s_descSetLayouts[PASS_ID_VSM_RENDER];
+    
+    VkPushConstantRange pushConstRange = { VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(GPU_CsmPerDrawData) };
+    
+    vkn::PSOLayout& layout = s_PSOLayouts[PASS_ID_VSM_RENDER];
+    
+    layout.Create(&s_vkDevice, layoutPtrs, std::span(&pushConstRange, 1));
+    s_vkDevice.SetObjDebugName(layout, "VSM_RENDER_PIPELINE_LAYOUT");
+}
+
+
 static void CreateGBufferPipelineLayout()
 {
     const vkn::DescriptorSetLayout* layoutPtrs[DESC_SET_TOTAL_COUNT] = {};
@@ -3515,6 +4187,32 @@ static void CreateGBufferPipelineLayout()
 }
 
 
+static void CreateLightCullingPipelineLayout()
+{
+    const vkn::DescriptorSetLayout* layoutPtrs[DESC_SET_TOTAL_COUNT] = {};
+    layoutPtrs[DESC_SET_PER_FRAME] = &s_descSetLayouts[PASS_ID_COMMON];
+    layoutPtrs[DESC_SET_PER_DRAW] = &s_descSetLayouts[PASS_ID_LIGHT_CULLING];
+
+    vkn::PSOLayout& layout = s_PSOLayouts[PASS_ID_LIGHT_CULLING];
+
+    layout.Create(&s_vkDevice, layoutPtrs);
+    s_vkDevice.SetObjDebugName(layout, "LIGHT_CULLING_PIPELINE_LAYOUT");
+}
+
+
+static void CreateDeferredLightingClassifyPipelineLayout()
+{
+    const vkn::DescriptorSetLayout* layoutPtrs[DESC_SET_TOTAL_COUNT] = {};
+    layoutPtrs[DESC_SET_PER_FRAME] = &s_descSetLayouts[PASS_ID_COMMON];
+    layoutPtrs[DESC_SET_PER_DRAW] = &s_descSetLayouts[PASS_ID_DEFERRED_LIGHTING_CLASSIFY];
+
+    vkn::PSOLayout& layout = s_PSOLayouts[PASS_ID_DEFERRED_LIGHTING_CLASSIFY];
+
+    layout.Create(&s_vkDevice, layoutPtrs);
+    s_vkDevice.SetObjDebugName(layout, "DEFERRED_LIGHTING_CLASSIFY_PIPELINE_LAYOUT");
+}
+
+
 static void CreateDeferredLightingPipelineLayout()
 {
     const vkn::DescriptorSetLayout* layoutPtrs[DESC_SET_TOTAL_COUNT] = {};
@@ -3657,19 +4355,41 @@ static void CreateDbgRTViewPipelineLayout()
 }
 
 
-static void CreateGeomCullingPipeline(const fs::path& csPath)
+static void CreateRadixSortPipeline(PSOBuildContext& ctx, const fs::path& csPath)
+{
+    if (!LoadShaderSpirVCode(csPath, ctx.shaderCodeBuffer)) {
+        VK_ASSERT_FAIL("Failed to load shader: %s", csPath.string().c_str());
+    }
+    
+    vkn::Shader shader;
+    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, ctx.shaderCodeBuffer);
+    s_vkDevice.SetObjDebugName(shader, "RADIX_SORT_COMPUTE_SHADER");
+
+    vkn::PSO& pso = s_PSOs[PASS_ID_RADIX_SORT];
+
+    pso = ctx.computePSOBuilder.Reset()
+        .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
+        .SetShader(shader)
+        .SetLayout(s_PSOLayouts[PASS_ID_RADIX_SORT])
+        .Build();
+
+    s_vkDevice.SetObjDebugName(pso, "RADIX_SORT_PSO");
+}
+
+
+static void CreateGeomCullingPipeline(PSOBuildContext& ctx, const fs::path& csPath)
 {
-    if (!LoadShaderSpirVCode(csPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(csPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", csPath.string().c_str());
     }
     
     vkn::Shader shader;
-    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, s_shaderCodeBuffer);
+    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(shader, "GEOM_CULLING_COMPUTE_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_GEOM_CULLING];
 
-    pso = s_computePSOBuilder.Reset()
+    pso = ctx.computePSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .SetShader(shader)
         .SetLayout(s_PSOLayouts[PASS_ID_GEOM_CULLING])
@@ -3679,19 +4399,19 @@ static void CreateGeomCullingPipeline(const fs::path& csPath)
 }
 
 
-static void CreateGeomBatchingPipeline(const fs::path& csPath)
+static void CreateGeomBatchingPipeline(PSOBuildContext& ctx, const fs::path& csPath)
 {
-    if (!LoadShaderSpirVCode(csPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(csPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", csPath.string().c_str());
     }
     
     vkn::Shader shader;
-    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, s_shaderCodeBuffer);
+    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(shader, "GEOM_BATCHING_COMPUTE_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_GEOM_BATCHING];
 
-    pso = s_computePSOBuilder.Reset()
+    pso = ctx.computePSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .SetShader(shader)
         .SetLayout(s_PSOLayouts[PASS_ID_GEOM_BATCHING])
@@ -3701,19 +4421,19 @@ static void CreateGeomBatchingPipeline(const fs::path& csPath)
 }
 
 
-static void CreateGeomDrawCmdGenPipeline(const fs::path& csPath)
+static void CreateGeomDrawCmdGenPipeline(PSOBuildContext& ctx, const fs::path& csPath)
 {
-    if (!LoadShaderSpirVCode(csPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(csPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", csPath.string().c_str());
     }
     
     vkn::Shader shader;
-    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, s_shaderCodeBuffer);
+    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(shader, "GEOM_DRAW_CMD_GEN_COMPUTE_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_GEOM_DRAW_CMD_GEN];
 
-    pso = s_computePSOBuilder.Reset()
+    pso = ctx.computePSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .SetShader(shader)
         .SetLayout(s_PSOLayouts[PASS_ID_GEOM_DRAW_CMD_GEN])
@@ -3723,27 +4443,27 @@ static void CreateGeomDrawCmdGenPipeline(const fs::path& csPath)
 }
 
 
-static void CreateZPassPipeline(const fs::path& vsPath, const fs::path& psPath)
+static void CreateZPassPipeline(PSOBuildContext& ctx, const fs::path& vsPath, const fs::path& psPath)
 {
-    if (!LoadShaderSpirVCode(vsPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(vsPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", vsPath.string().c_str());
     }
     
     vkn::Shader vsShader;
-    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, s_shaderCodeBuffer);
+    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(vsShader, "ZPASS_VERTEX_SHADER");
 
-    if (!LoadShaderSpirVCode(psPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(psPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", psPath.string().c_str());
     }
     
     vkn::Shader psShader;
-    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, s_shaderCodeBuffer);
+    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(psShader, "ZPASS_FRAGMENT_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_DEPTH];
 
-    s_graphicsPSOBuilder.Reset()
+    ctx.graphicsPSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .AddShader(vsShader)
         .AddShader(psShader)
@@ -3769,25 +4489,25 @@ static void CreateZPassPipeline(const fs::path& vsPath, const fs::path& psPath)
         })        
         .SetDepthAttachment(s_depthRT.GetFormat());
     
-    pso = s_graphicsPSOBuilder.Build();
+    pso = ctx.graphicsPSOBuilder.Build();
     
     s_vkDevice.SetObjDebugName(pso, "ZPASS_PSO");
 }
 
 
-static void CreateHZBGenPipeline(const fs::path& csPath)
+static void CreateHZBGenPipeline(PSOBuildContext& ctx, const fs::path& csPath)
 {
-    if (!LoadShaderSpirVCode(csPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(csPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", csPath.string().c_str());
     }
     
     vkn::Shader shader;
-    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, s_shaderCodeBuffer);
+    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(shader, "HZB_GEN_COMPUTE_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_HZB_GEN];
 
-    pso = s_computePSOBuilder.Reset()
+    pso = ctx.computePSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .SetShader(shader)
         .SetLayout(s_PSOLayouts[PASS_ID_HZB_GEN])
@@ -3797,19 +4517,19 @@ static void CreateHZBGenPipeline(const fs::path& csPath)
 }
 
 
-static void CreateCSMGeomCullingPipeline(const fs::path& csPath)
+static void CreateCSMGeomCullingPipeline(PSOBuildContext& ctx, const fs::path& csPath)
 {
-    if (!LoadShaderSpirVCode(csPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(csPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", csPath.string().c_str());
     }
     
     vkn::Shader shader;
-    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, s_shaderCodeBuffer);
+    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(shader, "CSM_GEOM_CULLING_COMPUTE_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_CSM_GEOM_CULLING];
 
-    pso = s_computePSOBuilder.Reset()
+    pso = ctx.computePSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .SetShader(shader)
         .SetLayout(s_PSOLayouts[PASS_ID_CSM_GEOM_CULLING])
@@ -3819,27 +4539,27 @@ static void CreateCSMGeomCullingPipeline(const fs::path& csPath)
 }
 
 
-static void CreateCSMRenderPipeline(const fs::path& vsPath, const fs::path& psPath)
+static void CreateCSMRenderPipeline(PSOBuildContext& ctx, const fs::path& vsPath, const fs::path& psPath)
 {
-    if (!LoadShaderSpirVCode(vsPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(vsPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", vsPath.string().c_str());
     }
     
     vkn::Shader vsShader;
-    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, s_shaderCodeBuffer);
+    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(vsShader, "CSM_RENDER_VERTEX_SHADER");
 
-    if (!LoadShaderSpirVCode(psPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(psPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", psPath.string().c_str());
     }
     
     vkn::Shader psShader;
-    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, s_shaderCodeBuffer);
+    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(psShader, "CSM_RENDER_FRAGMENT_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_CSM_RENDER];
 
-    s_graphicsPSOBuilder.Reset()
+    ctx.graphicsPSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .AddShader(vsShader)
         .AddShader(psShader)
@@ -3865,33 +4585,102 @@ static void CreateCSMRenderPipeline(const fs::path& vsPath, const fs::path& psPa
         })        
         .SetDepthAttachment(s_csmRT.GetFormat());
     
-    pso = s_graphicsPSOBuilder.Build();
+    pso = ctx.graphicsPSOBuilder.Build();
     
     s_vkDevice.SetObjDebugName(pso, "CSM_RENDER_PSO");
 }
+
+
+static void CreateVSMPagesPipeline(PSOBuildContext& ctx, const fs::path& csPath)
+{
+    if (!LoadShaderSpirVCode(csPath, ctx.shaderCodeBuffer)) {
+        VK_ASSERT_FAIL("Failed to load shader: %s", csPath.string().c_str());
+    }
+    
+    vkn::Shader shader;
+    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, ctx.shaderCodeBuffer);
+    s_vkDevice.SetObjDebugName(shader, "VSM_PAGES_COMPUTE_SHADER");
+
+    vkn::PSO& pso = s_PSOs[PASS_ID_VSM_PAGES];
+
+    pso = ctx.computePSOBuilder.Reset()
+        .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
+        .SetShader(shader)
+        .SetLayout(s_PSOLayouts[PASS_ID_VSM_PAGES])
+        .Build();
+
+    s_vkDevice.SetObjDebugName(pso, "VSM_PAGES_PSO");
+}
+
+
+// VSM pages are scattered across physical pool, so pass has no attachments. Depth test is done in fragment shader with atomics
+static void CreateVSMRenderPipeline(PSOBuildContext& ctx, const fs::path& vsPath, const fs::path& psPath)
+{
+    if (!LoadShaderSpirVCode(vsPath, ctx.shaderCodeBuffer)) {
+        VK_ASSERT_FAIL("Failed to load shader: %s", vsPath.string().c_str());
+    }
+    
+    vkn::Shader vsShader;
+    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, ctx.shaderCodeBuffer);
+    s_vkDevice.SetObjDebugName(vsShader, "VSM_RENDER_VERTEX_SHADER");
+
+    if (!LoadShaderSpirVCode(psPath, ctx.shaderCodeBuffer)) {
+        VK_ASSERT_FAIL("Failed to load shader: %s", psPath.string().c_str());
+    }
+    
+    vkn::Shader psShader;
+    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, ctx.shaderCodeBuffer);
+    s_vkDevice.SetObjDebugName(psShader, "VSM_RENDER_FRAGMENT_SHADER");
+
+    vkn::PSO& pso = s_PSOs[PASS_ID_VSM_RENDER];
+
+    pso = ctx.graphicsPSOBuilder.Reset()
+        .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
+        .AddShader(vsShader)
+        .AddShader(psShader)
+        .SetLayout(s_PSOLayouts[PASS_ID_VSM_RENDER])
+        .SetInputAssemblyState(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+        .SetRasterizerPolygonMode(VK_POLYGON_MODE_FILL)
+        .SetRasterizerCullMode(VK_CULL_MODE_BACK_BIT)
+        .SetRasterizerFrontFace(VK_FRONT_FACE_COUNTER_CLOCKWISE)
+        .SetRasterizerLineWidth(1.f)
+        .SetDepthTestState(VK_FALSE, VK_COMPARE_OP_ALWAYS)
+        .SetDepthWriteState(VK_FALSE)
+        .SetDepthBoundsTestState(VK_FALSE, 0.f, 1.f)
+        .AddDynamicState(std::array{
+            VK_DYNAMIC_STATE_VIEWPORT, 
+            VK_DYNAMIC_STATE_SCISSOR,
+        #ifdef ENG_BUILD_DEBUG
+            VK_DYNAMIC_STATE_POLYGON_MODE_EXT
+        #endif
+        })
+        .Build();
+    
+    s_vkDevice.SetObjDebugName(pso, "VSM_RENDER_PSO");
+}
     
 
-static void CreateGBufferRenderPipeline(const fs::path& vsPath, const fs::path& psPath)
+static void CreateGBufferRenderPipeline(PSOBuildContext& ctx, const fs::path& vsPath, const fs::path& psPath)
 {
-    if (!LoadShaderSpirVCode(vsPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(vsPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", vsPath.string().c_str());
     }
     
     vkn::Shader vsShader;
-    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, s_shaderCodeBuffer);
+    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(vsShader, "GBUFFER_VERTEX_SHADER");
 
-    if (!LoadShaderSpirVCode(psPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(psPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", psPath.string().c_str());
     }
     
     vkn::Shader psShader;
-    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, s_shaderCodeBuffer);
+    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(psShader, "GBUFFER_FRAGMENT_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_GBUFFER];
 
-    s_graphicsPSOBuilder.Reset()
+    ctx.graphicsPSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .AddShader(vsShader)
         .AddShader(psShader)
@@ -3914,76 +4703,103 @@ static void CreateGBufferRenderPipeline(const fs::path& vsPath, const fs::path&
         });
 
     for (const vkn::Texture& colorRT : s_gbufferRTs) {
-        s_graphicsPSOBuilder.AddColorAttachment(colorRT.GetFormat()); 
+        ctx.graphicsPSOBuilder.AddColorAttachment(colorRT.GetFormat()); 
     }
-    s_graphicsPSOBuilder.SetDepthAttachment(s_depthRT.GetFormat());
+    ctx.graphicsPSOBuilder.SetDepthAttachment(s_depthRT.GetFormat());
     
-    pso = s_graphicsPSOBuilder.Build();
+    pso = ctx.graphicsPSOBuilder.Build();
     
     s_vkDevice.SetObjDebugName(pso, "GBUFFER_PSO");
 }
 
 
-static void CreateDeferredLightingPipeline(const fs::path& vsPath, const fs::path& psPath)
+static void CreateLightCullingPipeline(PSOBuildContext& ctx, const fs::path& csPath)
 {
-    if (!LoadShaderSpirVCode(vsPath, s_shaderCodeBuffer)) {
-        VK_ASSERT_FAIL("Failed to load shader: %s", vsPath.string().c_str());
+    if (!LoadShaderSpirVCode(csPath, ctx.shaderCodeBuffer)) {
+        VK_ASSERT_FAIL("Failed to load shader: %s", csPath.string().c_str());
     }
     
-    vkn::Shader vsShader;
-    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, s_shaderCodeBuffer);
-    s_vkDevice.SetObjDebugName(vsShader, "DEFERRED_LIGHTING_VERTEX_SHADER");
+    vkn::Shader shader;
+    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, ctx.shaderCodeBuffer);
+    s_vkDevice.SetObjDebugName(shader, "LIGHT_CULLING_COMPUTE_SHADER");
 
-    if (!LoadShaderSpirVCode(psPath, s_shaderCodeBuffer)) {
-        VK_ASSERT_FAIL("Failed to load shader: %s", psPath.string().c_str());
+    vkn::PSO& pso = s_PSOs[PASS_ID_LIGHT_CULLING];
+
+    pso = ctx.computePSOBuilder.Reset()
+        .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
+        .SetShader(shader)
+        .SetLayout(s_PSOLayouts[PASS_ID_LIGHT_CULLING])
+        .Build();
+
+    s_vkDevice.SetObjDebugName(pso, "LIGHT_CULLING_PSO");
+}
+
+
+static void CreateDeferredLightingClassifyPipeline(PSOBuildContext& ctx, const fs::path& csPath)
+{
+    if (!LoadShaderSpirVCode(csPath, ctx.shaderCodeBuffer)) {
+        VK_ASSERT_FAIL("Failed to load shader: %s", csPath.string().c_str());
     }
     
-    vkn::Shader psShader;
-    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, s_shaderCodeBuffer);
-    s_vkDevice.SetObjDebugName(psShader, "DEFERRED_LIGHTING_FRAGMENT_SHADER");
+    vkn::Shader shader;
+    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, ctx.shaderCodeBuffer);
+    s_vkDevice.SetObjDebugName(shader, "DEFERRED_LIGHTING_CLASSIFY_COMPUTE_SHADER");
 
-    vkn::PSO& pso = s_PSOs[PASS_ID_DEFERRED_LIGHTING];
+    vkn::PSO& pso = s_PSOs[PASS_ID_DEFERRED_LIGHTING_CLASSIFY];
 
-    s_graphicsPSOBuilder.Reset()
+    pso = ctx.computePSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
-        .AddShader(vsShader)
-        .AddShader(psShader)
-        .SetLayout(s_PSOLayouts[PASS_ID_DEFERRED_LIGHTING])
-        .SetInputAssemblyState(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
-        .SetRasterizerPolygonMode(VK_POLYGON_MODE_FILL)
-        .SetRasterizerCullMode(VK_CULL_MODE_BACK_BIT)
-        .SetRasterizerFrontFace(VK_FRONT_FACE_COUNTER_CLOCKWISE)
-        .SetRasterizerLineWidth(1.f)
-        .AddDynamicState(std::array{ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR })
-        .AddColorAttachment(s_colorRT16F.GetFormat());
-    
-    pso = s_graphicsPSOBuilder.Build();
+        .SetShader(shader)
+        .SetLayout(s_PSOLayouts[PASS_ID_DEFERRED_LIGHTING_CLASSIFY])
+        .Build();
+
+    s_vkDevice.SetObjDebugName(pso, "DEFERRED_LIGHTING_CLASSIFY_PSO");
+}
+
+
+static void CreateDeferredLightingPipeline(PSOBuildContext& ctx, DeferredLightingTileClass tileClass, const fs::path& csPath)
+{
+    if (!LoadShaderSpirVCode(csPath, ctx.shaderCodeBuffer)) {
+        VK_ASSERT_FAIL("Failed to load shader: %s", csPath.string().c_str());
+    }
     
-    s_vkDevice.SetObjDebugName(pso, "DEFERRED_LIGHTING_PSO");
+    vkn::Shader shader;
+    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, ctx.shaderCodeBuffer);
+    s_vkDevice.SetObjDebugName(shader, "DEFERRED_LIGHTING_%s_COMPUTE_SHADER", DEFERRED_LIGHTING_TILE_CLASS_DBG_NAMES[tileClass]);
+
+    vkn::PSO& pso = s_deferredLightingPSOs[tileClass];
+
+    pso = ctx.computePSOBuilder.Reset()
+        .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
+        .SetShader(shader)
+        .SetLayout(s_PSOLayouts[PASS_ID_DEFERRED_LIGHTING])
+        .Build();
+
+    s_vkDevice.SetObjDebugName(pso, "DEFERRED_LIGHTING_%s_PSO", DEFERRED_LIGHTING_TILE_CLASS_DBG_NAMES[tileClass]);
 }
 
 
-static void CreatePostProcessingPipeline(const fs::path& vsPath, const fs::path& psPath)
+static void CreatePostProcessingPipeline(PSOBuildContext& ctx, const fs::path& vsPath, const fs::path& psPath)
 {
-    if (!LoadShaderSpirVCode(vsPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(vsPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", vsPath.string().c_str());
     }
     
     vkn::Shader vsShader;
-    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, s_shaderCodeBuffer);
+    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(vsShader, "POST_PROCESSING_VERTEX_SHADER");
 
-    if (!LoadShaderSpirVCode(psPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(psPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", psPath.string().c_str());
     }
     
     vkn::Shader psShader;
-    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, s_shaderCodeBuffer);
+    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(psShader, "POST_PROCESSING_FRAGMENT_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_POST_PROCESSING];
 
-    s_graphicsPSOBuilder.Reset()
+    ctx.graphicsPSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .AddShader(vsShader)
         .AddShader(psShader)
@@ -3996,33 +4812,33 @@ static void CreatePostProcessingPipeline(const fs::path& vsPath, const fs::path&
         .AddDynamicState(std::array{ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR })
         .AddColorAttachment(s_colorRT8U.GetFormat());
     
-    pso = s_graphicsPSOBuilder.Build();
+    pso = ctx.graphicsPSOBuilder.Build();
     
     s_vkDevice.SetObjDebugName(pso, "POST_PROCESSING_PSO");
 }
 
 
-static void CreateBackbufferPassPipeline(const fs::path& vsPath, const fs::path& psPath)
+static void CreateBackbufferPassPipeline(PSOBuildContext& ctx, const fs::path& vsPath, const fs::path& psPath)
 {
-    if (!LoadShaderSpirVCode(vsPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(vsPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", vsPath.string().c_str());
     }
     
     vkn::Shader vsShader;
-    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, s_shaderCodeBuffer);
+    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(vsShader, "BACKBUFFER_VERTEX_SHADER");
 
-    if (!LoadShaderSpirVCode(psPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(psPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", psPath.string().c_str());
     }
     
     vkn::Shader psShader;
-    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, s_shaderCodeBuffer);
+    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(psShader, "BACKBUFFER_FRAGMENT_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_BACKBUFFER];
 
-    s_graphicsPSOBuilder.Reset()
+    ctx.graphicsPSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .AddShader(vsShader)
         .AddShader(psShader)
@@ -4035,33 +4851,33 @@ static void CreateBackbufferPassPipeline(const fs::path& vsPath, const fs::path&
         .AddDynamicState(std::array{ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR })
         .AddColorAttachment(s_vkSwapchain.GetTextureFormat());
     
-    pso = s_graphicsPSOBuilder.Build();
+    pso = ctx.graphicsPSOBuilder.Build();
     
     s_vkDevice.SetObjDebugName(pso, "BACKBUFFER_PSO");
 }
 
 
-static void CreateSkyboxPipeline(const fs::path& vsPath, const fs::path& psPath)
+static void CreateSkyboxPipeline(PSOBuildContext& ctx, const fs::path& vsPath, const fs::path& psPath)
 {
-    if (!LoadShaderSpirVCode(vsPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(vsPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", vsPath.string().c_str());
     }
     
     vkn::Shader vsShader;
-    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, s_shaderCodeBuffer);
+    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(vsShader, "SKYBOX_VERTEX_SHADER");
 
-    if (!LoadShaderSpirVCode(psPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(psPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", psPath.string().c_str());
     }
     
     vkn::Shader psShader;
-    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, s_shaderCodeBuffer);
+    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(psShader, "SKYBOX_FRAGMENT_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_SKYBOX];
 
-    s_graphicsPSOBuilder.Reset()
+    ctx.graphicsPSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .AddShader(vsShader)
         .AddShader(psShader)
@@ -4081,25 +4897,25 @@ static void CreateSkyboxPipeline(const fs::path& vsPath, const fs::path& psPath)
         .AddColorAttachment(s_colorRT16F.GetFormat())
         .SetDepthAttachment(s_depthRT.GetFormat());
     
-    pso = s_graphicsPSOBuilder.Build();
+    pso = ctx.graphicsPSOBuilder.Build();
     
     s_vkDevice.SetObjDebugName(pso, "SKYBOX_PSO");
 }
 
 
-static void CreateIrradianceMapGenPipeline(const fs::path& csPath)
+static void CreateIrradianceMapGenPipeline(PSOBuildContext& ctx, const fs::path& csPath)
 {
-    if (!LoadShaderSpirVCode(csPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(csPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", csPath.string().c_str());
     }
     
     vkn::Shader shader;
-    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, s_shaderCodeBuffer);
+    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(shader, "IRRADIANCE_MAP_GEN_COMPUTE_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_IRRADIANCE_MAP_GEN];
 
-    pso = s_computePSOBuilder.Reset()
+    pso = ctx.computePSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .SetShader(shader)
         .SetLayout(s_PSOLayouts[PASS_ID_IRRADIANCE_MAP_GEN])
@@ -4109,19 +4925,19 @@ static void CreateIrradianceMapGenPipeline(const fs::path& csPath)
 }
 
 
-static void CreatePrefilteredEnvMapGenPipeline(const fs::path& csPath)
+static void CreatePrefilteredEnvMapGenPipeline(PSOBuildContext& ctx, const fs::path& csPath)
 {
-    if (!LoadShaderSpirVCode(csPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(csPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", csPath.string().c_str());
     }
     
     vkn::Shader shader;
-    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, s_shaderCodeBuffer);
+    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(shader, "PREFILT_ENV_MAP_GEN_COMPUTE_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_PREFILT_ENV_MAP_GEN];
 
-    pso = s_computePSOBuilder.Reset()
+    pso = ctx.computePSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .SetShader(shader)
         .SetLayout(s_PSOLayouts[PASS_ID_PREFILT_ENV_MAP_GEN])
@@ -4131,19 +4947,19 @@ static void CreatePrefilteredEnvMapGenPipeline(const fs::path& csPath)
 }
 
 
-static void CreateBRDFIntegrationLUTGenPipeline(const fs::path& csPath)
+static void CreateBRDFIntegrationLUTGenPipeline(PSOBuildContext& ctx, const fs::path& csPath)
 {
-    if (!LoadShaderSpirVCode(csPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(csPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", csPath.string().c_str());
     }
     
     vkn::Shader shader;
-    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, s_shaderCodeBuffer);
+    shader.Create(&s_vkDevice, VK_SHADER_STAGE_COMPUTE_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(shader, "BRDF_LUT_GEN_COMPUTE_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_BRDF_LUT_GEN];
 
-    pso = s_computePSOBuilder.Reset()
+    pso = ctx.computePSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .SetShader(shader)
         .SetLayout(s_PSOLayouts[PASS_ID_BRDF_LUT_GEN])
@@ -4153,28 +4969,28 @@ static void CreateBRDFIntegrationLUTGenPipeline(const fs::path& csPath)
 }
 
 
-static void CreateDbgDrawLinePipeline(const fs::path& vsPath, const fs::path& psPath)
+static void CreateDbgDrawLinePipeline(PSOBuildContext& ctx, const fs::path& vsPath, const fs::path& psPath)
 {
 #ifdef ENG_DEBUG_DRAW_ENABLED
-    if (!LoadShaderSpirVCode(vsPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(vsPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", vsPath.string().c_str());
     }
     
     vkn::Shader vsShader;
-    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, s_shaderCodeBuffer);
+    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(vsShader, "DBG_DRAW_LINE_VERTEX_SHADER");
 
-    if (!LoadShaderSpirVCode(psPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(psPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", psPath.string().c_str());
     }
     
     vkn::Shader psShader;
-    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, s_shaderCodeBuffer);
+    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(psShader, "DBG_DRAW_LINE_FRAGMENT_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_DBG_DRAW_LINES];
 
-    s_graphicsPSOBuilder.Reset()
+    ctx.graphicsPSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .AddShader(vsShader)
         .AddShader(psShader)
@@ -4196,35 +5012,35 @@ static void CreateDbgDrawLinePipeline(const fs::path& vsPath, const fs::path& ps
             VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT, VK_TRUE)
         .SetDepthAttachment(s_depthRT.GetFormat());
     
-    pso = s_graphicsPSOBuilder.Build();
+    pso = ctx.graphicsPSOBuilder.Build();
     
     s_vkDevice.SetObjDebugName(pso, "DBG_DRAW_LINES_PSO");
 #endif
 }
 
 
-static void CreateDbgDrawTrianglePipeline(const fs::path& vsPath, const fs::path& psPath)
+static void CreateDbgDrawTrianglePipeline(PSOBuildContext& ctx, const fs::path& vsPath, const fs::path& psPath)
 {
 #ifdef ENG_DEBUG_DRAW_ENABLED
-    if (!LoadShaderSpirVCode(vsPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(vsPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", vsPath.string().c_str());
     }
     
     vkn::Shader vsShader;
-    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, s_shaderCodeBuffer);
+    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(vsShader, "DBG_DRAW_TRIANGLE_VERTEX_SHADER");
 
-    if (!LoadShaderSpirVCode(psPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(psPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", psPath.string().c_str());
     }
     
     vkn::Shader psShader;
-    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, s_shaderCodeBuffer);
+    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(psShader, "DBG_DRAW_TRIANGLE_FRAGMENT_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_DBG_DRAW_TRIANGLES];
 
-    s_graphicsPSOBuilder.Reset()
+    ctx.graphicsPSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .AddShader(vsShader)
         .AddShader(psShader)
@@ -4246,35 +5062,35 @@ static void CreateDbgDrawTrianglePipeline(const fs::path& vsPath, const fs::path
             VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT, VK_TRUE)
         .SetDepthAttachment(s_depthRT.GetFormat());
     
-    pso = s_graphicsPSOBuilder.Build();
+    pso = ctx.graphicsPSOBuilder.Build();
     
     s_vkDevice.SetObjDebugName(pso, "DBG_DRAW_TRIANGLES_PSO");
 #endif
 }
 
 
-static void CreateDbgRTViewPipeline(const fs::path& vsPath, const fs::path& psPath)
+static void CreateDbgRTViewPipeline(PSOBuildContext& ctx, const fs::path& vsPath, const fs::path& psPath)
 {
 #ifdef ENG_DEBUG_DRAW_ENABLED
-    if (!LoadShaderSpirVCode(vsPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(vsPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", vsPath.string().c_str());
     }
     
     vkn::Shader vsShader;
-    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, s_shaderCodeBuffer);
+    vsShader.Create(&s_vkDevice, VK_SHADER_STAGE_VERTEX_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(vsShader, "DBG_RT_VIEW_VERTEX_SHADER");
 
-    if (!LoadShaderSpirVCode(psPath, s_shaderCodeBuffer)) {
+    if (!LoadShaderSpirVCode(psPath, ctx.shaderCodeBuffer)) {
         VK_ASSERT_FAIL("Failed to load shader: %s", psPath.string().c_str());
     }
     
     vkn::Shader psShader;
-    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, s_shaderCodeBuffer);
+    psShader.Create(&s_vkDevice, VK_SHADER_STAGE_FRAGMENT_BIT, ctx.shaderCodeBuffer);
     s_vkDevice.SetObjDebugName(psShader, "DBG_RT_VIEW_FRAGMENT_SHADER");
 
     vkn::PSO& pso = s_PSOs[PASS_ID_DBG_RT_VIEW];
 
-    s_graphicsPSOBuilder.Reset()
+    ctx.graphicsPSOBuilder.Reset()
         .SetFlags(VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)
         .AddShader(vsShader)
         .AddShader(psShader)
@@ -4287,15 +5103,95 @@ static void CreateDbgRTViewPipeline(const fs::path& vsPath, const fs::path& psPa
         .AddDynamicState(std::array{ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR })
         .AddColorAttachment(s_colorRT8U.GetFormat());
     
-    pso = s_graphicsPSOBuilder.Build();
+    pso = ctx.graphicsPSOBuilder.Build();
     
     s_vkDevice.SetObjDebugName(pso, "DBG_RT_VIEW_PSO");
 #endif
 }
 
 
+static const std::vector<PSOBuildJob>& GetPSOBuildJobs()
+{
+    static const std::vector<PSOBuildJob> jobs = {
+        { { "radix_sort.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateRadixSortPipeline(ctx, shaderPaths[0]); } },
+
+        { { "geom_culling.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateGeomCullingPipeline(ctx, shaderPaths[0]); } },
+        { { "geom_batching.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateGeomBatchingPipeline(ctx, shaderPaths[0]); } },
+        { { "geom_draw_cmd_gen.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateGeomDrawCmdGenPipeline(ctx, shaderPaths[0]); } },
+
+        { { "zpass.vs.spv", "zpass.ps.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateZPassPipeline(ctx, shaderPaths[0], shaderPaths[1]); } },
+
+        { { "hzb.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateHZBGenPipeline(ctx, shaderPaths[0]); } },
+
+        { { "csm.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateCSMGeomCullingPipeline(ctx, shaderPaths[0]); } },
+        { { "csm.vs.spv", "csm.ps.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateCSMRenderPipeline(ctx, shaderPaths[0], shaderPaths[1]); } },
+
+        { { "vsm_pages.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateVSMPagesPipeline(ctx, shaderPaths[0]); } },
+        { { "vsm.vs.spv", "vsm.ps.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateVSMRenderPipeline(ctx, shaderPaths[0], shaderPaths[1]); } },
+
+        { { "gbuffer.vs.spv", "gbuffer.ps.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateGBufferRenderPipeline(ctx, shaderPaths[0], shaderPaths[1]); } },
+
+        { { "light_culling.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateLightCullingPipeline(ctx, shaderPaths[0]); } },
+        { { "deferred_lighting_classify.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateDeferredLightingClassifyPipeline(ctx, shaderPaths[0]); } },
+        { { "deferred_lighting_unshadowed.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateDeferredLightingPipeline(ctx, DEFERRED_LIGHTING_TILE_CLASS_UNSHADOWED, shaderPaths[0]); } },
+        { { "deferred_lighting_single_cascade.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateDeferredLightingPipeline(ctx, DEFERRED_LIGHTING_TILE_CLASS_SINGLE_CASCADE, shaderPaths[0]); } },
+        { { "deferred_lighting_general.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateDeferredLightingPipeline(ctx, DEFERRED_LIGHTING_TILE_CLASS_GENERAL, shaderPaths[0]); } },
+        { { "deferred_lighting_pcss.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateDeferredLightingPipeline(ctx, DEFERRED_LIGHTING_TILE_CLASS_PCSS, shaderPaths[0]); } },
+
+        { { "post_processing.vs.spv", "post_processing.ps.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreatePostProcessingPipeline(ctx, shaderPaths[0], shaderPaths[1]); } },
+
+        { { "backbuffer.vs.spv", "backbuffer.ps.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateBackbufferPassPipeline(ctx, shaderPaths[0], shaderPaths[1]); } },
+
+        { { "skybox.vs.spv", "skybox.ps.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateSkyboxPipeline(ctx, shaderPaths[0], shaderPaths[1]); } },
+
+        { { "irradiance_map_gen.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateIrradianceMapGenPipeline(ctx, shaderPaths[0]); } },
+        { { "prefiltered_env_map_gen.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreatePrefilteredEnvMapGenPipeline(ctx, shaderPaths[0]); } },
+        { { "brdf_integration_gen.cs.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateBRDFIntegrationLUTGenPipeline(ctx, shaderPaths[0]); } },
+
+        { { "dbg_draw_lines.vs.spv", "dbg_draw_lines.ps.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateDbgDrawLinePipeline(ctx, shaderPaths[0], shaderPaths[1]); } },
+        { { "dbg_draw_triangles.vs.spv", "dbg_draw_triangles.ps.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateDbgDrawTrianglePipeline(ctx, shaderPaths[0], shaderPaths[1]); } },
+        { { "dbg_rt_view.vs.spv", "dbg_rt_view.ps.spv" }, [](PSOBuildContext& ctx, std::span<const fs::path> shaderPaths) { CreateDbgRTViewPipeline(ctx, shaderPaths[0], shaderPaths[1]); } }
+    };
+
+    return jobs;
+}
+
+
+static void RunPSOBuildJob(PSOBuildContext& ctx, const PSOBuildJob& job)
+{
+    std::array<fs::path, 2> shaderPaths;
+    CORE_ASSERT(job.shaderNames.size() <= shaderPaths.size());
+
+    for (size_t i = 0; i < job.shaderNames.size(); ++i) {
+        shaderPaths[i] = RND_SHADER_SPIRV_FULL_PATH(job.shaderNames[i]);
+    }
+
+    job.build(ctx, std::span(shaderPaths.data(), job.shaderNames.size()));
+}
+
+
+static void CreatePSOCache()
+{
+    // Cache lives near SPIR-V, since it becomes mostly useless after shaders rebuild anyway
+    s_PSOCache.Create(&s_vkDevice, RND_SHADER_SPIRV_FULL_PATH("pso_cache.bin"));
+    s_vkDevice.SetObjDebugName(s_PSOCache, "PSO_CACHE");
+}
+
+
+static void DestroyPSOCache()
+{
+    if (!s_PSOCache.Save()) {
+        CORE_LOG_WARN("Failed to save PSO cache to %s", s_PSOCache.GetFilepath().string().c_str());
+    }
+
+    s_PSOCache.Destroy();
+}
+
+
 static void CreatePipelines()
 {
+    CreateRadixSortPipelineLayout();
+
     CreateGeomCullingPipelineLayout();
     CreateGeomBatchingPipelineLayout();
     CreateGeomDrawCmdGenPipelineLayout();
@@ -4306,9 +5202,14 @@ static void CreatePipelines()
 
     CreateCSMGeomCullingPipelineLayout();
     CreateCSMRenderPipelineLayout();
+
+    CreateVSMPagesPipelineLayout();
+    CreateVSMRenderPipelineLayout();
     
     CreateGBufferPipelineLayout();
     
+    CreateLightCullingPipelineLayout();
+    CreateDeferredLightingClassifyPipelineLayout();
     CreateDeferredLightingPipelineLayout();
     
     CreatePostProcessingPipelineLayout();
@@ -4326,96 +5227,345 @@ static void CreatePipelines()
     CreateDbgRTViewPipelineLayout();
 
 
-    CreateGeomCullingPipeline(RND_SHADER_SPIRV_FULL_PATH("geom_culling.cs.spv"));
-    CreateGeomBatchingPipeline(RND_SHADER_SPIRV_FULL_PATH("geom_batching.cs.spv"));
-    CreateGeomDrawCmdGenPipeline(RND_SHADER_SPIRV_FULL_PATH("geom_draw_cmd_gen.cs.spv"));
-    
-    CreateZPassPipeline(RND_SHADER_SPIRV_FULL_PATH("zpass.vs.spv"), RND_SHADER_SPIRV_FULL_PATH("zpass.ps.spv"));
-    
-    CreateHZBGenPipeline(RND_SHADER_SPIRV_FULL_PATH("hzb.cs.spv"));
+    // Vulkan pipeline creation is thread safe, so driver compilation of independent PSOs is spread over all worker threads.
+    // ParallelFor returns after all jobs are finished, so every PSO is ready before the first frame
+    std::vector<PSOBuildContext> contexts(eng::GetThreadPool().GetWorkerSlotCount());
 
-    CreateCSMGeomCullingPipeline(RND_SHADER_SPIRV_FULL_PATH("csm.cs.spv"));
-    CreateCSMRenderPipeline(RND_SHADER_SPIRV_FULL_PATH("csm.vs.spv"), RND_SHADER_SPIRV_FULL_PATH("csm.ps.spv"));
-    
-    CreateGBufferRenderPipeline(RND_SHADER_SPIRV_FULL_PATH("gbuffer.vs.spv"), RND_SHADER_SPIRV_FULL_PATH("gbuffer.ps.spv"));
-    
-    CreateDeferredLightingPipeline(RND_SHADER_SPIRV_FULL_PATH("deferred_lighting.vs.spv"), RND_SHADER_SPIRV_FULL_PATH("deferred_lighting.ps.spv"));
-    
-    CreatePostProcessingPipeline(RND_SHADER_SPIRV_FULL_PATH("post_processing.vs.spv"), RND_SHADER_SPIRV_FULL_PATH("post_processing.ps.spv"));
-    
-    CreateBackbufferPassPipeline(RND_SHADER_SPIRV_FULL_PATH("backbuffer.vs.spv"), RND_SHADER_SPIRV_FULL_PATH("backbuffer.ps.spv"));
-    
-    CreateSkyboxPipeline(RND_SHADER_SPIRV_FULL_PATH("skybox.vs.spv"), RND_SHADER_SPIRV_FULL_PATH("skybox.ps.spv"));
-    
-    CreateIrradianceMapGenPipeline(RND_SHADER_SPIRV_FULL_PATH("irradiance_map_gen.cs.spv"));
-    CreatePrefilteredEnvMapGenPipeline(RND_SHADER_SPIRV_FULL_PATH("prefiltered_env_map_gen.cs.spv"));
-    CreateBRDFIntegrationLUTGenPipeline(RND_SHADER_SPIRV_FULL_PATH("brdf_integration_gen.cs.spv"));
-    
-    CreateDbgDrawLinePipeline(RND_SHADER_SPIRV_FULL_PATH("dbg_draw_lines.vs.spv"), RND_SHADER_SPIRV_FULL_PATH("dbg_draw_lines.ps.spv"));
-    CreateDbgDrawTrianglePipeline(RND_SHADER_SPIRV_FULL_PATH("dbg_draw_triangles.vs.spv"), RND_SHADER_SPIRV_FULL_PATH("dbg_draw_triangles.ps.spv"));
-    CreateDbgRTViewPipeline(RND_SHADER_SPIRV_FULL_PATH("dbg_rt_view.vs.spv"), RND_SHADER_SPIRV_FULL_PATH("dbg_rt_view.ps.spv"));
+    for (PSOBuildContext& ctx : contexts) {
+        ctx.computePSOBuilder.SetCache(&s_PSOCache);
+        ctx.graphicsPSOBuilder.SetCache(&s_PSOCache);
+    }
+
+    const std::vector<PSOBuildJob>& jobs = GetPSOBuildJobs();
+
+    eng::GetThreadPool().ParallelFor(jobs.size(), [&](size_t i, uint32_t slot) {
+        RunPSOBuildJob(contexts[slot], jobs[i]);
+    });
 }
 
 
-static void CreateGeomCullingAndInstancingResources()
+#ifdef ENG_SHADER_HOT_RELOAD_ENABLED
+// Collects files included by shader file recursively. Include paths are resolved the same way as slangc does: relative to the file first
+static void CollectShaderIncludes(const fs::path& filepath, std::set<fs::path>& includes)
 {
-    vkn::AllocationInfo allocInfo = {};
-    allocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
-    allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    std::ifstream file(filepath);
 
-    s_geomCullVisSortKeysBuffer.Create(
-        &s_vkDevice, 
-        s_cpuInstData.size() * sizeof(GPU_GeomSortKey), 
-        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
-        allocInfo
-    );
-    s_vkDevice.SetObjDebugName(s_geomCullVisSortKeysBuffer, "GEOM_CULL_VIS_SORT_KEYS_BUFFER");
+    if (!file.is_open()) {
+        return;
+    }
 
-    s_geomCullVisSortKeysCounterBuffer.Create(
-        &s_vkDevice,
-        sizeof(glm::uint), 
-        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT,
-        allocInfo
-    );
-    s_vkDevice.SetObjDebugName(s_geomCullVisSortKeysCounterBuffer, "GEOM_CULL_VIS_SORT_KEYS_COUNTER_BUFFER");
+    static constexpr std::string_view INCLUDE_DIRECTIVE = "#include";
 
-    s_geomCullVisGeomIDsBuffer.Create(
-        &s_vkDevice, 
-        s_cpuInstData.size() * sizeof(glm::uint), 
-        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
-        allocInfo
-    );
-    s_vkDevice.SetObjDebugName(s_geomCullVisGeomIDsBuffer, "GEOM_CULL_VIS_GEOM_IDS_BUFFER");
+    std::string line;
 
-    s_geomCullPerGeomMatTypeCountersBuffer.Create(
-        &s_vkDevice,
-        GEOM_MAT_TYPE_COUNT * sizeof(glm::uint), 
-        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT,
-        allocInfo
-    );
-    s_vkDevice.SetObjDebugName(s_geomCullPerGeomMatTypeCountersBuffer, "GEOM_CULL_PER_GEOM_MAT_TYPE_COUNTERS_BUFFER");
+    while (std::getline(file, line)) {
+        const size_t directivePos = line.find(INCLUDE_DIRECTIVE);
 
-    for (size_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
-        // TODO: we can caclulate actual instance count for certain queue during scene loading and allocate buffers with that sizes
-        s_visGeomIDQueueBuffer[queue].Create(
-            &s_vkDevice, 
-            s_cpuInstData.size() * sizeof(glm::uint), 
-            VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
-            allocInfo
-        );
-        s_vkDevice.SetObjDebugName(s_visGeomIDQueueBuffer[queue], "%s_VIS_INST_ID_BUFFER", GEOM_QUEUE_DBG_NAMES[queue]);
-        
-        s_geomBatchQueueBuffer[queue].Create(
-            &s_vkDevice, 
-            s_cpuInstData.size() * sizeof(GPU_GeomBatch), 
-            VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
-            allocInfo
-        );
-        s_vkDevice.SetObjDebugName(s_geomBatchQueueBuffer[queue], "%s_BATCH_BUFFER", GEOM_QUEUE_DBG_NAMES[queue]);
+        if (directivePos == std::string::npos || line.find_first_not_of(" \t") != directivePos) {
+            continue;
+        }
 
-        s_sortedVisGeomIDQueueBuffer[queue].Create(
+        const size_t nameBegin = line.find('"', directivePos + INCLUDE_DIRECTIVE.size());
+        const size_t nameEnd = nameBegin != std::string::npos ? line.find('"', nameBegin + 1) : std::string::npos;
+
+        if (nameEnd == std::string::npos) {
+            continue;
+        }
+
+        const fs::path name = line.substr(nameBegin + 1, nameEnd - nameBegin - 1);
+
+        fs::path includePath = filepath.parent_path() / name;
+        if (!fs::exists(includePath)) {
+            includePath = fs::path(SHADERS_INCLUDE_DIR) / name;
+        }
+
+        includePath = includePath.lexically_normal();
+
+        if (includes.insert(includePath).second) {
+            CollectShaderIncludes(includePath, includes);
+        }
+    }
+}
+
+
+static const char* GetShaderProfile(const fs::path& srcPath)
+{
+    // Source files are named as <name>.<stage>.slang
+    const fs::path stage = srcPath.stem().extension();
+
+    if (stage == ".vs") {
+        return "vs_6_6";
+    } else if (stage == ".ps") {
+        return "ps_6_6";
+    } else if (stage == ".cs") {
+        return "cs_6_6";
+    }
+
+    return nullptr;
+}
+
+
+// Mirrors shaders CMake compilation flags. Output is written into temporary file first, so failed compilation keeps the old SPIR-V
+static bool CompileShader(const fs::path& srcPath, const char* pProfile, const fs::path& spirvPath)
+{
+    fs::path tmpSpirvPath = spirvPath;
+    tmpSpirvPath += ".tmp";
+
+    std::string command = "\"" SHADERS_COMPILER_PATH "\" \"" + srcPath.string() + "\"";
+    command += " -emit-spirv-directly -target spirv -fvk-use-entrypoint-name -entry main -I\"" SHADERS_INCLUDE_DIR "\" -DENV_API_VULKAN";
+
+#if defined(ENG_BUILD_DEBUG)
+    command += " -O0 -g -DENV_DEBUG";
+#elif defined(ENG_BUILD_PROFILE)
+    command += " -O -DENV_PROFILE";
+#else
+    command += " -O -DENV_RELEASE";
+#endif
+
+#ifdef ENG_REVERSED_Z
+    command += " -DENV_REVERSED_Z";
+#endif
+
+    command += std::string(" -profile ") + pProfile + " -o \"" + tmpSpirvPath.string() + "\"";
+
+    std::string output;
+    const int exitCode = eng::ExecuteCommand(command, output);
+
+    if (exitCode != 0) {
+        CORE_LOG_ERROR("Failed to compile shader %s (exit code: %d):\n%s", srcPath.string().c_str(), exitCode, output.c_str());
+        
+        std::error_code error;
+        fs::remove(tmpSpirvPath, error);
+
+        return false;
+    }
+
+    std::error_code error;
+    fs::rename(tmpSpirvPath, spirvPath, error);
+
+    if (error) {
+        CORE_LOG_ERROR("Failed to replace %s: %s", spirvPath.string().c_str(), error.message().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+
+// Called on the watcher thread. Recompiles every shader which source or any of its includes was changed
+static void OnShaderFilesChanged(std::span<const fs::path> changedFiles)
+{
+    std::set<fs::path> changedShaderFiles;
+
+    for (const fs::path& filepath : changedFiles) {
+        if (filepath.extension() == ".slang") {
+            changedShaderFiles.insert(filepath.lexically_normal());
+        }
+    }
+
+    if (changedShaderFiles.empty()) {
+        return;
+    }
+
+    std::vector<std::string> compiledShaderNames;
+
+    std::error_code error;
+
+    for (fs::recursive_directory_iterator it(SHADERS_SOURCE_DIR, error), end; !error && it != end; it.increment(error)) {
+        const fs::path srcPath = it->path().lexically_normal();
+        const char* pProfile = GetShaderProfile(srcPath);
+
+        if (!it->is_regular_file(error) || pProfile == nullptr) {
+            continue;
+        }
+
+        bool isRecompileRequired = changedShaderFiles.contains(srcPath);
+
+        if (!isRecompileRequired) {
+            std::set<fs::path> includes;
+            CollectShaderIncludes(srcPath, includes);
+
+            isRecompileRequired = std::ranges::any_of(includes, [&](const fs::path& include) { return changedShaderFiles.contains(include); });
+        }
+
+        if (!isRecompileRequired) {
+            continue;
+        }
+
+        // <name>.<stage>.slang is compiled to <name>.<stage>.spv
+        const std::string spirvName = srcPath.stem().string() + ".spv";
+
+        CORE_LOG_INFO("Recompiling shader %s...", srcPath.string().c_str());
+
+        if (CompileShader(srcPath, pProfile, RND_SHADER_SPIRV_FULL_PATH(spirvName))) {
+            compiledShaderNames.emplace_back(spirvName);
+        }
+    }
+
+    if (compiledShaderNames.empty()) {
+        return;
+    }
+
+    std::scoped_lock lock(s_reloadedShaderNamesMutex);
+    s_reloadedShaderNames.insert(s_reloadedShaderNames.end(), compiledShaderNames.begin(), compiledShaderNames.end());
+}
+
+
+static void CreateShaderFileWatcher()
+{
+    const std::array shaderDirs = { fs::path(SHADERS_SOURCE_DIR), fs::path(SHADERS_INCLUDE_DIR) };
+    s_shaderFileWatcher.Create(shaderDirs, OnShaderFilesChanged);
+}
+
+
+// Rebuilds PSOs which use recompiled shaders. Called at frame boundary, since old PSOs can be used by frames in flight
+static void ApplyReloadedShaders()
+{
+    std::vector<std::string> reloadedShaderNames;
+
+    {
+        std::scoped_lock lock(s_reloadedShaderNamesMutex);
+        std::swap(reloadedShaderNames, s_reloadedShaderNames);
+    }
+
+    if (reloadedShaderNames.empty()) {
+        return;
+    }
+
+    ENG_PROFILE_SCOPED_MARKER_C(0x8b0000, "Apply_Reloaded_Shaders");
+
+    s_vkDevice.WaitIdle();
+
+    PSOBuildContext ctx;
+    ctx.computePSOBuilder.SetCache(&s_PSOCache);
+    ctx.graphicsPSOBuilder.SetCache(&s_PSOCache);
+
+    for (const PSOBuildJob& job : GetPSOBuildJobs()) {
+        const bool isReloaded = std::ranges::any_of(job.shaderNames, [&](std::string_view name) {
+            return std::ranges::find(reloadedShaderNames, name) != reloadedShaderNames.cend();
+        });
+
+        if (isReloaded) {
+            RunPSOBuildJob(ctx, job);
+            CORE_LOG_INFO("PSO with %s is reloaded", job.shaderNames[0].data());
+        }
+    }
+}
+#endif
+
+
+// Every block of sorted elements has its own histogram
+static size_t GetRadixSortHistogramCount(size_t maxElemCount)
+{
+    const size_t blockCount = (maxElemCount + RADIX_SORT_BLOCK_SIZE - 1) / RADIX_SORT_BLOCK_SIZE;
+    return std::max<size_t>(blockCount, 1) * RADIX_SORT_DIGIT_COUNT;
+}
+
+
+// Every (mesh, LOD) pair has its own bin
+static size_t GetGeomBatchBinCount()
+{
+    return s_cpuMeshData.size() * COMMON_MAX_GEOM_LOD_COUNT;
+}
+
+
+static void CreateGeomCullingAndInstancingResources()
+{
+    vkn::AllocationInfo allocInfo = {};
+    allocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    s_geomCullVisSortKeysBuffer.Create(
+        &s_vkDevice, 
+        s_cpuInstData.size() * sizeof(GPU_GeomSortKey), 
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_geomCullVisSortKeysBuffer, "GEOM_CULL_VIS_SORT_KEYS_BUFFER");
+
+    s_geomCullVisSortKeysCounterBuffer.Create(
+        &s_vkDevice,
+        sizeof(glm::uint), 
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT,
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_geomCullVisSortKeysCounterBuffer, "GEOM_CULL_VIS_SORT_KEYS_COUNTER_BUFFER");
+
+    s_geomCullVisGeomIDsBuffer.Create(
+        &s_vkDevice, 
+        s_cpuInstData.size() * sizeof(glm::uint), 
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_geomCullVisGeomIDsBuffer, "GEOM_CULL_VIS_GEOM_IDS_BUFFER");
+
+    s_geomCullPerGeomMatTypeCountersBuffer.Create(
+        &s_vkDevice,
+        GEOM_MAT_TYPE_COUNT * sizeof(glm::uint), 
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT,
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_geomCullPerGeomMatTypeCountersBuffer, "GEOM_CULL_PER_GEOM_MAT_TYPE_COUNTERS_BUFFER");
+
+    s_geomCullInstVisibilityBuffer.Create(
+        &s_vkDevice,
+        s_cpuInstData.size() * sizeof(glm::uint), 
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT,
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_geomCullInstVisibilityBuffer, "GEOM_CULL_INST_VISIBILITY_BUFFER");
+
+    s_geomCullInstVisibilityResetRequired = true;
+
+    s_geomRadixSortTmpKeysBuffer.Create(
+        &s_vkDevice, 
+        s_cpuInstData.size() * sizeof(GPU_GeomSortKey), 
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_geomRadixSortTmpKeysBuffer, "GEOM_RADIX_SORT_TMP_KEYS_BUFFER");
+
+    s_geomRadixSortTmpGeomIDsBuffer.Create(
+        &s_vkDevice, 
+        s_cpuInstData.size() * sizeof(glm::uint), 
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_geomRadixSortTmpGeomIDsBuffer, "GEOM_RADIX_SORT_TMP_GEOM_IDS_BUFFER");
+
+    s_radixSortHistogramsBuffer.Create(
+        &s_vkDevice,
+        GetRadixSortHistogramCount(s_cpuInstData.size()) * sizeof(glm::uint),
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT,
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_radixSortHistogramsBuffer, "RADIX_SORT_HISTOGRAMS_BUFFER");
+
+    s_radixSortDispatchArgsBuffer.Create(
+        &s_vkDevice,
+        sizeof(GPU_CmdDispatchIndirect),
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_INDIRECT_BUFFER_BIT,
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_radixSortDispatchArgsBuffer, "RADIX_SORT_DISPATCH_ARGS_BUFFER");
+
+    s_radixSortMaxElemCount = s_cpuInstData.size();
+
+    const size_t phaseQueueCapacity = s_cpuInstData.size() * GEOM_CULLING_PHASE_COUNT;
+
+    for (size_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
+        // TODO: we can caclulate actual instance count for certain queue during scene loading and allocate buffers with that sizes
+        s_geomBatchQueueBuffer[queue].Create(
+            &s_vkDevice, 
+            phaseQueueCapacity * sizeof(GPU_GeomBatch), 
+            VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
+            allocInfo
+        );
+        s_vkDevice.SetObjDebugName(s_geomBatchQueueBuffer[queue], "%s_BATCH_BUFFER", GEOM_QUEUE_DBG_NAMES[queue]);
+
+        s_sortedVisGeomIDQueueBuffer[queue].Create(
             &s_vkDevice, 
-            s_cpuInstData.size() * sizeof(glm::uint), 
+            phaseQueueCapacity * sizeof(glm::uint), 
             VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
             allocInfo
         );
@@ -4423,23 +5573,15 @@ static void CreateGeomCullingAndInstancingResources()
 
         s_geomDrawCmdQueueBuffer[queue].Create(
             &s_vkDevice,
-            s_cpuInstData.size() * sizeof(GPU_CmdDrawIndexedIndirect),
+            phaseQueueCapacity * sizeof(GPU_CmdDrawIndexedIndirect),
             VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_INDIRECT_BUFFER_BIT,
             allocInfo
         );
         s_vkDevice.SetObjDebugName(s_geomDrawCmdQueueBuffer[queue], "%s_DRAW_CMD_BUFFER", GEOM_QUEUE_DBG_NAMES[queue]);
         
-        s_visGeomIDQueueSizeBuffer[queue].Create(
-            &s_vkDevice,
-            sizeof(glm::uint), 
-            VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT | VK_BUFFER_USAGE_2_INDIRECT_BUFFER_BIT,
-            allocInfo
-        );
-        s_vkDevice.SetObjDebugName(s_visGeomIDQueueSizeBuffer[queue], "%s_VIS_INST_ID_QUEUE_SIZE_BUFFER", GEOM_QUEUE_DBG_NAMES[queue]);
-
         s_geomBatchQueueSizeBuffer[queue].Create(
             &s_vkDevice,
-            sizeof(glm::uint), 
+            GEOM_CULLING_PHASE_COUNT * sizeof(glm::uint), 
             VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT | VK_BUFFER_USAGE_2_INDIRECT_BUFFER_BIT,
             allocInfo
         );
@@ -4447,12 +5589,39 @@ static void CreateGeomCullingAndInstancingResources()
 
         s_sortedVisGeomIDQueueSizeBuffer[queue].Create(
             &s_vkDevice,
-            sizeof(glm::uint), 
+            GEOM_CULLING_PHASE_COUNT * sizeof(glm::uint), 
             VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT | VK_BUFFER_USAGE_2_INDIRECT_BUFFER_BIT,
             allocInfo
         );
         s_vkDevice.SetObjDebugName(s_sortedVisGeomIDQueueSizeBuffer[queue], "%s_SORTED_VIS_INST_ID_QUEUE_SIZE_BUFFER", GEOM_QUEUE_DBG_NAMES[queue]);
     }
+
+    CORE_ASSERT_MSG(s_cpuMeshData.size() <= (1ull << GPU_GeomSortKey::GEOM_SORT_MESH_BITS), "Mesh count %zu exceeds GPU batching limit", s_cpuMeshData.size());
+
+    s_geomBatchBinCountersBuffer.Create(
+        &s_vkDevice,
+        GetGeomBatchBinCount() * sizeof(glm::uint),
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT,
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_geomBatchBinCountersBuffer, "GEOM_BATCH_BIN_COUNTERS_BUFFER");
+
+    s_geomBatchBinOffsetsBuffer.Create(
+        &s_vkDevice,
+        GetGeomBatchBinCount() * sizeof(glm::uint),
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT,
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_geomBatchBinOffsetsBuffer, "GEOM_BATCH_BIN_OFFSETS_BUFFER");
+
+    // CSM visible instance queues are the biggest ones, since they contain entries of all cascades
+    s_geomBatchInstBinsBuffer.Create(
+        &s_vkDevice,
+        COMMON_CSM_CASCADE_COUNT * s_cpuInstData.size() * sizeof(glm::uvec2),
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT,
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_geomBatchInstBinsBuffer, "GEOM_BATCH_INST_BINS_BUFFER");
 }
 
 
@@ -4462,64 +5631,68 @@ static void CreateCSMResources()
     allocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
     allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 
-    for (size_t cascade = 0; cascade < COMMON_CSM_CASCADE_COUNT; ++cascade) {
+    CORE_ASSERT_MSG(s_cpuInstData.size() <= (1ull << GEOM_CSM_VIS_INST_CASCADE_OFFSET), "Instance ID doesn't fit packed CSM visible instance entry");
+
+    for (size_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
+        const size_t csmQueueCapacity = CSMGetVisInstQueueCapacity((GPU_CsmGeomType)geomType);
+
         for (size_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
             // TODO: we can caclulate actual instance count for certain queue during scene loading and allocate buffers with that sizes
-            s_csmVisGeomIDQueueBuffers[cascade][queue].Create(
+            s_csmVisGeomIDQueueBuffers[geomType][queue].Create(
                 &s_vkDevice, 
-                s_cpuInstData.size() * sizeof(glm::uint), 
+                csmQueueCapacity * sizeof(glm::uint), 
                 VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
                 allocInfo
             );
-            s_vkDevice.SetObjDebugName(s_csmVisGeomIDQueueBuffers[cascade][queue], "%s_CSM_VIS_INST_ID_BUFFER_%zu", GEOM_QUEUE_DBG_NAMES[queue], cascade);
-            
-            s_csmGeomBatchQueueBuffers[cascade][queue].Create(
+            s_vkDevice.SetObjDebugName(s_csmVisGeomIDQueueBuffers[geomType][queue], "%s_%s_CSM_VIS_INST_ID_BUFFER", CSM_GEOM_TYPE_DBG_NAMES[geomType], GEOM_QUEUE_DBG_NAMES[queue]);
+        
+            s_csmGeomBatchQueueBuffers[geomType][queue].Create(
                 &s_vkDevice, 
-                s_cpuInstData.size() * sizeof(GPU_GeomBatch), 
+                csmQueueCapacity * sizeof(GPU_GeomBatch), 
                 VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
                 allocInfo
             );
-            s_vkDevice.SetObjDebugName(s_csmGeomBatchQueueBuffers[cascade][queue], "%s_CSM_BATCH_BUFFER_%zu", GEOM_QUEUE_DBG_NAMES[queue], cascade);
+            s_vkDevice.SetObjDebugName(s_csmGeomBatchQueueBuffers[geomType][queue], "%s_%s_CSM_BATCH_BUFFER", CSM_GEOM_TYPE_DBG_NAMES[geomType], GEOM_QUEUE_DBG_NAMES[queue]);
 
-            s_csmSortedVisGeomIDQueueBuffers[cascade][queue].Create(
+            s_csmSortedVisGeomIDQueueBuffers[geomType][queue].Create(
                 &s_vkDevice, 
-                s_cpuInstData.size() * sizeof(glm::uint), 
+                csmQueueCapacity * sizeof(glm::uint), 
                 VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
                 allocInfo
             );
-            s_vkDevice.SetObjDebugName(s_csmSortedVisGeomIDQueueBuffers[cascade][queue], "%s_CSM_SORTED_VIS_INST_ID_BUFFER_%zu", GEOM_QUEUE_DBG_NAMES[queue], cascade);
+            s_vkDevice.SetObjDebugName(s_csmSortedVisGeomIDQueueBuffers[geomType][queue], "%s_%s_CSM_SORTED_VIS_INST_ID_BUFFER", CSM_GEOM_TYPE_DBG_NAMES[geomType], GEOM_QUEUE_DBG_NAMES[queue]);
 
-            s_csmGeomDrawCmdQueueBuffers[cascade][queue].Create(
+            s_csmGeomDrawCmdQueueBuffers[geomType][queue].Create(
                 &s_vkDevice,
-                s_cpuInstData.size() * sizeof(GPU_CmdDrawIndexedIndirect),
+                csmQueueCapacity * sizeof(GPU_CmdDrawIndexedIndirect),
                 VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_INDIRECT_BUFFER_BIT,
                 allocInfo
             );
-            s_vkDevice.SetObjDebugName(s_csmGeomDrawCmdQueueBuffers[cascade][queue], "%s_CSM_DRAW_CMD_BUFFER_%zu", GEOM_QUEUE_DBG_NAMES[queue], cascade);
-            
-            s_csmVisGeomIDQueueSizeBuffers[cascade][queue].Create(
+            s_vkDevice.SetObjDebugName(s_csmGeomDrawCmdQueueBuffers[geomType][queue], "%s_%s_CSM_DRAW_CMD_BUFFER", CSM_GEOM_TYPE_DBG_NAMES[geomType], GEOM_QUEUE_DBG_NAMES[queue]);
+        
+            s_csmVisGeomIDQueueSizeBuffers[geomType][queue].Create(
                 &s_vkDevice,
                 sizeof(glm::uint), 
                 VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT | VK_BUFFER_USAGE_2_INDIRECT_BUFFER_BIT,
                 allocInfo
             );
-            s_vkDevice.SetObjDebugName(s_csmVisGeomIDQueueSizeBuffers[cascade][queue], "%s_CSM_VIS_INST_ID_QUEUE_SIZE_BUFFER_%zu", GEOM_QUEUE_DBG_NAMES[queue], cascade);
+            s_vkDevice.SetObjDebugName(s_csmVisGeomIDQueueSizeBuffers[geomType][queue], "%s_%s_CSM_VIS_INST_ID_QUEUE_SIZE_BUFFER", CSM_GEOM_TYPE_DBG_NAMES[geomType], GEOM_QUEUE_DBG_NAMES[queue]);
 
-            s_csmGeomBatchQueueSizeBuffers[cascade][queue].Create(
+            s_csmGeomBatchQueueSizeBuffers[geomType][queue].Create(
                 &s_vkDevice,
                 sizeof(glm::uint), 
                 VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT | VK_BUFFER_USAGE_2_INDIRECT_BUFFER_BIT,
                 allocInfo
             );
-            s_vkDevice.SetObjDebugName(s_csmGeomBatchQueueSizeBuffers[cascade][queue], "%s_CSM_BATCH_QUEUE_SIZE_BUFFER_%zu", GEOM_QUEUE_DBG_NAMES[queue], cascade);
+            s_vkDevice.SetObjDebugName(s_csmGeomBatchQueueSizeBuffers[geomType][queue], "%s_%s_CSM_BATCH_QUEUE_SIZE_BUFFER", CSM_GEOM_TYPE_DBG_NAMES[geomType], GEOM_QUEUE_DBG_NAMES[queue]);
 
-            s_csmSortedVisGeomIDQueueSizeBuffers[cascade][queue].Create(
+            s_csmSortedVisGeomIDQueueSizeBuffers[geomType][queue].Create(
                 &s_vkDevice,
                 sizeof(glm::uint), 
                 VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT | VK_BUFFER_USAGE_2_INDIRECT_BUFFER_BIT,
                 allocInfo
             );
-            s_vkDevice.SetObjDebugName(s_csmSortedVisGeomIDQueueSizeBuffers[cascade][queue], "%s_CSM_SORTED_VIS_INST_ID_QUEUE_SIZE_BUFFER_%zu", GEOM_QUEUE_DBG_NAMES[queue], cascade);
+            s_vkDevice.SetObjDebugName(s_csmSortedVisGeomIDQueueSizeBuffers[geomType][queue], "%s_%s_CSM_SORTED_VIS_INST_ID_QUEUE_SIZE_BUFFER", CSM_GEOM_TYPE_DBG_NAMES[geomType], GEOM_QUEUE_DBG_NAMES[queue]);
         }
     }
 
@@ -4533,7 +5706,7 @@ static void CreateCSMResources()
     rtCreateInfo.mipLevels = 1;
     rtCreateInfo.arrayLayers = COMMON_CSM_CASCADE_COUNT;
     rtCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-    rtCreateInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    rtCreateInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
     rtCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
     rtCreateInfo.pAllocInfo = &allocInfo;
 
@@ -4542,18 +5715,6 @@ static void CreateCSMResources()
 
     VkComponentMapping mapping = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
 
-    for (size_t cascade = 0; cascade < COMMON_CSM_CASCADE_COUNT; ++cascade) {
-        VkImageSubresourceRange subresourceRange = {};
-        subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-        subresourceRange.baseMipLevel = 0;
-        subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
-        subresourceRange.baseArrayLayer = cascade;
-        subresourceRange.layerCount = 1;
-
-        s_csmRTViews[cascade].Create(s_csmRT, mapping, subresourceRange);
-        s_vkDevice.SetObjDebugName(s_csmRTViews[cascade], "CSM_DEPTH_RT_VIEW_%zu", cascade);
-    }
-
     vkn::TextureViewCreateInfo csmRTViewArrayCreateInfo = {};
     csmRTViewArrayCreateInfo.pOwner = &s_csmRT;
     csmRTViewArrayCreateInfo.type = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
@@ -4567,49 +5728,183 @@ static void CreateCSMResources()
 
     s_csmRTViewArray.Create(csmRTViewArrayCreateInfo);
     s_vkDevice.SetObjDebugName(s_csmRTViewArray, "CSM_DEPTH_RT_VIEW_ARRAY");
+
+    rtCreateInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    s_csmStaticCacheRT.Create(rtCreateInfo);
+    s_vkDevice.SetObjDebugName(s_csmStaticCacheRT, "CSM_STATIC_CACHE_DEPTH_RT");
+
+    csmRTViewArrayCreateInfo.pOwner = &s_csmStaticCacheRT;
+
+    s_csmStaticCacheRTViewArray.Create(csmRTViewArrayCreateInfo);
+    s_vkDevice.SetObjDebugName(s_csmStaticCacheRTViewArray, "CSM_STATIC_CACHE_DEPTH_RT_VIEW_ARRAY");
+
+    for (CsmStaticCacheState& state : s_csmStaticCacheStates) {
+        state.isValid = false;
+    }
 }
 
 
-static void CreateCommonSamplers()
+// Levels share depth range which covers the whole scene, so light space depth of static geometry never changes
+static void VSMComputeSceneDepthRange()
 {
-    s_commonSamplers.resize(SAMPLER_IDX_COUNT);
+    const glm::float3x3 lightRot = glm::float3x3(glm::lookAt(ZEROF3, SUN_LIGHT_DIR, M3D_AXIS_Y));
 
-    std::vector<vkn::SamplerCreateInfo> samplerCreateInfo(SAMPLER_IDX_COUNT);
+    glm::float3 sceneMinLS = glm::float3(FLT_MAX);
+    glm::float3 sceneMaxLS = glm::float3(-FLT_MAX);
 
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].pDevice = &s_vkDevice;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].magFilter = VK_FILTER_NEAREST;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].minFilter = VK_FILTER_NEAREST;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].mipLodBias = 0.f;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].anisotropyEnable = VK_FALSE;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].compareEnable = VK_FALSE;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].minLod = 0.f;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].maxLod = VK_LOD_CLAMP_NONE;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].unnormalizedCoordinates = VK_FALSE;
+    for (const GPU_GeomInst& inst : s_cpuInstData) {
+        const math::AABB aabb = inst.GetAABB_WCS();
 
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRRORED_REPEAT] = samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT];
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRRORED_REPEAT].addressModeU = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRRORED_REPEAT].addressModeV = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRRORED_REPEAT].addressModeW = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+        for (uint32_t i = 0; i < 8; ++i) {
+            const glm::float3 corner = glm::float3(
+                MATH_IS_BIT_SET(i, 0) ? aabb.max.x : aabb.min.x,
+                MATH_IS_BIT_SET(i, 1) ? aabb.max.y : aabb.min.y,
+                MATH_IS_BIT_SET(i, 2) ? aabb.max.z : aabb.min.z
+            );
 
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_EDGE] = samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT];
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_EDGE].addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_EDGE].addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_EDGE].addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            const glm::float3 cornerLS = lightRot * corner;
 
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_BORDER] = samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT];
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_BORDER].addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_BORDER].addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_BORDER].addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_BORDER].borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+            sceneMinLS = glm::min(sceneMinLS, cornerLS);
+            sceneMaxLS = glm::max(sceneMaxLS, cornerLS);
+        }
+    }
 
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRROR_CLAMP_TO_EDGE] = samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT];
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRROR_CLAMP_TO_EDGE].addressModeU = VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRROR_CLAMP_TO_EDGE].addressModeV = VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE;
-    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRROR_CLAMP_TO_EDGE].addressModeW = VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE;
+    if (s_cpuInstData.empty()) {
+        sceneMinLS = sceneMaxLS = ZEROF3;
+    }
+
+    s_vsmSceneCenterLS = (sceneMinLS + sceneMaxLS) * 0.5f;
+    s_vsmDepthRange = sceneMaxLS.z - sceneMinLS.z + 2.f * VSM_DEPTH_RANGE_MARGIN;
+}
+
+
+static void CreateVSMResources()
+{
+    vkn::AllocationInfo allocInfo = {};
+    allocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    s_vsmPageTableBuffer.Create(&s_vkDevice, COMMON_VSM_PAGE_TABLE_SIZE * sizeof(glm::uvec2), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
+    s_vkDevice.SetObjDebugName(s_vsmPageTableBuffer, "VSM_PAGE_TABLE_BUFFER");
+
+    s_vsmPhysPageLastUsedFrameBuffer.Create(&s_vkDevice, COMMON_VSM_PHYS_PAGE_COUNT * sizeof(glm::uint), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
+    s_vkDevice.SetObjDebugName(s_vsmPhysPageLastUsedFrameBuffer, "VSM_PHYS_PAGE_LAST_USED_FRAME_BUFFER");
+
+    s_vsmFreeListBuffer.Create(&s_vkDevice, COMMON_VSM_PHYS_PAGE_COUNT * sizeof(glm::uint), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
+    s_vkDevice.SetObjDebugName(s_vsmFreeListBuffer, "VSM_FREE_LIST_BUFFER");
+
+    s_vsmFreeListCounterBuffer.Create(&s_vkDevice, sizeof(int32_t), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
+    s_vkDevice.SetObjDebugName(s_vsmFreeListCounterBuffer, "VSM_FREE_LIST_COUNTER_BUFFER");
+
+    s_vsmDirtyListBuffer.Create(&s_vkDevice, COMMON_VSM_PHYS_PAGE_COUNT * sizeof(glm::uint), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
+    s_vkDevice.SetObjDebugName(s_vsmDirtyListBuffer, "VSM_DIRTY_LIST_BUFFER");
+
+    s_vsmClearDispatchArgsBuffer.Create(
+        &s_vkDevice, 
+        sizeof(GPU_CmdDispatchIndirect), 
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_INDIRECT_BUFFER_BIT, 
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_vsmClearDispatchArgsBuffer, "VSM_CLEAR_DISPATCH_ARGS_BUFFER");
+
+    s_vsmDirtyPageRectsBuffer.Create(&s_vkDevice, COMMON_VSM_LEVEL_COUNT * sizeof(glm::uvec4), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
+    s_vkDevice.SetObjDebugName(s_vsmDirtyPageRectsBuffer, "VSM_DIRTY_PAGE_RECTS_BUFFER");
+
+    vkn::TextureCreateInfo poolCreateInfo = {};
+    poolCreateInfo.pDevice = &s_vkDevice;
+    poolCreateInfo.type = VK_IMAGE_TYPE_2D;
+    poolCreateInfo.format = VK_FORMAT_R32_UINT;
+    poolCreateInfo.extent = VkExtent3D{ VSM_PHYS_POOL_SIZE, VSM_PHYS_POOL_SIZE, 1u };
+    poolCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    poolCreateInfo.flags = 0;
+    poolCreateInfo.mipLevels = 1;
+    poolCreateInfo.arrayLayers = 1;
+    poolCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    poolCreateInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    poolCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    poolCreateInfo.pAllocInfo = &allocInfo;
+
+    s_vsmPhysPool.Create(poolCreateInfo);
+    s_vkDevice.SetObjDebugName(s_vsmPhysPool, "VSM_PHYS_POOL");
+
+    VkComponentMapping mapping = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
+
+    VkImageSubresourceRange subresourceRange = {};
+    subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    subresourceRange.baseMipLevel = 0;
+    subresourceRange.levelCount = 1;
+    subresourceRange.baseArrayLayer = 0;
+    subresourceRange.layerCount = 1;
+
+    s_vsmPhysPoolView.Create(s_vsmPhysPool, mapping, subresourceRange);
+    s_vkDevice.SetObjDebugName(s_vsmPhysPoolView, "VSM_PHYS_POOL_VIEW");
+
+    VSMComputeSceneDepthRange();
+
+    s_vsmResetRequired = true;
+}
+
+
+static void CreateLightCullingResources()
+{
+    vkn::AllocationInfo allocInfo = {};
+    allocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    s_lightClusterLightCountsBuffer.Create(&s_vkDevice, COMMON_LIGHT_CLUSTER_COUNT * sizeof(glm::uint), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, allocInfo);
+    s_vkDevice.SetObjDebugName(s_lightClusterLightCountsBuffer, "LIGHT_CLUSTER_LIGHT_COUNTS_BUFFER");
+
+    s_lightClusterLightIndicesBuffer.Create(
+        &s_vkDevice, 
+        COMMON_LIGHT_CLUSTER_COUNT * COMMON_LIGHT_CLUSTER_MAX_LIGHT_COUNT * sizeof(glm::uint), 
+        VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT, 
+        allocInfo
+    );
+    s_vkDevice.SetObjDebugName(s_lightClusterLightIndicesBuffer, "LIGHT_CLUSTER_LIGHT_INDICES_BUFFER");
+}
+
+
+static void CreateCommonSamplers()
+{
+    s_commonSamplers.resize(SAMPLER_IDX_COUNT);
+
+    std::vector<vkn::SamplerCreateInfo> samplerCreateInfo(SAMPLER_IDX_COUNT);
+
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].pDevice = &s_vkDevice;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].magFilter = VK_FILTER_NEAREST;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].minFilter = VK_FILTER_NEAREST;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].mipLodBias = 0.f;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].anisotropyEnable = VK_FALSE;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].compareEnable = VK_FALSE;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].minLod = 0.f;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].maxLod = VK_LOD_CLAMP_NONE;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT].unnormalizedCoordinates = VK_FALSE;
+
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRRORED_REPEAT] = samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT];
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRRORED_REPEAT].addressModeU = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRRORED_REPEAT].addressModeV = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRRORED_REPEAT].addressModeW = VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_EDGE] = samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT];
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_EDGE].addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_EDGE].addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_EDGE].addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_BORDER] = samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT];
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_BORDER].addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_BORDER].addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_BORDER].addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_CLAMP_TO_BORDER].borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRROR_CLAMP_TO_EDGE] = samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT];
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRROR_CLAMP_TO_EDGE].addressModeU = VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRROR_CLAMP_TO_EDGE].addressModeV = VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE;
+    samplerCreateInfo[SAMPLER_IDX_NEAREST_MIRROR_CLAMP_TO_EDGE].addressModeW = VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE;
 
     samplerCreateInfo[SAMPLER_IDX_LINEAR_REPEAT] = samplerCreateInfo[SAMPLER_IDX_NEAREST_REPEAT];
     samplerCreateInfo[SAMPLER_IDX_LINEAR_REPEAT].magFilter = VK_FILTER_LINEAR;
@@ -4765,27 +6060,52 @@ static void CreateCommonSMSamplers()
 }
 
 
-static void WriteGeomCullingDescriptorSet(GPU_GeomQueue queue)
+// Writes descriptor which doesn't depend on frame in flight into descriptor buffers of all frames
+template <typename... Args>
+static void WriteSharedDescriptor(uint32_t setID, uint32_t binding, uint32_t elemIdx, const Args&... args)
+{
+    for (vkn::DescriptorBuffer& descBuffer : s_descriptorBuffers) {
+        descBuffer.WriteDescriptor(setID, binding, elemIdx, args...);
+    }
+}
+
+
+static void WriteGeomCullingDescriptorSet()
 {
-    CORE_ASSERT(queue < GEOM_QUEUE_COUNT);
-    
     const DescSetID setID = DESC_SET_ID_GEOM_CULLING;
 
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_CULL_VIS_INST_ID_QUEUES_UAV_DESCRIPTOR_SLOT, queue, s_visGeomIDQueueBuffer[queue]);
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_CULL_VIS_INST_ID_QUEUE_SIZES_UAV_DESCRIPTOR_SLOT, queue, s_visGeomIDQueueSizeBuffer[queue]);
+    WriteSharedDescriptor(setID, GEOM_CULL_VIS_SORT_KEYS_UAV_DESCRIPTOR_SLOT, 0, s_geomCullVisSortKeysBuffer);
+    WriteSharedDescriptor(setID, GEOM_CULL_VIS_SORT_KEYS_COUNTER_UAV_DESCRIPTOR_SLOT, 0, s_geomCullVisSortKeysCounterBuffer);
+    WriteSharedDescriptor(setID, GEOM_CULL_VIS_GEOM_IDS_UAV_DESCRIPTOR_SLOT, 0, s_geomCullVisGeomIDsBuffer);
+    WriteSharedDescriptor(setID, GEOM_CULL_PER_GEOM_MAT_TYPE_COUNTERS_UAV_DESCRIPTOR_SLOT, 0, s_geomCullPerGeomMatTypeCountersBuffer);
+    WriteSharedDescriptor(setID, GEOM_CULL_INST_VISIBILITY_UAV_DESCRIPTOR_SLOT, 0, s_geomCullInstVisibilityBuffer);
+}
+
+
+// Sorts src buffers into dst ones. Elements count is read from the first uint of elemCountBuffer
+static void WriteRadixSortDescriptorSet(DescSetID setID, vkn::Buffer& srcKeys, vkn::Buffer& srcPayloads, 
+    vkn::Buffer& dstKeys, vkn::Buffer& dstPayloads, vkn::Buffer& elemCountBuffer)
+{
+    WriteSharedDescriptor(setID, RADIX_SORT_SRC_KEYS_DESCRIPTOR_SLOT, 0, srcKeys);
+    WriteSharedDescriptor(setID, RADIX_SORT_SRC_PAYLOADS_DESCRIPTOR_SLOT, 0, srcPayloads);
+    
+    WriteSharedDescriptor(setID, RADIX_SORT_DST_KEYS_UAV_DESCRIPTOR_SLOT, 0, dstKeys);
+    WriteSharedDescriptor(setID, RADIX_SORT_DST_PAYLOADS_UAV_DESCRIPTOR_SLOT, 0, dstPayloads);
     
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_CULL_VIS_SORT_KEYS_UAV_DESCRIPTOR_SLOT, 0, s_geomCullVisSortKeysBuffer);
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_CULL_VIS_SORT_KEYS_COUNTER_UAV_DESCRIPTOR_SLOT, 0, s_geomCullVisSortKeysCounterBuffer);
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_CULL_VIS_GEOM_IDS_UAV_DESCRIPTOR_SLOT, 0, s_geomCullVisGeomIDsBuffer);
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_CULL_PER_GEOM_MAT_TYPE_COUNTERS_UAV_DESCRIPTOR_SLOT, 0, s_geomCullPerGeomMatTypeCountersBuffer);
+    WriteSharedDescriptor(setID, RADIX_SORT_ELEM_COUNT_DESCRIPTOR_SLOT, 0, elemCountBuffer);
+    
+    WriteSharedDescriptor(setID, RADIX_SORT_HISTOGRAMS_UAV_DESCRIPTOR_SLOT, 0, s_radixSortHistogramsBuffer);
+    WriteSharedDescriptor(setID, RADIX_SORT_DISPATCH_ARGS_UAV_DESCRIPTOR_SLOT, 0, s_radixSortDispatchArgsBuffer);
 }
 
 
-static void WriteGeomCullingDescriptorSet()
+static void WriteGeomRadixSortDescriptorSet()
 {
-    for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
-        WriteGeomCullingDescriptorSet((GPU_GeomQueue)queue);
-    }
+    WriteRadixSortDescriptorSet(DESC_SET_ID_GEOM_RADIX_SORT_EVEN_PASS, s_geomCullVisSortKeysBuffer, s_geomCullVisGeomIDsBuffer, 
+        s_geomRadixSortTmpKeysBuffer, s_geomRadixSortTmpGeomIDsBuffer, s_geomCullVisSortKeysCounterBuffer);
+
+    WriteRadixSortDescriptorSet(DESC_SET_ID_GEOM_RADIX_SORT_ODD_PASS, s_geomRadixSortTmpKeysBuffer, s_geomRadixSortTmpGeomIDsBuffer,
+        s_geomCullVisSortKeysBuffer, s_geomCullVisGeomIDsBuffer, s_geomCullVisSortKeysCounterBuffer);
 }
 
 
@@ -4804,14 +6124,22 @@ static void WriteGeomBatchingDescriptorSet(GPU_GeomQueue queue)
             break;
     }
 
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_BATCH_VIS_INST_ID_QUEUE_DESCRIPTOR_SLOT, 0, s_visGeomIDQueueBuffer[queue]);
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_BATCH_VIS_INST_ID_QUEUE_SIZE_DESCRIPTOR_SLOT, 0, s_visGeomIDQueueSizeBuffer[queue]);
+    // Main view batches radix sorted instances of all material types
+    WriteSharedDescriptor(setID, GEOM_BATCH_VIS_INST_ID_QUEUE_DESCRIPTOR_SLOT, 0, s_geomCullVisGeomIDsBuffer);
+    WriteSharedDescriptor(setID, GEOM_BATCH_VIS_INST_ID_QUEUE_SIZE_DESCRIPTOR_SLOT, 0, s_geomCullVisSortKeysCounterBuffer);
     
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_BATCH_BATCH_QUEUE_UAV_DESCRIPTOR_SLOT, 0, s_geomBatchQueueBuffer[queue]);
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_BATCH_BATCH_QUEUE_SIZE_UAV_DESCRIPTOR_SLOT, 0, s_geomBatchQueueSizeBuffer[queue]);
+    WriteSharedDescriptor(setID, GEOM_BATCH_BATCH_QUEUE_UAV_DESCRIPTOR_SLOT, 0, s_geomBatchQueueBuffer[queue]);
+    WriteSharedDescriptor(setID, GEOM_BATCH_BATCH_QUEUE_SIZE_UAV_DESCRIPTOR_SLOT, 0, s_geomBatchQueueSizeBuffer[queue]);
+
+    WriteSharedDescriptor(setID, GEOM_BATCH_SORTED_VIS_INST_ID_QUEUE_UAV_DESCRIPTOR_SLOT, 0, s_sortedVisGeomIDQueueBuffer[queue]);
+    WriteSharedDescriptor(setID, GEOM_BATCH_SORTED_VIS_INST_ID_QUEUE_SIZE_UAV_DESCRIPTOR_SLOT, 0, s_sortedVisGeomIDQueueSizeBuffer[queue]);
+
+    WriteSharedDescriptor(setID, GEOM_BATCH_BIN_COUNTERS_UAV_DESCRIPTOR_SLOT, 0, s_geomBatchBinCountersBuffer);
+    WriteSharedDescriptor(setID, GEOM_BATCH_BIN_OFFSETS_UAV_DESCRIPTOR_SLOT, 0, s_geomBatchBinOffsetsBuffer);
+    WriteSharedDescriptor(setID, GEOM_BATCH_INST_BINS_UAV_DESCRIPTOR_SLOT, 0, s_geomBatchInstBinsBuffer);
 
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_BATCH_SORTED_VIS_INST_ID_QUEUE_UAV_DESCRIPTOR_SLOT, 0, s_sortedVisGeomIDQueueBuffer[queue]);
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_BATCH_SORTED_VIS_INST_ID_QUEUE_SIZE_UAV_DESCRIPTOR_SLOT, 0, s_sortedVisGeomIDQueueSizeBuffer[queue]);
+    WriteSharedDescriptor(setID, GEOM_BATCH_SORTED_KEYS_DESCRIPTOR_SLOT, 0, s_geomCullVisSortKeysBuffer);
+    WriteSharedDescriptor(setID, GEOM_BATCH_PER_GEOM_MAT_TYPE_COUNTERS_DESCRIPTOR_SLOT, 0, s_geomCullPerGeomMatTypeCountersBuffer);
 }
 
 
@@ -4838,10 +6166,10 @@ static void WriteGeomDrawCmdGenDescriptorSet(GPU_GeomQueue queue)
             break;
     }
 
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_DRAW_CMD_GEN_BATCH_QUEUE_DESCRIPTOR_SLOT, 0, s_geomBatchQueueBuffer[queue]);
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_DRAW_CMD_GEN_BATCH_QUEUE_SIZE_DESCRIPTOR_SLOT, 0, s_geomBatchQueueSizeBuffer[queue]);
+    WriteSharedDescriptor(setID, GEOM_DRAW_CMD_GEN_BATCH_QUEUE_DESCRIPTOR_SLOT, 0, s_geomBatchQueueBuffer[queue]);
+    WriteSharedDescriptor(setID, GEOM_DRAW_CMD_GEN_BATCH_QUEUE_SIZE_DESCRIPTOR_SLOT, 0, s_geomBatchQueueSizeBuffer[queue]);
 
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_DRAW_CMD_GEN_CMD_QUEUE_UAV_DESCRIPTOR_SLOT, 0, s_geomDrawCmdQueueBuffer[queue]);
+    WriteSharedDescriptor(setID, GEOM_DRAW_CMD_GEN_CMD_QUEUE_UAV_DESCRIPTOR_SLOT, 0, s_geomDrawCmdQueueBuffer[queue]);
 }
 
 
@@ -4868,7 +6196,7 @@ static void WriteZPassDescriptorSet(GPU_GeomQueue queue)
             break;
     }
 
-    s_descriptorBuffer.WriteDescriptor(setID, ZPASS_INST_ID_QUEUE_DESCRIPTOR_SLOT, 0, s_sortedVisGeomIDQueueBuffer[queue]);
+    WriteSharedDescriptor(setID, ZPASS_INST_ID_QUEUE_DESCRIPTOR_SLOT, 0, s_sortedVisGeomIDQueueBuffer[queue]);
 }
 
 
@@ -4882,133 +6210,150 @@ static void WriteZPassDescriptorSet()
 
 static void WriteHZBGenDescriptorSets()
 {
-    for (uint32_t i = 0; i < s_HZB.GetMipCount(); ++i) {
-        vkn::TextureView& mip = s_HZBMipViews[i];
+    WriteSharedDescriptor(DESC_SET_ID_HZB_GEN, HZB_DEPTH_DESCRIPTOR_SLOT, 0, s_depthRTView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-        s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_HZB_GEN, HZB_SRC_MIPS_DESCRIPTOR_SLOT, i, mip, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-        s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_HZB_GEN, HZB_DST_MIPS_UAV_DESCRIPTOR_SLOT, i, mip, VK_IMAGE_LAYOUT_GENERAL);
+    for (uint32_t i = 0; i < s_HZB.GetMipCount(); ++i) {
+        WriteSharedDescriptor(DESC_SET_ID_HZB_GEN, HZB_DST_MIPS_UAV_DESCRIPTOR_SLOT, i, s_HZBMipViews[i], VK_IMAGE_LAYOUT_GENERAL);
     }
 
-    // First source mip must contain original depth buffer
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_HZB_GEN, HZB_SRC_MIPS_DESCRIPTOR_SLOT, 0, s_depthRTView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_HZB_GEN, HZB_SPD_COUNTER_UAV_DESCRIPTOR_SLOT, 0, s_hzbSpdCounterBuffer);
 }
 
 
-static void WriteCSMGeomCullingDescriptorSet(uint32_t cascade, GPU_GeomQueue queue)
+static void WriteCSMGeomCullingDescriptorSet(GPU_CsmGeomType geomType, GPU_GeomQueue queue)
 {
-    CORE_ASSERT(cascade < COMMON_CSM_CASCADE_COUNT);
+    CORE_ASSERT(geomType < CSM_GEOM_TYPE_COUNT);
     CORE_ASSERT(queue < GEOM_QUEUE_COUNT);
 
     static constexpr DescSetID descID = DESC_SET_ID_CSM_GEOM_CULLING;
-    const uint32_t index = CSMGetBufferIndex(cascade, queue);
+    const uint32_t index = CSMGetBufferIndex(geomType, queue);
 
-    s_descriptorBuffer.WriteDescriptor(descID, CSM_VIS_INST_ID_QUEUES_UAV_DESCRIPTOR_SLOT, 
-        index, s_csmVisGeomIDQueueBuffers[cascade][queue]);
+    WriteSharedDescriptor(descID, CSM_VIS_INST_ID_QUEUES_UAV_DESCRIPTOR_SLOT, 
+        index, s_csmVisGeomIDQueueBuffers[geomType][queue]);
 
-    s_descriptorBuffer.WriteDescriptor(descID, CSM_VIS_INST_ID_QUEUE_SIZES_UAV_DESCRIPTOR_SLOT, 
-        index, s_csmVisGeomIDQueueSizeBuffers[cascade][queue]);
+    WriteSharedDescriptor(descID, CSM_VIS_INST_ID_QUEUE_SIZES_UAV_DESCRIPTOR_SLOT, 
+        index, s_csmVisGeomIDQueueSizeBuffers[geomType][queue]);
 }
 
 
 static void WriteCSMGeomCullingDescriptorSet()
 {
-    for (uint32_t cascade = 0; cascade < COMMON_CSM_CASCADE_COUNT; ++cascade) {
+    for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
         for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
-            WriteCSMGeomCullingDescriptorSet(cascade, (GPU_GeomQueue)queue);
+            WriteCSMGeomCullingDescriptorSet((GPU_CsmGeomType)geomType, (GPU_GeomQueue)queue);
         }
     }
+
+    WriteSharedDescriptor(DESC_SET_ID_CSM_GEOM_CULLING, CSM_VSM_DIRTY_PAGE_RECTS_DESCRIPTOR_SLOT, 0, s_vsmDirtyPageRectsBuffer);
 }
 
 
-static void WriteCSMGeomBatchingDescriptorSet(uint32_t cascade, GPU_GeomQueue queue)
+static void WriteCSMGeomBatchingDescriptorSet(GPU_CsmGeomType geomType, GPU_GeomQueue queue)
 {
-    CORE_ASSERT(cascade < COMMON_CSM_CASCADE_COUNT);
+    CORE_ASSERT(geomType < CSM_GEOM_TYPE_COUNT);
     CORE_ASSERT(queue < GEOM_QUEUE_COUNT);
     
-    DescSetID setID;
-
-    switch(queue) {
-        case GEOM_QUEUE_OPAQUE:
-            setID = static_cast<DescSetID>(DESC_SET_ID_CSM_GEOM_BATCHING_OPAQUE_CASCADE_0 + cascade);
-            break;
-        case GEOM_QUEUE_AKILL:
-            setID = static_cast<DescSetID>(DESC_SET_ID_CSM_GEOM_BATCHING_AKILL_CASCADE_0 + cascade);
-            break;
-    }
+    const DescSetID setID = CSMGetGeomBatchingDescSetID(geomType, queue);
 
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_BATCH_VIS_INST_ID_QUEUE_DESCRIPTOR_SLOT, 0, s_csmVisGeomIDQueueBuffers[cascade][queue]);
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_BATCH_VIS_INST_ID_QUEUE_SIZE_DESCRIPTOR_SLOT, 0, s_csmVisGeomIDQueueSizeBuffers[cascade][queue]);
+    WriteSharedDescriptor(setID, GEOM_BATCH_VIS_INST_ID_QUEUE_DESCRIPTOR_SLOT, 0, s_csmVisGeomIDQueueBuffers[geomType][queue]);
+    WriteSharedDescriptor(setID, GEOM_BATCH_VIS_INST_ID_QUEUE_SIZE_DESCRIPTOR_SLOT, 0, s_csmVisGeomIDQueueSizeBuffers[geomType][queue]);
     
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_BATCH_BATCH_QUEUE_UAV_DESCRIPTOR_SLOT, 0, s_csmGeomBatchQueueBuffers[cascade][queue]);
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_BATCH_BATCH_QUEUE_SIZE_UAV_DESCRIPTOR_SLOT, 0, s_csmGeomBatchQueueSizeBuffers[cascade][queue]);
+    WriteSharedDescriptor(setID, GEOM_BATCH_BATCH_QUEUE_UAV_DESCRIPTOR_SLOT, 0, s_csmGeomBatchQueueBuffers[geomType][queue]);
+    WriteSharedDescriptor(setID, GEOM_BATCH_BATCH_QUEUE_SIZE_UAV_DESCRIPTOR_SLOT, 0, s_csmGeomBatchQueueSizeBuffers[geomType][queue]);
 
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_BATCH_SORTED_VIS_INST_ID_QUEUE_UAV_DESCRIPTOR_SLOT, 0, s_csmSortedVisGeomIDQueueBuffers[cascade][queue]);
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_BATCH_SORTED_VIS_INST_ID_QUEUE_SIZE_UAV_DESCRIPTOR_SLOT, 0, s_csmSortedVisGeomIDQueueSizeBuffers[cascade][queue]);
+    WriteSharedDescriptor(setID, GEOM_BATCH_SORTED_VIS_INST_ID_QUEUE_UAV_DESCRIPTOR_SLOT, 0, s_csmSortedVisGeomIDQueueBuffers[geomType][queue]);
+    WriteSharedDescriptor(setID, GEOM_BATCH_SORTED_VIS_INST_ID_QUEUE_SIZE_UAV_DESCRIPTOR_SLOT, 0, s_csmSortedVisGeomIDQueueSizeBuffers[geomType][queue]);
+
+    WriteSharedDescriptor(setID, GEOM_BATCH_BIN_COUNTERS_UAV_DESCRIPTOR_SLOT, 0, s_geomBatchBinCountersBuffer);
+    WriteSharedDescriptor(setID, GEOM_BATCH_BIN_OFFSETS_UAV_DESCRIPTOR_SLOT, 0, s_geomBatchBinOffsetsBuffer);
+    WriteSharedDescriptor(setID, GEOM_BATCH_INST_BINS_UAV_DESCRIPTOR_SLOT, 0, s_geomBatchInstBinsBuffer);
 }
 
 
 static void WriteCSMGeomBatchingDescriptorSet()
 {
-    for (uint32_t cascade = 0; cascade < COMMON_CSM_CASCADE_COUNT; ++cascade) {
+    for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
         for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
-            WriteCSMGeomBatchingDescriptorSet(cascade, (GPU_GeomQueue)queue);
+            WriteCSMGeomBatchingDescriptorSet((GPU_CsmGeomType)geomType, (GPU_GeomQueue)queue);
         }
     }
 }
 
 
-static void WriteCSMGeomDrawCmdGenDescriptorSet(uint32_t cascade, GPU_GeomQueue queue)
+static void WriteCSMGeomDrawCmdGenDescriptorSet(GPU_CsmGeomType geomType, GPU_GeomQueue queue)
 {
-    CORE_ASSERT(cascade < COMMON_CSM_CASCADE_COUNT);
+    CORE_ASSERT(geomType < CSM_GEOM_TYPE_COUNT);
     CORE_ASSERT(queue < GEOM_QUEUE_COUNT);
     
-    DescSetID setID;
-
-    switch(queue) {
-        case GEOM_QUEUE_OPAQUE:
-            setID = static_cast<DescSetID>(DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_OPAQUE_CASCADE_0 + cascade);
-            break;
-        case GEOM_QUEUE_AKILL:
-            setID = static_cast<DescSetID>(DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_AKILL_CASCADE_0 + cascade);
-            break;
-    }
+    const DescSetID setID = CSMGetGeomDrawCmdGenDescSetID(geomType, queue);
 
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_DRAW_CMD_GEN_BATCH_QUEUE_DESCRIPTOR_SLOT, 0, s_csmGeomBatchQueueBuffers[cascade][queue]);
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_DRAW_CMD_GEN_BATCH_QUEUE_SIZE_DESCRIPTOR_SLOT, 0, s_csmGeomBatchQueueSizeBuffers[cascade][queue]);
+    WriteSharedDescriptor(setID, GEOM_DRAW_CMD_GEN_BATCH_QUEUE_DESCRIPTOR_SLOT, 0, s_csmGeomBatchQueueBuffers[geomType][queue]);
+    WriteSharedDescriptor(setID, GEOM_DRAW_CMD_GEN_BATCH_QUEUE_SIZE_DESCRIPTOR_SLOT, 0, s_csmGeomBatchQueueSizeBuffers[geomType][queue]);
 
-    s_descriptorBuffer.WriteDescriptor(setID, GEOM_DRAW_CMD_GEN_CMD_QUEUE_UAV_DESCRIPTOR_SLOT, 0, s_csmGeomDrawCmdQueueBuffers[cascade][queue]);
+    WriteSharedDescriptor(setID, GEOM_DRAW_CMD_GEN_CMD_QUEUE_UAV_DESCRIPTOR_SLOT, 0, s_csmGeomDrawCmdQueueBuffers[geomType][queue]);
 }
 
 
 static void WriteCSMGeomDrawCmdGenDescriptorSet()
 {
-    for (uint32_t cascade = 0; cascade < COMMON_CSM_CASCADE_COUNT; ++cascade) {
+    for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
         for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
-            WriteCSMGeomDrawCmdGenDescriptorSet(cascade, (GPU_GeomQueue)queue);
+            WriteCSMGeomDrawCmdGenDescriptorSet((GPU_CsmGeomType)geomType, (GPU_GeomQueue)queue);
         }
     }
 }
 
 
-static void WriteCSMRenderDescriptorSet(uint32_t cascade, GPU_GeomQueue queue)
+static void WriteCSMRenderDescriptorSet(GPU_CsmGeomType geomType, GPU_GeomQueue queue)
 {
-    CORE_ASSERT(cascade < COMMON_CSM_CASCADE_COUNT);
+    CORE_ASSERT(geomType < CSM_GEOM_TYPE_COUNT);
     CORE_ASSERT(queue < GEOM_QUEUE_COUNT);
 
     static constexpr DescSetID setID = DESC_SET_ID_CSM_RENDER;
-    const uint32_t index = CSMGetBufferIndex(cascade, queue);
+    const uint32_t index = CSMGetBufferIndex(geomType, queue);
 
-    s_descriptorBuffer.WriteDescriptor(setID, CSM_INST_ID_QUEUE_DESCRIPTOR_SLOT, index, s_csmSortedVisGeomIDQueueBuffers[cascade][queue]);
+    WriteSharedDescriptor(setID, CSM_INST_ID_QUEUE_DESCRIPTOR_SLOT, index, s_csmSortedVisGeomIDQueueBuffers[geomType][queue]);
 }
 
 
 static void WriteCSMRenderDescriptorSet()
 {
-    for (uint32_t cascade = 0; cascade < COMMON_CSM_CASCADE_COUNT; ++cascade) {
+    for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
+        for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
+            WriteCSMRenderDescriptorSet((GPU_CsmGeomType)geomType, (GPU_GeomQueue)queue);
+        }
+    }
+}
+
+
+static void WriteVSMPagesDescriptorSet()
+{
+    static constexpr DescSetID setID = DESC_SET_ID_VSM_PAGES;
+
+    WriteSharedDescriptor(setID, VSM_PAGES_PAGE_TABLE_UAV_DESCRIPTOR_SLOT, 0, s_vsmPageTableBuffer);
+    WriteSharedDescriptor(setID, VSM_PAGES_PHYS_PAGE_LAST_USED_FRAME_UAV_DESCRIPTOR_SLOT, 0, s_vsmPhysPageLastUsedFrameBuffer);
+    WriteSharedDescriptor(setID, VSM_PAGES_FREE_LIST_UAV_DESCRIPTOR_SLOT, 0, s_vsmFreeListBuffer);
+    WriteSharedDescriptor(setID, VSM_PAGES_FREE_LIST_COUNTER_UAV_DESCRIPTOR_SLOT, 0, s_vsmFreeListCounterBuffer);
+    WriteSharedDescriptor(setID, VSM_PAGES_DIRTY_LIST_UAV_DESCRIPTOR_SLOT, 0, s_vsmDirtyListBuffer);
+    WriteSharedDescriptor(setID, VSM_PAGES_CLEAR_DISPATCH_ARGS_UAV_DESCRIPTOR_SLOT, 0, s_vsmClearDispatchArgsBuffer);
+    WriteSharedDescriptor(setID, VSM_PAGES_DIRTY_PAGE_RECTS_UAV_DESCRIPTOR_SLOT, 0, s_vsmDirtyPageRectsBuffer);
+    WriteSharedDescriptor(setID, VSM_PAGES_PHYS_POOL_UAV_DESCRIPTOR_SLOT, 0, s_vsmPhysPoolView, VK_IMAGE_LAYOUT_GENERAL);
+}
+
+
+static void WriteVSMRenderDescriptorSet()
+{
+    static constexpr DescSetID setID = DESC_SET_ID_VSM_RENDER;
+
+    for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
         for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
-            WriteCSMRenderDescriptorSet(cascade, (GPU_GeomQueue)queue);
+            const uint32_t index = CSMGetBufferIndex((GPU_CsmGeomType)geomType, (GPU_GeomQueue)queue);
+            WriteSharedDescriptor(setID, CSM_INST_ID_QUEUE_DESCRIPTOR_SLOT, index, s_csmSortedVisGeomIDQueueBuffers[geomType][queue]);
         }
     }
+
+    WriteSharedDescriptor(setID, VSM_PAGE_TABLE_DESCRIPTOR_SLOT, 0, s_vsmPageTableBuffer);
+    WriteSharedDescriptor(setID, VSM_PHYS_POOL_UAV_DESCRIPTOR_SLOT, 0, s_vsmPhysPoolView, VK_IMAGE_LAYOUT_GENERAL);
 }
 
 
@@ -5027,7 +6372,7 @@ static void WriteGBufferDescriptorSet(GPU_GeomQueue queue)
             break;
     }   
 
-    s_descriptorBuffer.WriteDescriptor(setID, GBUFFER_INST_ID_QUEUE_DESCRIPTOR_SLOT, 0, s_sortedVisGeomIDQueueBuffer[queue]);
+    WriteSharedDescriptor(setID, GBUFFER_INST_ID_QUEUE_DESCRIPTOR_SLOT, 0, s_sortedVisGeomIDQueueBuffer[queue]);
 }
 
 
@@ -5039,6 +6384,28 @@ static void WriteGBufferDescriptorSet()
 }
 
 
+static void WriteLightCullingDescriptorSet()
+{
+    static constexpr DescSetID setID = DESC_SET_ID_LIGHT_CULLING;
+
+    WriteSharedDescriptor(setID, LIGHT_CULLING_LIGHTS_DESCRIPTOR_SLOT, 0, s_punctualLightBuffer);
+    WriteSharedDescriptor(setID, LIGHT_CULLING_CLUSTER_LIGHT_COUNTS_UAV_DESCRIPTOR_SLOT, 0, s_lightClusterLightCountsBuffer);
+    WriteSharedDescriptor(setID, LIGHT_CULLING_CLUSTER_LIGHT_INDICES_UAV_DESCRIPTOR_SLOT, 0, s_lightClusterLightIndicesBuffer);
+}
+
+
+static void WriteDeferredLightingClassifyDescriptorSet()
+{
+    static constexpr DescSetID setID = DESC_SET_ID_DEFERRED_LIGHTING_CLASSIFY;
+
+    WriteSharedDescriptor(setID, DEFERRED_LIGHTING_CLASSIFY_DEPTH_DESCRIPTOR_SLOT, 0, s_depthRTView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(setID, DEFERRED_LIGHTING_CLASSIFY_GBUFFER_NORMAL_DESCRIPTOR_SLOT, 0, s_gbufferRTViews[1], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(setID, DEFERRED_LIGHTING_CLASSIFY_TILE_LIST_UAV_DESCRIPTOR_SLOT, 0, s_deferredLightingTileListBuffer);
+    WriteSharedDescriptor(setID, DEFERRED_LIGHTING_CLASSIFY_DISPATCH_ARGS_UAV_DESCRIPTOR_SLOT, 0, s_deferredLightingDispatchArgsBuffer);
+    WriteSharedDescriptor(setID, DEFERRED_LIGHTING_CLASSIFY_CSM_DESCRIPTOR_SLOT, 0, s_csmRTViewArray, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
+
 static void WriteDeferredLightingDescriptorSet()
 {
     std::array<vkn::TextureView*, GBUFFER_RT_COUNT> gbufferViews = {};
@@ -5047,98 +6414,113 @@ static void WriteDeferredLightingDescriptorSet()
     }
 
     for (size_t i = 0; i < GBUFFER_RT_COUNT; ++i) {
-        s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_GBUFFER_0_DESCRIPTOR_SLOT + i, 0, *gbufferViews[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        WriteSharedDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_GBUFFER_0_DESCRIPTOR_SLOT + i, 0, *gbufferViews[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     }
 
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_DEPTH_DESCRIPTOR_SLOT, 0, s_depthRTView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_IRRADIANCE_MAP_DESCRIPTOR_SLOT, 0, s_irradianceMapTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_PREFILTERED_ENV_MAP_DESCRIPTOR_SLOT, 0, s_prefilteredEnvMapTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_BRDF_LUT_DESCRIPTOR_SLOT, 0, s_brdfLUTTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_CSM_DESCRIPTOR_SLOT, 0, s_csmRTViewArray, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_DEPTH_DESCRIPTOR_SLOT, 0, s_depthRTView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_IRRADIANCE_MAP_DESCRIPTOR_SLOT, 0, s_irradianceMapTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_PREFILTERED_ENV_MAP_DESCRIPTOR_SLOT, 0, s_prefilteredEnvMapTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_BRDF_LUT_DESCRIPTOR_SLOT, 0, s_brdfLUTTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_CSM_DESCRIPTOR_SLOT, 0, s_csmRTViewArray, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_VSM_PAGE_TABLE_DESCRIPTOR_SLOT, 0, s_vsmPageTableBuffer);
+    WriteSharedDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_VSM_PHYS_POOL_DESCRIPTOR_SLOT, 0, s_vsmPhysPoolView, VK_IMAGE_LAYOUT_GENERAL);
+    WriteSharedDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_PUNCTUAL_LIGHTS_DESCRIPTOR_SLOT, 0, s_punctualLightBuffer);
+    WriteSharedDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_CLUSTER_LIGHT_COUNTS_DESCRIPTOR_SLOT, 0, s_lightClusterLightCountsBuffer);
+    WriteSharedDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_CLUSTER_LIGHT_INDICES_DESCRIPTOR_SLOT, 0, s_lightClusterLightIndicesBuffer);
+    WriteSharedDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_OUTPUT_UAV_DESCRIPTOR_SLOT, 0, s_colorRTView16F, VK_IMAGE_LAYOUT_GENERAL);
+    WriteSharedDescriptor(DESC_SET_ID_DEFERRED_LIGHTING, DEFERRED_LIGHTING_TILE_LIST_DESCRIPTOR_SLOT, 0, s_deferredLightingTileListBuffer);
 }
 
 
 static void WritePostProcessingDescriptorSet()
 {
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_POST_PROCESSING, POST_PROCESSING_INPUT_COLOR_DESCRIPTOR_SLOT, 0, s_colorRTView16F, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_POST_PROCESSING, POST_PROCESSING_INPUT_COLOR_DESCRIPTOR_SLOT, 0, s_colorRTView16F, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 }
 
 
 static void WriteBackbufferPassDescriptorSet()
 {
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_BACKBUFFER, BACKBUFFER_INPUT_COLOR_DESCRIPTOR_SLOT, 0, s_colorRTView8U, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_BACKBUFFER, BACKBUFFER_INPUT_COLOR_DESCRIPTOR_SLOT, 0, s_colorRTView8U, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 }
 
 
 static void WriteSkyboxDescriptorSet()
 {
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_SKYBOX, SKYBOX_TEXTURE_DESCRIPTOR_SLOT, 0, s_skyboxTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_SKYBOX, SKYBOX_TEXTURE_DESCRIPTOR_SLOT, 0, s_skyboxTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 }
 
 
 static void WriteIrradianceMapGenDescriptorSet()
 {
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_IRRADIANCE_MAP_GEN, IRRADIANCE_MAP_GEN_ENV_MAP_DESCRIPTOR_SLOT, 0, s_skyboxTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_IRRADIANCE_MAP_GEN, IRRADIANCE_MAP_GEN_OUTPUT_UAV_DESCRIPTOR_SLOT, 0, s_irradianceMapTextureViewRW, VK_IMAGE_LAYOUT_GENERAL);
+    WriteSharedDescriptor(DESC_SET_ID_IRRADIANCE_MAP_GEN, IRRADIANCE_MAP_GEN_ENV_MAP_DESCRIPTOR_SLOT, 0, s_skyboxTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_IRRADIANCE_MAP_GEN, IRRADIANCE_MAP_GEN_OUTPUT_UAV_DESCRIPTOR_SLOT, 0, s_irradianceMapTextureViewRW, VK_IMAGE_LAYOUT_GENERAL);
 }
 
 
 static void WritePrefilteredEnvMapGenDescriptorSets()
 {
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_PREFILT_ENV_MAP_GEN, PREFILTERED_ENV_MAP_GEN_ENV_MAP_DESCRIPTOR_SLOT, 0, s_skyboxTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_PREFILT_ENV_MAP_GEN, PREFILTERED_ENV_MAP_GEN_ENV_MAP_DESCRIPTOR_SLOT, 0, s_skyboxTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     
     for (uint32_t i = 0; i < s_prefilteredEnvMapTextureViewRWs.size(); ++i) {
-        s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_PREFILT_ENV_MAP_GEN, PREFILTERED_ENV_MAP_GEN_OUTPUT_UAV_DESCRIPTOR_SLOT, i, s_prefilteredEnvMapTextureViewRWs[i], VK_IMAGE_LAYOUT_GENERAL);
+        WriteSharedDescriptor(DESC_SET_ID_PREFILT_ENV_MAP_GEN, PREFILTERED_ENV_MAP_GEN_OUTPUT_UAV_DESCRIPTOR_SLOT, i, s_prefilteredEnvMapTextureViewRWs[i], VK_IMAGE_LAYOUT_GENERAL);
     }
 }
 
 
 static void WriteBRDFIntegrationLUTGenDescriptorSet()
 {
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_BRDF_LUT_GEN, BRDF_INTEGRATION_GEN_OUTPUT_UAV_DESCRIPTOR_SLOT, 0, s_brdfLUTTextureViewRW, VK_IMAGE_LAYOUT_GENERAL);
+    WriteSharedDescriptor(DESC_SET_ID_BRDF_LUT_GEN, BRDF_INTEGRATION_GEN_OUTPUT_UAV_DESCRIPTOR_SLOT, 0, s_brdfLUTTextureViewRW, VK_IMAGE_LAYOUT_GENERAL);
 }
 
 
 static void WriteCommonDescriptorSet()
 {
     for (size_t i = 0; i < s_commonSamplers.size(); ++i) {
-        s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_SAMPLERS_DESCRIPTOR_SLOT, i, s_commonSamplers[i]);
+        WriteSharedDescriptor(DESC_SET_ID_COMMON, COMMON_SAMPLERS_DESCRIPTOR_SLOT, i, s_commonSamplers[i]);
     }
 
     for (size_t i = 0; i < s_commonCmpSamplers.size(); ++i) {
-        s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_CMP_SAMPLERS_DESCRIPTOR_SLOT, i, s_commonCmpSamplers[i]);
+        WriteSharedDescriptor(DESC_SET_ID_COMMON, COMMON_CMP_SAMPLERS_DESCRIPTOR_SLOT, i, s_commonCmpSamplers[i]);
     }
 
-#ifdef ENG_BUILD_DEBUG
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_DBG_CB_DESCRIPTOR_SLOT, 0, s_commonDbgConstBuffer);
-#endif
+    for (uint32_t frameIdx = 0; frameIdx < FRAMES_IN_FLIGHT_COUNT; ++frameIdx) {
+        vkn::DescriptorBuffer& descBuffer = s_descriptorBuffers[frameIdx];
+
+    #ifdef ENG_BUILD_DEBUG
+        descBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_DBG_CB_DESCRIPTOR_SLOT, 0, s_commonDbgConstBuffers[frameIdx]);
+    #endif
 
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_CB_DESCRIPTOR_SLOT, 0, s_commonConstBuffer);
+        descBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_CB_DESCRIPTOR_SLOT, 0, s_commonConstBuffers[frameIdx]);
+    }
     
     for (size_t i = 0; i < COMMON_GEOM_STREAM_COUNT; ++i) {
-        s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_GEOM_STREAMS_DESCRIPTOR_SLOT, i, s_geomStreamBuffers[i]);
+        WriteSharedDescriptor(DESC_SET_ID_COMMON, COMMON_GEOM_STREAMS_DESCRIPTOR_SLOT, i, s_geomStreamBuffers[i]);
     }
     
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_MESH_LOD_BUFFER_DESCRIPTOR_SLOT, 0, s_commonMeshLODBuffer);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_MESH_BUFFER_DESCRIPTOR_SLOT, 0, s_commonMeshBuffer);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_MATERIALS_DESCRIPTOR_SLOT, 0, s_commonMaterialBuffer);
+    WriteSharedDescriptor(DESC_SET_ID_COMMON, COMMON_MESH_LOD_BUFFER_DESCRIPTOR_SLOT, 0, s_commonMeshLODBuffer);
+    WriteSharedDescriptor(DESC_SET_ID_COMMON, COMMON_MESH_BUFFER_DESCRIPTOR_SLOT, 0, s_commonMeshBuffer);
+    WriteSharedDescriptor(DESC_SET_ID_COMMON, COMMON_MATERIALS_DESCRIPTOR_SLOT, 0, s_commonMaterialBuffer);
 
     for (size_t i = 0; i < s_commonMaterialTextureViews.size(); ++i) {
-        s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_MTL_TEXTURES_DESCRIPTOR_SLOT, i, s_commonMaterialTextureViews[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        WriteSharedDescriptor(DESC_SET_ID_COMMON, COMMON_MTL_TEXTURES_DESCRIPTOR_SLOT, i, s_commonMaterialTextureViews[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     }
 
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_INST_BUFFER_DESCRIPTOR_SLOT, 0, s_commonInstBuffer);
+    WriteSharedDescriptor(DESC_SET_ID_COMMON, COMMON_INST_BUFFER_DESCRIPTOR_SLOT, 0, s_commonInstBuffer);
 
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_DEPTH_DESCRIPTOR_SLOT, 0, s_depthRTView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_COMMON, COMMON_HZB_DESCRIPTOR_SLOT, 0, s_HZBView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_COMMON, COMMON_DEPTH_DESCRIPTOR_SLOT, 0, s_depthRTView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_COMMON, COMMON_HZB_DESCRIPTOR_SLOT, 0, s_HZBView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 }
 
 
 static void WriteDbgDrawLineDescriptorSet()
 {
 #ifdef ENG_DEBUG_DRAW_ENABLED
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_DRAW_LINES, DBG_DRAW_LINES_VERTEX_BUFFER_DESCRIPTOR_SLOT, 0, s_dbgLineVertexDataGPU);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_DRAW_LINES, DBG_DRAW_LINES_DATA_DESCRIPTOR_SLOT, 0, s_dbgLineDataGPU);
+    for (uint32_t frameIdx = 0; frameIdx < FRAMES_IN_FLIGHT_COUNT; ++frameIdx) {
+        vkn::DescriptorBuffer& descBuffer = s_descriptorBuffers[frameIdx];
+
+        descBuffer.WriteDescriptor(DESC_SET_ID_DBG_DRAW_LINES, DBG_DRAW_LINES_VERTEX_BUFFER_DESCRIPTOR_SLOT, 0, s_dbgLineVertexDataGPU[frameIdx]);
+        descBuffer.WriteDescriptor(DESC_SET_ID_DBG_DRAW_LINES, DBG_DRAW_LINES_DATA_DESCRIPTOR_SLOT, 0, s_dbgLineDataGPU[frameIdx]);
+    }
 #endif
 }
 
@@ -5146,8 +6528,12 @@ static void WriteDbgDrawLineDescriptorSet()
 static void WriteDbgDrawTriangleDescriptorSet()
 {
 #ifdef ENG_DEBUG_DRAW_ENABLED
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_DRAW_TRIANGLES, DBG_DRAW_TRIANGLES_VERTEX_BUFFER_DESCRIPTOR_SLOT, 0, s_dbgTriangleVertexDataGPU);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_DRAW_TRIANGLES, DBG_DRAW_TRIANGLES_DATA_DESCRIPTOR_SLOT, 0, s_dbgTriangleDataGPU);
+    for (uint32_t frameIdx = 0; frameIdx < FRAMES_IN_FLIGHT_COUNT; ++frameIdx) {
+        vkn::DescriptorBuffer& descBuffer = s_descriptorBuffers[frameIdx];
+
+        descBuffer.WriteDescriptor(DESC_SET_ID_DBG_DRAW_TRIANGLES, DBG_DRAW_TRIANGLES_VERTEX_BUFFER_DESCRIPTOR_SLOT, 0, s_dbgTriangleVertexDataGPU[frameIdx]);
+        descBuffer.WriteDescriptor(DESC_SET_ID_DBG_DRAW_TRIANGLES, DBG_DRAW_TRIANGLES_DATA_DESCRIPTOR_SLOT, 0, s_dbgTriangleDataGPU[frameIdx]);
+    }
 #endif
 }
 
@@ -5155,18 +6541,18 @@ static void WriteDbgDrawTriangleDescriptorSet()
 static void WriteDbgRTViewDescriptorSet()
 {
 #ifdef ENG_DEBUG_DRAW_ENABLED
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_COMMON_DEPTH_DESCRIPTOR_SLOT, 0, s_depthRTColorView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_COMMON_HZB_DESCRIPTOR_SLOT, 0, s_HZBView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_GBUFFER_0_DESCRIPTOR_SLOT, 0, s_gbufferRTViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_GBUFFER_1_DESCRIPTOR_SLOT, 0, s_gbufferRTViews[1], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_GBUFFER_2_DESCRIPTOR_SLOT, 0, s_gbufferRTViews[2], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_GBUFFER_3_DESCRIPTOR_SLOT, 0, s_gbufferRTViews[3], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_IRRADIANCE_MAP_DESCRIPTOR_SLOT, 0, s_irradianceMapTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_PREFILTERED_ENV_MAP_DESCRIPTOR_SLOT, 0, s_prefilteredEnvMapTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_BRDF_LUT_DESCRIPTOR_SLOT, 0, s_brdfLUTTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_SKYBOX_DESCRIPTOR_SLOT, 0, s_skyboxTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_CSM_DESCRIPTOR_SLOT, 0, s_csmRTViewArray, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    s_descriptorBuffer.WriteDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_COLOR_16F_DESCRIPTOR_SLOT, 0, s_colorRTView16F, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_COMMON_DEPTH_DESCRIPTOR_SLOT, 0, s_depthRTColorView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_COMMON_HZB_DESCRIPTOR_SLOT, 0, s_HZBView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_GBUFFER_0_DESCRIPTOR_SLOT, 0, s_gbufferRTViews[0], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_GBUFFER_1_DESCRIPTOR_SLOT, 0, s_gbufferRTViews[1], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_GBUFFER_2_DESCRIPTOR_SLOT, 0, s_gbufferRTViews[2], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_GBUFFER_3_DESCRIPTOR_SLOT, 0, s_gbufferRTViews[3], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_IRRADIANCE_MAP_DESCRIPTOR_SLOT, 0, s_irradianceMapTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_PREFILTERED_ENV_MAP_DESCRIPTOR_SLOT, 0, s_prefilteredEnvMapTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_BRDF_LUT_DESCRIPTOR_SLOT, 0, s_brdfLUTTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_SKYBOX_DESCRIPTOR_SLOT, 0, s_skyboxTextureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_CSM_DESCRIPTOR_SLOT, 0, s_csmRTViewArray, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    WriteSharedDescriptor(DESC_SET_ID_DBG_RT_VIEW, DBG_RT_VIEW_COLOR_16F_DESCRIPTOR_SLOT, 0, s_colorRTView16F, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 #endif
 }
 
@@ -5176,6 +6562,7 @@ static void WriteDescriptorSets()
     WriteCommonDescriptorSet();
 
     WriteGeomCullingDescriptorSet();
+    WriteGeomRadixSortDescriptorSet();
     WriteGeomBatchingDescriptorSet();
     WriteGeomDrawCmdGenDescriptorSet();
     
@@ -5187,9 +6574,14 @@ static void WriteDescriptorSets()
     WriteHZBGenDescriptorSets();
 
     WriteCSMRenderDescriptorSet();
+
+    WriteVSMPagesDescriptorSet();
+    WriteVSMRenderDescriptorSet();
     
     WriteGBufferDescriptorSet();
     
+    WriteLightCullingDescriptorSet();
+    WriteDeferredLightingClassifyDescriptorSet();
     WriteDeferredLightingDescriptorSet();
     
     WritePostProcessingDescriptorSet();
@@ -5208,7 +6600,17 @@ static void WriteDescriptorSets()
 }
 
 
-static void LoadSceneMeshInstData(const gltf::Asset& asset, const gltf::Mesh& mesh, size_t primIdx)
+// Loading result of single mesh primitive. All offsets are local, they are rebased during merge into global CPU buffers
+struct MeshLoadScratch
+{
+    std::array<std::vector<uint32_t>, COMMON_GEOM_STREAM_COUNT> streams;
+    std::vector<IndexType> indices;
+    std::vector<GPU_MeshLOD> lods;
+    GPU_Mesh mesh;
+};
+
+
+static void LoadSceneMeshInstData(const gltf::Asset& asset, const gltf::Mesh& mesh, size_t primIdx, MeshLoadScratch& scratch)
 {
     ENG_PROFILE_SCOPED_MARKER_C_FMT(0x8b008b, "Load_Scene_Mesh_Data_%s", mesh.name.c_str());
 
@@ -5289,13 +6691,10 @@ static void LoadSceneMeshInstData(const gltf::Asset& asset, const gltf::Mesh& me
         maxVert = glm::float3(aabbLCSMax.get<double>(0), aabbLCSMax.get<double>(1), aabbLCSMax.get<double>(2));
     }
 
-    const size_t currVertCount = s_cpuGeomStreamBuffers[COMMON_GEOM_STREAM_POSITION].size() / 2; // position is packed 2 x uint
-
-    GPU_Mesh cpuMesh = {};
+    GPU_Mesh& cpuMesh = scratch.mesh;
+    cpuMesh = {};
     
-    cpuMesh.firstVertex = currVertCount;
     cpuMesh.vertexCount = positions.size();
-    cpuMesh.firstLOD = s_cpuMeshLODData.size();
 
     {
         ENG_PROFILE_SCOPED_MARKER_C_FMT(0x8b008b, "Mesh_%s_LOD_Generation", mesh.name.c_str());
@@ -5303,25 +6702,28 @@ static void LoadSceneMeshInstData(const gltf::Asset& asset, const gltf::Mesh& me
         std::vector<IndexType> currLodIndices = indices;
         std::vector<IndexType> nextLodIndices(currLodIndices.size());
 
+        // meshopt_simplify returns error relative to mesh extents
+        const float lodErrorScale = meshopt_simplifyScale(&positions[0].x, positions.size(), sizeof(glm::float3));
+        float lodError = 0.f;
+
         for (size_t i = 0; i < COMMON_MAX_GEOM_LOD_COUNT; ++i) {
             GPU_MeshLOD lod = {};
-            lod.firstIndex = s_cpuGeomIndexBuffer.size();
+            lod.firstIndex = scratch.indices.size();
             lod.indexCount = currLodIndices.size();
+            lod.error = lodError;
 
-            CORE_LOG_TRACE("Mesh %s LOD %zu: index count: %u", mesh.name.c_str(), i, lod.indexCount);
+            CORE_LOG_TRACE("Mesh %s LOD %zu: index count: %u, error: %f", mesh.name.c_str(), i, lod.indexCount, lod.error);
             
-            s_cpuMeshLODData.emplace_back(lod);
+            scratch.lods.emplace_back(lod);
     
             ++cpuMesh.lodCount;
             
-            s_cpuGeomIndexBuffer.reserve(s_cpuGeomIndexBuffer.size() + currLodIndices.size());
-    
-            for (IndexType index : currLodIndices) {
-                s_cpuGeomIndexBuffer.emplace_back(cpuMesh.firstVertex + index);
-            }
+            scratch.indices.insert(scratch.indices.end(), currLodIndices.cbegin(), currLodIndices.cend());
     
             const size_t nextLodIndexCountTarget = (size_t)(((float)currLodIndices.size() * LOD_SIMPLIFICATION_COEF) + 2) / 3 * 3;
     
+            float simplificationError = 0.f;
+
             const size_t nextLodIndexCount = meshopt_simplify(
                 nextLodIndices.data(), 
                 currLodIndices.data(), 
@@ -5330,7 +6732,9 @@ static void LoadSceneMeshInstData(const gltf::Asset& asset, const gltf::Mesh& me
                 positions.size(), 
                 sizeof(glm::float3), 
                 nextLodIndexCountTarget, 
-                LOD_SIMPLIFICATION_ERROR
+                LOD_SIMPLIFICATION_ERROR,
+                0,
+                &simplificationError
             );
     
             CORE_ASSERT(nextLodIndexCount <= currLodIndices.size());
@@ -5338,6 +6742,9 @@ static void LoadSceneMeshInstData(const gltf::Asset& asset, const gltf::Mesh& me
             if (nextLodIndexCount == currLodIndices.size()) {
                 break;
             }
+
+            // Every LOD is simplified from the previous one, so errors are accumulated to keep them monotonic
+            lodError += simplificationError * lodErrorScale;
     
             nextLodIndices.resize(nextLodIndexCount);
             currLodIndices.swap(nextLodIndices);
@@ -5346,34 +6753,32 @@ static void LoadSceneMeshInstData(const gltf::Asset& asset, const gltf::Mesh& me
 
     cpuMesh.PackAABB_LCS(minVert, maxVert + M3D_EPS);
 
-    s_cpuMeshData.emplace_back(cpuMesh);
-
     static constexpr size_t POS_SIZE_UI = 2;
     
-    std::vector<uint32_t>& posStream = s_cpuGeomStreamBuffers[COMMON_GEOM_STREAM_POSITION];
-    posStream.reserve(posStream.size() + positions.size() * POS_SIZE_UI);
+    std::vector<uint32_t>& posStream = scratch.streams[COMMON_GEOM_STREAM_POSITION];
+    posStream.reserve(positions.size() * POS_SIZE_UI);
 
     for (const glm::float3& pos : positions) {
         posStream.emplace_back(glm::packHalf2x16(glm::float2(pos.x, pos.y)));
         posStream.emplace_back(glm::packHalf2x16(glm::float2(pos.z, 0.f)));
     }
 
-    std::vector<uint32_t>& normStream = s_cpuGeomStreamBuffers[COMMON_GEOM_STREAM_NORMAL];
-    normStream.reserve(normStream.size() + normals.size());
+    std::vector<uint32_t>& normStream = scratch.streams[COMMON_GEOM_STREAM_NORMAL];
+    normStream.reserve(normals.size());
 
     for (const glm::float3& normal : normals) {
         normStream.emplace_back(glm::packSnorm4x8(glm::float4(normal.x, normal.y, normal.z, 0.f)));
     }
 
-    std::vector<uint32_t>& uvStream = s_cpuGeomStreamBuffers[COMMON_GEOM_STREAM_UV];
-    uvStream.reserve(uvStream.size() + uvs.size());
+    std::vector<uint32_t>& uvStream = scratch.streams[COMMON_GEOM_STREAM_UV];
+    uvStream.reserve(uvs.size());
 
     for (const glm::float2& uv : uvs) {
         uvStream.emplace_back(glm::packHalf2x16(uv));
     }
 
-    std::vector<uint32_t>& tangStream = s_cpuGeomStreamBuffers[COMMON_GEOM_STREAM_TANGENT];
-    tangStream.reserve(tangStream.size() + tangents.size());
+    std::vector<uint32_t>& tangStream = scratch.streams[COMMON_GEOM_STREAM_TANGENT];
+    tangStream.reserve(tangents.size());
 
     for (const glm::float4& tang : tangents) {
         tangStream.emplace_back(glm::packSnorm4x8(glm::float4(tang.x, tang.y, tang.z, tang.w > 0.f ? 1.f : -1.f)));
@@ -5381,65 +6786,707 @@ static void LoadSceneMeshInstData(const gltf::Asset& asset, const gltf::Mesh& me
 }
 
 
-static void LoadSceneMeshData(const gltf::Asset& asset)
-{
-    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Load_Scene_Mesh_Data");
+static void LoadSceneMeshData(const gltf::Asset& asset)
+{
+    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Load_Scene_Mesh_Data");
+
+    eng::Timer timer;
+
+    struct PrimitiveRef
+    {
+        const gltf::Mesh* pMesh;
+        size_t primIdx;
+    };
+
+    // Flattened in the same order as serial loading used to process primitives, mesh IDs in LoadSceneInstData rely on it
+    std::vector<PrimitiveRef> primitives;
+    for (const gltf::Mesh& mesh : asset.meshes) {
+        for (size_t primIdx = 0; primIdx < mesh.primitives.size(); ++primIdx) {
+            primitives.emplace_back(PrimitiveRef { &mesh, primIdx });
+        }
+    }
+
+    std::vector<MeshLoadScratch> scratches(primitives.size());
+
+    eng::GetThreadPool().ParallelFor(primitives.size(), [&](size_t i, uint32_t) {
+        LoadSceneMeshInstData(asset, *primitives[i].pMesh, primitives[i].primIdx, scratches[i]);
+    });
+
+    // Exclusive prefix sums of per primitive sizes define where each primitive lands in global buffers.
+    // Layout doesn't depend on execution order, so result is identical to serial loading
+    struct MergeOffsets
+    {
+        std::array<size_t, COMMON_GEOM_STREAM_COUNT> streams;
+        size_t vertex;
+        size_t index;
+        size_t lod;
+    };
+
+    std::vector<MergeOffsets> offsets(scratches.size());
+
+    MergeOffsets total = {};
+    
+    for (size_t i = 0; i < COMMON_GEOM_STREAM_COUNT; ++i) {
+        total.streams[i] = s_cpuGeomStreamBuffers[i].size();
+    }
+    total.vertex = s_cpuGeomStreamBuffers[COMMON_GEOM_STREAM_POSITION].size() / 2; // position is packed 2 x uint
+    total.index = s_cpuGeomIndexBuffer.size();
+    total.lod = s_cpuMeshLODData.size();
+
+    for (size_t i = 0; i < scratches.size(); ++i) {
+        const MeshLoadScratch& scratch = scratches[i];
+        
+        offsets[i] = total;
+        
+        for (size_t streamIdx = 0; streamIdx < COMMON_GEOM_STREAM_COUNT; ++streamIdx) {
+            total.streams[streamIdx] += scratch.streams[streamIdx].size();
+        }
+        total.vertex += scratch.mesh.vertexCount;
+        total.index += scratch.indices.size();
+        total.lod += scratch.lods.size();
+    }
+
+    for (size_t i = 0; i < COMMON_GEOM_STREAM_COUNT; ++i) {
+        s_cpuGeomStreamBuffers[i].resize(total.streams[i]);
+    }
+    s_cpuGeomIndexBuffer.resize(total.index);
+    s_cpuMeshLODData.resize(total.lod);
+
+    const size_t firstMeshIdx = s_cpuMeshData.size();
+    s_cpuMeshData.resize(firstMeshIdx + scratches.size());
+
+    eng::GetThreadPool().ParallelFor(scratches.size(), [&](size_t i, uint32_t) {
+        ENG_PROFILE_TRANSIENT_SCOPED_MARKER_C(0x8b008b, "Merge_Mesh_Data");
+
+        const MeshLoadScratch& scratch = scratches[i];
+        const MergeOffsets& offset = offsets[i];
+
+        for (size_t streamIdx = 0; streamIdx < COMMON_GEOM_STREAM_COUNT; ++streamIdx) {
+            std::copy(scratch.streams[streamIdx].cbegin(), scratch.streams[streamIdx].cend(), s_cpuGeomStreamBuffers[streamIdx].begin() + offset.streams[streamIdx]);
+        }
+
+        const IndexType firstVertex = static_cast<IndexType>(offset.vertex);
+
+        std::transform(scratch.indices.cbegin(), scratch.indices.cend(), s_cpuGeomIndexBuffer.begin() + offset.index, 
+            [firstVertex](IndexType index) { return static_cast<IndexType>(firstVertex + index); });
+
+        for (size_t lodIdx = 0; lodIdx < scratch.lods.size(); ++lodIdx) {
+            GPU_MeshLOD lod = scratch.lods[lodIdx];
+            lod.firstIndex += offset.index;
+
+            s_cpuMeshLODData[offset.lod + lodIdx] = lod;
+        }
+
+        GPU_Mesh cpuMesh = scratch.mesh;
+        cpuMesh.firstVertex = offset.vertex;
+        cpuMesh.firstLOD = offset.lod;
+
+        s_cpuMeshData[firstMeshIdx + i] = cpuMesh;
+    });
+
+    CORE_LOG_INFO("FastGLTF: Mesh loading finished: %f ms", timer.End().GetDuration<float, std::milli>());
+}
+
+
+static vkn::Texture& CreateGPUMaterialTexture(size_t textureIdx, VkFormat format, uint32_t width, uint32_t height, uint32_t mipCount, 
+    VkImageUsageFlags usage, const VkComponentMapping& mapping)
+{
+    vkn::AllocationInfo imageAllocInfo = {};
+    imageAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
+    imageAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    vkn::TextureCreateInfo imageCreateInfo = {};
+
+    imageCreateInfo.pDevice = &s_vkDevice;
+    imageCreateInfo.type = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.extent.width = width;
+    imageCreateInfo.extent.height = height;
+    imageCreateInfo.extent.depth = 1;
+    imageCreateInfo.format = format;
+    imageCreateInfo.usage = usage;
+    imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageCreateInfo.mipLevels = mipCount;
+    imageCreateInfo.arrayLayers = 1;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.pAllocInfo = &imageAllocInfo;
+
+    vkn::Texture& sceneImage = s_commonMaterialTextures[textureIdx];
+    sceneImage.Create(imageCreateInfo);
+    s_vkDevice.SetObjDebugName(sceneImage, "COMMON_MTL_TEXTURE_%zu", textureIdx);
+
+    VkImageSubresourceRange subresourceRange = {};
+    subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    subresourceRange.baseMipLevel = 0;
+    subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+    subresourceRange.baseArrayLayer = 0;
+    subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+    vkn::TextureView& sceneImageView = s_commonMaterialTextureViews[textureIdx];
+
+    sceneImageView.Create(sceneImage, mapping, subresourceRange);
+    s_vkDevice.SetObjDebugName(sceneImageView, "COMMON_MTL_TEXTURE_VIEW_%zu", textureIdx);
+
+    return sceneImage;
+}
+
+
+static void UploadGPUTexture(size_t textureIdx, const TextureLoadData& texData)
+{
+    ENG_PROFILE_SCOPED_MARKER_C_FMT(0x8b008b, "Upload_GPU_Texture_%zu", textureIdx);
+
+    CORE_ASSERT_MSG(texData.IsLoaded(), "Scene texture %zu (%s) is not loaded", textureIdx, texData.GetName());
+
+    const VkComponentMapping mapping = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
+    const VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    vkn::Texture& sceneImage = CreateGPUMaterialTexture(textureIdx, texData.GetFormat(), texData.GetWidth(), texData.GetHeight(), 
+        texData.GetMipsCount(), usage, mapping);
+
+    s_uploadManager.GetCmdBuffer()
+        .BeginBarrierList()
+            .AddTextureBarrier(sceneImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, 
+                VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 0, 1)
+        .Push();
+
+    s_uploadManager.UploadTexture(sceneImage, texData.GetData(), texData.GetMemorySize());
+
+    // Blits aren't supported by transfer queue
+    vkn::CmdBuffer& cmdBuffer = s_uploadManager.GetOwnerCmdBuffer();
+
+    GenerateTextureMipmaps(cmdBuffer, sceneImage, texData);
+
+    cmdBuffer
+        .BeginBarrierList()
+            .AddTextureBarrier(sceneImage, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, 
+                VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+        .Push();
+}
+
+
+// Block compressed texture already contains all mips, so each of them is copied as is
+static void UploadGPUTexture(size_t textureIdx, const eng::KTX2Texture& texData, const VkComponentMapping& mapping, const char* pName)
+{
+    ENG_PROFILE_SCOPED_MARKER_C_FMT(0x8b008b, "Upload_GPU_Texture_%zu", textureIdx);
+
+    CORE_ASSERT_MSG(texData.IsParsed(), "Scene texture %zu (%s) is not loaded", textureIdx, pName);
+
+    vkn::Texture& sceneImage = CreateGPUMaterialTexture(textureIdx, texData.GetFormat(), texData.GetWidth(), texData.GetHeight(), 
+        texData.GetMipCount(), VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, mapping);
+
+    s_uploadManager.GetCmdBuffer()
+        .BeginBarrierList()
+            .AddTextureBarrier(sceneImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, 
+                VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+        .Push();
+
+    for (uint32_t mip = 0; mip < texData.GetMipCount(); ++mip) {
+        const std::span<const uint8_t> mipData = texData.GetMipData(mip);
+        s_uploadManager.UploadTexture(sceneImage, mipData.data(), mipData.size(), mip);
+    }
+
+    s_uploadManager.GetOwnerCmdBuffer()
+        .BeginBarrierList()
+            .AddTextureBarrier(sceneImage, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, 
+                VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+        .Push();
+}
+
+
+// Encoded scene image. External images are mapped by decoding task, embedded data must stay valid until textures are loaded
+struct SceneImageSource
+{
+    std::string name;
+    fs::path filepath;
+    std::span<const uint8_t> data;
+
+    bool IsExternal() const { return !filepath.empty(); }
+};
+
+
+static void GetSceneImageSources(const gltf::Asset& asset, const fs::path& dirPath, std::vector<SceneImageSource>& outSources)
+{
+    outSources.resize(asset.images.size());
+
+    for (size_t i = 0; i < asset.images.size(); ++i) {
+        const gltf::Image& image = asset.images[i];
+        SceneImageSource& source = outSources[i];
+
+        source.name = image.name;
+
+        auto SetData = [&source](const std::byte* pData, size_t size) {
+            source.data = std::span(reinterpret_cast<const uint8_t*>(pData), size);
+        };
+
+        std::visit(
+            gltf::visitor {
+                [](const auto& arg){},
+                [&](const gltf::sources::URI& filePath) {   
+                    source.filepath = filePath.uri.isLocalPath() ? fs::absolute(dirPath / filePath.uri.fspath()) : filePath.uri.fspath();
+                },
+                [&](const gltf::sources::Vector& vector) {
+                    SetData(vector.bytes.data(), vector.bytes.size());
+                },
+                [&](const gltf::sources::Array& array) {
+                    SetData(array.bytes.data(), array.bytes.size());
+                },
+                [&](const gltf::sources::BufferView& view) {
+                    const gltf::BufferView& bufferView = asset.bufferViews[view.bufferViewIndex];
+                    const gltf::Buffer& buffer = asset.buffers[bufferView.bufferIndex];
+
+                    const std::byte* pBufferData = nullptr;
+                    size_t bufferSize = 0;
+
+                    std::visit(gltf::visitor {
+                        [](const auto& arg){},
+                        [&](const gltf::sources::Vector& vector) {
+                            pBufferData = vector.bytes.data();
+                            bufferSize = vector.bytes.size();
+                        },
+                        [&](const gltf::sources::Array& array) {
+                            pBufferData = array.bytes.data();
+                            bufferSize = array.bytes.size();
+                        },
+                        [&](const gltf::sources::ByteView& byteView) {
+                            pBufferData = byteView.bytes.data();
+                            bufferSize = byteView.bytes.size();
+                        },
+                    },
+                    buffer.data);
+
+                    if (pBufferData && bufferView.byteOffset + bufferView.byteLength <= bufferSize) {
+                        SetData(pBufferData + bufferView.byteOffset, bufferView.byteLength);
+                    }
+                },
+            },
+        image.data);
+    }
+}
+
+
+static constexpr uint64_t SCENE_SOURCE_HASH_SEED = 14695981039346656037ull; // FNV-1a offset basis
+
+
+// FNV-1a over 8 byte words. Unlike eng::HashMem it reads the whole data, since any change of the source must invalidate the cache
+static uint64_t HashSceneSourceData(uint64_t hash, std::span<const uint8_t> data)
+{
+    static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    const size_t wordCount = data.size() / sizeof(uint64_t);
+
+    for (size_t i = 0; i < wordCount; ++i) {
+        uint64_t word;
+        memcpy(&word, data.data() + i * sizeof(uint64_t), sizeof(word));
+
+        hash = (hash ^ word) * FNV_PRIME;
+    }
+
+    for (size_t i = wordCount * sizeof(uint64_t); i < data.size(); ++i) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+
+// Data is written to temporary file first, so interrupted writing doesn't leave corrupted cache
+static bool WriteCacheFile(const fs::path& path, std::span<const uint8_t> data)
+{
+    fs::path tmpPath = path;
+    tmpPath += ".tmp";
+
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open()) {
+        CORE_LOG_WARN("Failed to open cache file %s for writing", tmpPath.string().c_str());
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    file.close();
+
+    std::error_code error;
+
+    if (file.fail()) {
+        CORE_LOG_WARN("Failed to write cache file %s", tmpPath.string().c_str());
+        fs::remove(tmpPath, error);
+        return false;
+    }
+
+    fs::rename(tmpPath, path, error);
+
+    if (error) {
+        CORE_LOG_WARN("Failed to replace cache file %s: %s", path.string().c_str(), error.message().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+
+enum MaterialTextureRoleFlags : uint32_t
+{
+    MATERIAL_TEXTURE_ROLE_ALBEDO      = 0x1,
+    MATERIAL_TEXTURE_ROLE_NORMAL      = 0x2,
+    MATERIAL_TEXTURE_ROLE_METAL_ROUGH = 0x4,
+    MATERIAL_TEXTURE_ROLE_AO          = 0x8,
+    MATERIAL_TEXTURE_ROLE_EMISSIVE    = 0x10,
+};
+
+
+// Channels which aren't needed by texture role are dropped and the rest are swizzled back by texture view, so shaders don't depend on encoding
+struct MaterialTextureEncoding
+{
+    eng::BCEncodeInfo bcInfo;
+    VkComponentMapping mapping = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
+    bool isNormalMap = false;
+};
+
+
+static MaterialTextureEncoding GetMaterialTextureEncoding(uint32_t roleFlags)
+{
+    MaterialTextureEncoding encoding = {};
+
+    switch (roleFlags) {
+        case MATERIAL_TEXTURE_ROLE_NORMAL:
+            // Z is reconstructed in shader
+            encoding.bcInfo.format = VK_FORMAT_BC5_UNORM_BLOCK;
+            encoding.bcInfo.channels = { 0, 1 };
+            encoding.isNormalMap = true;
+            break;
+        case MATERIAL_TEXTURE_ROLE_METAL_ROUGH:
+            // Roughness (G) and metalness (B) are stored in RG
+            encoding.bcInfo.format = VK_FORMAT_BC5_UNORM_BLOCK;
+            encoding.bcInfo.channels = { 1, 2 };
+            encoding.mapping = { VK_COMPONENT_SWIZZLE_ONE, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_ONE };
+            break;
+        case MATERIAL_TEXTURE_ROLE_AO:
+            encoding.bcInfo.format = VK_FORMAT_BC4_UNORM_BLOCK;
+            encoding.bcInfo.channels = { 0, 0 };
+            break;
+        default:
+            // Albedo, emissive, packed occlusion-roughness-metalness and images with several unrelated roles
+            encoding.bcInfo.format = VK_FORMAT_BC7_UNORM_BLOCK;
+            encoding.bcInfo.isPerceptual = (roleFlags & (MATERIAL_TEXTURE_ROLE_NORMAL | MATERIAL_TEXTURE_ROLE_METAL_ROUGH | MATERIAL_TEXTURE_ROLE_AO)) == 0;
+            break;
+    }
+
+    return encoding;
+}
+
+
+static void GetMaterialTextureRoles(size_t textureCount, std::vector<uint32_t>& outRoles)
+{
+    outRoles.assign(textureCount, 0);
+
+    auto AddRole = [&outRoles](int texID, uint32_t role) {
+        if (texID >= 0 && static_cast<size_t>(texID) < outRoles.size()) {
+            outRoles[texID] |= role;
+        }
+    };
+
+    for (const GPU_GeomMaterial& mtl : s_cpuMaterialData) {
+        AddRole(mtl.albedoTexID, MATERIAL_TEXTURE_ROLE_ALBEDO);
+        AddRole(mtl.normalTexID, MATERIAL_TEXTURE_ROLE_NORMAL);
+        AddRole(mtl.metalRoughTexID, MATERIAL_TEXTURE_ROLE_METAL_ROUGH);
+        AddRole(mtl.aoTexID, MATERIAL_TEXTURE_ROLE_AO);
+        AddRole(mtl.emissiveTexID, MATERIAL_TEXTURE_ROLE_EMISSIVE);
+    }
+}
+
+
+static fs::path GetMaterialTextureCachePath(const fs::path& scenePath, size_t textureIdx)
+{
+    fs::path dirPath = scenePath;
+    dirPath += ".texture_cache";
+
+    return dirPath / (std::to_string(textureIdx) + ".ktx2");
+}
+
+
+static std::string HashMaterialTextureSource(std::span<const uint8_t> encodedImage, const MaterialTextureEncoding& encoding)
+{
+    const std::array<uint32_t, 5> params = { 
+        MATERIAL_TEXTURE_CACHE_VERSION, 
+        static_cast<uint32_t>(encoding.bcInfo.format), 
+        encoding.bcInfo.channels[0] | (encoding.bcInfo.channels[1] << 8),
+        encoding.bcInfo.isPerceptual,
+        encoding.isNormalMap,
+    };
+
+    uint64_t hash = HashSceneSourceData(SCENE_SOURCE_HASH_SEED, std::span(reinterpret_cast<const uint8_t*>(params.data()), sizeof(params)));
+    hash = HashSceneSourceData(hash, encodedImage);
+
+    std::array<char, 17> str = {};
+    sprintf_s(str.data(), str.size(), "%016llx", static_cast<unsigned long long>(hash));
+
+    return str.data();
+}
+
+
+// 2x2 box filter. Normal map texels are renormalized, otherwise averaged normals get shorter and distant surfaces look flatter
+static void GenerateMipRGBA8(const uint8_t* pSrc, uint32_t srcWidth, uint32_t srcHeight, bool isNormalMap, std::vector<uint8_t>& outMip)
+{
+    const uint32_t dstWidth = std::max(srcWidth / 2, 1u);
+    const uint32_t dstHeight = std::max(srcHeight / 2, 1u);
+
+    outMip.resize(size_t(dstWidth) * dstHeight * 4);
+
+    auto LoadTexel = [&](uint32_t x, uint32_t y) {
+        const uint8_t* pTexel = pSrc + (size_t(std::min(y, srcHeight - 1)) * srcWidth + std::min(x, srcWidth - 1)) * 4;
+        return glm::float4(pTexel[0], pTexel[1], pTexel[2], pTexel[3]);
+    };
+
+    for (uint32_t y = 0; y < dstHeight; ++y) {
+        for (uint32_t x = 0; x < dstWidth; ++x) {
+            glm::float4 texel = 0.25f * (LoadTexel(2 * x, 2 * y) + LoadTexel(2 * x + 1, 2 * y) + LoadTexel(2 * x, 2 * y + 1) + LoadTexel(2 * x + 1, 2 * y + 1));
+
+            if (isNormalMap) {
+                const glm::float3 normal = glm::float3(texel) / 127.5f - 1.f;
+                const float length = glm::length(normal);
+
+                if (length > 0.f) {
+                    texel = glm::float4((normal / length + 1.f) * 127.5f, texel.w);
+                }
+            }
+
+            const glm::float4 result = glm::round(glm::clamp(texel, 0.f, 255.f));
+
+            uint8_t* pDstTexel = outMip.data() + (size_t(y) * dstWidth + x) * 4;
+
+            for (glm::length_t i = 0; i < 4; ++i) {
+                pDstTexel[i] = static_cast<uint8_t>(result[i]);
+            }
+        }
+    }
+}
+
+
+// Encodes all mips of material texture into KTX2 container. Returns false if image can't be decoded
+static bool EncodeMaterialTexture(std::span<const uint8_t> encodedImage, const MaterialTextureEncoding& encoding, std::string_view sourceHash, 
+    std::vector<uint8_t>& outKTX2Data)
+{
+    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Encode_Material_Texture");
+
+    TextureLoadData image;
+
+    if (!image.LoadRGBA8(encodedImage.data(), encodedImage.size())) {
+        return false;
+    }
+
+    const uint32_t width = image.GetWidth();
+    const uint32_t height = image.GetHeight();
+    const uint32_t mipCount = image.GetMipsCount();
+
+    std::vector<std::vector<uint8_t>> encodedMips(mipCount);
+    std::array<std::vector<uint8_t>, 2> mipTexelBuffers;
+
+    const uint8_t* pMipTexels = static_cast<const uint8_t*>(image.GetData());
+
+    for (uint32_t mip = 0; mip < mipCount; ++mip) {
+        const uint32_t mipWidth = std::max(width >> mip, 1u);
+        const uint32_t mipHeight = std::max(height >> mip, 1u);
+
+        if (mip > 0) {
+            std::vector<uint8_t>& mipTexels = mipTexelBuffers[mip % 2];
+            GenerateMipRGBA8(pMipTexels, std::max(width >> (mip - 1), 1u), std::max(height >> (mip - 1), 1u), encoding.isNormalMap, mipTexels);
+
+            pMipTexels = mipTexels.data();
+        }
+
+        if (!eng::EncodeBC(encoding.bcInfo, pMipTexels, mipWidth, mipHeight, encodedMips[mip])) {
+            return false;
+        }
+    }
+
+    const std::vector<std::span<const uint8_t>> mips(encodedMips.cbegin(), encodedMips.cend());
+
+    const eng::KTX2Texture::KeyValue keyValues[] = {
+        { "KTXwriter", "VkEngine" },
+        { MATERIAL_TEXTURE_SOURCE_HASH_KEY, sourceHash },
+    };
+
+    eng::KTX2Texture::Write(outKTX2Data, encoding.bcInfo.format, width, height, mips, keyValues);
+
+    return !outKTX2Data.empty();
+}
+
+
+// Cached texture is valid only if it was encoded from the same source with the same encoding
+static bool LoadMaterialTextureCache(const fs::path& path, VkFormat format, std::string_view sourceHash, eng::MappedFile& outFile, 
+    eng::KTX2Texture& outTexture)
+{
+    if (!outFile.Open(path)) {
+        return false;
+    }
+
+    if (!outTexture.Parse(std::span(outFile.GetData(), outFile.GetSize())) || outTexture.GetFormat() != format || 
+        outTexture.FindValue(MATERIAL_TEXTURE_SOURCE_HASH_KEY) != sourceHash
+    ) {
+        outTexture.Reset();
+        outFile.Close();
+
+        return false;
+    }
+
+    return true;
+}
+
+
+// Decodes scene images on the thread pool and uploads each of them as soon as it's ready. Images are block compressed according to their
+// material roles, so materials must be loaded before. Compressed textures are cached next to the scene and loaded directly on the next runs.
+// Decoded but not yet uploaded data is limited by TEXTURE_STREAMING_MEMORY_BUDGET. Budget is reserved with header based estimates before
+// submission, so decode tasks never block pool workers
+static void LoadSceneTexturesData(const fs::path& scenePath, std::span<const SceneImageSource> imageSources)
+{
+    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Load_Scene_Textures_Data");
+
+    eng::Timer timer;
+
+    const size_t textureCount = imageSources.size();
+
+    s_commonMaterialTextures.resize(textureCount);
+    s_commonMaterialTextureViews.resize(textureCount);
+
+    std::vector<uint32_t> textureRoles;
+    GetMaterialTextureRoles(textureCount, textureRoles);
+
+    if (textureCount > 0) {
+        std::error_code error;
+        fs::create_directories(GetMaterialTextureCachePath(scenePath, 0).parent_path(), error);
+    }
+
+    struct DecodedTexture
+    {
+        size_t textureIdx;
+
+        // Uncompressed fallback for HDR images, which aren't block compressed
+        TextureLoadData data;
+
+        eng::MappedFile compressedFile;
+        std::vector<uint8_t> compressedData;
+        eng::KTX2Texture compressed;
+        VkComponentMapping mapping;
+    };
+
+    // Decoded RGBA mip 0 bounds both cached and encoded block compressed data. Only image headers are read here
+    std::vector<size_t> reservedMemorySizes(textureCount, 0);
+
+    for (size_t i = 0; i < textureCount; ++i) {
+        const SceneImageSource& source = imageSources[i];
+
+        eng::MappedFile file;
+        std::span<const uint8_t> encodedData = source.data;
+
+        if (source.IsExternal() && file.Open(source.filepath)) {
+            encodedData = std::span(file.GetData(), file.GetSize());
+        }
+
+        if (!encodedData.empty()) {
+            reservedMemorySizes[i] = TextureLoadData::EstimateDecodedSize(encodedData.data(), encodedData.size());
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable readyCV;
+
+    std::deque<DecodedTexture> readyTextures;
+
+    std::atomic<uint32_t> encodedCount = 0;
+
+    auto SubmitDecodeTask = [&](size_t textureIdx) {
+        eng::GetThreadPool().Submit([&, textureIdx]() {
+            const SceneImageSource& source = imageSources[textureIdx];
+
+            ENG_PROFILE_SCOPED_MARKER_C_FMT(0x8b008b, "Decode_Scene_Texture_%zu", textureIdx);
+
+            const MaterialTextureEncoding encoding = GetMaterialTextureEncoding(textureRoles[textureIdx]);
+            const fs::path cachePath = GetMaterialTextureCachePath(scenePath, textureIdx);
+
+            DecodedTexture decoded = {};
+            decoded.textureIdx = textureIdx;
+            decoded.mapping = encoding.mapping;
+
+            // Keeps external image file mapped until it's decoded
+            eng::MappedFile file;
+            std::span<const uint8_t> encodedData = source.data;
+
+            if (source.IsExternal() && file.Open(source.filepath)) {
+                encodedData = std::span(file.GetData(), file.GetSize());
+            }
+
+            std::string sourceHash;
+
+            if (!encodedData.empty()) {
+                sourceHash = HashMaterialTextureSource(encodedData, encoding);
+                LoadMaterialTextureCache(cachePath, encoding.bcInfo.format, sourceHash, decoded.compressedFile, decoded.compressed);
+            }
+
+            if (!encodedData.empty() && !decoded.compressed.IsParsed()) {
+                // There is no BC6H encoder, so HDR images stay uncompressed
+                const bool isHDR = TextureLoadData::IsHDR(encodedData.data(), encodedData.size());
+
+                if (!isHDR && EncodeMaterialTexture(encodedData, encoding, sourceHash, decoded.compressedData)) {
+                    decoded.compressed.Parse(decoded.compressedData);
+                    WriteCacheFile(cachePath, decoded.compressedData);
 
-    eng::Timer timer;
+                    ++encodedCount;
+                } else {
+                    decoded.data.Load(encodedData.data(), encodedData.size());
+                }
+            }
+            decoded.data.SetName(source.name);
 
-    for (const gltf::Mesh& mesh : asset.meshes) {
-        for (size_t primIdx = 0; primIdx < mesh.primitives.size(); ++primIdx) {
-            LoadSceneMeshInstData(asset, mesh, primIdx);
-        }
-    }
+            // Notify under the lock, otherwise loading thread may leave the function and destroy sync objects before notification
+            std::scoped_lock lock(mutex);
+            readyTextures.emplace_back(std::move(decoded));
+            readyCV.notify_one();
+        });
+    };
 
-    CORE_LOG_INFO("FastGLTF: Mesh loading finished: %f ms", timer.End().GetDuration<float, std::milli>());
-}
+    // Reservations are made and released only by this thread
+    size_t reservedMemorySize = 0;
+    size_t submittedCount = 0;
 
+    for (size_t uploadedCount = 0; uploadedCount < textureCount; ++uploadedCount) {
+        // Single texture bigger than the whole budget is still submitted when nothing else is reserved
+        while (submittedCount < textureCount) {
+            const size_t textureMemorySize = reservedMemorySizes[submittedCount];
 
-static void LoadSceneTexturesData(const gltf::Asset& asset, const fs::path& dirPath)
-{
-    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Load_Scene_Textures_Data");
+            if (reservedMemorySize != 0 && reservedMemorySize + textureMemorySize > TEXTURE_STREAMING_MEMORY_BUDGET) {
+                break;
+            }
 
-    eng::Timer timer;
+            reservedMemorySize += textureMemorySize;
+            SubmitDecodeTask(submittedCount++);
+        }
 
-    s_cpuTexturesData.reserve(asset.images.size());
-    s_cpuTexturesData.clear();
+        DecodedTexture decoded = {};
 
-    for (const gltf::Image& image : asset.images) {
-        TextureLoadData texData = {};
+        {
+            std::unique_lock lock(mutex);
+            readyCV.wait(lock, [&]() { return !readyTextures.empty(); });
 
-        std::visit(
-            gltf::visitor {
-                [](const auto& arg){},
-                [&](const gltf::sources::URI& filePath) {   
-                    const fs::path path = filePath.uri.isLocalPath() ? fs::absolute(dirPath / filePath.uri.fspath()) : filePath.uri.fspath();
-                    texData.Load(path);
-                },
-                [&](const gltf::sources::Vector& vector) {
-                    texData.Load(vector.bytes.data(), vector.bytes.size());
-                },
-                [&](const gltf::sources::BufferView& view) {
-                    const gltf::BufferView& bufferView = asset.bufferViews[view.bufferViewIndex];
-                    const gltf::Buffer& buffer = asset.buffers[bufferView.bufferIndex];
-    
-                    std::visit(gltf::visitor {
-                        [](const auto& arg){},
-                        [&](const gltf::sources::Vector& vector) {
-                            texData.Load(vector.bytes.data(), vector.bytes.size());                            
-                        }
-                    },
-                    buffer.data);
-                },
-            },
-        image.data);
+            decoded = std::move(readyTextures.front());
+            readyTextures.pop_front();
+        }
+
+        if (decoded.compressed.IsParsed()) {
+            UploadGPUTexture(decoded.textureIdx, decoded.compressed, decoded.mapping, decoded.data.GetName());
+        } else {
+            UploadGPUTexture(decoded.textureIdx, decoded.data);
+        }
 
-        texData.SetName(image.name);
+        decoded.data.Unload();
+        decoded.compressed.Reset();
+        decoded.compressedFile.Close();
+        decoded.compressedData = {};
 
-        s_cpuTexturesData.emplace_back(std::move(texData));
+        reservedMemorySize -= reservedMemorySizes[decoded.textureIdx];
     }
 
-    CORE_LOG_INFO("FastGLTF: Textures data loading finished: %f ms", timer.End().GetDuration<float, std::milli>());
+    CORE_LOG_INFO("FastGLTF: Textures data loading and GPU upload finished (%u of %zu textures encoded): %f ms", encodedCount.load(), textureCount, 
+        timer.End().GetDuration<float, std::milli>());
 }
 
 
@@ -5530,6 +7577,21 @@ static void LoadSceneMaterialData(const gltf::Asset& asset)
 }
 
 
+static void SetMainCameraFromScene(const SceneCameraData& cameraData)
+{
+    s_mainCamera.SetTransform(cameraData.transform);
+
+    if (cameraData.isPerspective) {
+        s_mainCamera.SetPerspProjection(cameraData.yfov, (float)s_pWnd->GetWidth() / s_pWnd->GetHeight(), cameraData.znear, cameraData.zfar);
+    } else {
+        s_mainCamera.SetOrthoProjection(-cameraData.xmag, cameraData.xmag, -cameraData.ymag, cameraData.ymag, cameraData.znear, cameraData.zfar);
+    }
+
+    s_mainCameraData = cameraData;
+    s_mainCameraLoaded = true;
+}
+
+
 static void LoadSceneInstData(const gltf::Asset& asset)
 {
     ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Load_Scene_Inst_Data");
@@ -5556,6 +7618,33 @@ static void LoadSceneInstData(const gltf::Asset& asset)
     s_cpuInstData.reserve(meshInstCount);
     s_cpuInstData.clear();
 
+    s_cpuPunctualLightData.clear();
+
+    // Animated nodes and their children are dynamic. They aren't cached in CSM static cache
+    std::vector<bool> isNodeDynamic(asset.nodes.size(), false);
+
+    std::function<void(size_t)> MarkNodeDynamic = [&](size_t nodeIdx) {
+        if (isNodeDynamic[nodeIdx]) {
+            return;
+        }
+
+        isNodeDynamic[nodeIdx] = true;
+
+        for (size_t childIdx : asset.nodes[nodeIdx].children) {
+            MarkNodeDynamic(childIdx);
+        }
+    };
+
+    for (const gltf::Animation& animation : asset.animations) {
+        for (const gltf::AnimationChannel& channel : animation.channels) {
+            if (channel.nodeIndex.has_value()) {
+                MarkNodeDynamic(channel.nodeIndex.value());
+            }
+        }
+    }
+
+    std::vector<GPU_GeomInst> dynamicInstData;
+
     auto GetInstAABB = [&](uint32_t meshIdx, const glm::float4x4& wMatr) -> math::AABB
     {
         const GPU_Mesh& mesh = s_cpuMeshData[meshIdx];
@@ -5596,25 +7685,70 @@ static void LoadSceneInstData(const gltf::Asset& asset)
                     inst.matrWCS = glm::transpose(transform);
                     inst.PackAABB_WCS(GetInstAABB(inst.meshID, transform));
 
-                    s_cpuInstData.emplace_back(inst);
+                    const size_t nodeIdx = &node - asset.nodes.data();
+
+                    if (isNodeDynamic[nodeIdx]) {
+                        dynamicInstData.emplace_back(inst);
+                    } else {
+                        s_cpuInstData.emplace_back(inst);
+                    }
                 }
             } else if (!s_mainCameraLoaded && node.cameraIndex.has_value()) {
                 const gltf::Camera& camera = asset.cameras[node.cameraIndex.value()];
 
-                s_mainCamera.SetTransform(transform);
+                SceneCameraData cameraData = {};
+                cameraData.transform = transform;
 
                 if (std::holds_alternative<gltf::Camera::Perspective>(camera.camera)) {
                     const gltf::Camera::Perspective& proj = std::get<gltf::Camera::Perspective>(camera.camera);
 
-                    s_mainCamera.SetPerspProjection(proj.yfov, (float)s_pWnd->GetWidth() / s_pWnd->GetHeight(), proj.znear, 
-                        proj.zfar.has_value() ? proj.zfar.value() : CAMERA_ZFAR);
+                    cameraData.isPerspective = true;
+                    cameraData.yfov = proj.yfov;
+                    cameraData.znear = proj.znear;
+                    cameraData.zfar = proj.zfar.has_value() ? proj.zfar.value() : CAMERA_ZFAR;
                 } else {
                     const gltf::Camera::Orthographic& proj = std::get<gltf::Camera::Orthographic>(camera.camera);
 
-                    s_mainCamera.SetOrthoProjection(-proj.xmag, proj.xmag, -proj.ymag, proj.ymag, proj.znear, proj.zfar);
+                    cameraData.isPerspective = false;
+                    cameraData.xmag = proj.xmag;
+                    cameraData.ymag = proj.ymag;
+                    cameraData.znear = proj.znear;
+                    cameraData.zfar = proj.zfar;
+                }
+
+                SetMainCameraFromScene(cameraData);
+            }
+
+            if (node.lightIndex.has_value()) {
+                const gltf::Light& light = asset.lights[node.lightIndex.value()];
+
+                if (light.type == gltf::LightType::Directional) {
+                    CORE_LOG_WARN("Directional light \"%s\" is skipped. Only sun directional light is supported", light.name.c_str());
+                    return;
+                }
+
+                GPU_PunctualLight gpuLight = {};
+
+                gpuLight.wpos = transform[3];
+                gpuLight.direction = glm::normalize(glm::float3(transform * glm::float4(-M3D_AXIS_Z, 0.f)));
+                gpuLight.color = glm::float3(light.color[0], light.color[1], light.color[2]) * light.intensity;
+                
+                // glTF lights without range have infinite one, so it's limited by inverse square falloff
+                const float maxIntensity = glm::max(gpuLight.color.x, glm::max(gpuLight.color.y, gpuLight.color.z));
+                gpuLight.range = light.range.has_value() ? light.range.value() : glm::sqrt(maxIntensity / PUNCTUAL_LIGHT_MIN_INTENSITY);
+
+                if (light.type == gltf::LightType::Spot) {
+                    const float cosInner = glm::cos(light.innerConeAngle.has_value() ? light.innerConeAngle.value() : 0.f);
+                    const float cosOuter = glm::cos(light.outerConeAngle.has_value() ? light.outerConeAngle.value() : glm::radians(45.f));
+
+                    gpuLight.type = PUNCTUAL_LIGHT_TYPE_SPOT;
+                    gpuLight.spotAngleScale = 1.f / glm::max(cosInner - cosOuter, 0.001f);
+                    gpuLight.spotAngleOffset = -cosOuter * gpuLight.spotAngleScale;
+                } else {
+                    gpuLight.type = PUNCTUAL_LIGHT_TYPE_POINT;
                 }
 
-                s_mainCameraLoaded = true;
+                s_cpuPunctualLightData.emplace_back(gpuLight);
             }
         });
     }
@@ -5623,283 +7757,548 @@ static void LoadSceneInstData(const gltf::Asset& asset)
 
     timer.Reset().Start();
 
-    std::sort(s_cpuInstData.begin(), s_cpuInstData.end(), 
-        [](const GPU_GeomInst& a, const GPU_GeomInst& b) {
-            return a.meshID < b.meshID;
-        }
-    );
+    auto SortInstances = [](std::vector<GPU_GeomInst>& instances) {
+        std::sort(instances.begin(), instances.end(), 
+            [](const GPU_GeomInst& a, const GPU_GeomInst& b) {
+                return a.meshID < b.meshID;
+            }
+        );
+    };
+
+    SortInstances(s_cpuInstData);
+    SortInstances(dynamicInstData);
+
+    s_geomFirstDynamicInstID = s_cpuInstData.size();
+    s_cpuInstData.insert(s_cpuInstData.end(), dynamicInstData.begin(), dynamicInstData.end());
+
+    CORE_LOG_INFO("Instance data sorting finished: %f ms", timer.End().GetDuration<float, std::milli>());
+}
+
+
+static void UploadGPUGeomStream(GPU_GeomStreamID ID)
+{
+    const std::span<const uint32_t> stream = s_sceneGeomUploadData.streams[ID];
+    const size_t gpuStreamSize = stream.size_bytes();
+
+    vkn::AllocationInfo streamBufAllocInfo = {};
+    streamBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
+    streamBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    s_geomStreamBuffers[ID].Create(&s_vkDevice, gpuStreamSize, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, streamBufAllocInfo);
+    s_vkDevice.SetObjDebugName(s_geomStreamBuffers[ID], "COMMON_GEOM_STREAM_%s", COMMON_GEOM_STREAM_DBG_NAMES[ID]);
+
+    s_uploadManager.UploadBuffer(s_geomStreamBuffers[ID], stream.data(), gpuStreamSize);
+}
+
+
+static void UploadGPUMeshData()
+{
+    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Upload_GPU_Mesh_Data");
+
+    eng::Timer timer;
+
+    for (size_t i = 0; i < COMMON_GEOM_STREAM_COUNT; ++i) {
+        UploadGPUGeomStream(static_cast<GPU_GeomStreamID>(i));
+    }
+
+    const size_t gpuIndexBufferSize = s_sceneGeomUploadData.indices.size_bytes();
+    vkn::AllocationInfo idxBufAllocInfo = {};
+    idxBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
+    idxBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    s_geomIndexBuffer.Create(&s_vkDevice, gpuIndexBufferSize, VK_BUFFER_USAGE_2_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, idxBufAllocInfo);
+    s_vkDevice.SetObjDebugName(s_geomIndexBuffer, "COMMON_IB");
+
+    s_uploadManager.UploadBuffer(s_geomIndexBuffer, s_sceneGeomUploadData.indices.data(), gpuIndexBufferSize);
+
+    const size_t meshDataBufferSize = s_cpuMeshData.size() * sizeof(GPU_Mesh);
+    vkn::AllocationInfo meshInfosBufAllocInfo = {};
+    meshInfosBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
+    meshInfosBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    
+    s_commonMeshBuffer.Create(&s_vkDevice, meshDataBufferSize, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, meshInfosBufAllocInfo);
+    s_vkDevice.SetObjDebugName(s_commonMeshBuffer, "COMMON_MESH_BUFFER");
+
+    s_uploadManager.UploadBuffer(s_commonMeshBuffer, s_cpuMeshData.data(), meshDataBufferSize);
+
+    const size_t meshLODDataBufferSize = s_sceneGeomUploadData.lods.size_bytes();
+    vkn::AllocationInfo meshLODInfosBufAllocInfo = {};
+    meshLODInfosBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
+    meshLODInfosBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    
+    s_commonMeshLODBuffer.Create(&s_vkDevice, meshLODDataBufferSize, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, meshLODInfosBufAllocInfo);
+    s_vkDevice.SetObjDebugName(s_commonMeshLODBuffer, "COMMON_MESH_LOD_BUFFER");
+
+    s_uploadManager.UploadBuffer(s_commonMeshLODBuffer, s_sceneGeomUploadData.lods.data(), meshLODDataBufferSize);
+
+    CORE_LOG_INFO("FastGLTF: Mesh data GPU upload finished: %f ms", timer.End().GetDuration<float, std::milli>());
+}
+
+
+static void UploadGPUMaterialData()
+{
+    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Upload_GPU_Material_Data");
+
+    eng::Timer timer;
+
+    const size_t mtlDataBufferSize = s_cpuMaterialData.size() * sizeof(GPU_GeomMaterial);
+    vkn::AllocationInfo mtlBufAllocInfo = {};
+    mtlBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
+    mtlBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    s_commonMaterialBuffer.Create(&s_vkDevice, mtlDataBufferSize, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, mtlBufAllocInfo);
+    s_vkDevice.SetObjDebugName(s_commonMaterialBuffer, "COMMON_MATERIAL_DATA");
+
+    s_uploadManager.UploadBuffer(s_commonMaterialBuffer, s_cpuMaterialData.data(), mtlDataBufferSize);
+
+    CORE_LOG_INFO("FastGLTF: Material data GPU upload finished: %f ms", timer.End().GetDuration<float, std::milli>());
+}
+
+
+static void UploadGPUInstData()
+{
+    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Upload_GPU_Inst_Data");
+
+    eng::Timer timer;
+
+    const size_t instBufferSize = s_cpuInstData.size() * sizeof(GPU_GeomInst);
+    vkn::AllocationInfo instInfosBufAllocInfo = {};
+    instInfosBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
+    instInfosBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    s_commonInstBuffer.Create(&s_vkDevice, instBufferSize, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, instInfosBufAllocInfo);
+    s_vkDevice.SetObjDebugName(s_commonInstBuffer, "COMMON_INSTANCE_BUFFER");
+
+    s_uploadManager.UploadBuffer(s_commonInstBuffer, s_cpuInstData.data(), instBufferSize);
+
+    CORE_LOG_INFO("FastGLTF: Instance data GPU upload finished: %f ms", timer.End().GetDuration<float, std::milli>());
+}
+
+
+static void UploadGPULightData()
+{
+    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Upload_GPU_Light_Data");
+
+    // Buffer can't be empty, since it's bound even if scene has no lights
+    const size_t lightBufferSize = std::max<size_t>(s_cpuPunctualLightData.size(), 1) * sizeof(GPU_PunctualLight);
+    vkn::AllocationInfo lightBufAllocInfo = {};
+    lightBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
+    lightBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    s_punctualLightBuffer.Create(&s_vkDevice, lightBufferSize, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, lightBufAllocInfo);
+    s_vkDevice.SetObjDebugName(s_punctualLightBuffer, "PUNCTUAL_LIGHT_BUFFER");
+
+    if (!s_cpuPunctualLightData.empty()) {
+        s_uploadManager.UploadBuffer(s_punctualLightBuffer, s_cpuPunctualLightData.data(), s_cpuPunctualLightData.size() * sizeof(GPU_PunctualLight));
+    }
+}
+
+
+static void UploadGPUResources()
+{
+    UploadGPUMeshData();
+    UploadGPUInstData();
+    UploadGPULightData();
+    UploadGPUMaterialData();
+
+    // Scene, skybox and texture uploads are batched, so this is the only point where CPU waits for them
+    s_uploadManager.WaitIdle();
+
+    s_sceneGeomUploadData = {};
+    s_sceneCacheFile.Close();
+}
+
+
+enum SceneCacheSectionID : uint32_t
+{
+    SCENE_CACHE_SECTION_GEOM_STREAMS,                                                  // COMMON_GEOM_STREAM_COUNT consecutive sections
+    SCENE_CACHE_SECTION_GEOM_INDICES = SCENE_CACHE_SECTION_GEOM_STREAMS + COMMON_GEOM_STREAM_COUNT,
+    SCENE_CACHE_SECTION_MESHES,
+    SCENE_CACHE_SECTION_MESH_LODS,
+    SCENE_CACHE_SECTION_MATERIALS,
+    SCENE_CACHE_SECTION_INSTANCES,
+    SCENE_CACHE_SECTION_PUNCTUAL_LIGHTS,
+    SCENE_CACHE_SECTION_IMAGES,                                                        // SceneCacheImage array
+    SCENE_CACHE_SECTION_DEPENDENCIES,                                                  // SceneCacheRange array of source file paths
+    SCENE_CACHE_SECTION_BLOB,                                                          // Strings and embedded images referenced by other sections
+
+    SCENE_CACHE_SECTION_COUNT
+};
+
+
+// Byte range in the cache file for sections and in the blob section for data referenced from them
+struct SceneCacheRange
+{
+    uint64_t offset;
+    uint64_t size;
+};
+
+
+// Path is relative to the scene directory for local external images. Data is set only for embedded ones
+struct SceneCacheImage
+{
+    SceneCacheRange name;
+    SceneCacheRange path;
+    SceneCacheRange data;
+};
+
+
+struct SceneCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+
+    SceneCameraData camera;
+    uint32_t isCameraLoaded;
+    uint32_t firstDynamicInstID;
+
+    std::array<SceneCacheRange, SCENE_CACHE_SECTION_COUNT> sections;
+};
+
+
+static constexpr uint32_t SCENE_CACHE_MAGIC = 0x4E435353; // "SSCN"
+// Must be incremented when cache layout or scene processing (LOD generation, streams packing) is changed
+static constexpr uint32_t SCENE_CACHE_VERSION = 1;
+
+static constexpr size_t SCENE_CACHE_SECTION_ALIGNMENT = 16;
+
+
+static constexpr size_t GetSceneCacheSectionElemSize(uint32_t sectionID)
+{
+    if (sectionID < SCENE_CACHE_SECTION_GEOM_INDICES) {
+        return sizeof(uint32_t);
+    }
+
+    switch (sectionID) {
+        case SCENE_CACHE_SECTION_GEOM_INDICES:      return sizeof(IndexType);
+        case SCENE_CACHE_SECTION_MESHES:            return sizeof(GPU_Mesh);
+        case SCENE_CACHE_SECTION_MESH_LODS:         return sizeof(GPU_MeshLOD);
+        case SCENE_CACHE_SECTION_MATERIALS:         return sizeof(GPU_GeomMaterial);
+        case SCENE_CACHE_SECTION_INSTANCES:         return sizeof(GPU_GeomInst);
+        case SCENE_CACHE_SECTION_PUNCTUAL_LIGHTS:   return sizeof(GPU_PunctualLight);
+        case SCENE_CACHE_SECTION_IMAGES:            return sizeof(SceneCacheImage);
+        case SCENE_CACHE_SECTION_DEPENDENCIES:      return sizeof(SceneCacheRange);
+        default:                                    return 1;
+    }
+}
+
+
+static fs::path GetSceneCachePath(const fs::path& scenePath)
+{
+    fs::path cachePath = scenePath;
+    cachePath += ".scene_cache";
+
+    return cachePath;
+}
+
+
+// Hash of glTF file, its external buffers and layout of cached structures. Images aren't hashed, since they're loaded from their files anyway
+static bool HashSceneSources(const fs::path& scenePath, std::span<const fs::path> dependencyPaths, uint64_t& outHash)
+{
+    static constexpr std::array<uint32_t, SCENE_CACHE_SECTION_COUNT + 1> layout = [](){
+        std::array<uint32_t, SCENE_CACHE_SECTION_COUNT + 1> sizes = {};
+
+        for (uint32_t i = 0; i < SCENE_CACHE_SECTION_COUNT; ++i) {
+            sizes[i] = GetSceneCacheSectionElemSize(i);
+        }
+        sizes.back() = sizeof(SceneCacheHeader);
+
+        return sizes;
+    }();
+
+    uint64_t hash = HashSceneSourceData(SCENE_SOURCE_HASH_SEED, std::span(reinterpret_cast<const uint8_t*>(layout.data()), sizeof(layout)));
+
+    eng::MappedFile file;
+
+    if (!file.Open(scenePath)) {
+        return false;
+    }
+
+    hash = HashSceneSourceData(hash, std::span(file.GetData(), file.GetSize()));
+
+    for (const fs::path& path : dependencyPaths) {
+        const fs::path fullPath = path.is_absolute() ? path : scenePath.parent_path() / path;
+
+        if (!file.Open(fullPath)) {
+            return false;
+        }
+
+        hash = HashSceneSourceData(hash, std::span(file.GetData(), file.GetSize()));
+    }
+
+    outHash = hash;
+
+    return true;
+}
+
+
+static gltf::Parser CreateSceneGltfParser()
+{
+    static constexpr gltf::Extensions requiredExtensions =
+        gltf::Extensions::KHR_mesh_quantization |
+        gltf::Extensions::KHR_texture_transform |
+        gltf::Extensions::KHR_materials_variants |
+        gltf::Extensions::KHR_lights_punctual;
 
-    CORE_LOG_INFO("Instance data sorting finished: %f ms", timer.End().GetDuration<float, std::milli>());
+    return gltf::Parser(requiredExtensions);
 }
 
 
-static void UploadGPUGeomStream(GPU_GeomStreamID ID)
+// External buffers are replaced with their data when they are loaded by fastgltf, so their URIs are collected by a separate JSON only parsing
+static bool GetSceneDependencyPaths(const fs::path& scenePath, std::vector<fs::path>& outPaths)
 {
-    const size_t gpuStreamSize = s_cpuGeomStreamBuffers[ID].size() * sizeof(uint32_t);
-    CORE_ASSERT(gpuStreamSize <= s_commonStagingBuffer.GetMemorySize());
+    outPaths.clear();
 
-    void* pDataGPU = s_commonStagingBuffer.Map();
-    memcpy(pDataGPU, s_cpuGeomStreamBuffers[ID].data(), gpuStreamSize);
-    s_commonStagingBuffer.Unmap();
+    gltf::Parser parser = CreateSceneGltfParser();
 
-    vkn::AllocationInfo streamBufAllocInfo = {};
-    streamBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
-    streamBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    gltf::Expected<gltf::MappedGltfFile> gltfFile = gltf::MappedGltfFile::FromPath(scenePath);
+    if (!gltfFile) {
+        return false;
+    }
 
-    s_geomStreamBuffers[ID].Create(&s_vkDevice, gpuStreamSize, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, streamBufAllocInfo);
-    s_vkDevice.SetObjDebugName(s_geomStreamBuffers[ID], "COMMON_GEOM_STREAM_%s", COMMON_GEOM_STREAM_DBG_NAMES[ID]);
+    gltf::Expected<gltf::Asset> asset = parser.loadGltf(gltfFile.get(), scenePath.parent_path(), gltf::Options::DontRequireValidAssetMember);
+    if (asset.error() != gltf::Error::None) {
+        return false;
+    }
 
-    ImmediateSubmitQueue(s_vkDevice.GetQueue(), [&](vkn::CmdBuffer& cmdBuffer){
-        cmdBuffer.CmdCopyBuffer(s_commonStagingBuffer, s_geomStreamBuffers[ID], gpuStreamSize); 
-    });
+    for (const gltf::Buffer& buffer : asset->buffers) {
+        if (const gltf::sources::URI* pURI = std::get_if<gltf::sources::URI>(&buffer.data)) {
+            outPaths.emplace_back(pURI->uri.fspath());
+        }
+    }
+
+    return true;
 }
 
 
-static void UploadGPUMeshData()
+static void SaveSceneCache(const fs::path& scenePath, std::span<const SceneImageSource> imageSources)
 {
-    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Upload_GPU_Mesh_Data");
+    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Save_Scene_Cache");
 
     eng::Timer timer;
 
-    for (size_t i = 0; i < COMMON_GEOM_STREAM_COUNT; ++i) {
-        UploadGPUGeomStream(static_cast<GPU_GeomStreamID>(i));
-    }
+    std::vector<fs::path> dependencyPaths;
+    uint64_t sourceHash = 0;
 
-    const size_t gpuIndexBufferSize = s_cpuGeomIndexBuffer.size() * sizeof(IndexType);
-    CORE_ASSERT(gpuIndexBufferSize <= s_commonStagingBuffer.GetMemorySize());
+    if (!GetSceneDependencyPaths(scenePath, dependencyPaths) || !HashSceneSources(scenePath, dependencyPaths, sourceHash)) {
+        CORE_LOG_WARN("Failed to collect scene sources of %s, scene cache isn't saved", scenePath.string().c_str());
+        return;
+    }
 
-    void* pIndexBufferData = s_commonStagingBuffer.Map();
-    memcpy(pIndexBufferData, s_cpuGeomIndexBuffer.data(), gpuIndexBufferSize);
-    s_commonStagingBuffer.Unmap();
+    std::vector<uint8_t> blob;
 
-    vkn::AllocationInfo idxBufAllocInfo = {};
-    idxBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
-    idxBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    auto AddBlobData = [&blob](const void* pData, size_t size) -> SceneCacheRange {
+        const SceneCacheRange range = { blob.size(), size };
+        blob.insert(blob.end(), static_cast<const uint8_t*>(pData), static_cast<const uint8_t*>(pData) + size);
 
-    s_geomIndexBuffer.Create(&s_vkDevice, gpuIndexBufferSize, VK_BUFFER_USAGE_2_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, idxBufAllocInfo);
-    s_vkDevice.SetObjDebugName(s_geomIndexBuffer, "COMMON_IB");
+        return range;
+    };
 
-    ImmediateSubmitQueue(s_vkDevice.GetQueue(), [&](vkn::CmdBuffer& cmdBuffer){
-        cmdBuffer.CmdCopyBuffer(s_commonStagingBuffer, s_geomIndexBuffer, gpuIndexBufferSize);    
-    });
+    auto AddBlobPath = [&AddBlobData](const fs::path& path) -> SceneCacheRange {
+        const std::u8string str = path.u8string();
+        return AddBlobData(str.data(), str.size());
+    };
 
-    const size_t meshDataBufferSize = s_cpuMeshData.size() * sizeof(GPU_Mesh);
-    CORE_ASSERT(meshDataBufferSize <= s_commonStagingBuffer.GetMemorySize());
+    std::vector<SceneCacheImage> images(imageSources.size());
 
-    void* pMeshBufferData = s_commonStagingBuffer.Map();
-    memcpy(pMeshBufferData, s_cpuMeshData.data(), meshDataBufferSize);
-    s_commonStagingBuffer.Unmap();
+    for (size_t i = 0; i < imageSources.size(); ++i) {
+        const SceneImageSource& source = imageSources[i];
+        SceneCacheImage& image = images[i];
 
-    vkn::AllocationInfo meshInfosBufAllocInfo = {};
-    meshInfosBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
-    meshInfosBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-    
-    s_commonMeshBuffer.Create(&s_vkDevice, meshDataBufferSize, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, meshInfosBufAllocInfo);
-    s_vkDevice.SetObjDebugName(s_commonMeshBuffer, "COMMON_MESH_BUFFER");
+        image.name = AddBlobData(source.name.data(), source.name.size());
 
-    ImmediateSubmitQueue(s_vkDevice.GetQueue(), [&](vkn::CmdBuffer& cmdBuffer){
-        cmdBuffer.CmdCopyBuffer(s_commonStagingBuffer, s_commonMeshBuffer, meshDataBufferSize);
-    });
+        if (source.IsExternal()) {
+            std::error_code error;
+            const fs::path relativePath = fs::relative(source.filepath, scenePath.parent_path(), error);
 
-    const size_t meshLODDataBufferSize = s_cpuMeshLODData.size() * sizeof(GPU_MeshLOD);
-    CORE_ASSERT(meshLODDataBufferSize <= s_commonStagingBuffer.GetMemorySize());
+            image.path = AddBlobPath(error || relativePath.empty() ? source.filepath : relativePath);
+        } else {
+            image.data = AddBlobData(source.data.data(), source.data.size());
+        }
+    }
 
-    void* pMeshLODBufferData = s_commonStagingBuffer.Map();
-    memcpy(pMeshLODBufferData, s_cpuMeshLODData.data(), meshLODDataBufferSize);
-    s_commonStagingBuffer.Unmap();
+    std::vector<SceneCacheRange> dependencies(dependencyPaths.size());
 
-    vkn::AllocationInfo meshLODInfosBufAllocInfo = {};
-    meshLODInfosBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
-    meshLODInfosBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-    
-    s_commonMeshLODBuffer.Create(&s_vkDevice, meshLODDataBufferSize, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, meshLODInfosBufAllocInfo);
-    s_vkDevice.SetObjDebugName(s_commonMeshLODBuffer, "COMMON_MESH_LOD_BUFFER");
+    for (size_t i = 0; i < dependencyPaths.size(); ++i) {
+        dependencies[i] = AddBlobPath(dependencyPaths[i]);
+    }
 
-    ImmediateSubmitQueue(s_vkDevice.GetQueue(), [&](vkn::CmdBuffer& cmdBuffer){
-        cmdBuffer.CmdCopyBuffer(s_commonStagingBuffer, s_commonMeshLODBuffer, meshLODDataBufferSize);
-    });
+    SceneCacheHeader header = {};
+    header.magic = SCENE_CACHE_MAGIC;
+    header.version = SCENE_CACHE_VERSION;
+    header.sourceHash = sourceHash;
+    header.camera = s_mainCameraData;
+    header.isCameraLoaded = s_mainCameraLoaded;
+    header.firstDynamicInstID = s_geomFirstDynamicInstID;
 
-    CORE_LOG_INFO("FastGLTF: Mesh data GPU upload finished: %f ms", timer.End().GetDuration<float, std::milli>());
-}
+    std::vector<uint8_t> fileData(sizeof(SceneCacheHeader));
 
+    auto AddSection = [&](uint32_t sectionID, const void* pData, size_t size) {
+        fileData.resize((fileData.size() + SCENE_CACHE_SECTION_ALIGNMENT - 1) / SCENE_CACHE_SECTION_ALIGNMENT * SCENE_CACHE_SECTION_ALIGNMENT);
 
-static void UploadGPUTextureData()
-{
-    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Upload_GPU_Texture_Data");
+        header.sections[sectionID] = { fileData.size(), size };
+        fileData.insert(fileData.end(), static_cast<const uint8_t*>(pData), static_cast<const uint8_t*>(pData) + size);
+    };
 
-    eng::Timer timer;
+    for (uint32_t i = 0; i < COMMON_GEOM_STREAM_COUNT; ++i) {
+        AddSection(SCENE_CACHE_SECTION_GEOM_STREAMS + i, s_cpuGeomStreamBuffers[i].data(), s_cpuGeomStreamBuffers[i].size() * sizeof(uint32_t));
+    }
 
-    s_commonMaterialTextures.resize(s_cpuTexturesData.size());
-    s_commonMaterialTextureViews.resize(s_cpuTexturesData.size());
+    AddSection(SCENE_CACHE_SECTION_GEOM_INDICES, s_cpuGeomIndexBuffer.data(), s_cpuGeomIndexBuffer.size() * sizeof(IndexType));
+    AddSection(SCENE_CACHE_SECTION_MESHES, s_cpuMeshData.data(), s_cpuMeshData.size() * sizeof(GPU_Mesh));
+    AddSection(SCENE_CACHE_SECTION_MESH_LODS, s_cpuMeshLODData.data(), s_cpuMeshLODData.size() * sizeof(GPU_MeshLOD));
+    AddSection(SCENE_CACHE_SECTION_MATERIALS, s_cpuMaterialData.data(), s_cpuMaterialData.size() * sizeof(GPU_GeomMaterial));
+    AddSection(SCENE_CACHE_SECTION_INSTANCES, s_cpuInstData.data(), s_cpuInstData.size() * sizeof(GPU_GeomInst));
+    AddSection(SCENE_CACHE_SECTION_PUNCTUAL_LIGHTS, s_cpuPunctualLightData.data(), s_cpuPunctualLightData.size() * sizeof(GPU_PunctualLight));
+    AddSection(SCENE_CACHE_SECTION_IMAGES, images.data(), images.size() * sizeof(SceneCacheImage));
+    AddSection(SCENE_CACHE_SECTION_DEPENDENCIES, dependencies.data(), dependencies.size() * sizeof(SceneCacheRange));
+    AddSection(SCENE_CACHE_SECTION_BLOB, blob.data(), blob.size());
 
-    for (size_t i = 0; i < s_cpuTexturesData.size(); ++i) {
-        const size_t textureIdx = i;
+    memcpy(fileData.data(), &header, sizeof(header));
 
-        const TextureLoadData& texData = s_cpuTexturesData[textureIdx];
-        const size_t texSizeInBytes = texData.GetMemorySize();
+    if (!WriteCacheFile(GetSceneCachePath(scenePath), fileData)) {
+        return;
+    }
 
-        CORE_ASSERT(texSizeInBytes <= s_commonStagingBuffer.GetMemorySize());
+    CORE_LOG_INFO("Scene cache saving finished: %f ms", timer.End().GetDuration<float, std::milli>());
+}
 
-        void* pImageData = s_commonStagingBuffer.Map();
-        memcpy(pImageData, texData.GetData(), texSizeInBytes);
-        s_commonStagingBuffer.Unmap();
 
-        vkn::AllocationInfo imageAllocInfo = {};
-        imageAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
-        imageAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+template <typename T>
+static std::span<const T> GetSceneCacheSection(const SceneCacheHeader& header, uint32_t sectionID)
+{
+    const SceneCacheRange& range = header.sections[sectionID];
+    return std::span(reinterpret_cast<const T*>(s_sceneCacheFile.GetData() + range.offset), range.size / sizeof(T));
+}
 
-        vkn::TextureCreateInfo imageCreateInfo = {};
 
-        imageCreateInfo.pDevice = &s_vkDevice;
-        imageCreateInfo.type = VK_IMAGE_TYPE_2D;
-        imageCreateInfo.extent.width = texData.GetWidth();
-        imageCreateInfo.extent.height = texData.GetHeight();
-        imageCreateInfo.extent.depth = 1;
-        imageCreateInfo.format = texData.GetFormat();
-        imageCreateInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-        imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        imageCreateInfo.mipLevels = texData.GetMipsCount();
-        imageCreateInfo.arrayLayers = 1;
-        imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-        imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-        imageCreateInfo.pAllocInfo = &imageAllocInfo;
+// Scene data is used straight from the mapped cache file. Geometry blobs aren't copied at all, they're uploaded directly from the mapping.
+// Returns false if cache doesn't exist, is corrupted or outdated
+static bool LoadSceneCache(const fs::path& scenePath)
+{
+    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Load_Scene_Cache");
 
-        vkn::Texture& sceneImage = s_commonMaterialTextures[textureIdx];
-        sceneImage.Create(imageCreateInfo);
-        s_vkDevice.SetObjDebugName(sceneImage, "COMMON_MTL_TEXTURE_%zu", textureIdx);
+    if (!s_sceneCacheFile.Open(GetSceneCachePath(scenePath))) {
+        return false;
+    }
 
-        VkComponentMapping mapping = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
-        
-        VkImageSubresourceRange subresourceRange = {};
-        subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        subresourceRange.baseMipLevel = 0;
-        subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
-        subresourceRange.baseArrayLayer = 0;
-        subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+    const size_t fileSize = s_sceneCacheFile.GetSize();
 
-        vkn::TextureView& sceneImageView = s_commonMaterialTextureViews[textureIdx];
+    auto Discard = [&scenePath](const char* pReason) {
+        CORE_LOG_WARN("Scene cache of %s is discarded: %s", scenePath.string().c_str(), pReason);
+        s_sceneCacheFile.Close();
 
-        sceneImageView.Create(sceneImage, mapping, subresourceRange);
-        s_vkDevice.SetObjDebugName(sceneImageView, "COMMON_MTL_TEXTURE_VIEW_%zu", textureIdx);
+        return false;
+    };
 
-        ImmediateSubmitQueue(s_vkDevice.GetQueue(), [&](vkn::CmdBuffer& cmdBuffer) {
-            vkn::Texture& texture = s_commonMaterialTextures[textureIdx];
+    if (fileSize < sizeof(SceneCacheHeader)) {
+        return Discard("file is too small");
+    }
 
-            cmdBuffer
-                .BeginBarrierList()
-                    .AddTextureBarrier(texture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, 
-                        VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT, 0, 1)
-                .Push();
+    SceneCacheHeader header = {};
+    memcpy(&header, s_sceneCacheFile.GetData(), sizeof(header));
 
-            vkn::BufferToTextureCopyInfo copyInfo = {};
-            copyInfo.texSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            copyInfo.texSubresource.mipLevel = 0;
-            copyInfo.texSubresource.baseArrayLayer = 0;
-            copyInfo.texSubresource.layerCount = 1;
-            copyInfo.texExtent = texture.GetSize();
+    if (header.magic != SCENE_CACHE_MAGIC || header.version != SCENE_CACHE_VERSION) {
+        return Discard("invalid magic or version");
+    }
 
-            cmdBuffer.CmdCopyBuffer(s_commonStagingBuffer, texture, copyInfo);
+    for (uint32_t i = 0; i < SCENE_CACHE_SECTION_COUNT; ++i) {
+        const SceneCacheRange& range = header.sections[i];
 
-            const TextureLoadData& texData = s_cpuTexturesData[textureIdx];
+        if (range.offset % SCENE_CACHE_SECTION_ALIGNMENT != 0 || range.offset > fileSize || range.size > fileSize - range.offset || 
+            range.size % GetSceneCacheSectionElemSize(i) != 0
+        ) {
+            return Discard("invalid section range");
+        }
+    }
 
-            GenerateTextureMipmaps(cmdBuffer, texture, texData);
+    const std::span<const uint8_t> blob = GetSceneCacheSection<uint8_t>(header, SCENE_CACHE_SECTION_BLOB);
 
-            cmdBuffer
-                .BeginBarrierList()
-                    .AddTextureBarrier(texture, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, 
-                        VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
-                .Push();
-        });
-    }
-}
+    auto IsBlobRangeValid = [&blob](const SceneCacheRange& range) {
+        return range.offset <= blob.size() && range.size <= blob.size() - range.offset;
+    };
 
+    auto GetBlobPath = [&blob](const SceneCacheRange& range) {
+        const char8_t* pStr = reinterpret_cast<const char8_t*>(blob.data() + range.offset);
+        return fs::path(std::u8string(pStr, range.size));
+    };
 
-static void UploadGPUMaterialData()
-{
-    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Upload_GPU_Material_Data");
+    const std::span<const SceneCacheRange> dependencies = GetSceneCacheSection<SceneCacheRange>(header, SCENE_CACHE_SECTION_DEPENDENCIES);
+    const std::span<const SceneCacheImage> images = GetSceneCacheSection<SceneCacheImage>(header, SCENE_CACHE_SECTION_IMAGES);
 
-    eng::Timer timer;
+    std::vector<fs::path> dependencyPaths;
+    dependencyPaths.reserve(dependencies.size());
 
-    const size_t mtlDataBufferSize = s_cpuMaterialData.size() * sizeof(GPU_GeomMaterial);
-    CORE_ASSERT(mtlDataBufferSize <= s_commonStagingBuffer.GetMemorySize());
+    for (const SceneCacheRange& range : dependencies) {
+        if (!IsBlobRangeValid(range)) {
+            return Discard("invalid dependency path");
+        }
 
-    void* pData = s_commonStagingBuffer.Map();
-    memcpy(pData, s_cpuMaterialData.data(), mtlDataBufferSize);
-    s_commonStagingBuffer.Unmap();
+        dependencyPaths.emplace_back(GetBlobPath(range));
+    }
 
-    vkn::AllocationInfo mtlBufAllocInfo = {};
-    mtlBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
-    mtlBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    for (const SceneCacheImage& image : images) {
+        if (!IsBlobRangeValid(image.name) || !IsBlobRangeValid(image.path) || !IsBlobRangeValid(image.data)) {
+            return Discard("invalid image data");
+        }
+    }
 
-    s_commonMaterialBuffer.Create(&s_vkDevice, mtlDataBufferSize, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, mtlBufAllocInfo);
-    s_vkDevice.SetObjDebugName(s_commonMaterialBuffer, "COMMON_MATERIAL_DATA");
+    uint64_t sourceHash = 0;
 
-    ImmediateSubmitQueue(s_vkDevice.GetQueue(), [&](vkn::CmdBuffer& cmdBuffer) {
-        cmdBuffer.CmdCopyBuffer(s_commonStagingBuffer, s_commonMaterialBuffer, mtlDataBufferSize);
-    });
+    if (!HashSceneSources(scenePath, dependencyPaths, sourceHash) || sourceHash != header.sourceHash) {
+        return Discard("scene sources were changed");
+    }
 
-    CORE_LOG_INFO("FastGLTF: Material data GPU upload finished: %f ms", timer.End().GetDuration<float, std::milli>());
-}
+    for (uint32_t i = 0; i < COMMON_GEOM_STREAM_COUNT; ++i) {
+        s_sceneGeomUploadData.streams[i] = GetSceneCacheSection<uint32_t>(header, SCENE_CACHE_SECTION_GEOM_STREAMS + i);
+    }
 
+    s_sceneGeomUploadData.indices = GetSceneCacheSection<IndexType>(header, SCENE_CACHE_SECTION_GEOM_INDICES);
+    s_sceneGeomUploadData.lods = GetSceneCacheSection<GPU_MeshLOD>(header, SCENE_CACHE_SECTION_MESH_LODS);
 
-static void UploadGPUInstData()
-{
-    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Upload_GPU_Inst_Data");
+    // Data below is also used on CPU during the frame, so it's copied
+    auto CopySection = [&header]<typename T>(std::vector<T>& dst, uint32_t sectionID) {
+        const std::span<const T> src = GetSceneCacheSection<T>(header, sectionID);
+        dst.assign(src.begin(), src.end());
+    };
 
-    eng::Timer timer;
+    CopySection(s_cpuMeshData, SCENE_CACHE_SECTION_MESHES);
+    CopySection(s_cpuMaterialData, SCENE_CACHE_SECTION_MATERIALS);
+    CopySection(s_cpuInstData, SCENE_CACHE_SECTION_INSTANCES);
+    CopySection(s_cpuPunctualLightData, SCENE_CACHE_SECTION_PUNCTUAL_LIGHTS);
 
-    const size_t instBufferSize = s_cpuInstData.size() * sizeof(GPU_GeomInst);
-    CORE_ASSERT(instBufferSize <= s_commonStagingBuffer.GetMemorySize());
+    s_geomFirstDynamicInstID = header.firstDynamicInstID;
 
-    {
-        void* pData = s_commonStagingBuffer.Map();
-        memcpy(pData, s_cpuInstData.data(), instBufferSize);
-        s_commonStagingBuffer.Unmap();
+    if (header.isCameraLoaded && !s_mainCameraLoaded) {
+        SetMainCameraFromScene(header.camera);
     }
 
-    vkn::AllocationInfo instInfosBufAllocInfo = {};
-    instInfosBufAllocInfo.flags = VMA_ALLOCATION_CREATE_STRATEGY_MIN_MEMORY_BIT;
-    instInfosBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    std::vector<SceneImageSource> imageSources(images.size());
 
-    s_commonInstBuffer.Create(&s_vkDevice, instBufferSize, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT, instInfosBufAllocInfo);
-    s_vkDevice.SetObjDebugName(s_commonInstBuffer, "COMMON_INSTANCE_BUFFER");
+    for (size_t i = 0; i < images.size(); ++i) {
+        const SceneCacheImage& image = images[i];
+        SceneImageSource& source = imageSources[i];
 
-    ImmediateSubmitQueue(s_vkDevice.GetQueue(), [&](vkn::CmdBuffer& cmdBuffer){
-        cmdBuffer.CmdCopyBuffer(s_commonStagingBuffer, s_commonInstBuffer, instBufferSize);
-    });
+        source.name = std::string(reinterpret_cast<const char*>(blob.data() + image.name.offset), image.name.size);
 
-    CORE_LOG_INFO("FastGLTF: Instance data GPU upload finished: %f ms", timer.End().GetDuration<float, std::milli>());
-}
+        if (image.path.size > 0) {
+            const fs::path path = GetBlobPath(image.path);
+            source.filepath = path.is_absolute() ? path : fs::absolute(scenePath.parent_path() / path);
+        } else {
+            source.data = blob.subspan(image.data.offset, image.data.size);
+        }
+    }
 
+    LoadSceneTexturesData(scenePath, imageSources);
 
-static void UploadGPUResources()
-{
-    UploadGPUMeshData();
-    UploadGPUInstData();
-    UploadGPUTextureData();
-    UploadGPUMaterialData();
+    return true;
 }
 
 
-static void LoadScene(const fs::path& filepath)
+static void LoadSceneGltf(const fs::path& filepath)
 {
-    const std::string strPath = filepath.string();
-
-    if (!fs::exists(filepath)) {
-		CORE_ASSERT_FAIL("Unknown scene path: %s", strPath.c_str());
-		return;
-	}
-    
-    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Load_Scene");
-    
-    eng::Timer timer;
-
-    static constexpr gltf::Extensions requiredExtensions =
-        gltf::Extensions::KHR_mesh_quantization |
-        gltf::Extensions::KHR_texture_transform |
-        gltf::Extensions::KHR_materials_variants;
-
-    gltf::Parser parser(requiredExtensions);
+    gltf::Parser parser = CreateSceneGltfParser();
 
     constexpr gltf::Options options =
         gltf::Options::DontRequireValidAssetMember |
@@ -5918,11 +8317,45 @@ static void LoadScene(const fs::path& filepath)
         return;
     }
 
+    std::vector<SceneImageSource> imageSources;
+    GetSceneImageSources(asset.get(), filepath.parent_path(), imageSources);
+
     LoadSceneMeshData(asset.get());
-    LoadSceneTexturesData(asset.get(), filepath.parent_path());
     LoadSceneMaterialData(asset.get());
+    LoadSceneTexturesData(filepath, imageSources);
     LoadSceneInstData(asset.get());
 
+    for (uint32_t i = 0; i < COMMON_GEOM_STREAM_COUNT; ++i) {
+        s_sceneGeomUploadData.streams[i] = s_cpuGeomStreamBuffers[i];
+    }
+
+    s_sceneGeomUploadData.indices = s_cpuGeomIndexBuffer;
+    s_sceneGeomUploadData.lods = s_cpuMeshLODData;
+
+    // Embedded images point into the asset, so cache is saved while it's alive
+    SaveSceneCache(filepath, imageSources);
+}
+
+
+static void LoadScene(const fs::path& filepath)
+{
+    const std::string strPath = filepath.string();
+
+    if (!fs::exists(filepath)) {
+		CORE_ASSERT_FAIL("Unknown scene path: %s", strPath.c_str());
+		return;
+	}
+    
+    ENG_PROFILE_SCOPED_MARKER_C(0x8b008b, "Load_Scene");
+    
+    eng::Timer timer;
+
+    const bool isLoadedFromCache = LoadSceneCache(filepath);
+
+    if (!isLoadedFromCache) {
+        LoadSceneGltf(filepath);
+    }
+
     if (!s_mainCameraLoaded) {
         s_mainCamera.SetPosition(glm::float3(0.f, 0.f, 16.f));
         s_mainCamera.SetRotation(glm::quatLookAt(-M3D_AXIS_Z, M3D_AXIS_Y));
@@ -5931,22 +8364,27 @@ static void LoadScene(const fs::path& filepath)
 
     s_mainCamera.Update();
 
-    CORE_LOG_INFO("\"%s\" loading finished: %f ms", filepath.filename().string().c_str(), timer.End().GetDuration<float, std::milli>());
+    CORE_LOG_INFO("\"%s\" loading finished%s: %f ms", filepath.filename().string().c_str(), isLoadedFromCache ? " (from cache)" : "",
+        timer.End().GetDuration<float, std::milli>());
 }
 
 
 static void CreateCommonConstBuffer()
 {
-    s_commonConstBuffer.CreateConstBuffer(&s_vkDevice, sizeof(GPU_CommonCBData));
-    s_vkDevice.SetObjDebugName(s_commonConstBuffer, "COMMON_CB");
+    for (uint32_t i = 0; i < FRAMES_IN_FLIGHT_COUNT; ++i) {
+        s_commonConstBuffers[i].CreateConstBuffer(&s_vkDevice, sizeof(GPU_CommonCBData));
+        s_vkDevice.SetObjDebugName(s_commonConstBuffers[i], "COMMON_CB_%u", i);
+    }
 }
 
 
 static void CreateCommonDbgConstBuffer()
 {
 #ifdef ENG_BUILD_DEBUG
-    s_commonDbgConstBuffer.CreateConstBuffer(&s_vkDevice, sizeof(GPU_CommonDbgCBData));
-    s_vkDevice.SetObjDebugName(s_commonDbgConstBuffer, "COMMON_DBG_CB");
+    for (uint32_t i = 0; i < FRAMES_IN_FLIGHT_COUNT; ++i) {
+        s_commonDbgConstBuffers[i].CreateConstBuffer(&s_vkDevice, sizeof(GPU_CommonDbgCBData));
+        s_vkDevice.SetObjDebugName(s_commonDbgConstBuffers[i], "COMMON_DBG_CB_%u", i);
+    }
 #endif
 }
 
@@ -5955,7 +8393,9 @@ void UpdateGPUCommonConstBuffer()
 {
     ENG_PROFILE_SCOPED_MARKER_C(0x008b8b, "Update_Common_Const_Buffer");
 
-    GPU_CommonCBData& constBuff = *reinterpret_cast<GPU_CommonCBData*>(s_commonConstBuffer.Map());
+    vkn::Buffer& commonConstBuffer = s_commonConstBuffers[s_frameInFlightIdx];
+
+    GPU_CommonCBData& constBuff = *reinterpret_cast<GPU_CommonCBData*>(commonConstBuffer.Map());
 
     const glm::float4x4& viewMatrix = s_mainCamera.GetViewMatrix();
     const glm::float4x4& projMatrix = s_mainCamera.GetProjMatrix();
@@ -5989,6 +8429,15 @@ void UpdateGPUCommonConstBuffer()
     constBuff.screenSize.x = static_cast<float>(s_pWnd->GetWidth());
     constBuff.screenSize.y = static_cast<float>(s_pWnd->GetHeight());
 
+    const eng::Camera& cullingCamera = s_cullingTestMode ? s_fixedCullCamera : s_mainCamera;
+
+    constBuff.cullingCamWPos = cullingCamera.GetPosition();
+    constBuff.cullingCamProjScale = 0.5f * s_pWnd->GetHeight() * glm::abs(cullingCamera.GetProjMatrix()[1][1]);
+
+    constBuff.geomLodPixelThreshold = s_geomLodPixelThreshold;
+    constBuff.firstDynamicInstID = s_geomFirstDynamicInstID;
+    constBuff.punctualLightCount = s_cpuPunctualLightData.size();
+
     constBuff.mainCamZNear = s_mainCamera.GetZNear();
     constBuff.mainCamZFar = s_mainCamera.GetZFar();
     
@@ -6007,6 +8456,7 @@ void UpdateGPUCommonConstBuffer()
         constBuff.csmData.cascadeZNear[i] = cam.GetZNear();
         constBuff.csmData.cascadeZFar[i] = cam.GetZFar();
         constBuff.csmData.cascadeWorldUnitsPerPixel[i] = s_csmCascadeWorldUnitsPerTexel[i];
+        constBuff.csmData.cascadeGeomLodPixelThresholds[i] = s_csmGeomLodPixelThresholds[i];
     }
 
     constBuff.csmData.cascadeBlendThresholdCoef = s_csmCascadeBlendThresholdCoef * 0.01f;
@@ -6016,6 +8466,17 @@ void UpdateGPUCommonConstBuffer()
 
     constBuff.csmData.texSize = glm::uvec2(CSM_CASCADE_RT_SIZE);
 
+    for (size_t i = 0; i < COMMON_VSM_LEVEL_COUNT; ++i) {
+        constBuff.vsmData.levelViewProjMatrices[i] = s_vsmLevelCameras[i].GetViewProjMatrix();
+        constBuff.vsmData.levelPageOffsets[i] = glm::int4(s_vsmLevelPageOffsets[i], 0, 0);
+        constBuff.vsmData.levelDynamicPageRects[i] = VSMUnitePageRects(s_vsmLevelDynamicPageRects[i], s_vsmLevelDynamicPageRectsPrev[i]);
+        constBuff.vsmData.levelWorldUnitsPerTexel[i] = s_vsmLevelWorldUnitsPerTexel[i];
+    }
+
+    constBuff.vsmData.depthRange = s_vsmDepthRange;
+    constBuff.vsmData.invalidLevelMask = s_vsmInvalidLevelMask;
+    constBuff.vsmData.frameNumber = static_cast<uint32_t>(s_frameNumber);
+
     constBuff.csmData.pcssData.lightAngularSlope = glm::tan(glm::radians(s_csmPcssSettings.lightAngularRadiusDegrees));
     constBuff.csmData.pcssData.maxSearchRadiusTexels = s_csmPcssSettings.maxSearchRadiusTexels;
     constBuff.csmData.pcssData.maxFilterRadiusTexels = s_csmPcssSettings.maxFilterRadiusTexels;
@@ -6026,7 +8487,7 @@ void UpdateGPUCommonConstBuffer()
     constBuff.csmData.pcssData.searchSamplesCount = s_csmPcssSettings.searchSamplesCount;
     constBuff.csmData.pcssData.filterSamplesCount = s_csmPcssSettings.filterSamplesCount;
 
-    s_commonConstBuffer.Unmap();
+    commonConstBuffer.Unmap();
 }
 
 
@@ -6035,7 +8496,9 @@ void UpdateGPUDbgConstBuffer()
 #ifdef ENG_BUILD_DEBUG
     ENG_PROFILE_SCOPED_MARKER_C(0x008b8b, "Update_Common_Dbg_Const_Buffer");
 
-    GPU_CommonDbgCBData& constBuff = *reinterpret_cast<GPU_CommonDbgCBData*>(s_commonDbgConstBuffer.Map());
+    vkn::Buffer& commonDbgConstBuffer = s_commonDbgConstBuffers[s_frameInFlightIdx];
+
+    GPU_CommonDbgCBData& constBuff = *reinterpret_cast<GPU_CommonDbgCBData*>(commonDbgConstBuffer.Map());
 
     uint32_t flags_0 = 0;
 
@@ -6050,6 +8513,7 @@ void UpdateGPUDbgConstBuffer()
     flags_0 |= s_isCSMEnabled && s_isCSMFilterRandomOffsetEnabled  ? (1u << 6u) : 0u;
     flags_0 |= csmPcssEnabled                                      ? (1u << 7u) : 0u;
     flags_0 |= csmPcssEnabled && s_csmPcssSettings.randomRotationEnabled ? (1u << 8u) : 0u;
+    flags_0 |= s_isCSMEnabled && s_isVSMEnabled                    ? (1u << 9u) : 0u;
 
     constBuff.forcedGeomLOD = s_forcedGeomLOD;
     constBuff.flags_0 = flags_0;
@@ -6057,46 +8521,159 @@ void UpdateGPUDbgConstBuffer()
     constBuff.tonemapPreset = s_tonemappingPreset;
     constBuff.csmPCFPreset = s_csmPCFPreset;
 
-    s_commonDbgConstBuffer.Unmap();
-#endif
+    commonDbgConstBuffer.Unmap();
+#endif
+}
+
+
+static void ResizeVkSwapchain(eng::Window& window)
+{
+    bool resizeSucceded;
+    s_vkSwapchain.Resize(window.GetWidth(), window.GetHeight(), resizeSucceded);
+    
+    s_swapchainRecreateRequired = !resizeSucceded;
+}
+
+
+static void UpdateMainCamera()
+{
+    const float moveDist = glm::length(s_mainCameraVel);
+
+    if (!math::IsZero(moveDist)) {
+        const glm::float3 moveDir = glm::normalize(s_mainCamera.GetRotation() * (s_mainCameraVel / moveDist));
+        s_mainCamera.MoveAlongDir(moveDir, moveDist);
+    }
+
+    s_mainCamera.Update();
+}
+
+
+// Bounding sphere of main camera frustum slice between cascade distance splits. VSM levels use the same splits as CSM cascades.
+// cascadeCamera is a copy of main camera, which is reused between calls
+static void CalcCascadeBoundingSphere(eng::Camera& cascadeCamera, uint32_t cascade, glm::float3& outCenter, float& outRadius)
+{
+    const float zNear = cascade == 0 ? 0.01f : CSM_CASCADE_DISTANCES[cascade - 1];
+    const float zFar = CSM_CASCADE_DISTANCES[cascade];
+
+    cascadeCamera.SetZNearFar(zNear, zFar);
+    cascadeCamera.Update();
+
+    const math::Frustum& cascadeFrustum = cascadeCamera.GetFrustum();
+
+    outCenter = cascadeFrustum.GetCenter();
+    outRadius = 0.f;
+
+    for (const glm::float3& point : cascadeFrustum.GetPoints()) {
+        outRadius = glm::max(outRadius, glm::distance(point, outCenter));
+    }
+}
+
+
+static void UpdateCSMDataCPU()
+{
+    ENG_PROFILE_SCOPED_MARKER_C(0x008b8b, "Update_CSM_Data_CPU");
+
+    eng::Camera cascadeCamera = s_mainCamera;
+
+    const glm::quat lightRotQuat = glm::quatLookAt(SUN_LIGHT_DIR, M3D_AXIS_Y);
+    const glm::float3x3 lightRot = glm::float3x3(glm::lookAt(ZEROF3, SUN_LIGHT_DIR, M3D_AXIS_Y));
+    const glm::float3x3 invLightRot = glm::inverse(lightRot);
+
+    // Far cascades cover big areas, so they can lag behind camera for a few frames. Refitting them one by one spreads
+    // their static cache rebuilds over frames
+    const uint32_t roundRobinCascade = CSM_ROUND_ROBIN_FIRST_CASCADE + s_frameNumber % (COMMON_CSM_CASCADE_COUNT - CSM_ROUND_ROBIN_FIRST_CASCADE);
+
+    for (uint32_t i = 0; i < COMMON_CSM_CASCADE_COUNT; ++i) {
+        if (s_csmCascadesFitted && i >= CSM_ROUND_ROBIN_FIRST_CASCADE && i != roundRobinCascade) {
+            continue;
+        }
+
+        glm::float3 frCenter;
+        float frRadius;
+        CalcCascadeBoundingSphere(cascadeCamera, i, frCenter, frRadius);
+
+        const float orthoSize = 2.f * frRadius;
+        const float texelSize = orthoSize / CSM_CASCADE_RT_SIZE;
+
+        glm::float3 frCenterLS = lightRot * frCenter;
+        frCenterLS.x = glm::round(frCenterLS.x / texelSize) * texelSize;
+        frCenterLS.y = glm::round(frCenterLS.y / texelSize) * texelSize;
+        // Depth range is 3 times bigger than cascade size, so snapping along light direction is harmless. It keeps cascade transform
+        // unchanged until camera moves by a texel, which allows to reuse static cache
+        frCenterLS.z = glm::round(frCenterLS.z / texelSize) * texelSize;
+
+        const glm::float3 snappedCenter = invLightRot * frCenterLS;
+
+        const glm::float3 lightPos = snappedCenter - SUN_LIGHT_DIR * frRadius;
+
+        eng::Camera& csmCamera = s_csmCameras[i];
+
+        csmCamera.SetPosition(lightPos);
+        csmCamera.SetRotation(lightRotQuat);
+        csmCamera.SetOrthoProjection(-frRadius, frRadius, -frRadius, frRadius, -3.f * frRadius, 3.f * frRadius);
+    
+        csmCamera.Update();
+
+        s_csmCascadeWorldUnitsPerTexel[i] = texelSize;
+    }
+
+    s_csmCascadesFitted = true;
 }
 
 
-static void ResizeVkSwapchain(eng::Window& window)
+// Radius of cascade frustum sphere slightly jitters with camera rotation. Quantization keeps level size and its pages stable
+static float VSMQuantizeLevelHalfSize(float halfSize)
 {
-    bool resizeSucceded;
-    s_vkSwapchain.Resize(window.GetWidth(), window.GetHeight(), resizeSucceded);
-    
-    s_swapchainRecreateRequired = !resizeSucceded;
+    const float step = glm::exp2(glm::floor(glm::log2(halfSize)) - 3.f);
+    return glm::ceil(halfSize / step) * step;
 }
 
 
-static void UpdateMainCamera()
+// Returns absolute coords of pages covered by AABB. Empty rect if AABB is outside of the level
+static glm::int4 VSMGetAABBPageRect(const math::AABB& aabb, const glm::float4x4& viewProjMatr, const glm::int2& pageOffset)
 {
-    const float moveDist = glm::length(s_mainCameraVel);
+    glm::float2 minUV = glm::float2(FLT_MAX);
+    glm::float2 maxUV = glm::float2(-FLT_MAX);
 
-    if (!math::IsZero(moveDist)) {
-        const glm::float3 moveDir = glm::normalize(s_mainCamera.GetRotation() * (s_mainCameraVel / moveDist));
-        s_mainCamera.MoveAlongDir(moveDir, moveDist);
+    for (uint32_t i = 0; i < 8; ++i) {
+        const glm::float4 corner = glm::float4(
+            MATH_IS_BIT_SET(i, 0) ? aabb.max.x : aabb.min.x,
+            MATH_IS_BIT_SET(i, 1) ? aabb.max.y : aabb.min.y,
+            MATH_IS_BIT_SET(i, 2) ? aabb.max.z : aabb.min.z,
+            1.f
+        );
+
+        // Orthographic projection, so w is always 1
+        const glm::float2 uv = 0.5f * glm::float2(viewProjMatr * corner) + 0.5f;
+
+        minUV = glm::min(minUV, uv);
+        maxUV = glm::max(maxUV, uv);
     }
 
-    s_mainCamera.Update();
+    if (glm::any(glm::greaterThan(minUV, ONEF2)) || glm::any(glm::lessThan(maxUV, ZEROF2))) {
+        return VSM_EMPTY_PAGE_RECT;
+    }
+
+    static constexpr int32_t MAX_PAGE = COMMON_VSM_VIRTUAL_PAGE_COUNT - 1;
+
+    const glm::int2 minPage = glm::clamp(glm::int2(glm::floor(minUV * float(COMMON_VSM_VIRTUAL_PAGE_COUNT))), 0, MAX_PAGE);
+    const glm::int2 maxPage = glm::clamp(glm::int2(glm::floor(maxUV * float(COMMON_VSM_VIRTUAL_PAGE_COUNT))), 0, MAX_PAGE);
+
+    return glm::int4(pageOffset + minPage, pageOffset + maxPage);
 }
 
 
-static void UpdateCSMDataCPU()
+static glm::int4 VSMUnitePageRects(const glm::int4& rect0, const glm::int4& rect1)
 {
-    ENG_PROFILE_SCOPED_MARKER_C(0x008b8b, "Update_CSM_Data_CPU");
-
-    auto GetCascadeSphereVolumeRadius = [](std::span<const glm::float3> points, const glm::float3& center) {
-        float radius = 0.f;
+    return glm::int4(glm::min(glm::int2(rect0.x, rect0.y), glm::int2(rect1.x, rect1.y)), glm::max(glm::int2(rect0.z, rect0.w), glm::int2(rect1.z, rect1.w)));
+}
 
-        for (const glm::float3& point : points) {
-            radius = glm::max(radius, glm::distance(point, center));
-        }
 
-        return radius;
-    };
+// Levels are centered around CSM cascades, but snapped to pages instead of texels. Level page keeps its depth while it's covered by the level,
+// so only pages which appear at level borders or touched by dynamic geometry are rendered
+static void UpdateVSMDataCPU()
+{
+    ENG_PROFILE_SCOPED_MARKER_C(0x008b8b, "Update_VSM_Data_CPU");
 
     eng::Camera cascadeCamera = s_mainCamera;
 
@@ -6104,41 +8681,64 @@ static void UpdateCSMDataCPU()
     const glm::float3x3 lightRot = glm::float3x3(glm::lookAt(ZEROF3, SUN_LIGHT_DIR, M3D_AXIS_Y));
     const glm::float3x3 invLightRot = glm::inverse(lightRot);
 
-    for (uint32_t i = 0; i < COMMON_CSM_CASCADE_COUNT; ++i) {
-        const float zNear = i == 0 ? 0.01f : CSM_CASCADE_DISTANCES[i - 1];
-        const float zFar = CSM_CASCADE_DISTANCES[i];
+    s_vsmInvalidLevelMask = 0;
 
-        cascadeCamera.SetZNearFar(zNear, zFar);
-        cascadeCamera.Update();
+    for (uint32_t i = 0; i < COMMON_VSM_LEVEL_COUNT; ++i) {
+        glm::float3 frCenter;
+        float frRadius;
+        CalcCascadeBoundingSphere(cascadeCamera, i, frCenter, frRadius);
 
-        const math::Frustum& cascadeFrustum = cascadeCamera.GetFrustum();
-        std::span<const glm::float3> frCorners = cascadeFrustum.GetPoints();
-        const glm::float3 frCenter = cascadeFrustum.GetCenter();
+        const float halfSize = VSMQuantizeLevelHalfSize(frRadius * VSM_LEVEL_RADIUS_SCALE);
+        const float pageSize = 2.f * halfSize / COMMON_VSM_VIRTUAL_PAGE_COUNT;
 
-        const float frRadius = GetCascadeSphereVolumeRadius(frCorners, frCenter);
+        glm::float3 levelCenterLS = lightRot * frCenter;
+        levelCenterLS.x = glm::round(levelCenterLS.x / pageSize) * pageSize;
+        levelCenterLS.y = glm::round(levelCenterLS.y / pageSize) * pageSize;
+        levelCenterLS.z = s_vsmSceneCenterLS.z;
 
-        glm::float3 lightPos = frCenter - SUN_LIGHT_DIR * frRadius;
+        eng::Camera& levelCamera = s_vsmLevelCameras[i];
 
-        const float orthoSize = 2.f * frRadius;
-        const float texelSize = orthoSize / CSM_CASCADE_RT_SIZE;
+        levelCamera.SetPosition(invLightRot * levelCenterLS);
+        levelCamera.SetRotation(lightRotQuat);
+        levelCamera.SetOrthoProjection(-halfSize, halfSize, -halfSize, halfSize, -0.5f * s_vsmDepthRange, 0.5f * s_vsmDepthRange);
 
-        glm::float3 frCenterLS = lightRot * frCenter;
-        frCenterLS.x = glm::round(frCenterLS.x / texelSize) * texelSize;
-        frCenterLS.y = glm::round(frCenterLS.y / texelSize) * texelSize;
+        levelCamera.Update();
 
-        const glm::float3 snappedCenter = invLightRot * frCenterLS;
+        const glm::float4x4& viewProjMatr = levelCamera.GetViewProjMatrix();
 
-        lightPos = snappedCenter - SUN_LIGHT_DIR * frRadius;
+        // Pages are addressed relative to world origin, so the same world area keeps its page coords when level moves
+        const glm::float2 originUV = 0.5f * glm::float2(viewProjMatr * glm::float4(ZEROF3, 1.f)) + 0.5f;
+        s_vsmLevelPageOffsets[i] = -glm::int2(glm::round(originUV * float(COMMON_VSM_VIRTUAL_PAGE_COUNT)));
 
-        eng::Camera& csmCamera = s_csmCameras[i];
+        s_vsmLevelWorldUnitsPerTexel[i] = 2.f * halfSize / COMMON_VSM_VIRTUAL_SIZE;
 
-        csmCamera.SetPosition(lightPos);
-        csmCamera.SetRotation(lightRotQuat);
-        csmCamera.SetOrthoProjection(-frRadius, frRadius, -frRadius, frRadius, -3.f * frRadius, 3.f * frRadius);
-    
-        csmCamera.Update();
+        s_vsmLevelDynamicPageRectsPrev[i] = s_vsmLevelDynamicPageRects[i];
+        s_vsmLevelDynamicPageRects[i] = VSM_EMPTY_PAGE_RECT;
 
-        s_csmCascadeWorldUnitsPerTexel[i] = texelSize;
+        for (size_t instID = s_geomFirstDynamicInstID; instID < s_cpuInstData.size(); ++instID) {
+            const glm::int4 instRect = VSMGetAABBPageRect(s_cpuInstData[instID].GetAABB_WCS(), viewProjMatr, s_vsmLevelPageOffsets[i]);
+            s_vsmLevelDynamicPageRects[i] = VSMUnitePageRects(s_vsmLevelDynamicPageRects[i], instRect);
+        }
+
+        VsmLevelState state = {};
+        state.halfSize = halfSize;
+        state.geomLodPixelThreshold = s_csmGeomLodPixelThresholds[i];
+        state.forcedGeomLOD = s_forcedGeomLOD;
+        state.isWireframe = s_geomWireframeMode;
+
+        const VsmLevelState& prevState = s_vsmLevelStates[i];
+
+        const bool isLevelValid = s_vsmWasEnabled &&
+            prevState.halfSize == state.halfSize &&
+            prevState.geomLodPixelThreshold == state.geomLodPixelThreshold &&
+            prevState.forcedGeomLOD == state.forcedGeomLOD &&
+            prevState.isWireframe == state.isWireframe;
+
+        if (!isLevelValid) {
+            s_vsmInvalidLevelMask |= 1u << i;
+        }
+
+        s_vsmLevelStates[i] = state;
     }
 }
 
@@ -6149,6 +8749,10 @@ static void UpdateScene()
 
     ClearDebugDrawData();
 
+#ifdef ENG_SHADER_HOT_RELOAD_ENABLED
+    ApplyReloadedShaders();
+#endif
+
     if (s_swapchainRecreateRequired) {
         s_vkDevice.WaitIdle();
 
@@ -6164,6 +8768,7 @@ static void UpdateScene()
 
     UpdateMainCamera();
     UpdateCSMDataCPU();
+    UpdateVSMDataCPU();
 
     if (s_drawInstAABBs) {
         const math::Frustum& frustum = s_mainCamera.GetFrustum();
@@ -6317,16 +8922,26 @@ static void PrecomputeIBLBRDFIntergrationLUT(vkn::CmdBuffer& cmdBuffer)
 }
 
 
-static void GeomCullingClearCounters(vkn::CmdBuffer& cmdBuffer)
+// Queue sizes of both phases are cleared at the early phase, since late phase draws are issued alongside early ones.
+// Visible sort keys are reused by phases, so their counters are cleared every phase
+static void GeomCullingClearCounters(vkn::CmdBuffer& cmdBuffer, GPU_GeomCullingPhase phase)
 {
     ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, 0x000000, "Geom_Culling_Clear_Counters");
 
+    const bool isEarlyPhase = phase == GEOM_CULLING_PHASE_EARLY;
+    const bool needResetVisibility = isEarlyPhase && s_geomCullInstVisibilityResetRequired;
+
     vkn::BarrierList& barriers = cmdBuffer.BeginBarrierList();
 
-    for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
-        barriers.AddBufferBarrier(s_visGeomIDQueueSizeBuffer[queue], VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
-        barriers.AddBufferBarrier(s_geomBatchQueueSizeBuffer[queue], VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
-        barriers.AddBufferBarrier(s_sortedVisGeomIDQueueSizeBuffer[queue], VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+    if (isEarlyPhase) {
+        for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
+            barriers.AddBufferBarrier(s_geomBatchQueueSizeBuffer[queue], VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+            barriers.AddBufferBarrier(s_sortedVisGeomIDQueueSizeBuffer[queue], VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+        }
+    }
+
+    if (needResetVisibility) {
+        barriers.AddBufferBarrier(s_geomCullInstVisibilityBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
     }
 
     barriers.AddBufferBarrier(s_geomCullVisSortKeysCounterBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
@@ -6334,10 +8949,17 @@ static void GeomCullingClearCounters(vkn::CmdBuffer& cmdBuffer)
 
     barriers.Push();
 
-    for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
-        cmdBuffer.CmdFillBuffer(s_visGeomIDQueueSizeBuffer[queue], 0, 0, sizeof(glm::uint));
-        cmdBuffer.CmdFillBuffer(s_geomBatchQueueSizeBuffer[queue], 0, 0, sizeof(glm::uint));
-        cmdBuffer.CmdFillBuffer(s_sortedVisGeomIDQueueSizeBuffer[queue], 0, 0, sizeof(glm::uint));
+    if (isEarlyPhase) {
+        for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
+            cmdBuffer.CmdFillBuffer(s_geomBatchQueueSizeBuffer[queue], 0);
+            cmdBuffer.CmdFillBuffer(s_sortedVisGeomIDQueueSizeBuffer[queue], 0);
+        }
+    }
+
+    if (needResetVisibility) {
+        // Nothing is considered visible in the previous frame, so the whole scene is tested by the late phase against HZB
+        cmdBuffer.CmdFillBuffer(s_geomCullInstVisibilityBuffer, 0);
+        s_geomCullInstVisibilityResetRequired = false;
     }
 
     cmdBuffer.CmdFillBuffer(s_geomCullVisSortKeysCounterBuffer, 0);
@@ -6345,7 +8967,7 @@ static void GeomCullingClearCounters(vkn::CmdBuffer& cmdBuffer)
 }
 
 
-static void GeomVisIDBufferPass(vkn::CmdBuffer& cmdBuffer)
+static void GeomVisIDBufferPass(vkn::CmdBuffer& cmdBuffer, GPU_GeomCullingPhase phase)
 {
     static constexpr const char* passName = "Geom_Vis_ID_Buffer_Pass";
     static constexpr uint32_t passColor = 0xff6a6a;
@@ -6357,15 +8979,11 @@ static void GeomVisIDBufferPass(vkn::CmdBuffer& cmdBuffer)
 
     vkn::BarrierList& barriers = cmdBuffer.BeginBarrierList();
 
-    for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
-        barriers.AddBufferBarrier(s_visGeomIDQueueBuffer[queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
-        barriers.AddBufferBarrier(s_visGeomIDQueueSizeBuffer[queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
-    }
-
     barriers.AddBufferBarrier(s_geomCullVisSortKeysBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
     barriers.AddBufferBarrier(s_geomCullVisSortKeysCounterBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
     barriers.AddBufferBarrier(s_geomCullVisGeomIDsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
     barriers.AddBufferBarrier(s_geomCullPerGeomMatTypeCountersBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
+    barriers.AddBufferBarrier(s_geomCullInstVisibilityBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
 
     barriers.AddTextureBarrier(s_HZB, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
         VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
@@ -6383,6 +9001,7 @@ static void GeomVisIDBufferPass(vkn::CmdBuffer& cmdBuffer)
 
     GPU_GeomCullingPerDrawData pushConsts = {};
     pushConsts.hzbMipsCount = s_HZB.GetMipCount();
+    pushConsts.phase = phase;
 
     cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
 
@@ -6390,27 +9009,204 @@ static void GeomVisIDBufferPass(vkn::CmdBuffer& cmdBuffer)
 }
 
 
-static void GeomBatchingPass(vkn::CmdBuffer& cmdBuffer, GPU_GeomQueue queue)
+// Radix sort data which is bound to descriptor sets of certain sort. Even passes sort keys/payloads into tmp buffers, odd ones - back.
+// Element count is read on GPU from the first uint of elemCountBuffer
+struct RadixSortBuffers
+{
+    vkn::Buffer* pKeys;
+    vkn::Buffer* pPayloads;
+    vkn::Buffer* pTmpKeys;
+    vkn::Buffer* pTmpPayloads;
+    vkn::Buffer* pElemCount;
+    
+    DescSetID evenPassSetID;
+    DescSetID oddPassSetID;
+};
+
+
+// LSD radix sort of 64-bit keys with uint payloads. Every pass sorts 8 bits with histograms build, their scan and stable scatter.
+// Sorted data ends up in source buffers since pass count is always even
+static void RadixSortPass(vkn::CmdBuffer& cmdBuffer, const RadixSortBuffers& buffers, uint32_t maxElemCount)
+{
+    static_assert((RADIX_SORT_KEY_BITS / RADIX_SORT_DIGIT_BITS) % 2 == 0, "Sorted data must end up in source buffers");
+
+    CORE_ASSERT_MSG(maxElemCount <= s_radixSortMaxElemCount, "Radix sort scratch buffers are too small for %u elements", maxElemCount);
+
+    vkn::PSO& pso = s_PSOs[PASS_ID_RADIX_SORT];
+
+    cmdBuffer.CmdBindPSO(pso);
+    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_COMMON, .shaderSetIdx = DESC_SET_PER_FRAME });
+
+    GPU_RadixSortPerDrawData pushConsts = {};
+    pushConsts.maxElemCount = maxElemCount;
+
+    cmdBuffer
+        .BeginBarrierList()
+            .AddBufferBarrier(*buffers.pElemCount, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+            .AddBufferBarrier(s_radixSortDispatchArgsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
+        .Push();
+
+    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = buffers.evenPassSetID, .shaderSetIdx = DESC_SET_PER_DRAW });
+
+    pushConsts.stage = RADIX_SORT_STAGE_SETUP;
+    cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
+    cmdBuffer.CmdDispatch(1, 1, 1);
+
+    cmdBuffer
+        .BeginBarrierList()
+            .AddBufferBarrier(s_radixSortDispatchArgsBuffer, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
+        .Push();
+
+    for (uint32_t bitOffset = 0; bitOffset < RADIX_SORT_KEY_BITS; bitOffset += RADIX_SORT_DIGIT_BITS) {
+        const bool isEvenPass = (bitOffset / RADIX_SORT_DIGIT_BITS) % 2 == 0;
+
+        vkn::Buffer& srcKeys = isEvenPass ? *buffers.pKeys : *buffers.pTmpKeys;
+        vkn::Buffer& srcPayloads = isEvenPass ? *buffers.pPayloads : *buffers.pTmpPayloads;
+        vkn::Buffer& dstKeys = isEvenPass ? *buffers.pTmpKeys : *buffers.pKeys;
+        vkn::Buffer& dstPayloads = isEvenPass ? *buffers.pTmpPayloads : *buffers.pPayloads;
+
+        cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = isEvenPass ? buffers.evenPassSetID : buffers.oddPassSetID, .shaderSetIdx = DESC_SET_PER_DRAW });
+
+        pushConsts.bitOffset = bitOffset;
+
+        cmdBuffer
+            .BeginBarrierList()
+                .AddBufferBarrier(srcKeys, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+                .AddBufferBarrier(s_radixSortHistogramsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
+            .Push();
+
+        pushConsts.stage = RADIX_SORT_STAGE_BUILD_HISTOGRAMS;
+        cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
+        cmdBuffer.CmdDispatchIndirect(s_radixSortDispatchArgsBuffer);
+
+        cmdBuffer
+            .BeginBarrierList()
+                .AddBufferBarrier(s_radixSortHistogramsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT)
+            .Push();
+
+        pushConsts.stage = RADIX_SORT_STAGE_SCAN_HISTOGRAMS;
+        cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
+        cmdBuffer.CmdDispatch(1, 1, 1);
+
+        cmdBuffer
+            .BeginBarrierList()
+                .AddBufferBarrier(s_radixSortHistogramsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+                .AddBufferBarrier(srcPayloads, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+                .AddBufferBarrier(dstKeys, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
+                .AddBufferBarrier(dstPayloads, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
+            .Push();
+
+        pushConsts.stage = RADIX_SORT_STAGE_SCATTER;
+        cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
+        cmdBuffer.CmdDispatchIndirect(s_radixSortDispatchArgsBuffer);
+    }
+}
+
+
+// Sorts visible instances by GPU_GeomSortKey: material type, material, mesh, LOD and then front-to-back
+static void GeomRadixSortPass(vkn::CmdBuffer& cmdBuffer)
+{
+    static constexpr const char* passName = "Geom_Radix_Sort_Pass";
+    static constexpr uint32_t passColor = 0xee7942;
+
+    ENG_PROFILE_SCOPED_MARKER_C(passColor, passName);
+    ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
+
+    RadixSortBuffers buffers = {};
+    buffers.pKeys = &s_geomCullVisSortKeysBuffer;
+    buffers.pPayloads = &s_geomCullVisGeomIDsBuffer;
+    buffers.pTmpKeys = &s_geomRadixSortTmpKeysBuffer;
+    buffers.pTmpPayloads = &s_geomRadixSortTmpGeomIDsBuffer;
+    buffers.pElemCount = &s_geomCullVisSortKeysCounterBuffer;
+    buffers.evenPassSetID = DESC_SET_ID_GEOM_RADIX_SORT_EVEN_PASS;
+    buffers.oddPassSetID = DESC_SET_ID_GEOM_RADIX_SORT_ODD_PASS;
+
+    RadixSortPass(cmdBuffer, buffers, s_cpuInstData.size());
+}
+
+
+// Bins visible instances by (mesh, LOD), emits one batch per non empty bin and scatters instance IDs into batch ranges.
+// Visible and output queues of the set must be already transited by caller
+static void GeomBatchingDispatch(vkn::CmdBuffer& cmdBuffer, DescSetID setID, bool isCSMPass, size_t maxVisInstCount)
+{
+    cmdBuffer
+        .BeginBarrierList()
+            .AddBufferBarrier(s_geomBatchBinCountersBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT)
+        .Push();
+
+    cmdBuffer.CmdFillBuffer(s_geomBatchBinCountersBuffer, 0);
+
+    cmdBuffer
+        .BeginBarrierList()
+            .AddBufferBarrier(s_geomBatchBinCountersBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT)
+            .AddBufferBarrier(s_geomBatchInstBinsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
+        .Push();
+
+    vkn::PSO& pso = s_PSOs[PASS_ID_GEOM_BATCHING];
+
+    cmdBuffer.CmdBindPSO(pso);
+
+    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_COMMON, .shaderSetIdx = DESC_SET_PER_FRAME });
+    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = (uint32_t)setID, .shaderSetIdx = DESC_SET_PER_DRAW });
+
+    const uint32_t instGroupCount = ceil(maxVisInstCount / (float)GEOM_BATCH_CS_GROUP_SIZE);
+    const uint32_t binGroupCount = ceil(GetGeomBatchBinCount() / (float)GEOM_BATCH_CS_GROUP_SIZE);
+
+    GPU_GeomBatchPerDrawData pushConsts = {};
+    pushConsts.isCSMPass = isCSMPass;
+    pushConsts.binCount = GetGeomBatchBinCount();
+
+    pushConsts.stage = GEOM_BATCH_STAGE_BIN_INSTANCES;
+    cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
+    cmdBuffer.CmdDispatch(instGroupCount, 1, 1);
+
+    cmdBuffer
+        .BeginBarrierList()
+            .AddBufferBarrier(s_geomBatchBinCountersBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+            .AddBufferBarrier(s_geomBatchBinOffsetsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
+        .Push();
+
+    pushConsts.stage = GEOM_BATCH_STAGE_EMIT_BATCHES;
+    cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
+    cmdBuffer.CmdDispatch(binGroupCount, 1, 1);
+
+    cmdBuffer
+        .BeginBarrierList()
+            .AddBufferBarrier(s_geomBatchBinOffsetsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+            .AddBufferBarrier(s_geomBatchInstBinsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+        .Push();
+
+    pushConsts.stage = GEOM_BATCH_STAGE_SCATTER_INSTANCES;
+    cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
+    cmdBuffer.CmdDispatch(instGroupCount, 1, 1);
+}
+
+
+static void GeomBatchingPass(vkn::CmdBuffer& cmdBuffer, GPU_GeomQueue queue, GPU_GeomCullingPhase phase)
 {
     CORE_ASSERT(queue < GEOM_QUEUE_COUNT);
     
     DescSetID setID;
+    GPU_GeomMatType matType;
 
     switch(queue) {
         case GEOM_QUEUE_OPAQUE:
             setID = DESC_SET_ID_GEOM_BATCHING_OPAQUE;
+            matType = GEOM_MAT_TYPE_OPAQUE;
             break;
         case GEOM_QUEUE_AKILL:
             setID = DESC_SET_ID_GEOM_BATCHING_AKILL;
+            matType = GEOM_MAT_TYPE_AKILL;
             break;
     }
 
     cmdBuffer
         .BeginBarrierList()
-            .AddBufferBarrier(s_visGeomIDQueueBuffer[queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
-            .AddBufferBarrier(s_visGeomIDQueueSizeBuffer[queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+            .AddBufferBarrier(s_geomCullVisSortKeysBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+            .AddBufferBarrier(s_geomCullVisGeomIDsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+            .AddBufferBarrier(s_geomCullPerGeomMatTypeCountersBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
             .AddBufferBarrier(s_geomBatchQueueBuffer[queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
-            .AddBufferBarrier(s_geomBatchQueueSizeBuffer[queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
+            .AddBufferBarrier(s_geomBatchQueueSizeBuffer[queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT)
             .AddBufferBarrier(s_sortedVisGeomIDQueueBuffer[queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
             .AddBufferBarrier(s_sortedVisGeomIDQueueSizeBuffer[queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
         .Push();
@@ -6420,16 +9216,20 @@ static void GeomBatchingPass(vkn::CmdBuffer& cmdBuffer, GPU_GeomQueue queue)
     cmdBuffer.CmdBindPSO(pso);
 
     cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_COMMON, .shaderSetIdx = DESC_SET_PER_FRAME });
-    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = (uint32_t)setID, .shaderSetIdx = DESC_SET_PER_DRAW });
+    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = setID, .shaderSetIdx = DESC_SET_PER_DRAW });
 
-    // GPU_GeomBatchPerDrawData pushConsts = {};
-    // cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
+    // Instances are already radix sorted by state and depth, so batches are runs of equal state keys
+    GPU_GeomBatchPerDrawData pushConsts = {};
+    pushConsts.stage = GEOM_BATCH_STAGE_EMIT_SORTED_BATCHES;
+    pushConsts.sortedMatType = matType;
+    pushConsts.sortedPhase = phase;
 
+    cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
     cmdBuffer.CmdDispatch(ceil(s_cpuInstData.size() / (float)GEOM_BATCH_CS_GROUP_SIZE), 1, 1);
 }
 
 
-static void GeomBatchingPass(vkn::CmdBuffer& cmdBuffer)
+static void GeomBatchingPass(vkn::CmdBuffer& cmdBuffer, GPU_GeomCullingPhase phase)
 {
     static constexpr const char* passName = "Geom_Batching_Pass";
     static constexpr uint32_t passColor = 0xcae1ff;
@@ -6441,12 +9241,12 @@ static void GeomBatchingPass(vkn::CmdBuffer& cmdBuffer)
         ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_%s", passName, pair.second);
         ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_%s", passName, pair.second);
 
-        GeomBatchingPass(cmdBuffer, pair.first);
+        GeomBatchingPass(cmdBuffer, pair.first, phase);
     }
 }
 
 
-static void GeomDrawCmdGenPass(vkn::CmdBuffer& cmdBuffer, GPU_GeomQueue queue)
+static void GeomDrawCmdGenPass(vkn::CmdBuffer& cmdBuffer, GPU_GeomQueue queue, GPU_GeomCullingPhase phase)
 {
     CORE_ASSERT(queue < GEOM_QUEUE_COUNT);
     
@@ -6475,14 +9275,16 @@ static void GeomDrawCmdGenPass(vkn::CmdBuffer& cmdBuffer, GPU_GeomQueue queue)
     cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_COMMON, .shaderSetIdx = DESC_SET_PER_FRAME });
     cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = setID, .shaderSetIdx = DESC_SET_PER_DRAW });
 
-    // GPU_GeomDrawCmdGenPerDrawData pushConsts = {};
-    // cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
+    GPU_GeomDrawCmdGenPerDrawData pushConsts = {};
+    pushConsts.phase = phase;
+
+    cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
 
     cmdBuffer.CmdDispatch(ceil(s_cpuInstData.size() / (float)GEOM_DRAW_CMD_GEN_CS_GROUP_SIZE), 1, 1);
 }
 
 
-static void GeomDrawCmdGenPass(vkn::CmdBuffer& cmdBuffer)
+static void GeomDrawCmdGenPass(vkn::CmdBuffer& cmdBuffer, GPU_GeomCullingPhase phase)
 {
     static constexpr const char* passName = "Geom_Draw_Cmd_Gen_Pass";
     static constexpr uint32_t passColor = 0x228b22;
@@ -6494,28 +9296,32 @@ static void GeomDrawCmdGenPass(vkn::CmdBuffer& cmdBuffer)
         ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_%s", passName, pair.second);
         ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_%s", passName, pair.second);
 
-        GeomDrawCmdGenPass(cmdBuffer, pair.first);
+        GeomDrawCmdGenPass(cmdBuffer, pair.first, phase);
     }
 }
 
 
-static void GeomCullingPass(vkn::CmdBuffer& cmdBuffer)
+// Early phase draws instances visible in the previous frame. Late phase tests the rest against HZB built from early phase depth
+static void GeomCullingPass(vkn::CmdBuffer& cmdBuffer, GPU_GeomCullingPhase phase)
 {
+    CORE_ASSERT(phase < GEOM_CULLING_PHASE_COUNT);
+
     static constexpr const char* passName = "Geom_Culling_Pass";
     static constexpr uint32_t passColor = 0x1e90ff;
 
-    ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, passName);
-    ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
+    ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_%s", passName, GEOM_CULLING_PHASE_DBG_NAMES[phase]);
+    ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_%s", passName, GEOM_CULLING_PHASE_DBG_NAMES[phase]);
 
-    GeomCullingClearCounters(cmdBuffer);
+    GeomCullingClearCounters(cmdBuffer, phase);
 
-    GeomVisIDBufferPass(cmdBuffer);
-    GeomBatchingPass(cmdBuffer);
-    GeomDrawCmdGenPass(cmdBuffer);
+    GeomVisIDBufferPass(cmdBuffer, phase);
+    GeomRadixSortPass(cmdBuffer);
+    GeomBatchingPass(cmdBuffer, phase);
+    GeomDrawCmdGenPass(cmdBuffer, phase);
 }
 
 
-void RenderPass_Depth(vkn::CmdBuffer& cmdBuffer, GPU_GeomQueue queue)
+void RenderPass_Depth(vkn::CmdBuffer& cmdBuffer, GPU_GeomQueue queue, GPU_GeomCullingPhase phase)
 {
     CORE_ASSERT(queue < GEOM_QUEUE_COUNT);
     
@@ -6531,20 +9337,10 @@ void RenderPass_Depth(vkn::CmdBuffer& cmdBuffer, GPU_GeomQueue queue)
     }
     
     const bool isAKillPass = queue == GEOM_QUEUE_AKILL;
-    const bool needClearDepth = setID == DESC_SET_ID_DEPTH_OPAQUE;
+    const bool needClearDepth = setID == DESC_SET_ID_DEPTH_OPAQUE && phase == GEOM_CULLING_PHASE_EARLY;
 
     vkn::Buffer& drawCmdBuffer = s_geomDrawCmdQueueBuffer[queue];
     vkn::Buffer& drawCmdCountBuffer = s_geomBatchQueueSizeBuffer[queue];
-    vkn::Buffer& visIDBuffer = s_sortedVisGeomIDQueueBuffer[queue];
-
-    cmdBuffer
-        .BeginBarrierList()
-            .AddTextureBarrier(s_depthRT, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, 
-                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_DEPTH_BIT)
-            .AddBufferBarrier(drawCmdBuffer, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
-            .AddBufferBarrier(drawCmdCountBuffer, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
-            .AddBufferBarrier(visIDBuffer, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
-        .Push();
 
     const VkExtent2D extent = VkExtent2D { s_pWnd->GetWidth(), s_pWnd->GetHeight() };
 
@@ -6578,34 +9374,44 @@ void RenderPass_Depth(vkn::CmdBuffer& cmdBuffer, GPU_GeomQueue queue)
 
         cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, pushConsts);
 
-        cmdBuffer.CmdDrawIndexedIndirect(drawCmdBuffer, 0, drawCmdCountBuffer, 0, s_cpuInstData.size(), sizeof(GPU_CmdDrawIndexedIndirect));
-    cmdBuffer.CmdEndRendering();
+        const VkDeviceSize drawCmdOffset = phase * s_cpuInstData.size() * sizeof(GPU_CmdDrawIndexedIndirect);
+        const VkDeviceSize drawCmdCountOffset = phase * sizeof(glm::uint);
 
-    cmdBuffer
-        .BeginBarrierList()
-            .AddTextureBarrier(s_depthRT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, 
-                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_IMAGE_ASPECT_DEPTH_BIT)
-        .Push();
+        cmdBuffer.CmdDrawIndexedIndirect(drawCmdBuffer, drawCmdOffset, drawCmdCountBuffer, drawCmdCountOffset, 
+            s_cpuInstData.size(), sizeof(GPU_CmdDrawIndexedIndirect));
+    cmdBuffer.CmdEndRendering();
 }
 
 
-void GeomDepthPass(vkn::CmdBuffer& cmdBuffer)
+void GeomDepthPass(vkn::CmdBuffer& cmdBuffer, GPU_GeomCullingPhase phase)
 {
     static constexpr const char* passName = "Geom_Depth_Pass";
     static constexpr uint32_t passColor = 0x7f7f7f;
 
-    ENG_PROFILE_SCOPED_MARKER_C(passColor, passName);
-    ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
+    ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_%s", passName, GEOM_CULLING_PHASE_DBG_NAMES[phase]);
+    ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_%s", passName, GEOM_CULLING_PHASE_DBG_NAMES[phase]);
 
 #ifdef ENG_BUILD_DEBUG
     SetWireframeMode(cmdBuffer, s_geomWireframeMode);
 #endif
 
+    bool isFirstQueue = true;
+
     for (const auto& pair : GEOM_QUEUE_TO_NAME) {
         ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_%s", passName, pair.second);
         ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_%s", passName, pair.second);
 
-        RenderPass_Depth(cmdBuffer, pair.first);
+        // Rasterization order doesn't work between rendering instances, so depth writes of queues are ordered by barrier
+        if (!isFirstQueue) {
+            cmdBuffer
+                .BeginBarrierList()
+                    .AddTextureBarrier(s_depthRT, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, 
+                        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_DEPTH_BIT)
+                .Push();
+        }
+
+        RenderPass_Depth(cmdBuffer, pair.first, phase);
+        isFirstQueue = false;
     }
 
 #ifdef ENG_BUILD_DEBUG
@@ -6616,62 +9422,29 @@ void GeomDepthPass(vkn::CmdBuffer& cmdBuffer)
 
 static void HZBGeneratePass(vkn::CmdBuffer& cmdBuffer)
 {
-    if (s_cullingTestMode) {
-        return;
-    }
-
     static constexpr const char* passName = "HZB_Generation_Pass";
     static constexpr uint32_t passColor = 0xcccccc;
 
     ENG_PROFILE_SCOPED_MARKER_C(passColor, passName);
     ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
 
-    eng::Timer timer;
+    if (s_hzbSpdCounterResetRequired) {
+        cmdBuffer
+            .BeginBarrierList()
+                .AddBufferBarrier(s_hzbSpdCounterBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT)
+            .Push();
+
+        cmdBuffer.CmdFillBuffer(s_hzbSpdCounterBuffer, 0);
+        s_hzbSpdCounterResetRequired = false;
+    }
 
+    // All mips are built by one dispatch: groups reduce their tiles, and the last finished one builds the rest mips
     cmdBuffer
         .BeginBarrierList()
-            .AddTextureBarrier(
-                s_depthRT,
-                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                VK_PIPELINE_STAGE_2_COPY_BIT,
-                VK_ACCESS_2_TRANSFER_READ_BIT,
-                VK_IMAGE_ASPECT_DEPTH_BIT,
-                0, 1)
-            .AddTextureBarrier(
-                s_HZB,
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                VK_PIPELINE_STAGE_2_COPY_BIT,
-                VK_ACCESS_2_TRANSFER_WRITE_BIT,
-                VK_IMAGE_ASPECT_COLOR_BIT,
-                0, 1)
+            .AddBufferBarrier(s_hzbSpdCounterBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
+                VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT)
         .Push();
 
-    VkImageCopy copyRegion = {};
-
-    copyRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-    copyRegion.srcSubresource.mipLevel = 0;
-    copyRegion.srcSubresource.baseArrayLayer = 0;
-    copyRegion.srcSubresource.layerCount = 1;
-
-    copyRegion.srcOffset = { 0, 0, 0 };
-
-    copyRegion.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    copyRegion.dstSubresource.mipLevel = 0;
-    copyRegion.dstSubresource.baseArrayLayer = 0;
-    copyRegion.dstSubresource.layerCount = 1;
-
-    copyRegion.dstOffset = { 0, 0, 0 };
-
-    CORE_ASSERT(s_depthRT.GetSizeX() == s_HZB.GetSizeX());
-    CORE_ASSERT(s_depthRT.GetSizeY() == s_HZB.GetSizeY());
-
-    copyRegion.extent = { s_depthRT.GetSizeX(), s_depthRT.GetSizeY(), 1 };
-
-    cmdBuffer.CmdCopyTexture(s_depthRT, s_HZB, copyRegion);
-
-    glm::uvec2 srcMipSize = glm::uvec2(s_HZB.GetSizeX(), s_HZB.GetSizeY());
-    glm::uvec2 dstMipSize = srcMipSize;
-
     vkn::PSO& pso = s_PSOs[PASS_ID_HZB_GEN];
     
     cmdBuffer.CmdBindPSO(pso);
@@ -6679,39 +9452,50 @@ static void HZBGeneratePass(vkn::CmdBuffer& cmdBuffer)
     cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_COMMON, .shaderSetIdx = DESC_SET_PER_FRAME });
     cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_HZB_GEN, .shaderSetIdx = DESC_SET_PER_DRAW });
 
+    CORE_ASSERT(s_HZB.GetSizeX() % HZB_SPD_TILE_SIZE == 0 && s_HZB.GetSizeY() % HZB_SPD_TILE_SIZE == 0);
+    CORE_ASSERT(s_depthRT.GetSizeX() <= s_HZB.GetSizeX() && s_depthRT.GetSizeY() <= s_HZB.GetSizeY());
+
+    const glm::uvec2 groupCount = glm::uvec2(s_HZB.GetSizeX(), s_HZB.GetSizeY()) / HZB_SPD_TILE_SIZE;
+
     GPU_HzbGenPerDrawData pushConsts = {};
+    pushConsts.depthResolution = glm::uvec2(s_depthRT.GetSizeX(), s_depthRT.GetSizeY());
+    pushConsts.mipCount = s_HZB.GetMipCount();
+    pushConsts.groupCount = groupCount.x * groupCount.y;
 
-    for (uint32_t mip = 1; mip < s_HZB.GetMipCount(); ++mip) {
-        srcMipSize = dstMipSize;
-        dstMipSize = glm::max(srcMipSize >> 1u, ONEU2);
+    cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
 
-        cmdBuffer
-            .BeginBarrierList()
-                .AddTextureBarrier(s_HZB, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
-                    VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mip - 1, 1)
-                .AddTextureBarrier(s_HZB, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
-                    VK_ACCESS_2_SHADER_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT, mip, 1)
-            .Push();
+    cmdBuffer.CmdDispatch(groupCount.x, groupCount.y, 1u);
+}
 
-        pushConsts.srcMipResolution = srcMipSize;
-        pushConsts.dstMipResolution = dstMipSize;
-        pushConsts.dstMipIdx = mip;
 
-        cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
+// Finds cascades which static cache was built with different state than the current one
+static void CSMUpdateStaticCacheMask()
+{
+    s_csmStaticCacheUpdateMask = 0;
 
-        cmdBuffer.CmdDispatch(
-            (uint32_t)glm::ceil(dstMipSize.x / (float)HZB_BUILD_CS_GROUP_SIZE), 
-            (uint32_t)glm::ceil(dstMipSize.y / (float)HZB_BUILD_CS_GROUP_SIZE),
-            1u
-        );
-    }
+    for (uint32_t i = 0; i < COMMON_CSM_CASCADE_COUNT; ++i) {
+        CsmStaticCacheState state = {};
+        state.viewProjMatr = s_csmCameras[i].GetViewProjMatrix();
+        state.geomLodPixelThreshold = s_csmGeomLodPixelThresholds[i];
+        state.forcedGeomLOD = s_forcedGeomLOD;
+        state.isWireframe = s_geomWireframeMode;
+        // VSM renders only dirty pages, so static geometry is culled against them every frame
+        state.isValid = s_isCSMStaticCacheEnabled && !s_isVSMEnabled;
+
+        const CsmStaticCacheState& cachedState = s_csmStaticCacheStates[i];
+
+        const bool isCacheValid = cachedState.isValid && state.isValid &&
+            cachedState.viewProjMatr == state.viewProjMatr &&
+            cachedState.geomLodPixelThreshold == state.geomLodPixelThreshold &&
+            cachedState.forcedGeomLOD == state.forcedGeomLOD &&
+            cachedState.isWireframe == state.isWireframe;
+
+        if (!isCacheValid) {
+            s_csmStaticCacheUpdateMask |= 1u << i;
+        }
 
-    // To get all mips in same layout
-    cmdBuffer
-        .BeginBarrierList()
-            .AddTextureBarrier(s_HZB, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
-                VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT, s_HZB.GetMipCount() - 1, 1)
-        .Push();
+        s_csmStaticCacheStates[i] = state;
+    }
 }
 
 
@@ -6721,21 +9505,21 @@ static void CSMGeomCullingClearCounters(vkn::CmdBuffer& cmdBuffer)
 
     vkn::BarrierList& barriers = cmdBuffer.BeginBarrierList();
 
-    for (uint32_t cascade = 0; cascade < COMMON_CSM_CASCADE_COUNT; ++cascade) {
+    for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
         for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
-            barriers.AddBufferBarrier(s_csmVisGeomIDQueueSizeBuffers[cascade][queue], VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
-            barriers.AddBufferBarrier(s_csmGeomBatchQueueSizeBuffers[cascade][queue], VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
-            barriers.AddBufferBarrier(s_csmSortedVisGeomIDQueueSizeBuffers[cascade][queue], VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+            barriers.AddBufferBarrier(s_csmVisGeomIDQueueSizeBuffers[geomType][queue], VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+            barriers.AddBufferBarrier(s_csmGeomBatchQueueSizeBuffers[geomType][queue], VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+            barriers.AddBufferBarrier(s_csmSortedVisGeomIDQueueSizeBuffers[geomType][queue], VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
         }
     }
 
     barriers.Push();
 
-    for (uint32_t cascade = 0; cascade < COMMON_CSM_CASCADE_COUNT; ++cascade) {
+    for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
         for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
-            cmdBuffer.CmdFillBuffer(s_csmVisGeomIDQueueSizeBuffers[cascade][queue], 0, 0, sizeof(glm::uint));
-            cmdBuffer.CmdFillBuffer(s_csmGeomBatchQueueSizeBuffers[cascade][queue], 0, 0, sizeof(glm::uint));
-            cmdBuffer.CmdFillBuffer(s_csmSortedVisGeomIDQueueSizeBuffers[cascade][queue], 0, 0, sizeof(glm::uint));
+            cmdBuffer.CmdFillBuffer(s_csmVisGeomIDQueueSizeBuffers[geomType][queue], 0, 0, sizeof(glm::uint));
+            cmdBuffer.CmdFillBuffer(s_csmGeomBatchQueueSizeBuffers[geomType][queue], 0, 0, sizeof(glm::uint));
+            cmdBuffer.CmdFillBuffer(s_csmSortedVisGeomIDQueueSizeBuffers[geomType][queue], 0, 0, sizeof(glm::uint));
         }
     }
 }
@@ -6751,10 +9535,10 @@ static void CSMGeomVisIDBufferPass(vkn::CmdBuffer& cmdBuffer)
 
     vkn::BarrierList& barriers = cmdBuffer.BeginBarrierList();
 
-    for (uint32_t cascade = 0; cascade < COMMON_CSM_CASCADE_COUNT; ++cascade) {
+    for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
         for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
-            barriers.AddBufferBarrier(s_csmVisGeomIDQueueBuffers[cascade][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
-            barriers.AddBufferBarrier(s_csmVisGeomIDQueueSizeBuffers[cascade][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
+            barriers.AddBufferBarrier(s_csmVisGeomIDQueueBuffers[geomType][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
+            barriers.AddBufferBarrier(s_csmVisGeomIDQueueSizeBuffers[geomType][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
         }
     }
 
@@ -6767,44 +9551,39 @@ static void CSMGeomVisIDBufferPass(vkn::CmdBuffer& cmdBuffer)
     cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_COMMON, .shaderSetIdx = DESC_SET_PER_FRAME });
     cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_CSM_GEOM_CULLING, .shaderSetIdx = DESC_SET_PER_DRAW });
 
+    GPU_CsmPerDrawData pushConsts = {};
+    pushConsts.staticCacheUpdateMask = s_csmStaticCacheUpdateMask;
+
+    cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
+
     cmdBuffer.CmdDispatch(ceil(s_cpuInstData.size() / (float)GEOM_CULLING_CS_GROUP_SIZE), 1, 1);
 }
 
 
-static void CSMGeomBatchingPass(vkn::CmdBuffer& cmdBuffer, uint32_t cascade, GPU_GeomQueue queue)
+static void CSMGeomBatchingPass(vkn::CmdBuffer& cmdBuffer, GPU_CsmGeomType geomType, GPU_GeomQueue queue)
 {
-    CORE_ASSERT(cascade < COMMON_CSM_CASCADE_COUNT);
+    CORE_ASSERT(geomType < CSM_GEOM_TYPE_COUNT);
     CORE_ASSERT(queue < GEOM_QUEUE_COUNT);
 
-    DescSetID setID;
-
-    switch(queue) {
-        case GEOM_QUEUE_OPAQUE:
-            setID = (DescSetID)(DESC_SET_ID_CSM_GEOM_BATCHING_OPAQUE_CASCADE_0 + cascade);
-            break;
-        case GEOM_QUEUE_AKILL:
-            setID = (DescSetID)(DESC_SET_ID_CSM_GEOM_BATCHING_AKILL_CASCADE_0 + cascade);
-            break;
-    }
+    const DescSetID setID = CSMGetGeomBatchingDescSetID(geomType, queue);
 
     cmdBuffer
         .BeginBarrierList()
-            .AddBufferBarrier(s_csmVisGeomIDQueueBuffers[cascade][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
-            .AddBufferBarrier(s_csmVisGeomIDQueueSizeBuffers[cascade][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
-            .AddBufferBarrier(s_csmGeomBatchQueueBuffers[cascade][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
-            .AddBufferBarrier(s_csmGeomBatchQueueSizeBuffers[cascade][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
-            .AddBufferBarrier(s_csmSortedVisGeomIDQueueBuffers[cascade][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
-            .AddBufferBarrier(s_csmSortedVisGeomIDQueueSizeBuffers[cascade][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
+            .AddBufferBarrier(s_csmVisGeomIDQueueBuffers[geomType][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+            .AddBufferBarrier(s_csmVisGeomIDQueueSizeBuffers[geomType][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+            .AddBufferBarrier(s_csmGeomBatchQueueBuffers[geomType][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
+            .AddBufferBarrier(s_csmGeomBatchQueueSizeBuffers[geomType][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
+            .AddBufferBarrier(s_csmSortedVisGeomIDQueueBuffers[geomType][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
+            .AddBufferBarrier(s_csmSortedVisGeomIDQueueSizeBuffers[geomType][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
         .Push();
 
-    vkn::PSO& pso = s_PSOs[PASS_ID_GEOM_BATCHING];
-
-    cmdBuffer.CmdBindPSO(pso);
+    GeomBatchingDispatch(cmdBuffer, setID, true, CSMGetVisInstQueueCapacity(geomType));
+}
 
-    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_COMMON, .shaderSetIdx = DESC_SET_PER_FRAME });
-    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = (uint32_t)setID, .shaderSetIdx = DESC_SET_PER_DRAW });
 
-    cmdBuffer.CmdDispatch(ceil(s_cpuInstData.size() / (float)GEOM_BATCH_CS_GROUP_SIZE), 1, 1);
+static bool CSMIsGeomTypeRendered(GPU_CsmGeomType geomType)
+{
+    return geomType == CSM_GEOM_TYPE_STATIC ? s_csmStaticCacheUpdateMask != 0 : CSMHasDynamicInstances();
 }
 
 
@@ -6816,38 +9595,33 @@ static void CSMVisGeometryBatchingPass(vkn::CmdBuffer& cmdBuffer)
     ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, passName);
     ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
 
-    for (const auto& pair : GEOM_QUEUE_TO_NAME) {
-        for (uint32_t cascade = 0; cascade < COMMON_CSM_CASCADE_COUNT; ++cascade) {
-            ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_Cascade_%u_%s", passName, cascade, pair.second);
-            ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_Cascade_%u_%s", passName, cascade, pair.second);
-    
-            CSMGeomBatchingPass(cmdBuffer, cascade, pair.first);
+    for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
+        if (!CSMIsGeomTypeRendered((GPU_CsmGeomType)geomType)) {
+            continue;
         }
-    }
-}
-
-
-static void CSMGeomDrawCmdGenPass(vkn::CmdBuffer& cmdBuffer, uint32_t cascade, GPU_GeomQueue queue)
-{
-    CORE_ASSERT(cascade < COMMON_CSM_CASCADE_COUNT);
-    CORE_ASSERT(queue < GEOM_QUEUE_COUNT);
 
-    DescSetID setID;
+        for (const auto& pair : GEOM_QUEUE_TO_NAME) {
+            ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_%s_%s", passName, CSM_GEOM_TYPE_DBG_NAMES[geomType], pair.second);
+            ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_%s_%s", passName, CSM_GEOM_TYPE_DBG_NAMES[geomType], pair.second);
 
-    switch(queue) {
-        case GEOM_QUEUE_OPAQUE:
-            setID = (DescSetID)(DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_OPAQUE_CASCADE_0 + cascade);
-            break;
-        case GEOM_QUEUE_AKILL:
-            setID = (DescSetID)(DESC_SET_ID_CSM_GEOM_DRAW_CMD_GEN_AKILL_CASCADE_0 + cascade);
-            break;
+            CSMGeomBatchingPass(cmdBuffer, (GPU_CsmGeomType)geomType, pair.first);
+        }
     }
+}
+
+
+static void CSMGeomDrawCmdGenPass(vkn::CmdBuffer& cmdBuffer, GPU_CsmGeomType geomType, GPU_GeomQueue queue)
+{
+    CORE_ASSERT(geomType < CSM_GEOM_TYPE_COUNT);
+    CORE_ASSERT(queue < GEOM_QUEUE_COUNT);
+
+    const DescSetID setID = CSMGetGeomDrawCmdGenDescSetID(geomType, queue);
 
     cmdBuffer
         .BeginBarrierList()
-            .AddBufferBarrier(s_csmGeomBatchQueueBuffers[cascade][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
-            .AddBufferBarrier(s_csmGeomBatchQueueSizeBuffers[cascade][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
-            .AddBufferBarrier(s_csmGeomDrawCmdQueueBuffers[cascade][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
+            .AddBufferBarrier(s_csmGeomBatchQueueBuffers[geomType][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+            .AddBufferBarrier(s_csmGeomBatchQueueSizeBuffers[geomType][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
+            .AddBufferBarrier(s_csmGeomDrawCmdQueueBuffers[geomType][queue], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT)
         .Push();
 
     vkn::PSO& pso = s_PSOs[PASS_ID_GEOM_DRAW_CMD_GEN];
@@ -6857,7 +9631,13 @@ static void CSMGeomDrawCmdGenPass(vkn::CmdBuffer& cmdBuffer, uint32_t cascade, G
     cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_COMMON, .shaderSetIdx = DESC_SET_PER_FRAME });
     cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = setID, .shaderSetIdx = DESC_SET_PER_DRAW });
 
-    cmdBuffer.CmdDispatch(ceil(s_cpuInstData.size() / (float)GEOM_DRAW_CMD_GEN_CS_GROUP_SIZE), 1, 1);
+    // Cascades are culled in one phase, so their queues have only the early phase region
+    GPU_GeomDrawCmdGenPerDrawData pushConsts = {};
+    pushConsts.phase = GEOM_CULLING_PHASE_EARLY;
+
+    cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
+
+    cmdBuffer.CmdDispatch(ceil(CSMGetVisInstQueueCapacity(geomType) / (float)GEOM_DRAW_CMD_GEN_CS_GROUP_SIZE), 1, 1);
 }
 
 
@@ -6869,12 +9649,16 @@ static void CSMGeometryDrawCmdGenPass(vkn::CmdBuffer& cmdBuffer)
     ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, passName);
     ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
 
-    for (const auto& pair : GEOM_QUEUE_TO_NAME) {
-        for (uint32_t cascade = 0; cascade < COMMON_CSM_CASCADE_COUNT; ++cascade) {
-            ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_Cascade_%u_%s", passName, cascade, pair.second);
-            ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_Cascade_%u_%s", passName, cascade, pair.second);
-    
-            CSMGeomDrawCmdGenPass(cmdBuffer, cascade, pair.first);
+    for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
+        if (!CSMIsGeomTypeRendered((GPU_CsmGeomType)geomType)) {
+            continue;
+        }
+
+        for (const auto& pair : GEOM_QUEUE_TO_NAME) {
+            ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_%s_%s", passName, CSM_GEOM_TYPE_DBG_NAMES[geomType], pair.second);
+            ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_%s_%s", passName, CSM_GEOM_TYPE_DBG_NAMES[geomType], pair.second);
+
+            CSMGeomDrawCmdGenPass(cmdBuffer, (GPU_CsmGeomType)geomType, pair.first);
         }
     }
 }
@@ -6888,6 +9672,13 @@ static void CSMGeometryCullingPass(vkn::CmdBuffer& cmdBuffer)
     ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, passName);
     ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
 
+    CSMUpdateStaticCacheMask();
+
+    // Nothing is rendered into cascades, so they keep the previous frame content
+    if (s_csmStaticCacheUpdateMask == 0 && !CSMHasDynamicInstances()) {
+        return;
+    }
+
     CSMGeomCullingClearCounters(cmdBuffer);
 
     CSMGeomVisIDBufferPass(cmdBuffer);
@@ -6896,46 +9687,40 @@ static void CSMGeometryCullingPass(vkn::CmdBuffer& cmdBuffer)
 }
 
 
-static void RenderPass_CSM(vkn::CmdBuffer& cmdBuffer, uint32_t cascade, GPU_GeomQueue queue)
+// All cascades are rendered at once. Vertex shader routes every instance entry into its cascade layer
+static void RenderPass_CSM(vkn::CmdBuffer& cmdBuffer, GPU_CsmGeomType geomType, GPU_GeomQueue queue, vkn::Texture& rt, vkn::TextureView& rtViewArray)
 {
-    CORE_ASSERT(cascade < COMMON_CSM_CASCADE_COUNT);
+    CORE_ASSERT(geomType < CSM_GEOM_TYPE_COUNT);
     CORE_ASSERT(queue < GEOM_QUEUE_COUNT);
 
     const DescSetID setID = DESC_SET_ID_CSM_RENDER;
-    
-    const bool needClearDepth = queue == GEOM_QUEUE_OPAQUE;
 
-    vkn::Buffer& drawCmdBuffer = s_csmGeomDrawCmdQueueBuffers[cascade][queue];
-    vkn::Buffer& drawCmdCountBuffer = s_csmGeomBatchQueueSizeBuffers[cascade][queue];
-    vkn::Buffer& visIDBuffer = s_csmSortedVisGeomIDQueueBuffers[cascade][queue];
+    vkn::Buffer& drawCmdBuffer = s_csmGeomDrawCmdQueueBuffers[geomType][queue];
+    vkn::Buffer& drawCmdCountBuffer = s_csmGeomBatchQueueSizeBuffers[geomType][queue];
+    vkn::Buffer& visIDBuffer = s_csmSortedVisGeomIDQueueBuffers[geomType][queue];
 
     cmdBuffer
         .BeginBarrierList()
             .AddBufferBarrier(drawCmdBuffer, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
             .AddBufferBarrier(drawCmdCountBuffer, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
             .AddBufferBarrier(visIDBuffer, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT)
-            .AddTextureBarrier(s_csmRT, 
+            .AddTextureBarrier(rt, 
                 VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, 
                 VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, 
                 VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, 
-                VK_IMAGE_ASPECT_DEPTH_BIT, 
-                0, VK_REMAINING_MIP_LEVELS, 
-                cascade, 1)
+                VK_IMAGE_ASPECT_DEPTH_BIT)
         .Push();
 
     const VkExtent2D extent = VkExtent2D { CSM_CASCADE_RT_SIZE, CSM_CASCADE_RT_SIZE };
 
+    // Cascades are cleared by CSMClearStaticCache() or filled with static cache copy before
     vkn::RenderInfo renderInfo = {};
 
     renderInfo.renderArea.extent = extent;
-    renderInfo.depthAttachment.view = &s_csmRTViews[cascade];
-    renderInfo.depthAttachment.loadOp  = needClearDepth ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+    renderInfo.layerCount = COMMON_CSM_CASCADE_COUNT;
+    renderInfo.depthAttachment.view = &rtViewArray;
+    renderInfo.depthAttachment.loadOp  = VK_ATTACHMENT_LOAD_OP_LOAD;
     renderInfo.depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-#ifdef ENG_REVERSED_Z
-    renderInfo.depthAttachment.clearValue.depthStencil.depth = 0.f;
-#else
-    renderInfo.depthAttachment.clearValue.depthStencil.depth = 1.f;
-#endif
 
     cmdBuffer.CmdBeginRendering(renderInfo);
         cmdBuffer.CmdSetViewport(0.f, 0.f, extent.width, extent.height);
@@ -6951,24 +9736,91 @@ static void RenderPass_CSM(vkn::CmdBuffer& cmdBuffer, uint32_t cascade, GPU_Geom
         cmdBuffer.CmdBindIndexBuffer(s_geomIndexBuffer, 0, GetVkIndexType());
 
         GPU_CsmPerDrawData pushConsts = {};
-        pushConsts.cascadeIdx = cascade;
         pushConsts.queue = queue;
+        pushConsts.geomType = geomType;
+        pushConsts.staticCacheUpdateMask = s_csmStaticCacheUpdateMask;
 
         cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, pushConsts);
 
-        cmdBuffer.CmdDrawIndexedIndirect(drawCmdBuffer, 0, drawCmdCountBuffer, 0, s_cpuInstData.size(), sizeof(GPU_CmdDrawIndexedIndirect));
+        cmdBuffer.CmdDrawIndexedIndirect(drawCmdBuffer, 0, drawCmdCountBuffer, 0, CSMGetVisInstQueueCapacity(geomType), sizeof(GPU_CmdDrawIndexedIndirect));
     cmdBuffer.CmdEndRendering();
+}
+
+
+// Clears static cache layers of invalidated cascades. Layers of other cascades keep static geometry of previous frames
+static void CSMClearStaticCache(vkn::CmdBuffer& cmdBuffer)
+{
+    ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, 0x000000, "CSM_Static_Cache_Clear");
 
     cmdBuffer
         .BeginBarrierList()
-            .AddTextureBarrier(s_csmRT, 
-                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-                VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, 
-                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
-                VK_IMAGE_ASPECT_DEPTH_BIT,
-                0, VK_REMAINING_MIP_LEVELS, 
-                cascade, 1)
+            .AddTextureBarrier(s_csmStaticCacheRT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, 
+                VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_ASPECT_DEPTH_BIT)
+        .Push();
+
+    vkn::TextureClearInfo clear = {};
+
+#ifdef ENG_REVERSED_Z
+    clear.depth = 0.f;
+#else
+    clear.depth = 1.f;
+#endif
+
+    for (uint32_t i = 0; i < COMMON_CSM_CASCADE_COUNT; ++i) {
+        if (!MATH_IS_BIT_SET(s_csmStaticCacheUpdateMask, i)) {
+            continue;
+        }
+
+        vkn::TextureClearRange range = {};
+        range.baseMipLevel = 0;
+        range.levelCount = 1;
+        range.baseArrayLayer = i;
+        range.layerCount = 1;
+
+        cmdBuffer.CmdClearTexture(s_csmStaticCacheRT, clear, range);
+    }
+}
+
+
+// Copies static cache into cascades which are either rebuilt or get dynamic geometry on top
+static void CSMCopyStaticCache(vkn::CmdBuffer& cmdBuffer)
+{
+    const uint32_t allCascadesMask = (1u << COMMON_CSM_CASCADE_COUNT) - 1u;
+    const uint32_t copyMask = CSMHasDynamicInstances() ? allCascadesMask : s_csmStaticCacheUpdateMask;
+
+    if (copyMask == 0) {
+        return;
+    }
+
+    ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, 0x000000, "CSM_Static_Cache_Copy");
+
+    cmdBuffer
+        .BeginBarrierList()
+            .AddTextureBarrier(s_csmStaticCacheRT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, 
+                VK_ACCESS_2_TRANSFER_READ_BIT, VK_IMAGE_ASPECT_DEPTH_BIT)
+            .AddTextureBarrier(s_csmRT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, 
+                VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_ASPECT_DEPTH_BIT)
         .Push();
+
+    std::array<VkImageCopy, COMMON_CSM_CASCADE_COUNT> regions = {};
+    uint32_t regionCount = 0;
+
+    for (uint32_t i = 0; i < COMMON_CSM_CASCADE_COUNT; ++i) {
+        if (!MATH_IS_BIT_SET(copyMask, i)) {
+            continue;
+        }
+
+        VkImageCopy& region = regions[regionCount++];
+
+        region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        region.srcSubresource.mipLevel = 0;
+        region.srcSubresource.baseArrayLayer = i;
+        region.srcSubresource.layerCount = 1;
+        region.dstSubresource = region.srcSubresource;
+        region.extent = VkExtent3D { CSM_CASCADE_RT_SIZE, CSM_CASCADE_RT_SIZE, 1u };
+    }
+
+    cmdBuffer.CmdCopyTexture(s_csmStaticCacheRT, s_csmRT, std::span(regions.data(), regionCount));
 }
 
 
@@ -6980,22 +9832,207 @@ static void CSMRenderPass(vkn::CmdBuffer& cmdBuffer)
     ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, passName);
     ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
 
+    const bool needUpdateStaticCache = s_csmStaticCacheUpdateMask != 0;
+    const bool hasDynamicInstances = CSMHasDynamicInstances();
+
+    if (!needUpdateStaticCache && !hasDynamicInstances) {
+        return;
+    }
+
 #ifdef ENG_BUILD_DEBUG
     SetWireframeMode(cmdBuffer, s_geomWireframeMode);
 #endif
 
-    for (const auto& pair : GEOM_QUEUE_TO_NAME) {
-        for (uint32_t cascade = 0; cascade < COMMON_CSM_CASCADE_COUNT; ++cascade) {
-            ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_Cascade_%u_%s", passName, cascade, pair.second);
-            ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_Cascade_%u_%s", passName, cascade, pair.second);
+    if (needUpdateStaticCache) {
+        CSMClearStaticCache(cmdBuffer);
+
+        for (const auto& pair : GEOM_QUEUE_TO_NAME) {
+            ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_%s_%s", passName, CSM_GEOM_TYPE_DBG_NAMES[CSM_GEOM_TYPE_STATIC], pair.second);
+            ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_%s_%s", passName, CSM_GEOM_TYPE_DBG_NAMES[CSM_GEOM_TYPE_STATIC], pair.second);
+
+            RenderPass_CSM(cmdBuffer, CSM_GEOM_TYPE_STATIC, pair.first, s_csmStaticCacheRT, s_csmStaticCacheRTViewArray);
+        }
+    }
+
+    CSMCopyStaticCache(cmdBuffer);
+
+    if (hasDynamicInstances) {
+        for (const auto& pair : GEOM_QUEUE_TO_NAME) {
+            ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_%s_%s", passName, CSM_GEOM_TYPE_DBG_NAMES[CSM_GEOM_TYPE_DYNAMIC], pair.second);
+            ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_%s_%s", passName, CSM_GEOM_TYPE_DBG_NAMES[CSM_GEOM_TYPE_DYNAMIC], pair.second);
+
+            RenderPass_CSM(cmdBuffer, CSM_GEOM_TYPE_DYNAMIC, pair.first, s_csmRT, s_csmRTViewArray);
+        }
+    }
+
+#ifdef ENG_BUILD_DEBUG
+    SetWireframeMode(cmdBuffer, false);
+#endif
+
+    cmdBuffer
+        .BeginBarrierList()
+            .AddTextureBarrier(s_csmRT, 
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, 
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                VK_IMAGE_ASPECT_DEPTH_BIT)
+        .Push();
+}
+
+
+static void VSMDispatchPagesStage(vkn::CmdBuffer& cmdBuffer, GPU_VsmPagesStage stage, const glm::uvec2& groupCount)
+{
+    vkn::PSO& pso = s_PSOs[PASS_ID_VSM_PAGES];
+
+    GPU_VsmPagesPerDrawData pushConsts = {};
+    pushConsts.stage = stage;
+
+    cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_COMPUTE_BIT, pushConsts);
+
+    if (stage == VSM_PAGES_STAGE_CLEAR) {
+        cmdBuffer.CmdDispatchIndirect(s_vsmClearDispatchArgsBuffer);
+    } else {
+        cmdBuffer.CmdDispatch(groupCount.x, groupCount.y, 1u);
+    }
+}
+
+
+static void VSMPushPagesBuffersBarrier(vkn::CmdBuffer& cmdBuffer)
+{
+    static constexpr VkAccessFlags2 access = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+    cmdBuffer
+        .BeginBarrierList()
+            .AddBufferBarrier(s_vsmPageTableBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, access)
+            .AddBufferBarrier(s_vsmPhysPageLastUsedFrameBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, access)
+            .AddBufferBarrier(s_vsmFreeListBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, access)
+            .AddBufferBarrier(s_vsmFreeListCounterBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, access)
+            .AddBufferBarrier(s_vsmDirtyListBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, access)
+            .AddBufferBarrier(s_vsmClearDispatchArgsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, access)
+            .AddBufferBarrier(s_vsmDirtyPageRectsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, access)
+        .Push();
+}
+
+
+// Marks pages requested by visible pixels, releases stale and unused ones, allocates physical pages for requested ones and
+// clears the dirty ones. Dirty page rects are used by CSM culling after it
+static void VSMPagesPass(vkn::CmdBuffer& cmdBuffer)
+{
+    static constexpr const char* passName = "VSM_Pages_Pass";
+    static constexpr uint32_t passColor = 0x4682b4;
+
+    ENG_PROFILE_SCOPED_MARKER_C(passColor, passName);
+    ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
+
+    vkn::PSO& pso = s_PSOs[PASS_ID_VSM_PAGES];
     
-            RenderPass_CSM(cmdBuffer, cascade, pair.first);
+    cmdBuffer.CmdBindPSO(pso);
+
+    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_COMMON, .shaderSetIdx = DESC_SET_PER_FRAME });
+    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_VSM_PAGES, .shaderSetIdx = DESC_SET_PER_DRAW });
+
+    const glm::uvec2 linearGroupCount = glm::uvec2(ceil(COMMON_VSM_PAGE_TABLE_SIZE / (float)(VSM_PAGES_CS_GROUP_SIZE * VSM_PAGES_CS_GROUP_SIZE)), 1u);
+    const glm::uvec2 screenGroupCount = glm::uvec2(
+        ceil(s_depthRT.GetSizeX() / (float)VSM_PAGES_CS_GROUP_SIZE), 
+        ceil(s_depthRT.GetSizeY() / (float)VSM_PAGES_CS_GROUP_SIZE)
+    );
+
+    if (s_vsmResetRequired) {
+        VSMPushPagesBuffersBarrier(cmdBuffer);
+        VSMDispatchPagesStage(cmdBuffer, VSM_PAGES_STAGE_RESET, linearGroupCount);
+
+        s_vsmResetRequired = false;
+    }
+
+    VSMPushPagesBuffersBarrier(cmdBuffer);
+    VSMDispatchPagesStage(cmdBuffer, VSM_PAGES_STAGE_MARK, screenGroupCount);
+
+    VSMPushPagesBuffersBarrier(cmdBuffer);
+    VSMDispatchPagesStage(cmdBuffer, VSM_PAGES_STAGE_RELEASE, linearGroupCount);
+
+    VSMPushPagesBuffersBarrier(cmdBuffer);
+    VSMDispatchPagesStage(cmdBuffer, VSM_PAGES_STAGE_ALLOCATE, linearGroupCount);
+
+    cmdBuffer
+        .BeginBarrierList()
+            .AddBufferBarrier(s_vsmClearDispatchArgsBuffer, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
+            .AddBufferBarrier(s_vsmDirtyListBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT)
+        .Push();
+
+    VSMDispatchPagesStage(cmdBuffer, VSM_PAGES_STAGE_CLEAR, ZEROU2);
+
+    cmdBuffer
+        .BeginBarrierList()
+            .AddBufferBarrier(s_vsmDirtyPageRectsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT)
+            .AddBufferBarrier(s_vsmPageTableBuffer, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT)
+        .Push();
+}
+
+
+// Depth of dirty pages is written into physical pool with atomics, so the pass has no attachments and
+// rasterizes the whole virtual level resolution
+static void VSMRenderPass(vkn::CmdBuffer& cmdBuffer)
+{
+    static constexpr const char* passName = "VSM_Render_Pass";
+    static constexpr uint32_t passColor = 0x708090;
+
+    ENG_PROFILE_SCOPED_MARKER_C(passColor, passName);
+    ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
+
+#ifdef ENG_BUILD_DEBUG
+    SetWireframeMode(cmdBuffer, s_geomWireframeMode);
+#endif
+
+    const VkExtent2D extent = VkExtent2D { COMMON_VSM_VIRTUAL_SIZE, COMMON_VSM_VIRTUAL_SIZE };
+
+    for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
+        for (const auto& pair : GEOM_QUEUE_TO_NAME) {
+            ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_%s_%s", passName, CSM_GEOM_TYPE_DBG_NAMES[geomType], pair.second);
+            ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_%s_%s", passName, CSM_GEOM_TYPE_DBG_NAMES[geomType], pair.second);
+
+            const GPU_GeomQueue queue = pair.first;
+
+            vkn::Buffer& drawCmdBuffer = s_csmGeomDrawCmdQueueBuffers[geomType][queue];
+            vkn::Buffer& drawCmdCountBuffer = s_csmGeomBatchQueueSizeBuffers[geomType][queue];
+
+            vkn::RenderInfo renderInfo = {};
+            renderInfo.renderArea.extent = extent;
+
+            cmdBuffer.CmdBeginRendering(renderInfo);
+                cmdBuffer.CmdSetViewport(0.f, 0.f, extent.width, extent.height);
+                cmdBuffer.CmdSetScissor(0, 0, extent.width, extent.height);
+
+                vkn::PSO& pso = s_PSOs[PASS_ID_VSM_RENDER];
+
+                cmdBuffer.CmdBindPSO(pso);
+
+                cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_COMMON, .shaderSetIdx = DESC_SET_PER_FRAME });
+                cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_VSM_RENDER, .shaderSetIdx = DESC_SET_PER_DRAW });
+
+                cmdBuffer.CmdBindIndexBuffer(s_geomIndexBuffer, 0, GetVkIndexType());
+
+                GPU_CsmPerDrawData pushConsts = {};
+                pushConsts.queue = queue;
+                pushConsts.geomType = (GPU_CsmGeomType)geomType;
+                pushConsts.staticCacheUpdateMask = s_csmStaticCacheUpdateMask;
+
+                cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, pushConsts);
+
+                cmdBuffer.CmdDrawIndexedIndirect(drawCmdBuffer, 0, drawCmdCountBuffer, 0, 
+                    CSMGetVisInstQueueCapacity((GPU_CsmGeomType)geomType), sizeof(GPU_CmdDrawIndexedIndirect));
+            cmdBuffer.CmdEndRendering();
         }
     }
 
 #ifdef ENG_BUILD_DEBUG
     SetWireframeMode(cmdBuffer, false);
 #endif
+
+    cmdBuffer
+        .BeginBarrierList()
+            .AddTextureBarrier(s_vsmPhysPool, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, 
+                VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+        .Push();
 }
 
 
@@ -7016,25 +10053,8 @@ static void RenderPass_GBuffer(vkn::CmdBuffer& cmdBuffer, GPU_GeomQueue queue)
 
     const bool isAKillPass = queue == GEOM_QUEUE_AKILL;
 
-    vkn::BarrierList& barrierList = cmdBuffer.BeginBarrierList();
- 
-    for (vkn::Texture& colorRT : s_gbufferRTs) {
-        barrierList.AddTextureBarrier(colorRT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, 
-            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
-    }
-
-    barrierList.AddTextureBarrier(s_depthRT, VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL, 
-        VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
-
     vkn::Buffer& drawCmdBuffer = s_geomDrawCmdQueueBuffer[queue];
     vkn::Buffer& drawCmdCountBuffer = s_geomBatchQueueSizeBuffer[queue];
-    vkn::Buffer& visIDBuffer = s_sortedVisGeomIDQueueBuffer[queue];
-
-    barrierList.AddBufferBarrier(drawCmdBuffer, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
-    barrierList.AddBufferBarrier(drawCmdCountBuffer, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
-    barrierList.AddBufferBarrier(visIDBuffer, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT);
-
-    barrierList.Push();    
 
     const VkExtent2D extent = VkExtent2D { s_pWnd->GetWidth(), s_pWnd->GetHeight() };
 
@@ -7077,7 +10097,14 @@ static void RenderPass_GBuffer(vkn::CmdBuffer& cmdBuffer, GPU_GeomQueue queue)
 
         cmdBuffer.CmdPushConstants(pso, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, pushConsts);
         
-        cmdBuffer.CmdDrawIndexedIndirect(drawCmdBuffer, 0, drawCmdCountBuffer, 0, s_cpuInstData.size(), sizeof(GPU_CmdDrawIndexedIndirect));
+        // Draws of both culling phases, since depth prepass already contains all visible geometry
+        for (uint32_t phase = 0; phase < GEOM_CULLING_PHASE_COUNT; ++phase) {
+            const VkDeviceSize drawCmdOffset = phase * s_cpuInstData.size() * sizeof(GPU_CmdDrawIndexedIndirect);
+            const VkDeviceSize drawCmdCountOffset = phase * sizeof(glm::uint);
+
+            cmdBuffer.CmdDrawIndexedIndirect(drawCmdBuffer, drawCmdOffset, drawCmdCountBuffer, drawCmdCountOffset, 
+                s_cpuInstData.size(), sizeof(GPU_CmdDrawIndexedIndirect));
+        }
     cmdBuffer.CmdEndRendering();
 }
 
@@ -7094,11 +10121,25 @@ void GBufferRenderPass(vkn::CmdBuffer& cmdBuffer)
     SetWireframeMode(cmdBuffer, s_geomWireframeMode);
 #endif
 
+    bool isFirstQueue = true;
+
     for (const auto& pair : GEOM_QUEUE_TO_NAME) {
         ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_%s", passName, pair.second);
         ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_%s", passName, pair.second);
 
+        if (!isFirstQueue) {
+            vkn::BarrierList& barrierList = cmdBuffer.BeginBarrierList();
+
+            for (vkn::Texture& colorRT : s_gbufferRTs) {
+                barrierList.AddTextureBarrier(colorRT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, 
+                    VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+            }
+
+            barrierList.Push();
+        }
+
         RenderPass_GBuffer(cmdBuffer, pair.first);
+        isFirstQueue = false;
     }
 
 #ifdef ENG_BUILD_DEBUG
@@ -7107,53 +10148,79 @@ void GBufferRenderPass(vkn::CmdBuffer& cmdBuffer)
 }
 
 
-void DeferredLightingPass(vkn::CmdBuffer& cmdBuffer)
+// Bins punctual lights into main camera clusters, so deferred lighting evaluates only lights which can affect pixel cluster
+static void LightCullingPass(vkn::CmdBuffer& cmdBuffer)
 {
-    static constexpr const char* passName = "Deferred_Lighting_Pass";
-    static constexpr uint32_t passColor = 0xffff00;
+    static constexpr const char* passName = "Light_Culling_Pass";
+    static constexpr uint32_t passColor = 0xffd700;
 
-    ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, passName);
+    ENG_PROFILE_SCOPED_MARKER_C(passColor, passName);
     ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
 
-    vkn::BarrierList& barrierList = cmdBuffer.BeginBarrierList();
+    vkn::PSO& pso = s_PSOs[PASS_ID_LIGHT_CULLING];
+    
+    cmdBuffer.CmdBindPSO(pso);
 
-    for (vkn::Texture& gbufferRT : s_gbufferRTs) {
-        barrierList.AddTextureBarrier(gbufferRT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 
-            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_COMMON, .shaderSetIdx = DESC_SET_PER_FRAME });
+    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_LIGHT_CULLING, .shaderSetIdx = DESC_SET_PER_DRAW });
+
+    cmdBuffer.CmdDispatch(ceil(COMMON_LIGHT_CLUSTER_COUNT / (float)LIGHT_CULLING_CS_GROUP_SIZE), 1, 1);
+}
+
+
+// Sorts screen tiles by the shadow work they need, so every class is lit by permutation without unused shadow paths.
+// Sky only tiles are skipped, since they are overwritten by skybox pass
+static void DeferredLightingClassifyPass(vkn::CmdBuffer& cmdBuffer)
+{
+    static constexpr const char* passName = "Deferred_Lighting_Classify_Pass";
+    static constexpr uint32_t passColor = 0xeeee00;
+
+    ENG_PROFILE_SCOPED_MARKER_C(passColor, passName);
+    ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
+
+    for (uint32_t tileClass = 0; tileClass < DEFERRED_LIGHTING_TILE_CLASS_COUNT; ++tileClass) {
+        cmdBuffer.CmdFillBuffer(s_deferredLightingDispatchArgsBuffer, 0, tileClass * sizeof(GPU_CmdDispatchIndirect), sizeof(glm::uint));
     }
 
-    barrierList.AddTextureBarrier(s_colorRT16F, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, 
-        VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
-    barrierList.AddTextureBarrier(s_depthRT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 
-        VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+    cmdBuffer
+        .BeginBarrierList()
+            .AddBufferBarrier(s_deferredLightingDispatchArgsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
+                VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT)
+        .Push();
 
-    barrierList.Push();
+    vkn::PSO& pso = s_PSOs[PASS_ID_DEFERRED_LIGHTING_CLASSIFY];
     
-    const VkExtent2D extent = VkExtent2D { s_colorRT16F.GetSizeX(), s_colorRT16F.GetSizeY() };
+    cmdBuffer.CmdBindPSO(pso);
 
-    vkn::RenderInfo renderInfo = {};
-    renderInfo.renderArea.extent = extent;
-    
-    vkn::RenderAttachmentInfo colorAttachment = {};
-    colorAttachment.view = &s_colorRTView16F;
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    
-    renderInfo.colorAttachments = std::span(&colorAttachment, 1);
+    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_COMMON, .shaderSetIdx = DESC_SET_PER_FRAME });
+    cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_DEFERRED_LIGHTING_CLASSIFY, .shaderSetIdx = DESC_SET_PER_DRAW });
 
-    cmdBuffer.CmdBeginRendering(renderInfo);
-        cmdBuffer.CmdSetViewport(0.f, 0.f, extent.width, extent.height);
-        cmdBuffer.CmdSetScissor(0, 0, extent.width, extent.height);
+    cmdBuffer.CmdDispatch(ceil(s_colorRT16F.GetSizeX() / (float)DEFERRED_LIGHTING_TILE_SIZE), ceil(s_colorRT16F.GetSizeY() / (float)DEFERRED_LIGHTING_TILE_SIZE), 1);
+}
+
+
+// Every tile class is lit by its own permutation with one group per tile. Group counts are written by classification
+void DeferredLightingPass(vkn::CmdBuffer& cmdBuffer)
+{
+    static constexpr const char* passName = "Deferred_Lighting_Pass";
+    static constexpr uint32_t passColor = 0xffff00;
+
+    ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, passName);
+    ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
+
+    for (uint32_t tileClass = 0; tileClass < DEFERRED_LIGHTING_TILE_CLASS_COUNT; ++tileClass) {
+        ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, "%s_%s", passName, DEFERRED_LIGHTING_TILE_CLASS_DBG_NAMES[tileClass]);
+        ENG_PROFILE_GPU_SCOPED_MARKER_C_FMT(cmdBuffer, passColor, "%s_%s", passName, DEFERRED_LIGHTING_TILE_CLASS_DBG_NAMES[tileClass]);
 
-        vkn::PSO& pso = s_PSOs[PASS_ID_DEFERRED_LIGHTING];
+        vkn::PSO& pso = s_deferredLightingPSOs[tileClass];
 
         cmdBuffer.CmdBindPSO(pso);
         
         cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_COMMON, .shaderSetIdx = DESC_SET_PER_FRAME });
         cmdBuffer.CmdBindDescriptorBufferSets(pso, { .elemIndex = DESC_SET_ID_DEFERRED_LIGHTING, .shaderSetIdx = DESC_SET_PER_DRAW });
 
-        cmdBuffer.CmdDraw(6, 1, 0, 0);
-    cmdBuffer.CmdEndRendering();
+        cmdBuffer.CmdDispatchIndirect(s_deferredLightingDispatchArgsBuffer, tileClass * sizeof(GPU_CmdDispatchIndirect));
+    }
 }
 
 
@@ -7165,14 +10232,6 @@ void SkyboxPass(vkn::CmdBuffer& cmdBuffer)
     ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, passName);
     ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
 
-    cmdBuffer
-        .BeginBarrierList()
-            .AddTextureBarrier(s_colorRT16F, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, 
-                VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
-            .AddTextureBarrier(s_depthRT, VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, 
-                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_IMAGE_ASPECT_DEPTH_BIT)
-        .Push();
-
     const VkExtent2D extent = VkExtent2D { s_pWnd->GetWidth(), s_pWnd->GetHeight() };
 
     vkn::RenderInfo renderInfo = {};
@@ -7213,14 +10272,6 @@ void PostProcessingPass(vkn::CmdBuffer& cmdBuffer)
     ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, passName);
     ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
 
-    cmdBuffer
-        .BeginBarrierList()
-            .AddTextureBarrier(s_colorRT16F, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, 
-                VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
-            .AddTextureBarrier(s_colorRT8U, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, 
-                VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
-        .Push();
-
     const VkExtent2D extent = VkExtent2D { s_pWnd->GetWidth(), s_pWnd->GetHeight() };
 
     vkn::RenderInfo renderInfo = {};
@@ -7249,19 +10300,9 @@ void PostProcessingPass(vkn::CmdBuffer& cmdBuffer)
 }
 
 
-#ifdef ENG_DEBUG_DRAW_ENABLED
-static void DbgRTViewPass(vkn::CmdBuffer& cmdBuffer)
-{
-    if (s_dbgOutputRTType == DBG_RT_VIEW_TYPE_NONE) {
-        return;
-    }
-
-    static constexpr const char* passName = "Dbg_RT_View_Render_Pass";
-    static constexpr uint32_t passColor = 0xff0000;
-
-    ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, passName);
-    ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
-
+#ifdef ENG_DEBUG_DRAW_ENABLED
+static vkn::Texture& DbgRTViewGetTexture()
+{
     vkn::Texture* pVisTex = nullptr;
 
     switch (s_dbgOutputRTType) {
@@ -7306,20 +10347,24 @@ static void DbgRTViewPass(vkn::CmdBuffer& cmdBuffer)
             break;
     }
 
-    VkImageAspectFlagBits aspect;
+    CORE_ASSERT(pVisTex != nullptr);
+    return *pVisTex;
+}
 
-    if (pVisTex == &s_depthRT || pVisTex == &s_csmRT) {
-        aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
-    } else {
-        aspect = VK_IMAGE_ASPECT_COLOR_BIT;
-    }
 
-    cmdBuffer.BeginBarrierList()
-        .AddTextureBarrier(*pVisTex, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, 
-            VK_ACCESS_2_SHADER_READ_BIT, aspect)
-        .AddTextureBarrier(s_colorRT8U, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, 
-            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
-    .Push();
+static VkImageAspectFlags DbgRTViewGetTextureAspect(const vkn::Texture& texture)
+{
+    return &texture == &s_depthRT || &texture == &s_csmRT ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+}
+
+
+static void DbgRTViewPass(vkn::CmdBuffer& cmdBuffer)
+{
+    static constexpr const char* passName = "Dbg_RT_View_Render_Pass";
+    static constexpr uint32_t passColor = 0xff0000;
+
+    ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, passName);
+    ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
 
     const VkExtent2D extent = VkExtent2D { s_pWnd->GetWidth(), s_pWnd->GetHeight() };
 
@@ -7363,58 +10408,36 @@ static void DbgDrawPass(vkn::CmdBuffer& cmdBuffer)
     const uint32_t lineInstCount = s_dbgLineDataCPU.size();
     const uint32_t triInstCount = s_dbgTriangleDataCPU.size();
 
-    if (lineInstCount == 0 && triInstCount == 0) {
-        return;
-    }
-
     static constexpr const char* passName = "Dbg_Draw_Render_Pass";
     static constexpr uint32_t passColor = 0xff0000;
 
     ENG_PROFILE_SCOPED_MARKER_C_FMT(passColor, passName);
     ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, passColor, passName);
 
+    vkn::Buffer& dbgLineDataGPU = s_dbgLineDataGPU[s_frameInFlightIdx];
+    vkn::Buffer& dbgLineVertexDataGPU = s_dbgLineVertexDataGPU[s_frameInFlightIdx];
+    vkn::Buffer& dbgTriangleDataGPU = s_dbgTriangleDataGPU[s_frameInFlightIdx];
+    vkn::Buffer& dbgTriangleVertexDataGPU = s_dbgTriangleVertexDataGPU[s_frameInFlightIdx];
+
     if (lineInstCount > 0) {
-        void* pLineData = s_dbgLineDataGPU.Map();
+        void* pLineData = dbgLineDataGPU.Map();
         memcpy(pLineData, s_dbgLineDataCPU.data(), lineInstCount * sizeof(GPU_DbgLineData));
-        s_dbgLineDataGPU.Unmap();
+        dbgLineDataGPU.Unmap();
 
-        void* pLineVertData = s_dbgLineVertexDataGPU.Map();
+        void* pLineVertData = dbgLineVertexDataGPU.Map();
         memcpy(pLineVertData, s_dbgLineVertexDataCPU.data(), s_dbgLineVertexDataCPU.size() * sizeof(s_dbgLineVertexDataCPU[0]));
-        s_dbgLineVertexDataGPU.Unmap();
+        dbgLineVertexDataGPU.Unmap();
     }
 
     if (triInstCount > 0) {
-        void* pTriData = s_dbgTriangleDataGPU.Map();
+        void* pTriData = dbgTriangleDataGPU.Map();
         memcpy(pTriData, s_dbgTriangleDataCPU.data(), triInstCount * sizeof(GPU_DbgTriangleData));
-        s_dbgTriangleDataGPU.Unmap();
+        dbgTriangleDataGPU.Unmap();
 
-        void* pTriVertData = s_dbgTriangleVertexDataGPU.Map();
+        void* pTriVertData = dbgTriangleVertexDataGPU.Map();
         memcpy(pTriVertData, s_dbgTriangleVertexDataCPU.data(), s_dbgTriangleVertexDataCPU.size() * sizeof(s_dbgTriangleVertexDataCPU[0]));
-        s_dbgTriangleVertexDataGPU.Unmap();
-    }
-
-    vkn::BarrierList& barriers = cmdBuffer.BeginBarrierList();
-
-    barriers.AddTextureBarrier(s_colorRT8U, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, 
-        VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
-    barriers.AddTextureBarrier(s_depthRT, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, 
-        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);  
-
-    if (lineInstCount > 0) {
-        barriers.AddBufferBarrier(s_dbgLineDataGPU, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
-            VK_ACCESS_2_SHADER_READ_BIT);
-        barriers.AddBufferBarrier(s_dbgLineVertexDataGPU, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, 
-            VK_ACCESS_2_SHADER_READ_BIT);
-    }
-    
-    if (triInstCount > 0) {
-        barriers.AddBufferBarrier(s_dbgTriangleDataGPU, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
-            VK_ACCESS_2_SHADER_READ_BIT);
-        barriers.AddBufferBarrier(s_dbgTriangleVertexDataGPU, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, 
-            VK_ACCESS_2_SHADER_READ_BIT);
+        dbgTriangleVertexDataGPU.Unmap();
     }
-        
-    barriers.Push();
 
     const VkExtent2D extent = VkExtent2D { s_pWnd->GetWidth(), s_pWnd->GetHeight() };
 
@@ -7475,6 +10498,18 @@ namespace DbgUI
         static constexpr ImVec4 IMGUI_GREEN_COLOR(0.f, 1.f, 0.f, 1.f);
 
         if (ImGui::Begin("Debug")) {
+            if (ImGui::CollapsingHeader("Frame Pacing")) {
+                ImGui::Text("Frames In Flight: %u", FRAMES_IN_FLIGHT_COUNT);
+                ImGui::Text("CPU Frame Time: %.3f ms", s_frameTime);
+                ImGui::Text("CPU Wait For GPU: %.3f ms", s_frameFenceWaitTime);
+                if (ImGui::IsItemHovered()) {
+                    if (ImGui::BeginTooltip()) {
+                        ImGui::Text("Time spent on waiting for frame in flight fence. Non zero value means that app is GPU bound");
+                    } ImGui::EndTooltip();
+                }
+                ImGui::NewLine();
+            }
+
             if (ImGui::CollapsingHeader("Camera", ImGuiTreeNodeFlags_DefaultOpen)) {
                 ImGui::Text("Fly Camera Mode (F5):");
                 ImGui::SameLine(); 
@@ -7558,10 +10593,65 @@ namespace DbgUI
                 
                 ImGui::NewLine();
 
-                ImGui::BulletText("Debug Lines Data Size: %.3f KB", (s_dbgLineDataGPU.GetMemorySize() + s_dbgLineVertexDataGPU.GetMemorySize()) / 1024.f);
-                ImGui::BulletText("Debug Triangles Data Size: %.3f KB", (s_dbgTriangleDataGPU.GetMemorySize() + s_dbgTriangleVertexDataGPU.GetMemorySize()) / 1024.f);
+                ImGui::BulletText("Debug Lines Data Size: %.3f KB", FRAMES_IN_FLIGHT_COUNT * (s_dbgLineDataGPU[0].GetMemorySize() + s_dbgLineVertexDataGPU[0].GetMemorySize()) / 1024.f);
+                ImGui::BulletText("Debug Triangles Data Size: %.3f KB", FRAMES_IN_FLIGHT_COUNT * (s_dbgTriangleDataGPU[0].GetMemorySize() + s_dbgTriangleVertexDataGPU[0].GetMemorySize()) / 1024.f);
+                
+                ImGui::NewLine();
+
+                ImGui::BulletText("Transient RTs Size: %.3f MB (%.3f MB without aliasing)", s_transientRTAllocator.GetMemorySize() / 1024.f / 1024.f,
+                    s_transientRTAllocator.GetUnaliasedMemorySize() / 1024.f / 1024.f);
             }
-            
+
+            if (ImGui::CollapsingHeader("Render Graph")) {
+                const eng::RenderGraph::Stats& stats = s_renderGraph.GetStats();
+
+                ImGui::Text("Passes: %u (culled: %u)", stats.passCount, stats.culledPassCount);
+                ImGui::Text("Batches: %u", stats.batchCount);
+                ImGui::Text("Batch Barrier Lists: %u", stats.batchBarrierListCount);
+                ImGui::Text("Barriers: %u declared, %u pushed", stats.declaredBarrierCount, stats.pushedBarrierCount);
+                if (ImGui::IsItemHovered()) {
+                    if (ImGui::BeginTooltip()) {
+                        ImGui::Text("Accesses of the same subresource in one batch are merged into single barrier");
+                    } ImGui::EndTooltip();
+                }
+                ImGui::Text("Secondary Cmd Buffers: %u", stats.secondaryCmdBufferCount);
+
+                ImGui::Text("Cmd Buffer Barrier Calls: %u", s_renderBarrierStats.barrierCallCount);
+                ImGui::Text("Cmd Buffer Barriers: %u emitted, %u elided, %u merged, %u collapsed", s_renderBarrierStats.emittedBarrierCount,
+                    s_renderBarrierStats.elidedBarrierCount, s_renderBarrierStats.mergedBarrierCount, s_renderBarrierStats.collapsedBarrierCount);
+                if (ImGui::IsItemHovered()) {
+                    if (ImGui::BeginTooltip()) {
+                        ImGui::Text("Stats of the previous frame. Barriers pushed without commands in between are recorded with single call");
+                    } ImGui::EndTooltip();
+                }
+
+                ImGui::NewLine();
+
+                const std::vector<eng::RenderGraph::PassInfo>& passInfos = s_renderGraph.GetPassInfos();
+
+                for (size_t i = 0; i < passInfos.size(); ++i) {
+                    const eng::RenderGraph::PassInfo& info = passInfos[i];
+
+                    ImGui::PushID(static_cast<int>(i));
+
+                    if (info.isCulled) {
+                        ImGui::TextColored(IMGUI_RED_COLOR, "%s: culled", info.name.c_str());
+                    } else {
+                        ImGui::Text("%s: batch %u%s", info.name.c_str(), info.batchIdx, info.hasSideEffect ? ", side effect" : "");
+                    }
+
+                    if (!info.dependencies.empty() && ImGui::TreeNode("Dependencies")) {
+                        for (uint32_t depIdx : info.dependencies) {
+                            ImGui::BulletText("%s", passInfos[depIdx].name.c_str());
+                        }
+
+                        ImGui::TreePop();
+                    }
+
+                    ImGui::PopID();
+                }
+            }
+
         #ifdef ENG_BUILD_DEBUG            
             if (ImGui::CollapsingHeader("Geom")) {
                 ImGui::Checkbox("Wireframe mode", &s_geomWireframeMode);
@@ -7575,6 +10665,22 @@ namespace DbgUI
                         } ImGui::EndTooltip();
                     }
 
+                    ImGui::DragFloat("Pixel Threshold", &s_geomLodPixelThreshold, 0.01f, 0.01f, 64.f, "%.2f px");
+
+                    if (ImGui::IsItemHovered()) {
+                        if (ImGui::BeginTooltip()) {
+                            ImGui::Text("The coarsest LOD which simplification error is projected to less pixels than threshold is selected");
+                        } ImGui::EndTooltip();
+                    }
+
+                    for (uint32_t i = 0; i < COMMON_CSM_CASCADE_COUNT; ++i) {
+                        ImGui::PushID(i);
+                        ImGui::Text("CSM Cascade %u", i);
+                        ImGui::SameLine();
+                        ImGui::DragFloat("Pixel Threshold", &s_csmGeomLodPixelThresholds[i], 0.01f, 0.01f, 64.f, "%.2f texels");
+                        ImGui::PopID();
+                    }
+
                     ImGui::TreePop();
                 }
 
@@ -7617,6 +10723,21 @@ namespace DbgUI
                         ImGui::TextColored(s_isCSMEnabled ? IMGUI_GREEN_COLOR : IMGUI_RED_COLOR, "Enabled");
 
                         ImGui::Checkbox("Visualize Cascades", &s_isCSMVisualizationEnabled);
+                        ImGui::Checkbox("Static Cache", &s_isCSMStaticCacheEnabled);
+
+                        if (ImGui::IsItemHovered()) {
+                            if (ImGui::BeginTooltip()) {
+                                ImGui::Text("Static geometry is redrawn only into cascades which transform or LOD settings were changed");
+                            } ImGui::EndTooltip();
+                        }
+
+                        ImGui::Checkbox("Virtual Shadow Maps", &s_isVSMEnabled);
+
+                        if (ImGui::IsItemHovered()) {
+                            if (ImGui::BeginTooltip()) {
+                                ImGui::Text("Cascades are replaced by paged virtual levels. Only pages requested by visible pixels are allocated and rendered");
+                            } ImGui::EndTooltip();
+                        }
 
                         if (ImGui::TreeNodeEx("PCSS")) {
                             ImGui::Checkbox("##CSMPCSSEnabled", &s_isCSMPCSSEnabled);
@@ -7933,12 +11054,6 @@ static void DbgUIPass(vkn::CmdBuffer& cmdBuffer)
 
     DbgUI::FillData();
 
-    cmdBuffer
-        .BeginBarrierList()
-            .AddTextureBarrier(s_colorRT8U, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, 
-                VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
-        .Push();
-
     vkn::RenderInfo renderInfo = {};
     renderInfo.renderArea.extent = VkExtent2D { s_pWnd->GetWidth(), s_pWnd->GetHeight() };
     
@@ -7954,7 +11069,7 @@ static void DbgUIPass(vkn::CmdBuffer& cmdBuffer)
     cmdBuffer.CmdEndRendering();
 
     // ImGui uses descriptor sets so we need to rebind descriptor buffer
-    cmdBuffer.CmdBindDescriptorBuffer(s_descriptorBuffer);
+    cmdBuffer.CmdBindDescriptorBuffer(s_descriptorBuffers[s_frameInFlightIdx]);
 }
 #endif
 
@@ -7970,14 +11085,6 @@ void ResolveToBackbufferPass(vkn::CmdBuffer& cmdBuffer)
     vkn::SCTexture& scTexture = s_vkSwapchain.GetTexture(s_nextImageIdx);
     vkn::SCTextureView& scTextureView = s_vkSwapchain.GetTextureView(s_nextImageIdx);
 
-    cmdBuffer
-        .BeginBarrierList()
-            .AddTextureBarrier(s_colorRT8U, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 
-                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
-            .AddTextureBarrier(scTexture, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, 
-                VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
-        .Push();
-
     const VkExtent2D extent = VkExtent2D { s_pWnd->GetWidth(), s_pWnd->GetHeight() };
 
     vkn::RenderInfo renderInfo = {};
@@ -8012,18 +11119,351 @@ void ResolveToBackbufferPass(vkn::CmdBuffer& cmdBuffer)
 }
 
 
-static void RenderScene()
+static void WaitForFrameInFlight(uint32_t frameIdx)
+{
+    const uint64_t renderFinishedValue = s_renderFinishedValues[frameIdx];
+
+    if (s_mainQueueProgress.IsCompleted(renderFinishedValue)) {
+        s_frameFenceWaitTime = 0.f;
+        return;
+    }
+
+    ENG_PROFILE_SCOPED_MARKER_C(0xcd2990, "Wait_For_Frame_In_Flight");
+
+    eng::Timer timer;
+    s_mainQueueProgress.WaitFor(renderFinishedValue, 10'000'000'000);
+    timer.End().GetDuration<float, std::milli>(s_frameFenceWaitTime);
+}
+
+
+// Geometry culling writes queues consumed by depth and GBuffer passes. Instance visibility is kept for the next frame early phase
+static void DeclareGeomCullingPass(eng::RenderGraph& graph, GPU_GeomCullingPhase phase)
+{
+    eng::RenderGraph::PassBuilder pass = graph.AddPass(phase == GEOM_CULLING_PHASE_EARLY ? "Geom_Culling_Pass_Early" : "Geom_Culling_Pass_Late",
+        [phase](vkn::CmdBuffer& cmdBuffer) { GeomCullingPass(cmdBuffer, phase); });
+
+    pass.SetSideEffect()
+        .TrackTextureRead(s_HZB)
+        .TrackBufferWrite(s_geomCullInstVisibilityBuffer)
+        .TrackBufferWrite(s_geomCullVisSortKeysBuffer)
+        .TrackBufferWrite(s_geomCullVisSortKeysCounterBuffer)
+        .TrackBufferWrite(s_geomCullVisGeomIDsBuffer)
+        .TrackBufferWrite(s_geomCullPerGeomMatTypeCountersBuffer)
+        .TrackBufferWrite(s_geomRadixSortTmpKeysBuffer)
+        .TrackBufferWrite(s_geomRadixSortTmpGeomIDsBuffer)
+        .TrackBufferWrite(s_radixSortHistogramsBuffer)
+        .TrackBufferWrite(s_radixSortDispatchArgsBuffer);
+
+    for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
+        pass.TrackBufferWrite(s_geomBatchQueueBuffer[queue])
+            .TrackBufferWrite(s_geomBatchQueueSizeBuffer[queue])
+            .TrackBufferWrite(s_sortedVisGeomIDQueueBuffer[queue])
+            .TrackBufferWrite(s_sortedVisGeomIDQueueSizeBuffer[queue])
+            .TrackBufferWrite(s_geomDrawCmdQueueBuffer[queue]);
+    }
+}
+
+
+static void DeclareGeomDepthPass(eng::RenderGraph& graph, GPU_GeomCullingPhase phase)
+{
+    eng::RenderGraph::PassBuilder pass = graph.AddPass(phase == GEOM_CULLING_PHASE_EARLY ? "Geom_Depth_Pass_Early" : "Geom_Depth_Pass_Late",
+        [phase](vkn::CmdBuffer& cmdBuffer) { GeomDepthPass(cmdBuffer, phase); });
+
+    pass.WriteTexture(s_depthRT, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, 
+        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+    for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
+        pass.ReadBuffer(s_geomDrawCmdQueueBuffer[queue], VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
+            .ReadBuffer(s_geomBatchQueueSizeBuffer[queue], VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
+            .ReadBuffer(s_sortedVisGeomIDQueueBuffer[queue], VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT);
+    }
+}
+
+
+static void DeclareCSMGeometryCullingPass(eng::RenderGraph& graph, bool isVSMEnabled)
+{
+    eng::RenderGraph::PassBuilder pass = graph.AddPass("CSM_Culling_Pass", CSMGeometryCullingPass);
+
+    if (isVSMEnabled) {
+        pass.TrackBufferRead(s_vsmDirtyPageRectsBuffer);
+    }
+
+    pass.TrackBufferWrite(s_geomBatchBinCountersBuffer)
+        .TrackBufferWrite(s_geomBatchBinOffsetsBuffer)
+        .TrackBufferWrite(s_geomBatchInstBinsBuffer);
+
+    for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
+        for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
+            pass.TrackBufferWrite(s_csmVisGeomIDQueueBuffers[geomType][queue])
+                .TrackBufferWrite(s_csmVisGeomIDQueueSizeBuffers[geomType][queue])
+                .TrackBufferWrite(s_csmGeomBatchQueueBuffers[geomType][queue])
+                .TrackBufferWrite(s_csmGeomBatchQueueSizeBuffers[geomType][queue])
+                .TrackBufferWrite(s_csmSortedVisGeomIDQueueBuffers[geomType][queue])
+                .TrackBufferWrite(s_csmSortedVisGeomIDQueueSizeBuffers[geomType][queue])
+                .TrackBufferWrite(s_csmGeomDrawCmdQueueBuffers[geomType][queue]);
+        }
+    }
+}
+
+
+static void DeclareShadowPasses(eng::RenderGraph& graph, bool isVSMEnabled)
+{
+    if (isVSMEnabled) {
+        // Page table and physical pool keep pages rendered in previous frames
+        graph.AddPass("VSM_Pages_Pass", VSMPagesPass)
+            .SetSideEffect()
+            .ReadTexture(s_depthRT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
+                VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_ASPECT_DEPTH_BIT)
+            .WriteTexture(s_vsmPhysPool, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
+                VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+            .TrackBufferWrite(s_vsmPageTableBuffer)
+            .TrackBufferWrite(s_vsmPhysPageLastUsedFrameBuffer)
+            .TrackBufferWrite(s_vsmFreeListBuffer)
+            .TrackBufferWrite(s_vsmFreeListCounterBuffer)
+            .TrackBufferWrite(s_vsmDirtyListBuffer)
+            .TrackBufferWrite(s_vsmClearDispatchArgsBuffer)
+            .TrackBufferWrite(s_vsmDirtyPageRectsBuffer);
+
+        DeclareCSMGeometryCullingPass(graph, isVSMEnabled);
+
+        eng::RenderGraph::PassBuilder renderPass = graph.AddPass("VSM_Render_Pass", VSMRenderPass);
+
+        renderPass.SetSideEffect()
+            .WriteTexture(s_vsmPhysPool, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, 
+                VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+            .TrackBufferRead(s_vsmPageTableBuffer);
+
+        for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
+            for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
+                renderPass
+                    .ReadBuffer(s_csmGeomDrawCmdQueueBuffers[geomType][queue], VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
+                    .ReadBuffer(s_csmGeomBatchQueueSizeBuffers[geomType][queue], VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
+                    .ReadBuffer(s_csmSortedVisGeomIDQueueBuffers[geomType][queue], VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT);
+            }
+        }
+    } else if (s_isCSMEnabled) {
+        // Static cache layers are reused by the next frames
+        eng::RenderGraph::PassBuilder renderPass = graph.AddPass("CSM_Render_Pass", CSMRenderPass);
+
+        renderPass.SetSideEffect()
+            .TrackTextureWrite(s_csmRT)
+            .TrackTextureWrite(s_csmStaticCacheRT);
+
+        for (uint32_t geomType = 0; geomType < CSM_GEOM_TYPE_COUNT; ++geomType) {
+            for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
+                renderPass.TrackBufferRead(s_csmGeomDrawCmdQueueBuffers[geomType][queue])
+                    .TrackBufferRead(s_csmGeomBatchQueueSizeBuffers[geomType][queue])
+                    .TrackBufferRead(s_csmSortedVisGeomIDQueueBuffers[geomType][queue]);
+            }
+        }
+    }
+}
+
+
+static void DeclareLightingPasses(eng::RenderGraph& graph, bool isVSMEnabled)
+{
+    // GBuffer and light culling passes are independent, so they share a batch and are recorded into secondaries in parallel.
+    // GBuffer queues aren't split into separate passes, since they write the same attachments and would end up in dependent batches.
+    // The same applies to CSM cascades, which are rendered with one layered pass
+    eng::RenderGraph::PassBuilder gbufferPass = graph.AddPass("GBuffer_Pass", GBufferRenderPass);
+    gbufferPass.SetParallelRecording();
+
+    // The first queue clears attachments
+    for (vkn::Texture& colorRT : s_gbufferRTs) {
+        gbufferPass.OverwriteTexture(colorRT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, 
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+
+    gbufferPass.ReadTexture(s_depthRT, VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, 
+        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+    for (uint32_t queue = 0; queue < GEOM_QUEUE_COUNT; ++queue) {
+        gbufferPass.ReadBuffer(s_geomDrawCmdQueueBuffer[queue], VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
+            .ReadBuffer(s_geomBatchQueueSizeBuffer[queue], VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT)
+            .ReadBuffer(s_sortedVisGeomIDQueueBuffer[queue], VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT);
+    }
+
+    graph.AddPass("Light_Culling_Pass", LightCullingPass)
+        .SetParallelRecording()
+        .WriteBuffer(s_lightClusterLightCountsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT)
+        .WriteBuffer(s_lightClusterLightIndicesBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+    eng::RenderGraph::PassBuilder classifyPass = graph.AddPass("Deferred_Lighting_Classify_Pass", DeferredLightingClassifyPass);
+
+    classifyPass
+        .WriteBuffer(s_deferredLightingDispatchArgsBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT)
+        .WriteBuffer(s_deferredLightingTileListBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT)
+        .ReadTexture(s_gbufferRTs[1], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
+            VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+        .ReadTexture(s_depthRT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
+            VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+    // CSM is sampled to find tiles which need PCSS penumbra search
+    if (!isVSMEnabled && s_isCSMEnabled) {
+        classifyPass.TrackTextureRead(s_csmRT);
+    }
+
+    eng::RenderGraph::PassBuilder lightingPass = graph.AddPass("Deferred_Lighting_Pass", DeferredLightingPass);
+
+    for (vkn::Texture& gbufferRT : s_gbufferRTs) {
+        lightingPass.ReadTexture(gbufferRT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
+            VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+
+    lightingPass
+        .WriteTexture(s_colorRT16F, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
+            VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+        .ReadTexture(s_depthRT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
+            VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_ASPECT_DEPTH_BIT)
+        .ReadBuffer(s_lightClusterLightCountsBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT)
+        .ReadBuffer(s_lightClusterLightIndicesBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT)
+        .ReadBuffer(s_deferredLightingTileListBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT)
+        .ReadBuffer(s_deferredLightingDispatchArgsBuffer, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
+
+    // Shadow maps are left in sampled state by their passes
+    if (isVSMEnabled) {
+        lightingPass.TrackTextureRead(s_vsmPhysPool).TrackBufferRead(s_vsmPageTableBuffer);
+    } else if (s_isCSMEnabled) {
+        lightingPass.TrackTextureRead(s_csmRT);
+    }
+
+    graph.AddPass("Skybox_Pass", SkyboxPass)
+        .WriteTexture(s_colorRT16F, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, 
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+        .ReadTexture(s_depthRT, VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, 
+            VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+    graph.AddPass("Post_Processing_Pass", PostProcessingPass)
+        .ReadTexture(s_colorRT16F, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, 
+            VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+        .OverwriteTexture(s_colorRT8U, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, 
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+}
+
+
+#ifdef ENG_DEBUG_DRAW_ENABLED
+static void DeclareDbgDrawPasses(eng::RenderGraph& graph)
 {
-    if (s_renderFinishedFence.GetStatus() == VK_NOT_READY) {
+    // RT view covers the whole color target, so passes which results are only visible in it are culled
+    if (s_dbgOutputRTType != DBG_RT_VIEW_TYPE_NONE) {
+        vkn::Texture& visTex = DbgRTViewGetTexture();
+
+        graph.AddPass("Dbg_RT_View_Render_Pass", DbgRTViewPass)
+            .ReadTexture(visTex, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, 
+                VK_ACCESS_2_SHADER_READ_BIT, DbgRTViewGetTextureAspect(visTex))
+            .OverwriteTexture(s_colorRT8U, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, 
+                VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+
+    const bool hasLines = !s_dbgLineDataCPU.empty();
+    const bool hasTriangles = !s_dbgTriangleDataCPU.empty();
+
+    if (!hasLines && !hasTriangles) {
         return;
     }
 
+    eng::RenderGraph::PassBuilder pass = graph.AddPass("Dbg_Draw_Render_Pass", DbgDrawPass);
+
+    pass.WriteTexture(s_colorRT8U, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, 
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+        .WriteTexture(s_depthRT, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, 
+            VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+    if (hasLines) {
+        pass.ReadBuffer(s_dbgLineDataGPU[s_frameInFlightIdx], VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                VK_ACCESS_2_SHADER_READ_BIT)
+            .ReadBuffer(s_dbgLineVertexDataGPU[s_frameInFlightIdx], VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT);
+    }
+
+    if (hasTriangles) {
+        pass.ReadBuffer(s_dbgTriangleDataGPU[s_frameInFlightIdx], VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                VK_ACCESS_2_SHADER_READ_BIT)
+            .ReadBuffer(s_dbgTriangleVertexDataGPU[s_frameInFlightIdx], VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT);
+    }
+}
+#endif
+
+
+// Passes are declared in execution order. Graph only merges their entry barriers and culls the ones which results aren't used
+static void SetupRenderGraph(eng::RenderGraph& graph)
+{
+    // Secondary command buffers don't inherit descriptor buffer binding of the primary one
+    graph.Reset()
+        .SetTransientAllocator(&s_transientRTAllocator)
+        .SetSecondaryCmdBufferAllocator(&s_secondaryCmdBufferAllocators[s_frameInFlightIdx], [](vkn::CmdBuffer& cmdBuffer) {
+            cmdBuffer.CmdBindDescriptorBuffer(s_descriptorBuffers[s_frameInFlightIdx]);
+        });
+
+    const bool isVSMEnabled = s_isCSMEnabled && s_isVSMEnabled;
+
+    DeclareGeomCullingPass(graph, GEOM_CULLING_PHASE_EARLY);
+
+    // VSM culls shadow casters against pages requested by the final depth, so its culling is done after depth pass
+    if (s_isCSMEnabled && !isVSMEnabled) {
+        DeclareCSMGeometryCullingPass(graph, isVSMEnabled);
+    }
+
+    DeclareGeomDepthPass(graph, GEOM_CULLING_PHASE_EARLY);
+
+    // HZB of the current frame is built from occluders visible in the previous one and used to cull the rest.
+    // It's also kept for the next frame early phase
+    if (!s_cullingTestMode) {
+        graph.AddPass("HZB_Generation_Pass", HZBGeneratePass)
+            .SetSideEffect()
+            .ReadTexture(s_depthRT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
+                VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_ASPECT_DEPTH_BIT)
+            .OverwriteTexture(s_HZB, VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 
+                VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+            .TrackBufferWrite(s_hzbSpdCounterBuffer);
+    }
+
+    DeclareGeomCullingPass(graph, GEOM_CULLING_PHASE_LATE);
+    DeclareGeomDepthPass(graph, GEOM_CULLING_PHASE_LATE);
+
+    DeclareShadowPasses(graph, isVSMEnabled);
+
+    s_vsmWasEnabled = isVSMEnabled;
+
+    DeclareLightingPasses(graph, isVSMEnabled);
+
+#ifdef ENG_DEBUG_DRAW_ENABLED
+    DeclareDbgDrawPasses(graph);
+#endif
+
+#ifdef ENG_DEBUG_UI_ENABLED
+    // Debug UI is built inside the pass, so it runs every frame
+    graph.AddPass("Dbg_UI_Render_Pass", DbgUIPass)
+        .SetSideEffect()
+        .WriteTexture(s_colorRT8U, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, 
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+#endif
+
+    graph.AddPass("Resolve_To_Backbuffer_Pass", ResolveToBackbufferPass)
+        .SetSideEffect()
+        .ReadTexture(s_colorRT8U, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, 
+            VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_ASPECT_COLOR_BIT)
+        .WriteTexture(s_vkSwapchain.GetTexture(s_nextImageIdx), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, 
+            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+
+    graph.Compile();
+}
+
+
+static void RenderScene()
+{
     ENG_PROFILE_SCOPED_MARKER_C(0x696969, "Render_Scene");
 
+    // Blocks only if GPU is still processing the frame which used this frame in flight resources last time
+    WaitForFrameInFlight(s_frameInFlightIdx);
+
+    s_secondaryCmdBufferAllocators[s_frameInFlightIdx].Reset();
+
     UpdateGPUCommonConstBuffer();
     UpdateGPUDbgConstBuffer();
 
-    const VkResult acquireResult = vkAcquireNextImageKHR(s_vkDevice.Get(), s_vkSwapchain.Get(), 10'000'000'000, s_presentFinishedSemaphore.Get(), VK_NULL_HANDLE, &s_nextImageIdx);
+    vkn::Semaphore& presentFinishedSemaphore = s_presentFinishedSemaphores[s_frameInFlightIdx];
+
+    const VkResult acquireResult = vkAcquireNextImageKHR(s_vkDevice.Get(), s_vkSwapchain.Get(), 10'000'000'000, presentFinishedSemaphore.Get(), VK_NULL_HANDLE, &s_nextImageIdx);
     
     if (acquireResult != VK_SUBOPTIMAL_KHR && acquireResult != VK_ERROR_OUT_OF_DATE_KHR) {
         VK_CHECK(acquireResult);
@@ -8033,7 +11473,18 @@ static void RenderScene()
     }
 
     vkn::Semaphore& renderingFinishedSemaphore = s_renderFinishedSemaphores[s_nextImageIdx];
-    vkn::CmdBuffer& cmdBuffer = *s_pRenderCmdBuffer;
+    vkn::CmdBuffer& cmdBuffer = *s_pRenderCmdBuffers[s_frameInFlightIdx];
+
+    SetupRenderGraph(s_renderGraph);
+
+    // Transient RT lifetimes depend on enabled passes. Graph keeps pointers to RTs, so it's still valid after their recreation
+    if (s_transientRTAllocator.Update(s_renderGraph)) {
+        s_vkDevice.WaitIdle();
+
+        DestroyTransientRTs();
+        CreateTransientRTs();
+        WriteDescriptorSets();
+    }
 
     cmdBuffer.Reset();
 
@@ -8041,51 +11492,29 @@ static void RenderScene()
     {
         ENG_PROFILE_GPU_SCOPED_MARKER_C(cmdBuffer, 0x1a1a1a, "Render_Scene_GPU");
 
-        cmdBuffer.CmdBindDescriptorBuffer(s_descriptorBuffer);
-
-        HZBGeneratePass(cmdBuffer);
-        GeomCullingPass(cmdBuffer);
-
-        if (s_isCSMEnabled) {
-            CSMGeometryCullingPass(cmdBuffer);
-        }
-
-        GeomDepthPass(cmdBuffer);
-
-        if (s_isCSMEnabled) {
-            CSMRenderPass(cmdBuffer);
-        }
-
-        GBufferRenderPass(cmdBuffer);
-        DeferredLightingPass(cmdBuffer);
-
-        SkyboxPass(cmdBuffer);
-
-        PostProcessingPass(cmdBuffer);
-
-    #ifdef ENG_DEBUG_DRAW_ENABLED
-        DbgRTViewPass(cmdBuffer);
-        DbgDrawPass(cmdBuffer);
-    #endif
-
-    #ifdef ENG_DEBUG_UI_ENABLED
-        DbgUIPass(cmdBuffer);
-    #endif
+        cmdBuffer.CmdBindDescriptorBuffer(s_descriptorBuffers[s_frameInFlightIdx]);
 
-        ResolveToBackbufferPass(cmdBuffer);
+        s_renderGraph.Execute(cmdBuffer);
 
         ENG_PROFILE_GPU_COLLECT_STATS(cmdBuffer);
     }
     cmdBuffer.End();
 
-    s_renderFinishedFence.Reset();
+    s_renderBarrierStats = cmdBuffer.GetBarrierStats();
 
-    vkn::QueueSyncData waitData = { &s_presentFinishedSemaphore, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT };
+    vkn::QueueSyncData waitData = { &presentFinishedSemaphore, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT };
     vkn::QueueSyncData signalData = { &renderingFinishedSemaphore, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT };
 
-    s_vkDevice.GetQueue().Submit(cmdBuffer, &s_renderFinishedFence, &waitData, &signalData);
+    const uint64_t renderFinishedValue = s_mainQueueProgress.AcquireSignalValue();
+    vkn::QueueTimelineSyncData renderFinishedData = { &s_mainQueueProgress.GetSemaphore(), renderFinishedValue, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT };
+
+    s_vkDevice.GetQueue().Submit(cmdBuffer, renderFinishedData, &waitData, &signalData);
+
+    s_renderFinishedValues[s_frameInFlightIdx] = renderFinishedValue;
 
     PresentImage(s_nextImageIdx);
+
+    s_frameInFlightIdx = (s_frameInFlightIdx + 1) % FRAMES_IN_FLIGHT_COUNT;
 }
 
 
@@ -8199,6 +11628,8 @@ void AppProcessWndEvent(const eng::WndEvent& event)
             if (s_cullingTestMode) {
                 s_fixedCullCamera = s_mainCamera;
             }
+
+            s_geomCullInstVisibilityResetRequired = true;
         } else if (keyEvent.key == eng::WndKey::KEY_F7 && keyEvent.IsPressed()) {
             s_csmTestMode = !s_csmTestMode;
 
@@ -8231,7 +11662,7 @@ void ProcessFrame()
     static eng::Timer timer;
     timer.End().GetDuration<float, std::milli>(s_frameTime).Reset();
 
-    s_pWnd->SetTitle("%s | Build Type: %s | CPU: %.3f ms (%.1f FPS)", APP_NAME, APP_BUILD_TYPE_STR, s_frameTime, 1000.f / s_frameTime);
+    s_pWnd->SetTitle("%s | Build Type: %s | CPU: %.3f ms (%.1f FPS) | GPU Wait: %.3f ms", APP_NAME, APP_BUILD_TYPE_STR, s_frameTime, 1000.f / s_frameTime, s_frameFenceWaitTime);
 
     s_mainCamera.PushPrevState();
 
@@ -8262,11 +11693,7 @@ int main(int argc, char* argv[])
 {
     InitWindow();
 
-    // LoadScene(argc > 1 ? argv[1] : "../assets/Sponza/Sponza.gltf");
-    // LoadScene(argc > 1 ? argv[1] : "../assets/LightSponza/Sponza.gltf");
-    // LoadScene(argc > 1 ? argv[1] : "../assets/TestPBR/TestPBR.gltf");
-    LoadScene(argc > 1 ? argv[1] : "../assets/GPUOcclusionTest/Occlusion.gltf");
-    // LoadScene(argc > 1 ? argv[1] : "../assets/ShadowTest/ShadowTest.gltf");
+    eng::GetThreadPool().Create();
 
     CreateVkInstance();    
     CreateVkSurface();    
@@ -8284,7 +11711,14 @@ int main(int argc, char* argv[])
 
     CreateImmediateSubmitObjects();
 
-    CreateCommonStagingBuffer();
+    CreateUploadManager();
+
+    // Scene textures are uploaded while they are decoded, so device and upload manager must be created before
+    // LoadScene(argc > 1 ? argv[1] : "../assets/Sponza/Sponza.gltf");
+    // LoadScene(argc > 1 ? argv[1] : "../assets/LightSponza/Sponza.gltf");
+    // LoadScene(argc > 1 ? argv[1] : "../assets/TestPBR/TestPBR.gltf");
+    LoadScene(argc > 1 ? argv[1] : "../assets/GPUOcclusionTest/Occlusion.gltf");
+    // LoadScene(argc > 1 ? argv[1] : "../assets/ShadowTest/ShadowTest.gltf");
 
     CreateDynamicRenderTargets();
 
@@ -8294,10 +11728,17 @@ int main(int argc, char* argv[])
     CreateCommonDbgConstBuffer();
     CreateGeomCullingAndInstancingResources();
     CreateCSMResources();
+    CreateVSMResources();
+    CreateLightCullingResources();
     CreateDbgDrawResources();
     CreateDescriptorSets();
+    CreatePSOCache();
     CreatePipelines();
 
+#ifdef ENG_SHADER_HOT_RELOAD_ENABLED
+    CreateShaderFileWatcher();
+#endif
+
     std::array skyBoxFaceFilepaths = {
         fs::path("../assets/TestPBR/textures/skybox/1024/px.hdr"),
         fs::path("../assets/TestPBR/textures/skybox/1024/nx.hdr"),
@@ -8312,8 +11753,12 @@ int main(int argc, char* argv[])
 
     CreateSyncObjects();
     
-    s_pRenderCmdBuffer = s_commonCmdPool.AllocCmdBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
-    s_vkDevice.SetObjDebugName(*s_pRenderCmdBuffer, "RND_CMD_BUFFER");
+    for (uint32_t i = 0; i < FRAMES_IN_FLIGHT_COUNT; ++i) {
+        s_pRenderCmdBuffers[i] = s_commonCmdPool.AllocCmdBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+        s_vkDevice.SetObjDebugName(*s_pRenderCmdBuffers[i], "RND_CMD_BUFFER_%u", i);
+    }
+
+    CreateSecondaryCmdBufferAllocators();
 
     UploadGPUResources();
     CreateIBLResources();
@@ -8321,22 +11766,28 @@ int main(int argc, char* argv[])
     WriteDescriptorSets();
 
     ImmediateSubmitQueue(s_vkDevice.GetQueue(), [&](vkn::CmdBuffer& cmdBuffer) {
-        cmdBuffer.CmdBindDescriptorBuffer(s_descriptorBuffer);
+        cmdBuffer.CmdBindDescriptorBuffer(s_descriptorBuffers[s_frameInFlightIdx]);
 
         PrecomputeIBLIrradianceMap(cmdBuffer);
         PrecomputeIBLPrefilteredEnvMap(cmdBuffer);
         PrecomputeIBLBRDFIntergrationLUT(cmdBuffer);
     });
 
-    s_cpuTexturesData.clear();
-
     s_pWnd->SetVisible(true);
 
     while(!s_pWnd->IsClosed()) {
         ProcessFrame();
     }
 
+#ifdef ENG_SHADER_HOT_RELOAD_ENABLED
+    s_shaderFileWatcher.Destroy();
+#endif
+
     s_vkDevice.WaitIdle();
 
+    DestroyPSOCache();
+
+    eng::GetThreadPool().Destroy();
+
     return 0;
 }
\ No newline at end of file
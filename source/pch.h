@@ -15,6 +15,7 @@
 #include <bitset>
 #include <unordered_map>
 #include <unordered_set>
+#include <set>
 #include <functional>
 #include <fstream>
 #include <filesystem>
@@ -0,0 +1,637 @@
+#include "pch.h"
+
+#include "render_graph.h"
+#include "transient_texture_allocator.h"
+#include "secondary_cmd_buffer_allocator.h"
+
+#include "render/core/vulkan/vk_cmd.h"
+#include "render/core/vulkan/vk_buffer.h"
+#include "render/core/vulkan/vk_texture.h"
+#include "render/core/vulkan/vk_swapchain.h"
+
+#include "core/engine/jobs/thread_pool.h"
+#include "core/engine/profiler/cpu_profiler.h"
+
+
+namespace eng
+{
+    static VkDeviceSize GetBufferRangeEnd(VkDeviceSize offset, VkDeviceSize size)
+    {
+        return size == VK_WHOLE_SIZE ? UINT64_MAX : offset + size;
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::ReadBuffer(vkn::Buffer& buffer, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask,
+        VkDeviceSize offset, VkDeviceSize size)
+    {
+        return AddBufferAccess(buffer, AccessType::READ, stageMask, accessMask, offset, size, true);
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::WriteBuffer(vkn::Buffer& buffer, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask,
+        VkDeviceSize offset, VkDeviceSize size)
+    {
+        return AddBufferAccess(buffer, AccessType::WRITE, stageMask, accessMask, offset, size, true);
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::ReadTexture(vkn::Texture& texture, VkImageLayout layout, VkPipelineStageFlags2 stageMask,
+        VkAccessFlags2 accessMask, VkImageAspectFlags aspectMask, uint32_t baseMip, uint32_t mipCount, uint32_t baseLayer, uint32_t layerCount)
+    {
+        return AddTextureAccess(texture, AccessType::READ, layout, stageMask, accessMask, aspectMask, baseMip, mipCount, baseLayer, layerCount, true);
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::WriteTexture(vkn::Texture& texture, VkImageLayout layout, VkPipelineStageFlags2 stageMask,
+        VkAccessFlags2 accessMask, VkImageAspectFlags aspectMask, uint32_t baseMip, uint32_t mipCount, uint32_t baseLayer, uint32_t layerCount)
+    {
+        return AddTextureAccess(texture, AccessType::WRITE, layout, stageMask, accessMask, aspectMask, baseMip, mipCount, baseLayer, layerCount, true);
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::OverwriteTexture(vkn::Texture& texture, VkImageLayout layout, VkPipelineStageFlags2 stageMask,
+        VkAccessFlags2 accessMask, VkImageAspectFlags aspectMask, uint32_t baseMip, uint32_t mipCount, uint32_t baseLayer, uint32_t layerCount)
+    {
+        return AddTextureAccess(texture, AccessType::OVERWRITE, layout, stageMask, accessMask, aspectMask, baseMip, mipCount, baseLayer, layerCount, true);
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::WriteTexture(vkn::SCTexture& texture, VkImageLayout layout, VkPipelineStageFlags2 stageMask,
+        VkAccessFlags2 accessMask, VkImageAspectFlags aspectMask)
+    {
+        ResourceAccess access = {};
+        access.pResource = &texture;
+        access.layout = layout;
+        access.stageMask = stageMask;
+        access.accessMask = accessMask;
+        access.aspectMask = aspectMask;
+        access.resourceType = ResourceType::SC_TEXTURE;
+        access.type = AccessType::WRITE;
+        access.needBarrier = true;
+
+        m_pGraph->m_passes[m_passIdx].accesses.emplace_back(access);
+
+        return *this;
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::TrackBufferRead(vkn::Buffer& buffer)
+    {
+        return AddBufferAccess(buffer, AccessType::READ, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, 0, VK_WHOLE_SIZE, false);
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::TrackBufferWrite(vkn::Buffer& buffer)
+    {
+        return AddBufferAccess(buffer, AccessType::WRITE, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, 0, VK_WHOLE_SIZE, false);
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::TrackTextureRead(vkn::Texture& texture)
+    {
+        return AddTextureAccess(texture, AccessType::READ, VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, 0,
+            0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS, false);
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::TrackTextureWrite(vkn::Texture& texture)
+    {
+        return AddTextureAccess(texture, AccessType::WRITE, VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, 0,
+            0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS, false);
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::SetSideEffect()
+    {
+        m_pGraph->m_passInfos[m_passIdx].hasSideEffect = true;
+        return *this;
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::SetParallelRecording()
+    {
+        m_pGraph->m_passInfos[m_passIdx].isParallel = true;
+        return *this;
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::AddBufferAccess(vkn::Buffer& buffer, AccessType type, VkPipelineStageFlags2 stageMask,
+        VkAccessFlags2 accessMask, VkDeviceSize offset, VkDeviceSize size, bool needBarrier)
+    {
+        CORE_ASSERT_MSG(!m_pGraph->m_isCompiled, "Attempt to declare resource access of already compiled render graph");
+
+        ResourceAccess access = {};
+        access.pResource = &buffer;
+        access.offset = offset;
+        access.size = size;
+        access.stageMask = stageMask;
+        access.accessMask = accessMask;
+        access.resourceType = ResourceType::BUFFER;
+        access.type = type;
+        access.needBarrier = needBarrier;
+
+        m_pGraph->m_passes[m_passIdx].accesses.emplace_back(access);
+
+        return *this;
+    }
+
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::AddTextureAccess(vkn::Texture& texture, AccessType type, VkImageLayout layout,
+        VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask, VkImageAspectFlags aspectMask, uint32_t baseMip, uint32_t mipCount,
+        uint32_t baseLayer, uint32_t layerCount, bool needBarrier)
+    {
+        CORE_ASSERT_MSG(!m_pGraph->m_isCompiled, "Attempt to declare resource access of already compiled render graph");
+        CORE_ASSERT(baseMip < texture.GetMipCount() && baseLayer < texture.GetLayerCount());
+
+        ResourceAccess access = {};
+        access.pResource = &texture;
+        access.baseMip = baseMip;
+        access.mipCount = mipCount == VK_REMAINING_MIP_LEVELS ? texture.GetMipCount() - baseMip : mipCount;
+        access.baseLayer = baseLayer;
+        access.layerCount = layerCount == VK_REMAINING_ARRAY_LAYERS ? texture.GetLayerCount() - baseLayer : layerCount;
+        access.layout = layout;
+        access.stageMask = stageMask;
+        access.accessMask = accessMask;
+        access.aspectMask = aspectMask;
+        access.resourceType = ResourceType::TEXTURE;
+        access.type = type;
+        access.needBarrier = needBarrier;
+
+        m_pGraph->m_passes[m_passIdx].accesses.emplace_back(access);
+
+        return *this;
+    }
+
+
+    RenderGraph& RenderGraph::Reset()
+    {
+        m_passes.clear();
+        m_passInfos.clear();
+
+        m_pSecondaryAllocator = nullptr;
+        m_secondarySetupFunc = nullptr;
+
+        m_stats = {};
+        m_isCompiled = false;
+
+        return *this;
+    }
+
+
+    RenderGraph::PassBuilder RenderGraph::AddPass(std::string_view name, PassFunc&& func)
+    {
+        CORE_ASSERT_MSG(!m_isCompiled, "Attempt to add pass \"%.*s\" to already compiled render graph", (int)name.size(), name.data());
+        CORE_ASSERT(func);
+
+        Pass& pass = m_passes.emplace_back();
+        pass.func = std::move(func);
+
+        PassInfo& info = m_passInfos.emplace_back();
+        info.name = name;
+
+        return PassBuilder(this, static_cast<uint32_t>(m_passes.size() - 1));
+    }
+
+
+    RenderGraph& RenderGraph::SetTransientAllocator(const TransientTextureAllocator* pAllocator)
+    {
+        m_pTransientAllocator = pAllocator;
+        return *this;
+    }
+
+
+    RenderGraph& RenderGraph::SetSecondaryCmdBufferAllocator(SecondaryCmdBufferAllocator* pAllocator, PassFunc&& setupFunc)
+    {
+        CORE_ASSERT(!pAllocator || pAllocator->IsCreated());
+
+        m_pSecondaryAllocator = pAllocator;
+        m_secondarySetupFunc = std::move(setupFunc);
+
+        return *this;
+    }
+
+
+    RenderGraph& RenderGraph::Compile()
+    {
+        ENG_PROFILE_SCOPED_MARKER_C(0x696969, "Render_Graph_Compile");
+
+        CORE_ASSERT_MSG(!m_isCompiled, "Render graph is already compiled");
+
+        CullPasses();
+        MarkDiscards();
+        BuildDependencies();
+        BuildBatches();
+
+        m_stats.passCount = static_cast<uint32_t>(m_passes.size());
+
+        m_isCompiled = true;
+
+        return *this;
+    }
+
+
+    RenderGraph& RenderGraph::Execute(vkn::CmdBuffer& cmdBuffer)
+    {
+        CORE_ASSERT_MSG(m_isCompiled, "Render graph must be compiled before execution");
+
+        m_passCmdBuffers.assign(m_passes.size(), nullptr);
+
+        for (const Batch& batch : m_batches) {
+            PushBatchBarriers(cmdBuffer, batch);
+            RecordParallelPasses(batch);
+
+            // Consecutive secondary command buffers are executed with one call, so the order of passes is kept
+            for (uint32_t i = batch.firstPassIdx; i < batch.endPassIdx; ++i) {
+                if (m_passInfos[i].isCulled) {
+                    continue;
+                }
+
+                if (m_passCmdBuffers[i] != nullptr) {
+                    m_secondaryCmdBuffers.emplace_back(m_passCmdBuffers[i]);
+                    continue;
+                }
+
+                if (!m_secondaryCmdBuffers.empty()) {
+                    cmdBuffer.CmdExecuteCommands(m_secondaryCmdBuffers);
+                    m_secondaryCmdBuffers.clear();
+                }
+
+                m_passes[i].func(cmdBuffer);
+            }
+
+            if (!m_secondaryCmdBuffers.empty()) {
+                cmdBuffer.CmdExecuteCommands(m_secondaryCmdBuffers);
+                m_secondaryCmdBuffers.clear();
+            }
+        }
+
+        return *this;
+    }
+
+
+    void RenderGraph::PushBatchBarriers(vkn::CmdBuffer& cmdBuffer, const Batch& batch)
+    {
+        if (batch.barrierCount == 0) {
+            return;
+        }
+
+        vkn::BarrierList& barriers = cmdBuffer.BeginBarrierList();
+
+        for (uint32_t i = batch.firstBarrierIdx; i < batch.firstBarrierIdx + batch.barrierCount; ++i) {
+            const ResourceAccess& barrier = m_batchBarriers[i];
+
+            switch (barrier.resourceType) {
+                case ResourceType::BUFFER:
+                    barriers.AddBufferBarrier(*static_cast<vkn::Buffer*>(barrier.pResource), barrier.stageMask, barrier.accessMask, 
+                        barrier.offset, barrier.size);
+                    break;
+                case ResourceType::TEXTURE:
+                {
+                    vkn::Texture& texture = *static_cast<vkn::Texture*>(barrier.pResource);
+
+                    if (barrier.isDiscard) {
+                        CORE_ASSERT_MSG(m_pTransientAllocator, "Transient allocator isn't set, but texture %s is aliased", 
+                            texture.GetDebugName().data());
+                        CORE_ASSERT_MSG(!IsMemorySharedInBatch(batch, texture), "Discard of texture %s overwrites memory of other texture "
+                            "used in the same batch. Transient allocator must be updated with the compiled graph", texture.GetDebugName().data());
+
+                        VkPipelineStageFlags2 aliasedStageMask = VK_PIPELINE_STAGE_2_NONE;
+                        VkAccessFlags2 aliasedAccessMask = VK_ACCESS_2_NONE;
+                        m_pTransientAllocator->GetAliasedAccessState(texture, aliasedStageMask, aliasedAccessMask);
+
+                        barriers.AddTextureDiscardBarrier(texture, aliasedStageMask, aliasedAccessMask, barrier.layout, barrier.stageMask, 
+                            barrier.accessMask, barrier.aspectMask, barrier.baseMip, barrier.mipCount, barrier.baseLayer, barrier.layerCount);
+                    } else {
+                        barriers.AddTextureBarrier(texture, barrier.layout, barrier.stageMask, barrier.accessMask, barrier.aspectMask, 
+                            barrier.baseMip, barrier.mipCount, barrier.baseLayer, barrier.layerCount);
+                    }
+                    break;
+                }
+                case ResourceType::SC_TEXTURE:
+                    barriers.AddTextureBarrier(*static_cast<vkn::SCTexture*>(barrier.pResource), barrier.layout, barrier.stageMask, 
+                        barrier.accessMask, barrier.aspectMask);
+                    break;
+            }
+        }
+
+        barriers.Push();
+    }
+
+
+    // Discard barriers are pushed before the first pass of the batch, so no other pass of it may use memory of discarded texture.
+    // E.g. texture last used by pass N and texture first used by independent pass N + 1 land in one batch and mustn't share memory
+    bool RenderGraph::IsMemorySharedInBatch(const Batch& batch, const vkn::Texture& texture) const
+    {
+        for (uint32_t i = batch.firstPassIdx; i < batch.endPassIdx; ++i) {
+            if (m_passInfos[i].isCulled) {
+                continue;
+            }
+
+            const bool isShared = std::ranges::any_of(m_passes[i].accesses, [&](const ResourceAccess& access) {
+                return access.resourceType == ResourceType::TEXTURE && 
+                    m_pTransientAllocator->IsMemoryShared(texture, *static_cast<const vkn::Texture*>(access.pResource));
+            });
+
+            if (isShared) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    // Passes of one batch don't conflict, and entry barriers of the batch are already pushed into primary command buffer,
+    // so parallel passes are recorded in any order. Single parallel pass isn't worth a secondary command buffer
+    void RenderGraph::RecordParallelPasses(const Batch& batch)
+    {
+        if (m_pSecondaryAllocator == nullptr) {
+            return;
+        }
+
+        m_parallelPassIndices.clear();
+
+        for (uint32_t i = batch.firstPassIdx; i < batch.endPassIdx; ++i) {
+            if (!m_passInfos[i].isCulled && m_passInfos[i].isParallel) {
+                m_parallelPassIndices.emplace_back(i);
+            }
+        }
+
+        if (m_parallelPassIndices.size() < 2) {
+            return;
+        }
+
+        ENG_PROFILE_SCOPED_MARKER_C(0x696969, "Render_Graph_Record_Parallel_Passes");
+
+        ThreadPool& threadPool = GetThreadPool();
+        CORE_ASSERT_MSG(m_pSecondaryAllocator->GetSlotCount() >= threadPool.GetWorkerSlotCount(), 
+            "Secondary command buffer allocator has less slots (%u) than thread pool (%u)", m_pSecondaryAllocator->GetSlotCount(), 
+            threadPool.GetWorkerSlotCount());
+
+        threadPool.ParallelFor(m_parallelPassIndices.size(), [this](size_t idx, uint32_t slot) {
+            const uint32_t passIdx = m_parallelPassIndices[idx];
+
+            vkn::CmdBuffer& secondary = m_pSecondaryAllocator->Allocate(slot);
+
+            secondary.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+            if (m_secondarySetupFunc) {
+                m_secondarySetupFunc(secondary);
+            }
+
+            m_passes[passIdx].func(secondary);
+
+            secondary.End();
+
+            m_passCmdBuffers[passIdx] = &secondary;
+        });
+
+        m_stats.secondaryCmdBufferCount += static_cast<uint32_t>(m_parallelPassIndices.size());
+    }
+
+
+    bool RenderGraph::IsOverlapped(const ResourceAccess& l, const ResourceAccess& r)
+    {
+        if (l.pResource != r.pResource) {
+            return false;
+        }
+
+        if (l.resourceType == ResourceType::BUFFER) {
+            return l.offset < GetBufferRangeEnd(r.offset, r.size) && r.offset < GetBufferRangeEnd(l.offset, l.size);
+        }
+
+        const bool isMipsOverlapped = l.baseMip < r.baseMip + r.mipCount && r.baseMip < l.baseMip + l.mipCount;
+        const bool isLayersOverlapped = l.baseLayer < r.baseLayer + r.layerCount && r.baseLayer < l.baseLayer + l.layerCount;
+
+        return isMipsOverlapped && isLayersOverlapped;
+    }
+
+
+    bool RenderGraph::IsCovered(const ResourceAccess& access, const ResourceAccess& cover)
+    {
+        if (access.pResource != cover.pResource) {
+            return false;
+        }
+
+        if (access.resourceType == ResourceType::BUFFER) {
+            return cover.offset <= access.offset && GetBufferRangeEnd(access.offset, access.size) <= GetBufferRangeEnd(cover.offset, cover.size);
+        }
+
+        return cover.baseMip <= access.baseMip && access.baseMip + access.mipCount <= cover.baseMip + cover.mipCount &&
+            cover.baseLayer <= access.baseLayer && access.baseLayer + access.layerCount <= cover.baseLayer + cover.layerCount;
+    }
+
+
+    // Reads of the same layout can be done in any order. Tracked only texture accesses have unknown layout, so they always conflict
+    bool RenderGraph::IsConflicted(const ResourceAccess& l, const ResourceAccess& r)
+    {
+        if (!IsOverlapped(l, r)) {
+            return false;
+        }
+
+        if (l.type != AccessType::READ || r.type != AccessType::READ) {
+            return true;
+        }
+
+        if (l.resourceType == ResourceType::BUFFER) {
+            return false;
+        }
+
+        return l.layout != r.layout || l.layout == VK_IMAGE_LAYOUT_UNDEFINED;
+    }
+
+
+    // Passes are walked from the last one. Pass is alive if it has side effect or writes anything read by alive passes after it.
+    // Ranges overwritten by alive pass aren't needed by passes before it anymore
+    void RenderGraph::CullPasses()
+    {
+        m_neededAccesses.clear();
+
+        for (size_t i = m_passes.size(); i-- > 0;) {
+            const Pass& pass = m_passes[i];
+            PassInfo& info = m_passInfos[i];
+
+            bool isAlive = info.hasSideEffect;
+
+            for (size_t j = 0; j < pass.accesses.size() && !isAlive; ++j) {
+                const ResourceAccess& access = pass.accesses[j];
+
+                if (access.type == AccessType::READ) {
+                    continue;
+                }
+
+                isAlive = std::ranges::any_of(m_neededAccesses, [&](const ResourceAccess& needed) { return IsOverlapped(needed, access); });
+            }
+
+            info.isCulled = !isAlive;
+
+            if (!isAlive) {
+                ++m_stats.culledPassCount;
+                continue;
+            }
+
+            for (const ResourceAccess& access : pass.accesses) {
+                if (access.type != AccessType::OVERWRITE) {
+                    continue;
+                }
+
+                std::erase_if(m_neededAccesses, [&](const ResourceAccess& needed) { return IsCovered(needed, access); });
+            }
+
+            for (const ResourceAccess& access : pass.accesses) {
+                if (access.type != AccessType::OVERWRITE) {
+                    m_neededAccesses.emplace_back(access);
+                }
+            }
+        }
+    }
+
+
+    // Memory of aliased texture may be used by other textures between frames, so its content is discarded on the first access
+    void RenderGraph::MarkDiscards()
+    {
+        m_discardedTextures.clear();
+
+        for (size_t i = 0; i < m_passes.size(); ++i) {
+            if (m_passInfos[i].isCulled) {
+                continue;
+            }
+
+            for (ResourceAccess& access : m_passes[i].accesses) {
+                if (access.resourceType != ResourceType::TEXTURE || !static_cast<const vkn::Texture*>(access.pResource)->IsAliased()) {
+                    continue;
+                }
+
+                if (std::ranges::find(m_discardedTextures, access.pResource) != m_discardedTextures.end()) {
+                    continue;
+                }
+
+                CORE_ASSERT_MSG(access.needBarrier, "The first access of aliased texture %s in pass \"%s\" must be declared with barrier",
+                    static_cast<const vkn::Texture*>(access.pResource)->GetDebugName().data(), m_passInfos[i].name.c_str());
+
+                access.isDiscard = true;
+                m_discardedTextures.emplace_back(access.pResource);
+            }
+        }
+    }
+
+
+    // Entry barriers of the whole batch, including discards of aliased textures, are pushed before its first pass. So lifetime covers
+    // whole batches, otherwise texture first accessed in the batch could discard memory of texture still used by earlier pass of it
+    RenderGraph::Lifetime RenderGraph::GetTextureLifetime(const vkn::Texture& texture) const
+    {
+        CORE_ASSERT_MSG(m_isCompiled, "Render graph must be compiled before lifetime query");
+
+        Lifetime lifetime = {};
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_passes.size()); ++i) {
+            if (m_passInfos[i].isCulled) {
+                continue;
+            }
+
+            const bool isAccessed = std::ranges::any_of(m_passes[i].accesses, [&texture](const ResourceAccess& access) { 
+                return access.pResource == &texture;
+            });
+
+            if (!isAccessed) {
+                continue;
+            }
+
+            const Batch& batch = m_batches[m_passInfos[i].batchIdx];
+
+            lifetime.firstPassIdx = std::min(lifetime.firstPassIdx, batch.firstPassIdx);
+            lifetime.lastPassIdx = std::max(lifetime.lastPassIdx, batch.endPassIdx - 1);
+        }
+
+        return lifetime;
+    }
+
+
+    void RenderGraph::BuildDependencies()
+    {
+        for (size_t i = 0; i < m_passes.size(); ++i) {
+            PassInfo& info = m_passInfos[i];
+            info.dependencies.clear();
+
+            if (info.isCulled) {
+                continue;
+            }
+
+            for (size_t j = 0; j < i; ++j) {
+                if (m_passInfos[j].isCulled) {
+                    continue;
+                }
+
+                const bool isDependent = std::ranges::any_of(m_passes[i].accesses, [&](const ResourceAccess& access) {
+                    return std::ranges::any_of(m_passes[j].accesses, [&](const ResourceAccess& prevAccess) { return IsConflicted(access, prevAccess); });
+                });
+
+                if (isDependent) {
+                    info.dependencies.emplace_back(static_cast<uint32_t>(j));
+                }
+            }
+        }
+    }
+
+
+    // Greedy batching in declaration order: pass starts new batch if it depends on any pass of the current one.
+    // Passes of one batch don't conflict, so their accesses of the same subresource and layout are merged into one barrier
+    void RenderGraph::BuildBatches()
+    {
+        m_batches.clear();
+        m_batchBarriers.clear();
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_passes.size()); ++i) {
+            PassInfo& info = m_passInfos[i];
+
+            if (info.isCulled) {
+                continue;
+            }
+
+            const bool isDependentOnBatch = !m_batches.empty() && std::ranges::any_of(info.dependencies, [&](uint32_t depIdx) {
+                return m_passInfos[depIdx].batchIdx == m_batches.size() - 1;
+            });
+
+            if (m_batches.empty() || isDependentOnBatch) {
+                Batch& newBatch = m_batches.emplace_back();
+                newBatch.firstPassIdx = i;
+                newBatch.firstBarrierIdx = static_cast<uint32_t>(m_batchBarriers.size());
+            }
+
+            Batch& batch = m_batches.back();
+            batch.endPassIdx = i + 1;
+
+            info.batchIdx = static_cast<uint32_t>(m_batches.size() - 1);
+
+            for (const ResourceAccess& access : m_passes[i].accesses) {
+                if (!access.needBarrier) {
+                    continue;
+                }
+
+                ++m_stats.declaredBarrierCount;
+
+                const auto batchBarriers = std::span(m_batchBarriers).subspan(batch.firstBarrierIdx);
+
+                auto it = std::ranges::find_if(batchBarriers, [&](const ResourceAccess& barrier) {
+                    return barrier.pResource == access.pResource && barrier.offset == access.offset && barrier.size == access.size &&
+                        barrier.baseMip == access.baseMip && barrier.mipCount == access.mipCount &&
+                        barrier.baseLayer == access.baseLayer && barrier.layerCount == access.layerCount &&
+                        barrier.layout == access.layout && barrier.aspectMask == access.aspectMask;
+                });
+
+                if (it != batchBarriers.end()) {
+                    it->stageMask |= access.stageMask;
+                    it->accessMask |= access.accessMask;
+                    it->isDiscard = it->isDiscard || access.isDiscard;
+                } else {
+                    m_batchBarriers.emplace_back(access);
+                    ++batch.barrierCount;
+                }
+            }
+        }
+
+        m_stats.batchCount = static_cast<uint32_t>(m_batches.size());
+        m_stats.pushedBarrierCount = static_cast<uint32_t>(m_batchBarriers.size());
+        m_stats.batchBarrierListCount = static_cast<uint32_t>(std::ranges::count_if(m_batches, [](const Batch& batch) { return batch.barrierCount > 0; }));
+    }
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+#include "core/core.h"
+
+#include "render/core/vulkan/vk_core.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace vkn
+{
+    class CmdBuffer;
+    class Buffer;
+    class Texture;
+    class SCTexture;
+}
+
+
+namespace eng
+{
+    class TransientTextureAllocator;
+    class SecondaryCmdBufferAllocator;
+
+
+    // Frame graph on top of vkn::CmdBuffer. Passes declare accesses of buffer ranges and texture subresources, and graph:
+    //  - culls passes which results aren't read by any alive pass. Passes with side effects are never culled
+    //  - splits alive passes into batches of independent ones and pushes entry barriers of the whole batch with one vkCmdPipelineBarrier2
+    // Passes are executed in declaration order. Barriers between stages of a single pass stay inside it, such resources are declared
+    // with Track* methods, which add dependency but no barrier. Every pass which touches resource must declare it in any way.
+    // Content of aliased textures is discarded on their first access in the frame, so it must be declared with barrier.
+    // Parallel passes of one batch are recorded into secondary command buffers on the thread pool, if allocator of them is set
+    class RenderGraph
+    {
+    public:
+        using PassFunc = std::function<void(vkn::CmdBuffer&)>;
+
+        enum class AccessType : uint8_t
+        {
+            READ,
+            WRITE,      // Previous content is read or partially kept
+            OVERWRITE,  // Previous content isn't used, so its producers can be culled
+        };
+
+        struct PassInfo
+        {
+            std::string name;
+            std::vector<uint32_t> dependencies; // Indices of earlier alive passes which must be finished before the pass
+            uint32_t batchIdx = UINT32_MAX;
+            bool hasSideEffect = false;
+            bool isParallel = false;
+            bool isCulled = false;
+        };
+
+        struct Stats
+        {
+            uint32_t passCount = 0;
+            uint32_t culledPassCount = 0;
+            uint32_t batchCount = 0;
+            uint32_t declaredBarrierCount = 0;
+            uint32_t pushedBarrierCount = 0; // After merging of the same subresource accesses in batch
+            uint32_t batchBarrierListCount = 0; // Batches which flush non-empty entry barrier list
+            uint32_t secondaryCmdBufferCount = 0;
+        };
+
+        // Indices of the first and the last passes of batches which access resource
+        struct Lifetime
+        {
+            bool IsEmpty() const { return firstPassIdx > lastPassIdx; }
+
+            uint32_t firstPassIdx = UINT32_MAX;
+            uint32_t lastPassIdx = 0;
+        };
+
+        class PassBuilder
+        {
+            friend class RenderGraph;
+
+        public:
+            PassBuilder& ReadBuffer(vkn::Buffer& buffer, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask,
+                VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+            PassBuilder& WriteBuffer(vkn::Buffer& buffer, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask,
+                VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+            PassBuilder& ReadTexture(vkn::Texture& texture, VkImageLayout layout, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask,
+                VkImageAspectFlags aspectMask, uint32_t baseMip = 0, uint32_t mipCount = VK_REMAINING_MIP_LEVELS,
+                uint32_t baseLayer = 0, uint32_t layerCount = VK_REMAINING_ARRAY_LAYERS);
+            PassBuilder& WriteTexture(vkn::Texture& texture, VkImageLayout layout, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask,
+                VkImageAspectFlags aspectMask, uint32_t baseMip = 0, uint32_t mipCount = VK_REMAINING_MIP_LEVELS,
+                uint32_t baseLayer = 0, uint32_t layerCount = VK_REMAINING_ARRAY_LAYERS);
+            PassBuilder& OverwriteTexture(vkn::Texture& texture, VkImageLayout layout, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask,
+                VkImageAspectFlags aspectMask, uint32_t baseMip = 0, uint32_t mipCount = VK_REMAINING_MIP_LEVELS,
+                uint32_t baseLayer = 0, uint32_t layerCount = VK_REMAINING_ARRAY_LAYERS);
+
+            PassBuilder& WriteTexture(vkn::SCTexture& texture, VkImageLayout layout, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask,
+                VkImageAspectFlags aspectMask);
+
+            // Dependency only. Barriers of these resources are pushed by the pass itself
+            PassBuilder& TrackBufferRead(vkn::Buffer& buffer);
+            PassBuilder& TrackBufferWrite(vkn::Buffer& buffer);
+            PassBuilder& TrackTextureRead(vkn::Texture& texture);
+            PassBuilder& TrackTextureWrite(vkn::Texture& texture);
+
+            // Pass writes state used outside of the frame (caches, history, presented image) and must not be culled
+            PassBuilder& SetSideEffect();
+
+            // Pass can be recorded into secondary command buffer on worker thread. Its func must be thread safe, start and end
+            // its own rendering and push barriers only of resources written by the pass, since tracker states are shared
+            PassBuilder& SetParallelRecording();
+
+        private:
+            PassBuilder(RenderGraph* pGraph, uint32_t passIdx) : m_pGraph(pGraph), m_passIdx(passIdx) {}
+
+            PassBuilder& AddBufferAccess(vkn::Buffer& buffer, AccessType type, VkPipelineStageFlags2 stageMask, VkAccessFlags2 accessMask,
+                VkDeviceSize offset, VkDeviceSize size, bool needBarrier);
+            PassBuilder& AddTextureAccess(vkn::Texture& texture, AccessType type, VkImageLayout layout, VkPipelineStageFlags2 stageMask,
+                VkAccessFlags2 accessMask, VkImageAspectFlags aspectMask, uint32_t baseMip, uint32_t mipCount, uint32_t baseLayer,
+                uint32_t layerCount, bool needBarrier);
+
+        private:
+            RenderGraph* m_pGraph = nullptr;
+            uint32_t m_passIdx = UINT32_MAX;
+        };
+
+    public:
+        ENG_DECL_CLASS_NO_COPIABLE(RenderGraph);
+
+        RenderGraph() = default;
+
+        // Graph is rebuilt every frame, passes are declared after reset
+        RenderGraph& Reset();
+
+        PassBuilder AddPass(std::string_view name, PassFunc&& func);
+
+        // Allocator of aliased textures used by the graph. It provides accesses which must be finished before content discard
+        RenderGraph& SetTransientAllocator(const TransientTextureAllocator* pAllocator);
+        // Source of secondary command buffers for parallel passes. Setup func is called for each of them before the pass func,
+        // e.g. to bind descriptor buffer, since secondary command buffers don't inherit bindings
+        RenderGraph& SetSecondaryCmdBufferAllocator(SecondaryCmdBufferAllocator* pAllocator, PassFunc&& setupFunc);
+
+        RenderGraph& Compile();
+        RenderGraph& Execute(vkn::CmdBuffer& cmdBuffer);
+
+        Lifetime GetTextureLifetime(const vkn::Texture& texture) const;
+
+        const std::vector<PassInfo>& GetPassInfos() const { return m_passInfos; }
+        const Stats& GetStats() const { return m_stats; }
+
+        bool IsCompiled() const { return m_isCompiled; }
+
+    private:
+        enum class ResourceType : uint8_t
+        {
+            BUFFER,
+            TEXTURE,
+            SC_TEXTURE,
+        };
+
+        struct ResourceAccess
+        {
+            void* pResource = nullptr;
+
+            VkDeviceSize offset = 0;
+            VkDeviceSize size = VK_WHOLE_SIZE;
+
+            uint32_t baseMip = 0;
+            uint32_t mipCount = 1;
+            uint32_t baseLayer = 0;
+            uint32_t layerCount = 1;
+
+            VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            VkPipelineStageFlags2 stageMask = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2 accessMask = VK_ACCESS_2_NONE;
+            VkImageAspectFlags aspectMask = 0;
+
+            ResourceType resourceType = ResourceType::BUFFER;
+            AccessType type = AccessType::READ;
+            bool needBarrier = false;
+            bool isDiscard = false;
+        };
+
+        struct Batch
+        {
+            uint32_t firstPassIdx = 0;
+            uint32_t endPassIdx = 0;
+            uint32_t firstBarrierIdx = 0;
+            uint32_t barrierCount = 0;
+        };
+
+        struct Pass
+        {
+            PassFunc func;
+            std::vector<ResourceAccess> accesses;
+        };
+
+    private:
+        static bool IsOverlapped(const ResourceAccess& l, const ResourceAccess& r);
+        static bool IsCovered(const ResourceAccess& access, const ResourceAccess& cover);
+        static bool IsConflicted(const ResourceAccess& l, const ResourceAccess& r);
+
+        void CullPasses();
+        void MarkDiscards();
+        void BuildDependencies();
+        void BuildBatches();
+
+        void PushBatchBarriers(vkn::CmdBuffer& cmdBuffer, const Batch& batch);
+        bool IsMemorySharedInBatch(const Batch& batch, const vkn::Texture& texture) const;
+        void RecordParallelPasses(const Batch& batch);
+
+    private:
+        std::vector<Pass> m_passes;
+        std::vector<PassInfo> m_passInfos;
+
+        std::vector<Batch> m_batches;
+        std::vector<ResourceAccess> m_batchBarriers; // Merged entry barriers of all batches
+
+        // Scratch data of culling and discard marking reused between frames
+        std::vector<ResourceAccess> m_neededAccesses;
+        std::vector<const void*> m_discardedTextures;
+
+        // Scratch data of parallel recording. Secondary command buffer of pass is null if the pass is recorded inline
+        std::vector<uint32_t> m_parallelPassIndices;
+        std::vector<vkn::CmdBuffer*> m_passCmdBuffers;
+        std::vector<vkn::CmdBuffer*> m_secondaryCmdBuffers;
+
+        const TransientTextureAllocator* m_pTransientAllocator = nullptr;
+
+        SecondaryCmdBufferAllocator* m_pSecondaryAllocator = nullptr;
+        PassFunc m_secondarySetupFunc;
+
+        Stats m_stats = {};
+
+        bool m_isCompiled = false;
+    };
+}
@@ -0,0 +1,88 @@
+#include "pch.h"
+
+#include "secondary_cmd_buffer_allocator.h"
+
+#include "render/core/vulkan/vk_device.h"
+
+
+namespace eng
+{
+    SecondaryCmdBufferAllocator::~SecondaryCmdBufferAllocator()
+    {
+        Destroy();
+    }
+
+
+    SecondaryCmdBufferAllocator& SecondaryCmdBufferAllocator::Create(vkn::Device* pDevice, uint32_t queueFamilyIndex, uint32_t slotCount,
+        uint16_t cmdBufferCountPerSlot)
+    {
+        if (IsCreated()) {
+            CORE_LOG_WARN("Recreation of secondary command buffer allocator");
+            Destroy();
+        }
+
+        CORE_ASSERT(pDevice && pDevice->IsCreated());
+        CORE_ASSERT(slotCount >= 1 && cmdBufferCountPerSlot >= 1);
+
+        vkn::CmdPoolCreateInfo poolCreateInfo = {};
+        poolCreateInfo.pDevice = pDevice;
+        poolCreateInfo.queueFamilyIndex = queueFamilyIndex;
+        poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolCreateInfo.size = cmdBufferCountPerSlot;
+
+        // Command buffers keep pointer to their pool, so pools are created in place and never moved
+        m_slots.resize(slotCount);
+
+        for (Slot& slot : m_slots) {
+            slot.pool.Create(poolCreateInfo);
+            slot.cmdBuffers.reserve(cmdBufferCountPerSlot);
+        }
+
+        return *this;
+    }
+
+
+    SecondaryCmdBufferAllocator& SecondaryCmdBufferAllocator::Destroy()
+    {
+        for (Slot& slot : m_slots) {
+            slot.pool.Destroy();
+        }
+
+        m_slots.clear();
+
+        return *this;
+    }
+
+
+    SecondaryCmdBufferAllocator& SecondaryCmdBufferAllocator::Reset()
+    {
+        CORE_ASSERT(IsCreated());
+
+        for (Slot& slot : m_slots) {
+            slot.pool.Reset();
+            slot.usedCount = 0;
+        }
+
+        return *this;
+    }
+
+
+    vkn::CmdBuffer& SecondaryCmdBufferAllocator::Allocate(uint32_t slotIdx)
+    {
+        CORE_ASSERT(IsCreated());
+        CORE_ASSERT_MSG(slotIdx < m_slots.size(), "Secondary command buffer slot %u is out of range [0, %zu)", slotIdx, m_slots.size());
+
+        Slot& slot = m_slots[slotIdx];
+
+        if (slot.usedCount == slot.cmdBuffers.size()) {
+            vkn::CmdBuffer* pCmdBuffer = slot.pool.AllocCmdBuffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+            CORE_ASSERT(pCmdBuffer);
+
+            slot.pool.GetDevice().SetObjDebugName(*pCmdBuffer, "SEC_CMD_BUFFER_%u_%zu", slotIdx, slot.cmdBuffers.size());
+
+            slot.cmdBuffers.emplace_back(pCmdBuffer);
+        }
+
+        return *slot.cmdBuffers[slot.usedCount++];
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "core/core.h"
+
+#include "render/core/vulkan/vk_cmd.h"
+
+#include <vector>
+
+
+namespace eng
+{
+    // Secondary command buffers for parallel recording. Each worker slot of the thread pool owns its command pool, so slots
+    // record without synchronization. Buffers are allocated on demand and reused after Reset(), which must be called only
+    // when the GPU finished all buffers allocated since the previous reset, e.g. once per frame in flight
+    class SecondaryCmdBufferAllocator
+    {
+    public:
+        ENG_DECL_CLASS_NO_COPIABLE(SecondaryCmdBufferAllocator);
+
+        SecondaryCmdBufferAllocator() = default;
+        ~SecondaryCmdBufferAllocator();
+
+        SecondaryCmdBufferAllocator& Create(vkn::Device* pDevice, uint32_t queueFamilyIndex, uint32_t slotCount, uint16_t cmdBufferCountPerSlot);
+        SecondaryCmdBufferAllocator& Destroy();
+
+        SecondaryCmdBufferAllocator& Reset();
+
+        // Must be called only from the thread which owns the slot
+        vkn::CmdBuffer& Allocate(uint32_t slot);
+
+        uint32_t GetSlotCount() const { return static_cast<uint32_t>(m_slots.size()); }
+
+        bool IsCreated() const { return !m_slots.empty(); }
+
+    private:
+        struct Slot
+        {
+            vkn::CmdPool pool;
+            std::vector<vkn::CmdBuffer*> cmdBuffers;
+            uint32_t usedCount = 0;
+        };
+
+    private:
+        std::vector<Slot> m_slots;
+    };
+}
@@ -0,0 +1,249 @@
+#include "pch.h"
+
+#include "transient_texture_allocator.h"
+
+
+namespace eng
+{
+    static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+
+    TransientTextureAllocator::~TransientTextureAllocator()
+    {
+        Destroy();
+    }
+
+
+    TransientTextureAllocator& TransientTextureAllocator::AddTexture(vkn::Texture& texture, const vkn::TextureCreateInfo& info)
+    {
+        CORE_ASSERT_MSG(!IsAllocated(), "Attempt to add texture to already allocated transient texture allocator");
+
+        auto it = std::ranges::find_if(m_entries, [&texture](const Entry& entry) { return entry.pTexture == &texture; });
+        Entry& entry = it != m_entries.end() ? *it : m_entries.emplace_back();
+
+        entry.pTexture = &texture;
+        entry.createInfo = info;
+        entry.createInfo.pAllocInfo = nullptr;
+        entry.memRequirements = vkn::Texture::GetMemoryRequirements(info);
+
+        return *this;
+    }
+
+
+    TransientTextureAllocator& TransientTextureAllocator::Allocate()
+    {
+        CORE_ASSERT_MSG(!IsAllocated(), "Transient texture allocator is already allocated");
+
+        PlaceTextures(m_entries, m_heaps);
+
+        for (Heap& heap : m_heaps) {
+            VkMemoryRequirements heapRequirements = {};
+            heapRequirements.size = heap.size;
+            heapRequirements.alignment = heap.alignment;
+            heapRequirements.memoryTypeBits = heap.memoryTypeBits;
+
+            VmaAllocationCreateInfo allocCI = {};
+            allocCI.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+            allocCI.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+            VK_CHECK(vmaAllocateMemory(vkn::GetAllocator().Get(), &heapRequirements, &allocCI, &heap.allocation, nullptr));
+            CORE_ASSERT_MSG(heap.allocation != VK_NULL_HANDLE, "Failed to allocate transient texture heap");
+        }
+
+        for (Entry& entry : m_entries) {
+            entry.pTexture->CreateAliased(entry.createInfo, m_heaps[entry.heapIdx].allocation, entry.offset);
+        }
+
+        return *this;
+    }
+
+
+    TransientTextureAllocator& TransientTextureAllocator::Destroy()
+    {
+        for (Heap& heap : m_heaps) {
+            vmaFreeMemory(vkn::GetAllocator().Get(), heap.allocation);
+        }
+
+        m_heaps.clear();
+
+        return *this;
+    }
+
+
+    bool TransientTextureAllocator::Update(const RenderGraph& graph)
+    {
+        if (!IsAllocated()) {
+            return false;
+        }
+
+        for (Entry& entry : m_entries) {
+            entry.lifetime = graph.GetTextureLifetime(*entry.pTexture);
+            entry.hasLifetime = true;
+        }
+
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            for (size_t j = i + 1; j < m_entries.size(); ++j) {
+                if (IsMemoryOverlapped(m_entries[i], m_entries[j]) && IsLifetimeOverlapped(m_entries[i], m_entries[j])) {
+                    return true;
+                }
+            }
+        }
+
+        // Current placement is valid, but it may be too conservative, e.g. before the first update
+        m_scratchEntries = m_entries;
+        PlaceTextures(m_scratchEntries, m_scratchHeaps);
+
+        VkDeviceSize newMemorySize = 0;
+
+        for (const Heap& heap : m_scratchHeaps) {
+            newMemorySize += heap.size;
+        }
+
+        return newMemorySize < GetMemorySize();
+    }
+
+
+    void TransientTextureAllocator::GetAliasedAccessState(const vkn::Texture& texture, VkPipelineStageFlags2& outStageMask,
+        VkAccessFlags2& outAccessMask) const
+    {
+        outStageMask = VK_PIPELINE_STAGE_2_NONE;
+        outAccessMask = VK_ACCESS_2_NONE;
+
+        auto it = std::ranges::find_if(m_entries, [&texture](const Entry& entry) { return entry.pTexture == &texture; });
+        CORE_ASSERT_MSG(it != m_entries.end(), "Texture %s isn't transient", texture.GetDebugName().data());
+
+        for (const Entry& entry : m_entries) {
+            if (&entry == &*it || !IsMemoryOverlapped(entry, *it) || !entry.pTexture->IsCreated()) {
+                continue;
+            }
+
+            const vkn::TextureAccessTracker& tracker = entry.pTexture->GetAccessTracker();
+
+            for (uint32_t layer = 0; layer < entry.pTexture->GetLayerCount(); ++layer) {
+                for (uint32_t mip = 0; mip < entry.pTexture->GetMipCount(); ++mip) {
+                    const vkn::TextureAccessTracker::State& state = tracker.GetState(layer, mip);
+
+                    outStageMask |= state.stageMask;
+                    outAccessMask |= state.accessMask;
+                }
+            }
+        }
+    }
+
+
+    bool TransientTextureAllocator::IsMemoryShared(const vkn::Texture& l, const vkn::Texture& r) const
+    {
+        auto lIt = std::ranges::find_if(m_entries, [&l](const Entry& entry) { return entry.pTexture == &l; });
+        auto rIt = std::ranges::find_if(m_entries, [&r](const Entry& entry) { return entry.pTexture == &r; });
+
+        if (lIt == m_entries.end() || rIt == m_entries.end() || lIt == rIt) {
+            return false;
+        }
+
+        return IsMemoryOverlapped(*lIt, *rIt);
+    }
+
+
+    VkDeviceSize TransientTextureAllocator::GetMemorySize() const
+    {
+        VkDeviceSize size = 0;
+
+        for (const Heap& heap : m_heaps) {
+            size += heap.size;
+        }
+
+        return size;
+    }
+
+
+    VkDeviceSize TransientTextureAllocator::GetUnaliasedMemorySize() const
+    {
+        VkDeviceSize size = 0;
+
+        for (const Entry& entry : m_entries) {
+            size += entry.memRequirements.size;
+        }
+
+        return size;
+    }
+
+
+    // Textures without known lifetime are considered to be alive during the whole frame
+    bool TransientTextureAllocator::IsLifetimeOverlapped(const Entry& l, const Entry& r)
+    {
+        if (!l.hasLifetime || !r.hasLifetime) {
+            return true;
+        }
+
+        if (l.lifetime.IsEmpty() || r.lifetime.IsEmpty()) {
+            return false;
+        }
+
+        return l.lifetime.firstPassIdx <= r.lifetime.lastPassIdx && r.lifetime.firstPassIdx <= l.lifetime.lastPassIdx;
+    }
+
+
+    bool TransientTextureAllocator::IsMemoryOverlapped(const Entry& l, const Entry& r)
+    {
+        return l.heapIdx == r.heapIdx && l.offset < r.offset + r.memRequirements.size && r.offset < l.offset + l.memRequirements.size;
+    }
+
+
+    // Textures are placed from the largest one. Each one gets the first offset which doesn't intersect memory of already placed
+    // textures with overlapping lifetimes. Textures with different memory type requirements are placed into different heaps
+    void TransientTextureAllocator::PlaceTextures(std::vector<Entry>& entries, std::vector<Heap>& heaps)
+    {
+        heaps.clear();
+
+        std::vector<Entry*> sortedEntries(entries.size());
+
+        for (size_t i = 0; i < entries.size(); ++i) {
+            entries[i].heapIdx = UINT32_MAX;
+            sortedEntries[i] = &entries[i];
+        }
+
+        std::stable_sort(sortedEntries.begin(), sortedEntries.end(), [](const Entry* pL, const Entry* pR) {
+            return pL->memRequirements.size > pR->memRequirements.size;
+        });
+
+        for (Entry* pEntry : sortedEntries) {
+            const VkMemoryRequirements& requirements = pEntry->memRequirements;
+
+            auto heapIt = std::ranges::find_if(heaps, [&requirements](const Heap& heap) { return heap.memoryTypeBits == requirements.memoryTypeBits; });
+
+            if (heapIt == heaps.end()) {
+                heapIt = heaps.emplace(heaps.end());
+                heapIt->memoryTypeBits = requirements.memoryTypeBits;
+            }
+
+            const uint32_t heapIdx = static_cast<uint32_t>(heapIt - heaps.begin());
+
+            pEntry->heapIdx = heapIdx;
+            pEntry->offset = 0;
+
+            // Offset only grows, so the loop ends when it's moved past all conflicting textures
+            bool isConflicted = true;
+
+            while (isConflicted) {
+                isConflicted = false;
+
+                for (const Entry& placed : entries) {
+                    if (&placed == pEntry || placed.heapIdx != heapIdx) {
+                        continue;
+                    }
+
+                    if (IsMemoryOverlapped(*pEntry, placed) && IsLifetimeOverlapped(*pEntry, placed)) {
+                        pEntry->offset = AlignUp(placed.offset + placed.memRequirements.size, requirements.alignment);
+                        isConflicted = true;
+                    }
+                }
+            }
+
+            heapIt->size = std::max(heapIt->size, pEntry->offset + requirements.size);
+            heapIt->alignment = std::max(heapIt->alignment, requirements.alignment);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "core/core.h"
+
+#include "render/core/vulkan/vk_texture.h"
+
+#include "render_graph.h"
+
+#include <vector>
+
+
+namespace eng
+{
+    // Places textures which content isn't kept between frames into shared memory heaps. Textures which lifetimes in the render
+    // graph don't overlap share memory ranges. Lifetimes are taken from the compiled graph, so until the first Update() textures
+    // don't alias anything. Content of transient texture is discarded by the graph on its first access in the frame
+    class TransientTextureAllocator
+    {
+    public:
+        ENG_DECL_CLASS_NO_COPIABLE(TransientTextureAllocator);
+
+        TransientTextureAllocator() = default;
+        ~TransientTextureAllocator();
+
+        // Texture is created by Allocate(), info.pAllocInfo is ignored. Re-adding the same texture updates its create info
+        // and keeps its lifetime, e.g. on resize
+        TransientTextureAllocator& AddTexture(vkn::Texture& texture, const vkn::TextureCreateInfo& info);
+
+        TransientTextureAllocator& Allocate();
+        // Frees heaps. Textures must be destroyed before
+        TransientTextureAllocator& Destroy();
+
+        // Updates lifetimes from compiled graph. Returns true if textures must be reallocated, because current placement
+        // aliases textures which are alive at the same time or less memory is needed for the new lifetimes
+        bool Update(const RenderGraph& graph);
+
+        // Union of the last accesses of textures which share memory with the texture
+        void GetAliasedAccessState(const vkn::Texture& texture, VkPipelineStageFlags2& outStageMask, VkAccessFlags2& outAccessMask) const;
+
+        bool IsMemoryShared(const vkn::Texture& l, const vkn::Texture& r) const;
+
+        VkDeviceSize GetMemorySize() const;
+        VkDeviceSize GetUnaliasedMemorySize() const;
+
+        bool IsAllocated() const { return !m_heaps.empty(); }
+
+    private:
+        struct Entry
+        {
+            vkn::Texture* pTexture = nullptr;
+            vkn::TextureCreateInfo createInfo = {};
+            VkMemoryRequirements memRequirements = {};
+
+            RenderGraph::Lifetime lifetime = {};
+            bool hasLifetime = false;
+
+            uint32_t heapIdx = UINT32_MAX;
+            VkDeviceSize offset = 0;
+        };
+
+        struct Heap
+        {
+            VmaAllocation allocation = VK_NULL_HANDLE;
+            VkDeviceSize size = 0;
+            VkDeviceSize alignment = 1;
+            uint32_t memoryTypeBits = 0;
+        };
+
+    private:
+        static bool IsLifetimeOverlapped(const Entry& l, const Entry& r);
+        static bool IsMemoryOverlapped(const Entry& l, const Entry& r);
+
+        static void PlaceTextures(std::vector<Entry>& entries, std::vector<Heap>& heaps);
+
+    private:
+        std::vector<Entry> m_entries;
+        std::vector<Heap> m_heaps;
+
+        // Scratch data of placement check reused between frames
+        std::vector<Entry> m_scratchEntries;
+        std::vector<Heap> m_scratchHeaps;
+    };
+}
@@ -0,0 +1,110 @@
+#include "pch.h"
+
+#include "bc_encoder.h"
+
+#include <bc7enc.h>
+#include <rgbcx.h>
+
+#include <mutex>
+
+
+namespace eng
+{
+    static constexpr uint32_t BC_BLOCK_EXTENT = 4;
+    static constexpr uint32_t RGBA8_TEXEL_SIZE = 4;
+
+
+    static uint32_t GetBCBlockSize(VkFormat format)
+    {
+        switch (format) {
+            case VK_FORMAT_BC4_UNORM_BLOCK: return 8;
+            case VK_FORMAT_BC5_UNORM_BLOCK: return 16;
+            case VK_FORMAT_BC7_UNORM_BLOCK: return 16;
+            case VK_FORMAT_BC7_SRGB_BLOCK:  return 16;
+            default: return 0;
+        }
+    }
+
+
+    // Both encoders initialize global lookup tables, which are read only afterwards
+    static void InitBCEncoders()
+    {
+        static std::once_flag initFlag;
+
+        std::call_once(initFlag, []() {
+            rgbcx::init();
+            bc7enc_compress_block_init();
+        });
+    }
+
+
+    size_t CalcBCEncodedSize(VkFormat format, uint32_t width, uint32_t height)
+    {
+        const size_t blockCountX = (width + BC_BLOCK_EXTENT - 1) / BC_BLOCK_EXTENT;
+        const size_t blockCountY = (height + BC_BLOCK_EXTENT - 1) / BC_BLOCK_EXTENT;
+
+        return blockCountX * blockCountY * GetBCBlockSize(format);
+    }
+
+
+    bool EncodeBC(const BCEncodeInfo& info, const uint8_t* pRGBA8, uint32_t width, uint32_t height, std::vector<uint8_t>& outData)
+    {
+        CORE_ASSERT(pRGBA8 != nullptr);
+        CORE_ASSERT(width > 0 && height > 0);
+        CORE_ASSERT(info.channels[0] < RGBA8_TEXEL_SIZE && info.channels[1] < RGBA8_TEXEL_SIZE);
+
+        const uint32_t blockSize = GetBCBlockSize(info.format);
+
+        if (blockSize == 0) {
+            CORE_ASSERT_FAIL("Unsupported BC encoding format: %u", static_cast<uint32_t>(info.format));
+            return false;
+        }
+
+        InitBCEncoders();
+
+        bc7enc_compress_block_params bc7Params = {};
+        bc7enc_compress_block_params_init(&bc7Params);
+
+        if (!info.isPerceptual) {
+            bc7enc_compress_block_params_init_linear_weights(&bc7Params);
+        }
+
+        const uint32_t blockCountX = (width + BC_BLOCK_EXTENT - 1) / BC_BLOCK_EXTENT;
+        const uint32_t blockCountY = (height + BC_BLOCK_EXTENT - 1) / BC_BLOCK_EXTENT;
+
+        outData.resize(CalcBCEncodedSize(info.format, width, height));
+
+        std::array<uint8_t, BC_BLOCK_EXTENT * BC_BLOCK_EXTENT * RGBA8_TEXEL_SIZE> texels = {};
+
+        for (uint32_t blockY = 0; blockY < blockCountY; ++blockY) {
+            for (uint32_t blockX = 0; blockX < blockCountX; ++blockX) {
+                for (uint32_t y = 0; y < BC_BLOCK_EXTENT; ++y) {
+                    const uint32_t srcY = std::min(blockY * BC_BLOCK_EXTENT + y, height - 1);
+
+                    for (uint32_t x = 0; x < BC_BLOCK_EXTENT; ++x) {
+                        const uint32_t srcX = std::min(blockX * BC_BLOCK_EXTENT + x, width - 1);
+
+                        memcpy(&texels[(y * BC_BLOCK_EXTENT + x) * RGBA8_TEXEL_SIZE], pRGBA8 + (size_t(srcY) * width + srcX) * RGBA8_TEXEL_SIZE, 
+                            RGBA8_TEXEL_SIZE);
+                    }
+                }
+
+                uint8_t* pBlock = outData.data() + (size_t(blockY) * blockCountX + blockX) * blockSize;
+
+                switch (info.format) {
+                    case VK_FORMAT_BC4_UNORM_BLOCK:
+                        rgbcx::encode_bc4(pBlock, texels.data() + info.channels[0], RGBA8_TEXEL_SIZE);
+                        break;
+                    case VK_FORMAT_BC5_UNORM_BLOCK:
+                        rgbcx::encode_bc5(pBlock, texels.data(), info.channels[0], info.channels[1], RGBA8_TEXEL_SIZE);
+                        break;
+                    default:
+                        bc7enc_compress_block(pBlock, texels.data(), &bc7Params);
+                        break;
+                }
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "core/core.h"
+
+#include "render/core/vulkan/vk_core.h"
+
+#include <array>
+#include <vector>
+
+
+namespace eng
+{
+    struct BCEncodeInfo
+    {
+        VkFormat format = VK_FORMAT_BC7_UNORM_BLOCK;
+
+        // Source channels which are encoded into BC4 (only the first one) and BC5 channels
+        std::array<uint32_t, 2> channels = { 0, 1 };
+
+        // BC7 only. Color data should use perceptual error metric, other data is encoded with linear one
+        bool isPerceptual = true;
+    };
+
+
+    // Size of encoded data in bytes. Returns 0 if format isn't supported by encoder
+    size_t CalcBCEncodedSize(VkFormat format, uint32_t width, uint32_t height);
+
+    // Encodes tightly packed RGBA8 image into BC4, BC5 or BC7 blocks. Image size doesn't have to be multiple of 4,
+    // edge texels are replicated into incomplete blocks
+    bool EncodeBC(const BCEncodeInfo& info, const uint8_t* pRGBA8, uint32_t width, uint32_t height, std::vector<uint8_t>& outData);
+}
@@ -0,0 +1,310 @@
+#include "pch.h"
+
+#include "ktx2.h"
+
+
+namespace eng
+{
+    static constexpr std::array<uint8_t, 12> KTX2_IDENTIFIER = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    static constexpr uint32_t KTX2_DFD_VERSION = 2;
+    static constexpr uint32_t KTX2_DFD_PRIMARIES_BT709 = 1;
+    static constexpr uint32_t KTX2_DFD_TRANSFER_LINEAR = 1;
+    static constexpr uint32_t KTX2_DFD_TRANSFER_SRGB = 2;
+
+
+    struct KTX2Header
+    {
+        std::array<uint8_t, 12> identifier;
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+
+    static_assert(sizeof(KTX2Header) == 80);
+
+
+    struct KTX2LevelIndex
+    {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+
+    // Data format descriptor parameters of supported block compressed formats
+    struct KTX2BlockFormatDesc
+    {
+        uint32_t colorModel;
+        uint32_t transfer;
+        uint32_t blockSize;
+        uint32_t sampleCount;
+        std::array<uint32_t, 2> sampleChannels;
+    };
+
+
+    static bool GetBlockFormatDesc(VkFormat format, KTX2BlockFormatDesc& outDesc)
+    {
+        // KHR_DF_MODEL_BC4, KHR_DF_MODEL_BC5, KHR_DF_MODEL_BC7 from Khronos Data Format Specification
+        switch (format) {
+            case VK_FORMAT_BC4_UNORM_BLOCK: outDesc = { 131, KTX2_DFD_TRANSFER_LINEAR, 8, 1, { 0, 0 } }; return true;
+            case VK_FORMAT_BC5_UNORM_BLOCK: outDesc = { 132, KTX2_DFD_TRANSFER_LINEAR, 16, 2, { 0, 1 } }; return true;
+            case VK_FORMAT_BC7_UNORM_BLOCK: outDesc = { 134, KTX2_DFD_TRANSFER_LINEAR, 16, 1, { 0, 0 } }; return true;
+            case VK_FORMAT_BC7_SRGB_BLOCK:  outDesc = { 134, KTX2_DFD_TRANSFER_SRGB, 16, 1, { 0, 0 } }; return true;
+            default: return false;
+        }
+    }
+
+
+    static size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+
+    static size_t CalcBlockMipDataSize(const KTX2BlockFormatDesc& desc, uint32_t width, uint32_t height, uint32_t mip)
+    {
+        const size_t mipWidth = std::max(width >> mip, 1u);
+        const size_t mipHeight = std::max(height >> mip, 1u);
+
+        return (AlignUp(mipWidth, 4) / 4) * (AlignUp(mipHeight, 4) / 4) * desc.blockSize;
+    }
+
+
+    template <typename T>
+    static void AppendData(std::vector<uint8_t>& data, const T& value)
+    {
+        const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(&value);
+        data.insert(data.end(), pBytes, pBytes + sizeof(T));
+    }
+
+
+    bool KTX2Texture::Parse(std::span<const uint8_t> data)
+    {
+        Reset();
+
+        if (data.size() < sizeof(KTX2Header)) {
+            return false;
+        }
+
+        KTX2Header header = {};
+        memcpy(&header, data.data(), sizeof(header));
+
+        if (header.identifier != KTX2_IDENTIFIER || header.supercompressionScheme != 0) {
+            return false;
+        }
+
+        if (header.vkFormat == VK_FORMAT_UNDEFINED || header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth != 0 ||
+            header.layerCount > 1 || header.faceCount != 1 || header.levelCount == 0
+        ) {
+            return false;
+        }
+
+        const size_t levelIndexSize = size_t(header.levelCount) * sizeof(KTX2LevelIndex);
+
+        if (levelIndexSize > data.size() - sizeof(KTX2Header)) {
+            return false;
+        }
+
+        if (header.kvdByteOffset > data.size() || header.kvdByteLength > data.size() - header.kvdByteOffset) {
+            return false;
+        }
+
+        KTX2BlockFormatDesc formatDesc = {};
+        const bool isKnownFormat = GetBlockFormatDesc(static_cast<VkFormat>(header.vkFormat), formatDesc);
+
+        m_mips.resize(header.levelCount);
+
+        for (uint32_t mip = 0; mip < header.levelCount; ++mip) {
+            KTX2LevelIndex level = {};
+            memcpy(&level, data.data() + sizeof(KTX2Header) + mip * sizeof(KTX2LevelIndex), sizeof(level));
+
+            const bool isInvalidLevel = level.byteLength == 0 || level.byteOffset > data.size() || level.byteLength > data.size() - level.byteOffset;
+            const bool isInvalidSize = isKnownFormat && level.byteLength != CalcBlockMipDataSize(formatDesc, header.pixelWidth, header.pixelHeight, mip);
+
+            if (isInvalidLevel || isInvalidSize) {
+                m_mips.clear();
+                return false;
+            }
+
+            m_mips[mip] = data.subspan(level.byteOffset, level.byteLength);
+        }
+
+        m_keyValueData = data.subspan(header.kvdByteOffset, header.kvdByteLength);
+
+        m_format = static_cast<VkFormat>(header.vkFormat);
+        m_width = header.pixelWidth;
+        m_height = header.pixelHeight;
+
+        return true;
+    }
+
+
+    void KTX2Texture::Reset()
+    {
+        m_keyValueData = {};
+        m_mips.clear();
+
+        m_format = VK_FORMAT_UNDEFINED;
+
+        m_width = 0;
+        m_height = 0;
+    }
+
+
+    void KTX2Texture::Write(std::vector<uint8_t>& outData, VkFormat format, uint32_t width, uint32_t height,
+        std::span<const std::span<const uint8_t>> mips, std::span<const KeyValue> keyValues)
+    {
+        CORE_ASSERT(!mips.empty());
+
+        outData.clear();
+
+        KTX2BlockFormatDesc formatDesc = {};
+
+        if (!GetBlockFormatDesc(format, formatDesc)) {
+            CORE_ASSERT_FAIL("Unsupported KTX2 format: %u", static_cast<uint32_t>(format));
+            return;
+        }
+
+        // Data format descriptor: total size, basic descriptor block header and one sample per compressed channel
+        const uint32_t dfdBlockSize = 24 + 16 * formatDesc.sampleCount;
+        const uint32_t dfdSize = 4 + dfdBlockSize;
+
+        std::vector<uint8_t> dfd;
+        dfd.reserve(dfdSize);
+
+        AppendData(dfd, dfdSize);
+        AppendData(dfd, uint32_t(0));
+        AppendData(dfd, KTX2_DFD_VERSION | (dfdBlockSize << 16));
+        AppendData(dfd, formatDesc.colorModel | (KTX2_DFD_PRIMARIES_BT709 << 8) | (formatDesc.transfer << 16));
+        AppendData(dfd, uint32_t(3 | (3 << 8))); // 4x4 texel block, dimensions are stored minus one
+        AppendData(dfd, formatDesc.blockSize);
+        AppendData(dfd, uint32_t(0));
+
+        const uint32_t sampleBitLength = formatDesc.blockSize * 8 / formatDesc.sampleCount;
+
+        for (uint32_t i = 0; i < formatDesc.sampleCount; ++i) {
+            AppendData(dfd, (i * sampleBitLength) | ((sampleBitLength - 1) << 16) | (formatDesc.sampleChannels[i] << 24));
+            AppendData(dfd, uint32_t(0));
+            AppendData(dfd, uint32_t(0));
+            AppendData(dfd, UINT32_MAX);
+        }
+
+        // Keys must be sorted, values are written with null terminator
+        std::vector<KeyValue> sortedKeyValues(keyValues.begin(), keyValues.end());
+        std::sort(sortedKeyValues.begin(), sortedKeyValues.end(), [](const KeyValue& l, const KeyValue& r) { return l.key < r.key; });
+
+        std::vector<uint8_t> kvd;
+
+        for (const KeyValue& kv : sortedKeyValues) {
+            AppendData(kvd, static_cast<uint32_t>(kv.key.size() + kv.value.size() + 2));
+
+            kvd.insert(kvd.end(), kv.key.begin(), kv.key.end());
+            kvd.push_back(0);
+            kvd.insert(kvd.end(), kv.value.begin(), kv.value.end());
+            kvd.push_back(0);
+
+            kvd.resize(AlignUp(kvd.size(), 4));
+        }
+
+        KTX2Header header = {};
+        header.identifier = KTX2_IDENTIFIER;
+        header.vkFormat = format;
+        header.typeSize = 1;
+        header.pixelWidth = width;
+        header.pixelHeight = height;
+        header.levelCount = static_cast<uint32_t>(mips.size());
+        header.faceCount = 1;
+        header.dfdByteOffset = static_cast<uint32_t>(sizeof(KTX2Header) + mips.size() * sizeof(KTX2LevelIndex));
+        header.dfdByteLength = dfdSize;
+        header.kvdByteOffset = kvd.empty() ? 0 : header.dfdByteOffset + dfdSize;
+        header.kvdByteLength = static_cast<uint32_t>(kvd.size());
+
+        std::vector<KTX2LevelIndex> levels(mips.size());
+
+        // Mips are stored from the smallest to the largest one, each is aligned to the texel block size
+        size_t dataSize = header.dfdByteOffset + dfdSize + kvd.size();
+
+        for (size_t i = mips.size(); i-- > 0;) {
+            CORE_ASSERT(mips[i].size() == CalcBlockMipDataSize(formatDesc, width, height, static_cast<uint32_t>(i)));
+
+            dataSize = AlignUp(dataSize, formatDesc.blockSize);
+
+            levels[i].byteOffset = dataSize;
+            levels[i].byteLength = mips[i].size();
+            levels[i].uncompressedByteLength = mips[i].size();
+
+            dataSize += mips[i].size();
+        }
+
+        outData.resize(dataSize);
+
+        uint8_t* pData = outData.data();
+
+        memcpy(pData, &header, sizeof(header));
+        memcpy(pData + sizeof(header), levels.data(), levels.size() * sizeof(KTX2LevelIndex));
+        memcpy(pData + header.dfdByteOffset, dfd.data(), dfd.size());
+
+        if (!kvd.empty()) {
+            memcpy(pData + header.kvdByteOffset, kvd.data(), kvd.size());
+        }
+
+        for (size_t i = 0; i < mips.size(); ++i) {
+            memcpy(pData + levels[i].byteOffset, mips[i].data(), mips[i].size());
+        }
+    }
+
+
+    std::string_view KTX2Texture::FindValue(std::string_view key) const
+    {
+        size_t offset = 0;
+
+        while (offset + sizeof(uint32_t) <= m_keyValueData.size()) {
+            uint32_t entrySize = 0;
+            memcpy(&entrySize, m_keyValueData.data() + offset, sizeof(entrySize));
+
+            offset += sizeof(uint32_t);
+
+            if (entrySize > m_keyValueData.size() - offset) {
+                break;
+            }
+
+            const std::string_view entry(reinterpret_cast<const char*>(m_keyValueData.data() + offset), entrySize);
+            const size_t keyEnd = entry.find('\0');
+
+            if (keyEnd != std::string_view::npos && entry.substr(0, keyEnd) == key) {
+                std::string_view value = entry.substr(keyEnd + 1);
+
+                if (!value.empty() && value.back() == '\0') {
+                    value.remove_suffix(1);
+                }
+
+                return value;
+            }
+
+            offset += AlignUp(entrySize, 4);
+        }
+
+        return {};
+    }
+
+
+    std::span<const uint8_t> KTX2Texture::GetMipData(uint32_t mip) const
+    {
+        CORE_ASSERT(mip < m_mips.size());
+        return m_mips[mip];
+    }
+}
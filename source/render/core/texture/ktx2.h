@@ -0,0 +1,56 @@
+#pragma once
+
+#include "core/core.h"
+
+#include "render/core/vulkan/vk_core.h"
+
+#include <span>
+#include <vector>
+#include <string_view>
+
+
+namespace eng
+{
+    // Minimal KTX2 container support. Only 2D textures with single layer and face and without supercompression are supported,
+    // which is enough for offline compressed material textures
+    class KTX2Texture
+    {
+    public:
+        struct KeyValue
+        {
+            std::string_view key;
+            std::string_view value;
+        };
+
+    public:
+        // Data isn't copied, so it must outlive the texture. Returns false if container is invalid or unsupported
+        bool Parse(std::span<const uint8_t> data);
+        void Reset();
+
+        // Builds container with mips[i] as data of i-th mip level. Only BC4, BC5 and BC7 formats are supported
+        static void Write(std::vector<uint8_t>& outData, VkFormat format, uint32_t width, uint32_t height,
+            std::span<const std::span<const uint8_t>> mips, std::span<const KeyValue> keyValues = {});
+
+        // Returns empty string if key isn't found. Trailing null terminator isn't included into the value
+        std::string_view FindValue(std::string_view key) const;
+
+        std::span<const uint8_t> GetMipData(uint32_t mip) const;
+
+        VkFormat GetFormat() const { return m_format; }
+
+        uint32_t GetWidth() const { return m_width; }
+        uint32_t GetHeight() const { return m_height; }
+        uint32_t GetMipCount() const { return static_cast<uint32_t>(m_mips.size()); }
+
+        bool IsParsed() const { return m_format != VK_FORMAT_UNDEFINED; }
+
+    private:
+        std::span<const uint8_t> m_keyValueData;
+        std::vector<std::span<const uint8_t>> m_mips;
+
+        VkFormat m_format = VK_FORMAT_UNDEFINED;
+
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+    };
+}
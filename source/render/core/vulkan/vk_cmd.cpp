@@ -23,6 +23,15 @@ namespace vkn
     static PFN_vkCmdSetPolygonModeEXT vkCmdSetPolygonMode = nullptr;
 
 
+    // Loaded on pool creation rather than on the first use, since command buffers can be recorded from several threads
+    static void LoadExtensionFunctions(const Device& device)
+    {
+        vkCmdBindDescriptorBuffers = (PFN_vkCmdBindDescriptorBuffersEXT)device.GetProcAddr("vkCmdBindDescriptorBuffersEXT");
+        vkCmdSetDescriptorBufferOffsets = (PFN_vkCmdSetDescriptorBufferOffsetsEXT)device.GetProcAddr("vkCmdSetDescriptorBufferOffsetsEXT");
+        vkCmdSetPolygonMode = (PFN_vkCmdSetPolygonModeEXT)device.GetProcAddr("vkCmdSetPolygonModeEXT");
+    }
+
+
     static VkImageMemoryBarrier2 CreateImageMemoryBarrier2Data(
         VkImage image, 
         VkPipelineStageFlags2 srcStageMask, 
@@ -59,6 +68,133 @@ namespace vkn
     }
 
 
+    static bool IsQueueOwnershipAcquire(uint32_t srcQueueFamilyIndex, uint32_t dstQueueFamilyIndex, uint32_t cmdBufferQueueFamilyIndex)
+    {
+        return srcQueueFamilyIndex != dstQueueFamilyIndex && dstQueueFamilyIndex == cmdBufferQueueFamilyIndex;
+    }
+
+
+    static bool IsReadOnlyAccess(VkAccessFlags2 accessMask)
+    {
+        // Unknown bits are considered to be writes
+        constexpr VkAccessFlags2 READ_ACCESS_MASK = 
+            VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_INDEX_READ_BIT | VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT | 
+            VK_ACCESS_2_UNIFORM_READ_BIT | VK_ACCESS_2_INPUT_ATTACHMENT_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT | 
+            VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT | 
+            VK_ACCESS_2_HOST_READ_BIT | VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_SHADER_SAMPLED_READ_BIT | 
+            VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_DESCRIPTOR_BUFFER_READ_BIT_EXT;
+
+        return (accessMask & ~READ_ACCESS_MASK) == 0;
+    }
+
+
+    // Read after read in the same layout doesn't need barrier if the previous one already made data visible for requested stages
+    static bool IsAccessVisible(VkPipelineStageFlags2 currStageMask, VkAccessFlags2 currAccessMask, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask)
+    {
+        return IsReadOnlyAccess(currAccessMask) && IsReadOnlyAccess(dstAccessMask) 
+            && (dstStageMask & ~currStageMask) == 0 && (dstAccessMask & ~currAccessMask) == 0;
+    }
+
+
+    static bool IsTextureAccessVisible(const TextureAccessTracker& tracker, uint32_t baseMip, uint32_t mipCount, uint32_t baseLayer, uint32_t layerCount,
+        VkImageLayout dstLayout, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask)
+    {
+        for (uint32_t layer = baseLayer; layer < baseLayer + layerCount; ++layer) {
+            for (uint32_t mip = baseMip; mip < baseMip + mipCount; ++mip) {
+                const TextureAccessTracker::State& state = tracker.GetState(layer, mip);
+
+                if (state.layout != dstLayout || !IsAccessVisible(state.stageMask, state.accessMask, dstStageMask, dstAccessMask)) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+
+    static VkDeviceSize GetRangeEnd(VkDeviceSize offset, VkDeviceSize size)
+    {
+        return size == VK_WHOLE_SIZE ? UINT64_MAX : offset + size;
+    }
+
+
+    // VK_REMAINING_MIP_LEVELS and VK_REMAINING_ARRAY_LAYERS are the same value
+    static uint32_t GetRangeEnd(uint32_t base, uint32_t count)
+    {
+        return count == VK_REMAINING_MIP_LEVELS ? UINT32_MAX : base + count;
+    }
+
+
+    // Aspects are ignored, since tracker state is shared by all aspects of subresource
+    static bool IsOverlapped(const VkImageSubresourceRange& l, const VkImageSubresourceRange& r)
+    {
+        return l.baseMipLevel < GetRangeEnd(r.baseMipLevel, r.levelCount) && r.baseMipLevel < GetRangeEnd(l.baseMipLevel, l.levelCount)
+            && l.baseArrayLayer < GetRangeEnd(r.baseArrayLayer, r.layerCount) && r.baseArrayLayer < GetRangeEnd(l.baseArrayLayer, l.layerCount);
+    }
+
+
+    static bool IsSameRange(const VkImageSubresourceRange& l, const VkImageSubresourceRange& r)
+    {
+        return l.aspectMask == r.aspectMask && l.baseMipLevel == r.baseMipLevel && l.levelCount == r.levelCount 
+            && l.baseArrayLayer == r.baseArrayLayer && l.layerCount == r.layerCount;
+    }
+
+
+    // Extends l by r if they differ only by adjacent mips or layers
+    static bool TryCollapseRanges(VkImageSubresourceRange& l, const VkImageSubresourceRange& r)
+    {
+        if (l.aspectMask != r.aspectMask) {
+            return false;
+        }
+
+        auto TryCollapse = [](uint32_t& lBase, uint32_t& lCount, uint32_t rBase, uint32_t rCount) -> bool
+        {
+            if (lCount == VK_REMAINING_MIP_LEVELS || rCount == VK_REMAINING_MIP_LEVELS) {
+                return false;
+            }
+
+            if (lBase + lCount == rBase) {
+                lCount += rCount;
+                return true;
+            }
+            
+            if (rBase + rCount == lBase) {
+                lBase = rBase;
+                lCount += rCount;
+                return true;
+            }
+
+            return false;
+        };
+
+        if (l.baseArrayLayer == r.baseArrayLayer && l.layerCount == r.layerCount) {
+            return TryCollapse(l.baseMipLevel, l.levelCount, r.baseMipLevel, r.levelCount);
+        }
+
+        if (l.baseMipLevel == r.baseMipLevel && l.levelCount == r.levelCount) {
+            return TryCollapse(l.baseArrayLayer, l.layerCount, r.baseArrayLayer, r.layerCount);
+        }
+
+        return false;
+    }
+
+
+    // No commands are recorded after pending barrier, so its destination accesses didn't happen and can be replaced.
+    // Accesses in the same layout are combined, since both of them are expected after the barrier
+    static void MergeTextureBarrier(VkImageMemoryBarrier2& pending, VkImageLayout dstLayout, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask)
+    {
+        if (pending.newLayout == dstLayout) {
+            pending.dstStageMask |= dstStageMask;
+            pending.dstAccessMask |= dstAccessMask;
+        } else {
+            pending.newLayout = dstLayout;
+            pending.dstStageMask = dstStageMask;
+            pending.dstAccessMask = dstAccessMask;
+        }
+    }
+
+
     static VkRenderingAttachmentInfo RenderAttachmentInfoToVkRenderingAttachmentInfo(const RenderAttachmentInfo& info)
     {
         VkRenderingAttachmentInfo res = {};
@@ -196,6 +332,37 @@ namespace vkn
     }
 
 
+    BarrierList& BarrierList::AddBufferReleaseBarrier(Buffer& buffer, const Queue& dstQueue, VkDeviceSize offset, VkDeviceSize size)
+    {
+        VK_ASSERT_MSG(IsStarted(), "Attempt to add barrier in barrier list which wasn't started");
+        VK_ASSERT(buffer.IsCreated());
+
+        const uint32_t srcFamilyIndex = m_pCmdBufferOwner->GetOwnerPool().GetQueueFamilyIndex();
+        VK_ASSERT_MSG(srcFamilyIndex != dstQueue.GetFamilyIndex(), "Ownership release of buffer %s to the same queue family %u", 
+            buffer.GetDebugName().data(), srcFamilyIndex);
+
+        m_bufferBarriers.emplace_back(BufferBarrierData{ &buffer, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, offset, size, srcFamilyIndex, dstQueue.GetFamilyIndex() });
+
+        return *this;
+    }
+
+
+    BarrierList& BarrierList::AddBufferAcquireBarrier(Buffer& buffer, const Queue& srcQueue, VkPipelineStageFlags2 dstStageMask, 
+        VkAccessFlags2 dstAccessMask, VkDeviceSize offset, VkDeviceSize size
+    ) {
+        VK_ASSERT_MSG(IsStarted(), "Attempt to add barrier in barrier list which wasn't started");
+        VK_ASSERT(buffer.IsCreated());
+
+        const uint32_t dstFamilyIndex = m_pCmdBufferOwner->GetOwnerPool().GetQueueFamilyIndex();
+        VK_ASSERT_MSG(srcQueue.GetFamilyIndex() != dstFamilyIndex, "Ownership acquire of buffer %s from the same queue family %u", 
+            buffer.GetDebugName().data(), dstFamilyIndex);
+
+        m_bufferBarriers.emplace_back(BufferBarrierData{ &buffer, dstStageMask, dstAccessMask, offset, size, srcQueue.GetFamilyIndex(), dstFamilyIndex });
+
+        return *this;
+    }
+
+
     BarrierList& BarrierList::AddTextureBarrier(
         Texture& texture, 
         VkImageLayout dstLayout, 
@@ -226,6 +393,91 @@ namespace vkn
     }
 
 
+    BarrierList& BarrierList::AddTextureDiscardBarrier(
+        Texture& texture, 
+        VkPipelineStageFlags2 aliasedSrcStageMask, 
+        VkAccessFlags2 aliasedSrcAccessMask,
+        VkImageLayout dstLayout, 
+        VkPipelineStageFlags2 dstStageMask, 
+        VkAccessFlags2 dstAccessMask,
+        VkImageAspectFlags aspectMask, 
+        uint32_t baseMip, uint32_t mipCount, 
+        uint32_t baseLayer, uint32_t layerCount
+    ) {
+        AddTextureBarrier(texture, dstLayout, dstStageMask, dstAccessMask, aspectMask, baseMip, mipCount, baseLayer, layerCount);
+
+        TextureBarrierData& data = m_textureBarriers.back();
+        data.aliasedSrcStageMask = aliasedSrcStageMask;
+        data.aliasedSrcAccessMask = aliasedSrcAccessMask;
+        data.isDiscard = true;
+
+        return *this;
+    }
+
+
+    BarrierList& BarrierList::AddTextureReleaseBarrier(
+        Texture& texture, 
+        const Queue& dstQueue,
+        VkImageAspectFlags aspectMask, 
+        uint32_t baseMip, uint32_t mipCount, 
+        uint32_t baseLayer, uint32_t layerCount
+    ) {
+        VK_ASSERT_MSG(IsStarted(), "Attempt to add barrier in barrier list which wasn't started");
+        VK_ASSERT(texture.IsCreated());
+
+        const uint32_t srcFamilyIndex = m_pCmdBufferOwner->GetOwnerPool().GetQueueFamilyIndex();
+        VK_ASSERT_MSG(srcFamilyIndex != dstQueue.GetFamilyIndex(), "Ownership release of texture %s to the same queue family %u", 
+            texture.GetDebugName().data(), srcFamilyIndex);
+
+        mipCount = mipCount == VK_REMAINING_MIP_LEVELS ? texture.GetMipCount() : mipCount;
+        layerCount = layerCount == VK_REMAINING_ARRAY_LAYERS ? texture.GetLayerCount() : layerCount;
+
+        // Layout is kept, since release and acquire must specify the same transition and acquiring side doesn't know the source layout
+        const VkImageLayout layout = texture.GetAccessTracker().GetState(baseLayer, baseMip).layout;
+
+        m_textureBarriers.emplace_back(
+            TextureBarrierData{ 
+                layout, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, aspectMask, 
+                baseMip, mipCount, baseLayer, layerCount, &texture, srcFamilyIndex, dstQueue.GetFamilyIndex()
+            }
+        );
+
+        return *this;
+    }
+
+
+    BarrierList& BarrierList::AddTextureAcquireBarrier(
+        Texture& texture, 
+        const Queue& srcQueue,
+        VkPipelineStageFlags2 dstStageMask, 
+        VkAccessFlags2 dstAccessMask,
+        VkImageAspectFlags aspectMask, 
+        uint32_t baseMip, uint32_t mipCount, 
+        uint32_t baseLayer, uint32_t layerCount
+    ) {
+        VK_ASSERT_MSG(IsStarted(), "Attempt to add barrier in barrier list which wasn't started");
+        VK_ASSERT(texture.IsCreated());
+
+        const uint32_t dstFamilyIndex = m_pCmdBufferOwner->GetOwnerPool().GetQueueFamilyIndex();
+        VK_ASSERT_MSG(srcQueue.GetFamilyIndex() != dstFamilyIndex, "Ownership acquire of texture %s from the same queue family %u", 
+            texture.GetDebugName().data(), dstFamilyIndex);
+
+        mipCount = mipCount == VK_REMAINING_MIP_LEVELS ? texture.GetMipCount() : mipCount;
+        layerCount = layerCount == VK_REMAINING_ARRAY_LAYERS ? texture.GetLayerCount() : layerCount;
+
+        const VkImageLayout layout = texture.GetAccessTracker().GetState(baseLayer, baseMip).layout;
+
+        m_textureBarriers.emplace_back(
+            TextureBarrierData{ 
+                layout, dstStageMask, dstAccessMask, aspectMask, 
+                baseMip, mipCount, baseLayer, layerCount, &texture, srcQueue.GetFamilyIndex(), dstFamilyIndex
+            }
+        );
+
+        return *this;
+    }
+
+
     BarrierList& BarrierList::AddTextureBarrier(SCTexture& texture, VkImageLayout dstLayout, VkPipelineStageFlags2 dstStageMask,
         VkAccessFlags2 dstAccessMask, VkImageAspectFlags aspectMask
     ) {
@@ -308,11 +560,15 @@ namespace vkn
         }
 
         m_barrierList.Swap(cmdBuffer.m_barrierList);
+        std::swap(m_pendingBufferBarriers, cmdBuffer.m_pendingBufferBarriers);
+        std::swap(m_pendingTextureBarriers, cmdBuffer.m_pendingTextureBarriers);
+        std::swap(m_barrierStats, cmdBuffer.m_barrierStats);
 
         std::swap(m_pOwner, cmdBuffer.m_pOwner);
         std::swap(m_blitCache, cmdBuffer.m_blitCache);
         std::swap(m_bufImageCopyCache, cmdBuffer.m_bufImageCopyCache);
         std::swap(m_texSubresCache, cmdBuffer.m_texSubresCache);
+        std::swap(m_cmdBufferCache, cmdBuffer.m_cmdBufferCache);
         std::swap(m_pDescrBufferBindingCache, cmdBuffer.m_pDescrBufferBindingCache);
         std::swap(m_pPSOCache, cmdBuffer.m_pPSOCache);
         std::swap(m_pIndexBufferCache, cmdBuffer.m_pIndexBufferCache);
@@ -329,13 +585,23 @@ namespace vkn
         VK_ASSERT(IsValid());
         VK_ASSERT(!IsStarted());
 
+        // Secondary command buffer starts and ends its own rendering, so nothing is inherited
+        VkCommandBufferInheritanceInfo inheritanceInfo = {};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+
         VkCommandBufferBeginInfo beginInfo = {};
         beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
         beginInfo.flags = flags;
+        beginInfo.pInheritanceInfo = IsSecondary() ? &inheritanceInfo : nullptr;
 
         VK_CHECK(vkBeginCommandBuffer(Get(), &beginInfo));
 
         ResetCache();
+
+        m_pendingBufferBarriers.clear();
+        m_pendingTextureBarriers.clear();
+        m_barrierStats = {};
+
         m_state.set(FLAG_IS_STARTED, true);
 
         return *this;
@@ -347,6 +613,8 @@ namespace vkn
         VK_CHECK_CMD_BUFFER_STARTED(this);
         VK_ASSERT_MSG(!m_barrierList.IsStarted(), "Attempt to end command buffer with started buffer barrier list");
 
+        CmdFlushBarriers();
+
         VK_CHECK(vkEndCommandBuffer(Get()));
 
         m_state.set(FLAG_IS_STARTED, false);
@@ -360,6 +628,8 @@ namespace vkn
         VK_CHECK_CMD_BUFFER_STARTED(this);
         VK_ASSERT(firstQuery + queryCount <= queryPool.GetQueryCount());
 
+        CmdFlushBarriers();
+
         vkCmdResetQueryPool(Get(), queryPool.Get(), firstQuery, queryCount);
 
         return *this;
@@ -377,6 +647,8 @@ namespace vkn
         VK_CHECK_CMD_BUFFER_STARTED(this);
         VK_ASSERT(queryPool.IsQueryIndexValid(queryIndex));
 
+        CmdFlushBarriers();
+
         vkCmdWriteTimestamp2(Get(), stage, queryPool.Get(), queryIndex);
 
         return *this;
@@ -388,6 +660,8 @@ namespace vkn
         VK_CHECK_CMD_BUFFER_STARTED(this);
         VK_ASSERT(!IsRenderingStarted());
 
+        CmdFlushBarriers();
+
         VkRenderingInfo renderingInfo = {};
         renderingInfo.sType      = VK_STRUCTURE_TYPE_RENDERING_INFO;
         renderingInfo.pNext      = info.pNext;
@@ -433,6 +707,8 @@ namespace vkn
     {
         VK_CHECK_CMD_BUFFER_RENDERING_STARTED(this);
 
+        CmdFlushBarriers();
+
         vkCmdEndRendering(Get());
 
         m_state.set(FLAG_IS_RENDERING_STARTED, false);
@@ -527,10 +803,6 @@ namespace vkn
     {
         VK_CHECK_CMD_BUFFER_STARTED(this);
 
-        if (!vkCmdSetPolygonMode) {
-            vkCmdSetPolygonMode = (PFN_vkCmdSetPolygonModeEXT)GetDevice().GetProcAddr("vkCmdSetPolygonModeEXT");
-        }
-
         vkCmdSetPolygonMode(Get(), mode);
         
         return *this;
@@ -542,6 +814,8 @@ namespace vkn
         VK_CHECK_CMD_BUFFER_STARTED(this);
         VK_ASSERT(regions.size() >= 1);
 
+        CmdFlushBarriers();
+
         VkBlitImageInfo2 blitInfo = {};
         blitInfo.sType = VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2;
         blitInfo.srcImage = srcTexture.Get();
@@ -592,6 +866,8 @@ namespace vkn
     {
         VK_CHECK_CMD_BUFFER_STARTED(this);
 
+        CmdFlushBarriers();
+
         size = size == VK_WHOLE_SIZE ? buffer.GetMemorySize() : size;
         VK_ASSERT(offset + size <= buffer.GetMemorySize());
 
@@ -605,6 +881,8 @@ namespace vkn
     {
         VK_CHECK_CMD_BUFFER_STARTED(this);
 
+        CmdFlushBarriers();
+
         VK_ASSERT(!ranges.empty());
 
         m_texSubresCache.resize(ranges.size());
@@ -690,6 +968,8 @@ namespace vkn
         VK_CHECK_CMD_BUFFER_STARTED(this);
         VK_ASSERT(regions.size() >= 1);
 
+        CmdFlushBarriers();
+
     #ifdef ENG_BUILD_DEBUG
         const VkDeviceSize srcBuffSize = srcBuffer.GetMemorySize();
         const VkDeviceSize dstBuffSize = dstBuffer.GetMemorySize();
@@ -737,6 +1017,8 @@ namespace vkn
         VK_CHECK_CMD_BUFFER_STARTED(this);
         VK_ASSERT(regions.size() >= 1);
 
+        CmdFlushBarriers();
+
         VkCopyBufferToImageInfo2 copyInfo = {};
         copyInfo.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_TO_IMAGE_INFO_2;
         copyInfo.srcBuffer = srcBuffer.Get();
@@ -781,6 +1063,8 @@ namespace vkn
         VK_CHECK_CMD_BUFFER_STARTED(this);
         VK_ASSERT(regions.size() >= 1);
 
+        CmdFlushBarriers();
+
         const TextureAccessTracker& srcTracker = srcTexture.GetAccessTracker();
         const TextureAccessTracker& dstTracker = dstTexture.GetAccessTracker();
 
@@ -819,6 +1103,8 @@ namespace vkn
     {
         VK_CHECK_CMD_BUFFER_STARTED(this);
 
+        CmdFlushBarriers();
+
         vkCmdDispatch(Get(), groupCountX, groupCountY, groupCountZ);
 
         return *this;
@@ -829,6 +1115,8 @@ namespace vkn
     {
         VK_CHECK_CMD_BUFFER_STARTED(this);
 
+        CmdFlushBarriers();
+
         vkCmdDispatchIndirect(Get(), argBuffer.Get(), offset);
 
         return *this;
@@ -855,6 +1143,8 @@ namespace vkn
     {
         VK_CHECK_CMD_BUFFER_RENDERING_STARTED(this);
 
+        CmdFlushBarriers();
+
         vkCmdDraw(Get(), vertexCount, instanceCount, firstVertex, firstInstance);
 
         return *this;
@@ -865,6 +1155,8 @@ namespace vkn
     {
         VK_CHECK_CMD_BUFFER_RENDERING_STARTED(this);
 
+        CmdFlushBarriers();
+
         vkCmdDrawIndexed(Get(), indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
 
         return *this;
@@ -875,21 +1167,67 @@ namespace vkn
     {
         VK_CHECK_CMD_BUFFER_RENDERING_STARTED(this);
 
+        CmdFlushBarriers();
+
         vkCmdDrawIndexedIndirectCount(Get(), argBuffer.Get(), argBufferOffset, countBuffer.Get(), countBufferOffset, maxDrawCount, argStride);
 
         return *this;
     }
 
 
-    CmdBuffer& CmdBuffer::CmdBindDescriptorBuffer(DescriptorBuffer& buffer)
+    CmdBuffer& CmdBuffer::CmdExecuteCommands(std::span<CmdBuffer* const> cmdBuffers)
     {
         VK_CHECK_CMD_BUFFER_STARTED(this);
-        VK_ASSERT(buffer.IsCreated());
+        VK_ASSERT(!IsSecondary());
+        VK_ASSERT(cmdBuffers.size() >= 1);
+
+        CmdFlushBarriers();
+
+        m_cmdBufferCache.resize(cmdBuffers.size());
+
+        for (size_t i = 0; i < cmdBuffers.size(); ++i) {
+            const CmdBuffer* pCmdBuffer = cmdBuffers[i];
+
+            VK_ASSERT(pCmdBuffer && pCmdBuffer->IsSecondary());
+            VK_ASSERT_MSG(!pCmdBuffer->IsStarted(), "Secondary command buffer %s must be ended before execution", pCmdBuffer->GetDebugName().data());
+
+            m_cmdBufferCache[i] = pCmdBuffer->Get();
+
+            const BarrierStats& stats = pCmdBuffer->GetBarrierStats();
+
+            m_barrierStats.emittedBarrierCount += stats.emittedBarrierCount;
+            m_barrierStats.elidedBarrierCount += stats.elidedBarrierCount;
+            m_barrierStats.mergedBarrierCount += stats.mergedBarrierCount;
+            m_barrierStats.collapsedBarrierCount += stats.collapsedBarrierCount;
+            m_barrierStats.barrierCallCount += stats.barrierCallCount;
+        }
+
+        vkCmdExecuteCommands(Get(), static_cast<uint32_t>(m_cmdBufferCache.size()), m_cmdBufferCache.data());
+
+        // Bound state of primary command buffer is undefined after execution of secondary ones
+        m_pPSOCache = nullptr;
+        m_pIndexBufferCache = nullptr;
 
-        if (vkCmdBindDescriptorBuffers == nullptr) {
-            vkCmdBindDescriptorBuffers = (PFN_vkCmdBindDescriptorBuffersEXT)GetDevice().GetProcAddr("vkCmdBindDescriptorBuffersEXT");
+        if (m_pDescrBufferBindingCache != nullptr) {
+            CmdBindDescriptorBuffer(*m_pDescrBufferBindingCache);
         }
 
+        return *this;
+    }
+
+
+    CmdBuffer& CmdBuffer::CmdExecuteCommands(CmdBuffer& cmdBuffer)
+    {
+        CmdBuffer* pCmdBuffer = &cmdBuffer;
+        return CmdExecuteCommands(std::span(&pCmdBuffer, 1));
+    }
+
+
+    CmdBuffer& CmdBuffer::CmdBindDescriptorBuffer(DescriptorBuffer& buffer)
+    {
+        VK_CHECK_CMD_BUFFER_STARTED(this);
+        VK_ASSERT(buffer.IsCreated());
+
         m_pDescrBufferBindingCache = &buffer;
 
         VkDescriptorBufferBindingInfoEXT bindingInfo = {};
@@ -907,10 +1245,6 @@ namespace vkn
     {
         VK_CHECK_CMD_BUFFER_STARTED(this);
 
-        if (!vkCmdSetDescriptorBufferOffsets) {
-            vkCmdSetDescriptorBufferOffsets = (PFN_vkCmdSetDescriptorBufferOffsetsEXT)GetDevice().GetProcAddr("vkCmdSetDescriptorBufferOffsetsEXT");
-        }
-
         VK_ASSERT(pso.IsCreated());
         VK_ASSERT_MSG(m_pDescrBufferBindingCache != nullptr, "Call CmdBindDescriptorBuffer before CmdBindDescriptorBufferSet");
         VK_ASSERT(bindigInfo.elemIndex < m_pDescrBufferBindingCache->GetSetCount());
@@ -964,8 +1298,7 @@ namespace vkn
 
         VK_ASSERT_MSG(m_barrierList.IsStarted(), "Attempt to push buffer barrier list which wasn't started");
 
-        static std::vector<VkBufferMemoryBarrier2> bufferBarriers(m_barrierList.GetBufferBarriersCount());
-        bufferBarriers.clear();
+        const uint32_t queueFamilyIndex = GetOwnerPool().GetQueueFamilyIndex();
 
         for (size_t i = 0; i < m_barrierList.GetBufferBarriersCount(); ++i) {
             const BarrierList::BufferBarrierData& data = m_barrierList.GetBufferBarrierByIdx(i);
@@ -973,26 +1306,47 @@ namespace vkn
             BufferAccessTracker& tracker = data.pBuffer->GetAccessTracker();
             const BufferAccessTracker::State& state = tracker.GetState();
 
+            const bool isOwnershipTransfer = data.srcQueueFamilyIndex != data.dstQueueFamilyIndex;
+
+            const bool isInsideVisibleRange = state.offset <= data.offset && GetRangeEnd(data.offset, data.size) <= GetRangeEnd(state.offset, state.size);
+
+            if (!isOwnershipTransfer && isInsideVisibleRange && IsAccessVisible(state.stageMask, state.accessMask, data.dstStageMask, data.dstAccessMask)) {
+                ++m_barrierStats.elidedBarrierCount;
+                continue;
+            }
+
+            VkBufferMemoryBarrier2* pPending = FindMergeablePendingBarrier(data.pBuffer->Get(), data.offset, data.size, isOwnershipTransfer);
+
+            if (pPending) {
+                pPending->dstStageMask |= data.dstStageMask;
+                pPending->dstAccessMask |= data.dstAccessMask;
+
+                tracker.Transit(pPending->dstStageMask, pPending->dstAccessMask, data.offset, data.size);
+
+                ++m_barrierStats.mergedBarrierCount;
+                continue;
+            }
+
+            // Previous accesses of acquired resource belong to the other queue, they're synchronized by the release barrier and semaphore
+            const bool isAcquire = IsQueueOwnershipAcquire(data.srcQueueFamilyIndex, data.dstQueueFamilyIndex, queueFamilyIndex);
+
             VkBufferMemoryBarrier2 barrier = {};
             barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
             barrier.buffer = data.pBuffer->Get();
-            barrier.srcStageMask = state.stageMask;
-            barrier.srcAccessMask = state.accessMask;
+            barrier.srcStageMask = isAcquire ? VK_PIPELINE_STAGE_2_NONE : state.stageMask;
+            barrier.srcAccessMask = isAcquire ? VK_ACCESS_2_NONE : state.accessMask;
             barrier.dstStageMask = data.dstStageMask;
             barrier.dstAccessMask = data.dstAccessMask;
-            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.srcQueueFamilyIndex = data.srcQueueFamilyIndex;
+            barrier.dstQueueFamilyIndex = data.dstQueueFamilyIndex;
             barrier.offset = data.offset;
             barrier.size = data.size;
 
-            tracker.Transit(data.dstStageMask, data.dstAccessMask);
+            tracker.Transit(data.dstStageMask, data.dstAccessMask, data.offset, data.size);
 
-            bufferBarriers.emplace_back(barrier);
+            m_pendingBufferBarriers.emplace_back(barrier);
         }
 
-        static std::vector<VkImageMemoryBarrier2> textureBarriers(m_barrierList.GetTextureBarriersCount() + m_barrierList.GetSCTextureBarriersCount());
-        textureBarriers.clear();
-
         for (size_t i = 0; i < m_barrierList.GetTextureBarriersCount(); ++i) {
             const BarrierList::TextureBarrierData& data = m_barrierList.GetTextureBarrierByIdx(i);
 
@@ -1001,25 +1355,89 @@ namespace vkn
             TextureAccessTracker& accessTracker = pTexture->GetAccessTracker();
             accessTracker.CheckLayoutConsistency(data.baseLayer, data.layerCount, data.baseMip, data.mipCount);
 
+            const bool isOwnershipTransfer = data.srcQueueFamilyIndex != data.dstQueueFamilyIndex;
+
+            if (!isOwnershipTransfer && !data.isDiscard && IsTextureAccessVisible(accessTracker, data.baseMip, data.mipCount, data.baseLayer, 
+                data.layerCount, data.dstLayout, data.dstStageMask, data.dstAccessMask)
+            ) {
+                ++m_barrierStats.elidedBarrierCount;
+                continue;
+            }
+
+            VkImageSubresourceRange range = {};
+            range.aspectMask = data.dstAspectMask;
+            range.baseMipLevel = data.baseMip;
+            range.levelCount = data.mipCount;
+            range.baseArrayLayer = data.baseLayer;
+            range.layerCount = data.layerCount;
+
+            VkImageMemoryBarrier2* pPending = FindMergeablePendingBarrier(pTexture->Get(), range, isOwnershipTransfer);
+
+            if (pPending) {
+                pPending->srcStageMask |= data.aliasedSrcStageMask;
+                pPending->srcAccessMask |= data.aliasedSrcAccessMask;
+                pPending->oldLayout = data.isDiscard ? VK_IMAGE_LAYOUT_UNDEFINED : pPending->oldLayout;
+
+                MergeTextureBarrier(*pPending, data.dstLayout, data.dstStageMask, data.dstAccessMask);
+
+                accessTracker.Transit(data.baseMip, data.mipCount, data.baseLayer, data.layerCount, 
+                    pPending->newLayout, pPending->dstStageMask, pPending->dstAccessMask);
+
+                ++m_barrierStats.mergedBarrierCount;
+                continue;
+            }
+
             const TextureAccessTracker::State& currState = accessTracker.GetState(data.baseLayer, data.baseMip);
 
+            const bool isAcquire = IsQueueOwnershipAcquire(data.srcQueueFamilyIndex, data.dstQueueFamilyIndex, queueFamilyIndex);
+
+            // Discard must also wait for the last accesses of other resources which share texture memory
+            const VkPipelineStageFlags2 srcStageMask = currState.stageMask | data.aliasedSrcStageMask;
+            const VkAccessFlags2 srcAccessMask = currState.accessMask | data.aliasedSrcAccessMask;
+
             VkImageMemoryBarrier2 barrier = CreateImageMemoryBarrier2Data(
                 pTexture->Get(),
-                currState.stageMask, data.dstStageMask,
-                currState.accessMask, data.dstAccessMask,
-                currState.layout, data.dstLayout,
+                isAcquire ? VK_PIPELINE_STAGE_2_NONE : srcStageMask, data.dstStageMask,
+                isAcquire ? VK_ACCESS_2_NONE : srcAccessMask, data.dstAccessMask,
+                data.isDiscard ? VK_IMAGE_LAYOUT_UNDEFINED : currState.layout, data.dstLayout,
                 data.dstAspectMask, data.baseMip, data.mipCount, data.baseLayer, data.layerCount
             );
+            barrier.srcQueueFamilyIndex = data.srcQueueFamilyIndex;
+            barrier.dstQueueFamilyIndex = data.dstQueueFamilyIndex;
 
             accessTracker.Transit(data.baseMip, data.mipCount, data.baseLayer, data.layerCount, data.dstLayout, data.dstStageMask, data.dstAccessMask);
 
-            textureBarriers.emplace_back(barrier);
+            AddPendingBarrier(barrier);
         }
 
         for (size_t i = 0; i < m_barrierList.GetSCTextureBarriersCount(); ++i) {
             const BarrierList::SCTextureBarrierData& data = m_barrierList.GetSCTextureBarrierByIdx(i);
 
             TextureAccessTracker& tracker = data.pTexture->GetAccessTracker();
+
+            if (IsTextureAccessVisible(tracker, 0, 1, 0, 1, data.dstLayout, data.dstStageMask, data.dstAccessMask)) {
+                ++m_barrierStats.elidedBarrierCount;
+                continue;
+            }
+
+            VkImageSubresourceRange range = {};
+            range.aspectMask = data.dstAspectMask;
+            range.baseMipLevel = 0;
+            range.levelCount = VK_REMAINING_MIP_LEVELS;
+            range.baseArrayLayer = 0;
+            range.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+            VkImageMemoryBarrier2* pPending = FindMergeablePendingBarrier(data.pTexture->Get(), range, false);
+
+            if (pPending) {
+                MergeTextureBarrier(*pPending, data.dstLayout, data.dstStageMask, data.dstAccessMask);
+
+                tracker.Transit(0, 1, 0, 1, pPending->newLayout, pPending->dstStageMask, pPending->dstAccessMask);
+
+                ++m_barrierStats.mergedBarrierCount;
+                continue;
+            }
+
             const TextureAccessTracker::State& accessState = tracker.GetState(0, 0);
 
             VkImageMemoryBarrier2 barrier = CreateImageMemoryBarrier2Data(
@@ -1032,19 +1450,37 @@ namespace vkn
 
             tracker.Transit(0, 1, 0, 1, data.dstLayout, data.dstStageMask, data.dstAccessMask);
 
-            textureBarriers.emplace_back(barrier);
+            m_pendingTextureBarriers.emplace_back(barrier);
+        }
+
+        m_barrierList.End();
+
+        return *this;
+    }
+
+
+    CmdBuffer& CmdBuffer::CmdFlushBarriers()
+    {
+        VK_CHECK_CMD_BUFFER_STARTED(this);
+
+        if (m_pendingBufferBarriers.empty() && m_pendingTextureBarriers.empty()) {
+            return *this;
         }
 
         VkDependencyInfo dependencyInfo = {};
         dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
-        dependencyInfo.bufferMemoryBarrierCount = bufferBarriers.size();
-        dependencyInfo.pBufferMemoryBarriers = bufferBarriers.data();
-        dependencyInfo.imageMemoryBarrierCount = textureBarriers.size();
-        dependencyInfo.pImageMemoryBarriers = textureBarriers.data();
+        dependencyInfo.bufferMemoryBarrierCount = m_pendingBufferBarriers.size();
+        dependencyInfo.pBufferMemoryBarriers = m_pendingBufferBarriers.data();
+        dependencyInfo.imageMemoryBarrierCount = m_pendingTextureBarriers.size();
+        dependencyInfo.pImageMemoryBarriers = m_pendingTextureBarriers.data();
 
         vkCmdPipelineBarrier2(Get(), &dependencyInfo);
 
-        m_barrierList.End();
+        m_barrierStats.emittedBarrierCount += static_cast<uint32_t>(m_pendingBufferBarriers.size() + m_pendingTextureBarriers.size());
+        ++m_barrierStats.barrierCallCount;
+
+        m_pendingBufferBarriers.clear();
+        m_pendingTextureBarriers.clear();
 
         return *this;
     }
@@ -1086,6 +1522,13 @@ namespace vkn
     }
 
 
+    bool CmdBuffer::IsSecondary() const
+    {
+        VK_ASSERT(IsValid());
+        return m_state.test(FLAG_IS_SECONDARY);
+    }
+
+
     CmdBuffer::CmdBuffer(CmdPool* pOwnerPool, VkCommandBufferLevel level, ID id)
     {
         Allocate(pOwnerPool, level, id);
@@ -1122,6 +1565,8 @@ namespace vkn
         m_pOwner = pOwnerPool;
         m_ID = id;
 
+        m_state.set(FLAG_IS_SECONDARY, level == VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
         return *this;
     }
 
@@ -1133,10 +1578,14 @@ namespace vkn
         }
         
         m_barrierList = {};
+        m_pendingBufferBarriers = {};
+        m_pendingTextureBarriers = {};
+        m_barrierStats = {};
 
         m_blitCache = {};
         m_bufImageCopyCache = {};
         m_texSubresCache = {};
+        m_cmdBufferCache = {};
         m_pDescrBufferBindingCache = nullptr;
         m_pPSOCache = nullptr;
         m_pIndexBufferCache = nullptr;
@@ -1160,6 +1609,7 @@ namespace vkn
         m_blitCache.clear();
         m_bufImageCopyCache.clear();
         m_texSubresCache.clear();
+        m_cmdBufferCache.clear();
         m_pDescrBufferBindingCache = nullptr;
         m_pPSOCache = nullptr;
         m_pIndexBufferCache = nullptr;
@@ -1168,6 +1618,79 @@ namespace vkn
     }
 
 
+    // Buffer tracker keeps the state of the whole buffer, so the previous barrier of any range is a source of the new one
+    // and must be flushed, unless the range is the same
+    VkBufferMemoryBarrier2* CmdBuffer::FindMergeablePendingBarrier(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, bool isOwnershipTransfer)
+    {
+        auto it = std::ranges::find_if(m_pendingBufferBarriers, [buffer](const VkBufferMemoryBarrier2& barrier) { 
+            return barrier.buffer == buffer;
+        });
+
+        if (it == m_pendingBufferBarriers.end()) {
+            return nullptr;
+        }
+
+        const bool isPendingOwnershipTransfer = it->srcQueueFamilyIndex != it->dstQueueFamilyIndex;
+
+        if (!isOwnershipTransfer && !isPendingOwnershipTransfer && it->offset == offset && it->size == size) {
+            return &*it;
+        }
+
+        CmdFlushBarriers();
+
+        return nullptr;
+    }
+
+
+    // Pending barriers of one texture never overlap, so the first overlapped one is either the same range or conflicts
+    VkImageMemoryBarrier2* CmdBuffer::FindMergeablePendingBarrier(VkImage image, const VkImageSubresourceRange& range, bool isOwnershipTransfer)
+    {
+        auto it = std::ranges::find_if(m_pendingTextureBarriers, [image, &range](const VkImageMemoryBarrier2& barrier) {
+            return barrier.image == image && IsOverlapped(barrier.subresourceRange, range);
+        });
+
+        if (it == m_pendingTextureBarriers.end()) {
+            return nullptr;
+        }
+
+        const bool isPendingOwnershipTransfer = it->srcQueueFamilyIndex != it->dstQueueFamilyIndex;
+
+        if (!isOwnershipTransfer && !isPendingOwnershipTransfer && IsSameRange(it->subresourceRange, range)) {
+            return &*it;
+        }
+
+        CmdFlushBarriers();
+
+        return nullptr;
+    }
+
+
+    // Per mip or per layer transitions with the same source and destination are collapsed into ranged barrier
+    CmdBuffer& CmdBuffer::AddPendingBarrier(const VkImageMemoryBarrier2& barrier)
+    {
+        const bool isOwnershipTransfer = barrier.srcQueueFamilyIndex != barrier.dstQueueFamilyIndex;
+
+        if (!isOwnershipTransfer) {
+            for (VkImageMemoryBarrier2& pending : m_pendingTextureBarriers) {
+                const bool isSameTransition = pending.image == barrier.image 
+                    && pending.srcQueueFamilyIndex == barrier.srcQueueFamilyIndex && pending.dstQueueFamilyIndex == barrier.dstQueueFamilyIndex
+                    && pending.srcStageMask == barrier.srcStageMask && pending.srcAccessMask == barrier.srcAccessMask
+                    && pending.dstStageMask == barrier.dstStageMask && pending.dstAccessMask == barrier.dstAccessMask
+                    && pending.oldLayout == barrier.oldLayout && pending.newLayout == barrier.newLayout;
+
+                if (isSameTransition && TryCollapseRanges(pending.subresourceRange, barrier.subresourceRange)) {
+                    ++m_barrierStats.collapsedBarrierCount;
+                    return *this;
+                }
+            }
+        }
+
+        m_pendingTextureBarriers.emplace_back(barrier);
+
+        return *this;
+    }
+
+
     CmdPool::CmdPool(const CmdPoolCreateInfo& info)
     {
         Create(info);
@@ -1197,6 +1720,7 @@ namespace vkn
         }
 
         std::swap(m_pDevice, pool.m_pDevice);
+        std::swap(m_queueFamilyIndex, pool.m_queueFamilyIndex);
 
         std::swap(m_allocatedBuffers, pool.m_allocatedBuffers);
         std::swap(m_freeIds, pool.m_freeIds);
@@ -1232,6 +1756,9 @@ namespace vkn
         VK_ASSERT(IsCreated());
 
         m_pDevice = info.pDevice;
+        m_queueFamilyIndex = info.queueFamilyIndex;
+
+        LoadExtensionFunctions(*m_pDevice);
 
         m_allocatedBuffers.reserve(info.size);
         m_freeIds.reserve(info.size);
@@ -1255,6 +1782,7 @@ namespace vkn
         });
 
         m_pDevice = nullptr;
+        m_queueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
         return *this;
     }
@@ -40,6 +40,8 @@ namespace vkn
             VkAccessFlags2        dstAccessMask;
             VkDeviceSize          offset;
             VkDeviceSize          size;
+            uint32_t              srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            uint32_t              dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         };
 
         struct TextureBarrierDataBase
@@ -57,6 +59,12 @@ namespace vkn
             uint32_t baseLayer;
             uint32_t layerCount;
             Texture* pTexture;
+            uint32_t srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            uint32_t dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+            VkPipelineStageFlags2 aliasedSrcStageMask = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2        aliasedSrcAccessMask = VK_ACCESS_2_NONE;
+            bool                  isDiscard = false;
         };
 
         struct SCTextureBarrierData : TextureBarrierDataBase
@@ -79,6 +87,22 @@ namespace vkn
             VkDeviceSize offset = 0,
             VkDeviceSize size = VK_WHOLE_SIZE);
 
+        // Queue family ownership transfer. Release is recorded on the source queue, acquire is recorded on the destination one
+        // and must be ordered after release submission with semaphore
+        BarrierList& AddBufferReleaseBarrier(
+            Buffer& buffer,
+            const Queue& dstQueue,
+            VkDeviceSize offset = 0,
+            VkDeviceSize size = VK_WHOLE_SIZE);
+
+        BarrierList& AddBufferAcquireBarrier(
+            Buffer& buffer,
+            const Queue& srcQueue,
+            VkPipelineStageFlags2 dstStageMask,
+            VkAccessFlags2 dstAccessMask, 
+            VkDeviceSize offset = 0,
+            VkDeviceSize size = VK_WHOLE_SIZE);
+
         BarrierList& AddTextureBarrier(
             Texture& texture,
             VkImageLayout dstLayout,
@@ -90,6 +114,42 @@ namespace vkn
             uint32_t baseLayer = 0, 
             uint32_t layerCount = VK_REMAINING_ARRAY_LAYERS);
 
+        // Previous content is discarded. Memory of aliased texture is shared with other resources, their last accesses
+        // must be passed as aliasedSrcStageMask and aliasedSrcAccessMask
+        BarrierList& AddTextureDiscardBarrier(
+            Texture& texture,
+            VkPipelineStageFlags2 aliasedSrcStageMask,
+            VkAccessFlags2 aliasedSrcAccessMask,
+            VkImageLayout dstLayout,
+            VkPipelineStageFlags2 dstStageMask,
+            VkAccessFlags2 dstAccessMask, 
+            VkImageAspectFlags aspectMask, 
+            uint32_t baseMip = 0, 
+            uint32_t mipCount = VK_REMAINING_MIP_LEVELS,
+            uint32_t baseLayer = 0, 
+            uint32_t layerCount = VK_REMAINING_ARRAY_LAYERS);
+
+        // Texture layout isn't changed by ownership transfer, use regular barrier after acquire to transit it
+        BarrierList& AddTextureReleaseBarrier(
+            Texture& texture,
+            const Queue& dstQueue,
+            VkImageAspectFlags aspectMask, 
+            uint32_t baseMip = 0, 
+            uint32_t mipCount = VK_REMAINING_MIP_LEVELS,
+            uint32_t baseLayer = 0, 
+            uint32_t layerCount = VK_REMAINING_ARRAY_LAYERS);
+
+        BarrierList& AddTextureAcquireBarrier(
+            Texture& texture,
+            const Queue& srcQueue,
+            VkPipelineStageFlags2 dstStageMask,
+            VkAccessFlags2 dstAccessMask, 
+            VkImageAspectFlags aspectMask, 
+            uint32_t baseMip = 0, 
+            uint32_t mipCount = VK_REMAINING_MIP_LEVELS,
+            uint32_t baseLayer = 0, 
+            uint32_t layerCount = VK_REMAINING_ARRAY_LAYERS);
+
         BarrierList& AddTextureBarrier(
             SCTexture& texture,
             VkImageLayout dstLayout,
@@ -211,6 +271,15 @@ namespace vkn
     public:
         using Base = Handle<VkCommandBuffer>;
 
+        struct BarrierStats
+        {
+            uint32_t emittedBarrierCount = 0;
+            uint32_t elidedBarrierCount = 0;    // Tracker state already makes requested read access visible
+            uint32_t mergedBarrierCount = 0;    // Folded into pending barrier of the same range
+            uint32_t collapsedBarrierCount = 0; // Joined with pending barrier of adjacent mips or layers
+            uint32_t barrierCallCount = 0;
+        };
+
     public:
         ENG_DECL_CLASS_NO_COPIABLE(CmdBuffer);
 
@@ -286,16 +355,29 @@ namespace vkn
         CmdBuffer& CmdDrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance);
         CmdBuffer& CmdDrawIndexedIndirect(Buffer& argBuffer, VkDeviceSize argBufferOffset, Buffer& countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t argStride);
 
+        // Secondary command buffers must be ended. Their barrier stats are added to the stats of this one.
+        // Bound PSO and index buffer must be rebound after the call, descriptor buffer is rebound automatically
+        CmdBuffer& CmdExecuteCommands(std::span<CmdBuffer* const> cmdBuffers);
+        CmdBuffer& CmdExecuteCommands(CmdBuffer& cmdBuffer);
+
         BarrierList& GetBarrierList();
         BarrierList& BeginBarrierList();
         CmdBuffer& CmdPushBarrierList(); // Post list of barriers to command buffer
 
+        // Pushed barriers are kept pending and recorded with single vkCmdPipelineBarrier2 right before the next command.
+        // Must be called explicitly before recording of commands through raw handle
+        CmdBuffer& CmdFlushBarriers();
+
+        // Counted since the last Begin()
+        const BarrierStats& GetBarrierStats() const { return m_barrierStats; }
+
         Device& GetDevice() const;
 
         CmdPool& GetOwnerPool() const;
 
         bool IsStarted() const;
         bool IsRenderingStarted() const;
+        bool IsSecondary() const;
 
         bool IsValid() const;
 
@@ -304,6 +386,7 @@ namespace vkn
         {
             FLAG_IS_STARTED,
             FLAG_IS_RENDERING_STARTED,
+            FLAG_IS_SECONDARY,
             FLAG_COUNT,
         };
 
@@ -320,6 +403,13 @@ namespace vkn
 
         CmdBuffer& ResetCache();
 
+        // Returns pending barrier of the same range which new barrier can be merged into. Pending barriers which conflict with
+        // the new one are flushed, since barriers of single vkCmdPipelineBarrier2 aren't ordered between each other
+        VkBufferMemoryBarrier2* FindMergeablePendingBarrier(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, bool isOwnershipTransfer);
+        VkImageMemoryBarrier2* FindMergeablePendingBarrier(VkImage image, const VkImageSubresourceRange& range, bool isOwnershipTransfer);
+
+        CmdBuffer& AddPendingBarrier(const VkImageMemoryBarrier2& barrier);
+
         ID GetID() const { return m_ID; }
 
     private:
@@ -330,9 +420,15 @@ namespace vkn
 
         BarrierList m_barrierList;
 
+        std::vector<VkBufferMemoryBarrier2> m_pendingBufferBarriers;
+        std::vector<VkImageMemoryBarrier2> m_pendingTextureBarriers;
+
+        BarrierStats m_barrierStats = {};
+
         std::vector<VkImageBlit2> m_blitCache;
         std::vector<VkBufferImageCopy2> m_bufImageCopyCache;
         std::vector<VkImageSubresourceRange> m_texSubresCache;
+        std::vector<VkCommandBuffer> m_cmdBufferCache;
         DescriptorBuffer* m_pDescrBufferBindingCache;
         PSO* m_pPSOCache;
         Buffer* m_pIndexBufferCache;
@@ -380,6 +476,8 @@ namespace vkn
 
         Device& GetDevice() const;
 
+        uint32_t GetQueueFamilyIndex() const { return m_queueFamilyIndex; }
+
     private:
         using BufferID = CmdBuffer::ID;
 
@@ -389,6 +487,7 @@ namespace vkn
 
     private:
         Device* m_pDevice = nullptr;
+        uint32_t m_queueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
         std::vector<CmdBuffer> m_allocatedBuffers;
         std::vector<BufferID> m_freeIds;
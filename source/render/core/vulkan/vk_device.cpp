@@ -41,34 +41,82 @@ namespace vkn
         std::span<QueueSyncData> waitSemaphores,
         std::span<QueueSyncData> signalSemaphores
     ) {
-        VK_ASSERT(IsCreated());
-        VK_ASSERT(!cmdBuffers.empty());
+        return Submit(cmdBuffers, pFinishFence, waitSemaphores, signalSemaphores, {}, {});
+    }
+
+
+    Queue& Queue::Submit(CmdBuffer& cmdBuffer, Fence* pFinishFence, QueueSyncData* pWaitSemaphore, QueueSyncData* pSignalSemaphore)
+    {
+        CmdBuffer* pCmdBuffer = &cmdBuffer;
         
-        m_waitSemaphoreCache.resize(waitSemaphores.size());
-        for (size_t i = 0; i < waitSemaphores.size(); ++i) {
-            const QueueSyncData& data = waitSemaphores[i];
-            VK_ASSERT(data.pSemaphore && data.pSemaphore->IsCreated());
+        return Submit(std::span(&pCmdBuffer, 1), pFinishFence, 
+            std::span(pWaitSemaphore, pWaitSemaphore ? 1 : 0), 
+            std::span(pSignalSemaphore, pSignalSemaphore ? 1 : 0)
+        );
+    }
 
-            VkSemaphoreSubmitInfo& waitSemaphoreInfo = m_waitSemaphoreCache[i];
-            waitSemaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-            waitSemaphoreInfo.semaphore = data.pSemaphore->Get();
-            waitSemaphoreInfo.value = 0;
-            waitSemaphoreInfo.stageMask = data.stage;
-            waitSemaphoreInfo.deviceIndex = 0;
-        }
 
-        m_signalSemaphoreCache.resize(signalSemaphores.size());
-        for (size_t i = 0; i < signalSemaphores.size(); ++i) {
-            const QueueSyncData& data = signalSemaphores[i];
+    Queue& Queue::Submit(std::span<CmdBuffer*> cmdBuffers, 
+        std::span<QueueTimelineSyncData> waitTimelines,
+        std::span<QueueTimelineSyncData> signalTimelines,
+        std::span<QueueSyncData> waitSemaphores,
+        std::span<QueueSyncData> signalSemaphores
+    ) {
+        return Submit(cmdBuffers, nullptr, waitSemaphores, signalSemaphores, waitTimelines, signalTimelines);
+    }
+
+
+    Queue& Queue::Submit(CmdBuffer& cmdBuffer, const QueueTimelineSyncData& signalTimeline, QueueSyncData* pWaitSemaphore, QueueSyncData* pSignalSemaphore)
+    {
+        CmdBuffer* pCmdBuffer = &cmdBuffer;
+        QueueTimelineSyncData signalData = signalTimeline;
+
+        return Submit(std::span(&pCmdBuffer, 1), {}, std::span(&signalData, 1), 
+            std::span(pWaitSemaphore, pWaitSemaphore ? 1 : 0), 
+            std::span(pSignalSemaphore, pSignalSemaphore ? 1 : 0)
+        );
+    }
+
+
+    template <typename SyncData>
+    static void FillSemaphoreSubmitInfos(std::span<SyncData> syncData, VkSemaphoreSubmitInfo* pInfos)
+    {
+        for (size_t i = 0; i < syncData.size(); ++i) {
+            const SyncData& data = syncData[i];
             VK_ASSERT(data.pSemaphore && data.pSemaphore->IsCreated());
 
-            VkSemaphoreSubmitInfo& signalSemaphoreInfo = m_signalSemaphoreCache[i];
-            signalSemaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-            signalSemaphoreInfo.semaphore = data.pSemaphore->Get();
-            signalSemaphoreInfo.value = 0;
-            signalSemaphoreInfo.stageMask = data.stage;
-            signalSemaphoreInfo.deviceIndex = 0;
+            VkSemaphoreSubmitInfo& semaphoreInfo = pInfos[i];
+            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            semaphoreInfo.semaphore = data.pSemaphore->Get();
+            semaphoreInfo.stageMask = data.stage;
+            semaphoreInfo.deviceIndex = 0;
+
+            if constexpr (std::is_same_v<SyncData, QueueTimelineSyncData>) {
+                semaphoreInfo.value = data.value;
+            } else {
+                semaphoreInfo.value = 0;
+            }
         }
+    }
+
+
+    Queue& Queue::Submit(std::span<CmdBuffer*> cmdBuffers, Fence* pFinishFence, 
+        std::span<QueueSyncData> waitSemaphores,
+        std::span<QueueSyncData> signalSemaphores,
+        std::span<QueueTimelineSyncData> waitTimelines,
+        std::span<QueueTimelineSyncData> signalTimelines
+    ) {
+        VK_ASSERT(IsCreated());
+        VK_ASSERT(!cmdBuffers.empty());
+        
+        // Binary and timeline semaphores share one array, value of binary ones is ignored
+        m_waitSemaphoreCache.resize(waitSemaphores.size() + waitTimelines.size());
+        FillSemaphoreSubmitInfos(waitSemaphores, m_waitSemaphoreCache.data());
+        FillSemaphoreSubmitInfos(waitTimelines, m_waitSemaphoreCache.data() + waitSemaphores.size());
+
+        m_signalSemaphoreCache.resize(signalSemaphores.size() + signalTimelines.size());
+        FillSemaphoreSubmitInfos(signalSemaphores, m_signalSemaphoreCache.data());
+        FillSemaphoreSubmitInfos(signalTimelines, m_signalSemaphoreCache.data() + signalSemaphores.size());
 
         m_cmdBuffCache.resize(cmdBuffers.size());
         for (size_t i = 0; i < cmdBuffers.size(); ++i) {
@@ -97,17 +145,6 @@ namespace vkn
     }
 
 
-    Queue& Queue::Submit(CmdBuffer& cmdBuffer, Fence* pFinishFence, QueueSyncData* pWaitSemaphore, QueueSyncData* pSignalSemaphore)
-    {
-        CmdBuffer* pCmdBuffer = &cmdBuffer;
-        
-        return Submit(std::span(&pCmdBuffer, 1), pFinishFence, 
-            std::span(pWaitSemaphore, pWaitSemaphore ? 1 : 0), 
-            std::span(pSignalSemaphore, pSignalSemaphore ? 1 : 0)
-        );
-    }
-
-
     VkResult Queue::Present(Swapchain& swapchain, uint32_t imageIndex, Semaphore* pWaitSemaphores)
     {
         return Present(swapchain, imageIndex, std::span(&pWaitSemaphores, pWaitSemaphores ? 1 : 0));
@@ -310,18 +347,56 @@ namespace vkn
 
         const uint32_t queueFamilyIndex = graphicsQueueFamilyIndex;
 
-        VkDeviceQueueCreateInfo queueCreateInfo = {};
-        queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-        queueCreateInfo.queueFamilyIndex = queueFamilyIndex;
-        queueCreateInfo.queueCount = 1;
-        queueCreateInfo.pQueuePriorities = &info.queuePriority;
+        // Dedicated queues don't need presentation support, so they're searched separately.
+        // Family without graphics and compute bits is usually backed by DMA engine which works in parallel with the main queue
+        uint32_t dedicatedTransferQueueFamilyIndex = UINT32_MAX;
+        uint32_t asyncComputeQueueFamilyIndex = UINT32_MAX;
+
+        for (uint32_t i = 0; i < queueFamilyProps.size(); ++i) {
+            const VkQueueFlags flags = queueFamilyProps[i].queueFlags;
+
+            if (i == queueFamilyIndex) {
+                continue;
+            }
+
+            if (!IsQueueFamilyIndexValid(dedicatedTransferQueueFamilyIndex) && 
+                (flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))
+            ) {
+                dedicatedTransferQueueFamilyIndex = i;
+            }
+
+            if (!IsQueueFamilyIndexValid(asyncComputeQueueFamilyIndex) && (flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+                asyncComputeQueueFamilyIndex = i;
+            }
+        }
+
+        std::array<VkDeviceQueueCreateInfo, 3> queueCreateInfos = {};
+        uint32_t queueCreateInfoCount = 0;
+
+        auto AddQueueCreateInfo = [&](uint32_t familyIndex) {
+            VkDeviceQueueCreateInfo& queueCreateInfo = queueCreateInfos[queueCreateInfoCount++];
+            queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queueCreateInfo.queueFamilyIndex = familyIndex;
+            queueCreateInfo.queueCount = 1;
+            queueCreateInfo.pQueuePriorities = &info.queuePriority;
+        };
+
+        AddQueueCreateInfo(queueFamilyIndex);
+
+        if (IsQueueFamilyIndexValid(dedicatedTransferQueueFamilyIndex)) {
+            AddQueueCreateInfo(dedicatedTransferQueueFamilyIndex);
+        }
+
+        if (IsQueueFamilyIndexValid(asyncComputeQueueFamilyIndex)) {
+            AddQueueCreateInfo(asyncComputeQueueFamilyIndex);
+        }
 
         VkDeviceCreateInfo deviceCreateInfo = {};
         deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
         deviceCreateInfo.pNext = info.pFeatures2;
         deviceCreateInfo.pEnabledFeatures = info.pFeatures;
-        deviceCreateInfo.queueCreateInfoCount = 1;
-        deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
+        deviceCreateInfo.queueCreateInfoCount = queueCreateInfoCount;
+        deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
         deviceCreateInfo.enabledExtensionCount = info.extensions.size();
         deviceCreateInfo.ppEnabledExtensionNames = info.extensions.empty() ? nullptr : info.extensions.data();
 
@@ -338,6 +413,20 @@ namespace vkn
 
         m_queue.SetDebugName("DEVICE_GFX_CMP_TRANSFER_QUEUE");
 
+        if (IsQueueFamilyIndexValid(dedicatedTransferQueueFamilyIndex)) {
+            vkGetDeviceQueue(Get(), dedicatedTransferQueueFamilyIndex, 0, &queue);
+            m_transferQueue.Create(this, queue, dedicatedTransferQueueFamilyIndex);
+            
+            m_transferQueue.SetDebugName("DEVICE_TRANSFER_QUEUE");
+        }
+
+        if (IsQueueFamilyIndexValid(asyncComputeQueueFamilyIndex)) {
+            vkGetDeviceQueue(Get(), asyncComputeQueueFamilyIndex, 0, &queue);
+            m_computeQueue.Create(this, queue, asyncComputeQueueFamilyIndex);
+            
+            m_computeQueue.SetDebugName("DEVICE_ASYNC_COMPUTE_QUEUE");
+        }
+
         return *this;
     }
 
@@ -350,6 +439,8 @@ namespace vkn
 
         m_pPhysDevice = VK_NULL_HANDLE;
         m_queue.Destroy();
+        m_transferQueue.Destroy();
+        m_computeQueue.Destroy();
 
         Base::Destroy([](VkDevice& device) {
             vkDestroyDevice(device, nullptr);
@@ -398,4 +489,44 @@ namespace vkn
         VK_ASSERT(IsCreated());
         return m_queue;
     }
+
+
+    const Queue& Device::GetTransferQueue() const
+    {
+        VK_ASSERT(IsCreated());
+        return HasDedicatedTransferQueue() ? m_transferQueue : m_queue;
+    }
+
+
+    Queue& Device::GetTransferQueue()
+    {
+        VK_ASSERT(IsCreated());
+        return HasDedicatedTransferQueue() ? m_transferQueue : m_queue;
+    }
+
+
+    const Queue& Device::GetComputeQueue() const
+    {
+        VK_ASSERT(IsCreated());
+        return HasAsyncComputeQueue() ? m_computeQueue : m_queue;
+    }
+
+
+    Queue& Device::GetComputeQueue()
+    {
+        VK_ASSERT(IsCreated());
+        return HasAsyncComputeQueue() ? m_computeQueue : m_queue;
+    }
+
+
+    bool Device::HasDedicatedTransferQueue() const
+    {
+        return m_transferQueue.IsCreated();
+    }
+
+
+    bool Device::HasAsyncComputeQueue() const
+    {
+        return m_computeQueue.IsCreated();
+    }
 }
\ No newline at end of file
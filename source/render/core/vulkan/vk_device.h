@@ -14,6 +14,7 @@ namespace vkn
     class CmdBuffer;
     class Fence;
     class Semaphore;
+    class TimelineSemaphore;
     class Swapchain;
 
 
@@ -24,6 +25,14 @@ namespace vkn
     };
 
 
+    struct QueueTimelineSyncData
+    {
+        TimelineSemaphore*    pSemaphore = nullptr;
+        uint64_t              value = 0;
+        VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_NONE;
+    };
+
+
     class Queue : public Handle<VkQueue>
     {
         friend class Device;
@@ -47,6 +56,19 @@ namespace vkn
             QueueSyncData* pSignalSemaphore = nullptr
         );
 
+        // Timeline semaphores wait for and signal values instead of fence. Binary semaphores can be used together with them, e.g. for swapchain
+        Queue& Submit(std::span<CmdBuffer*> cmdBuffers, 
+            std::span<QueueTimelineSyncData> waitTimelines, 
+            std::span<QueueTimelineSyncData> signalTimelines,
+            std::span<QueueSyncData> waitSemaphores = {}, 
+            std::span<QueueSyncData> signalSemaphores = {}
+        );
+
+        Queue& Submit(CmdBuffer& cmdBuffer, const QueueTimelineSyncData& signalTimeline, 
+            QueueSyncData* pWaitSemaphore = nullptr, 
+            QueueSyncData* pSignalSemaphore = nullptr
+        );
+
         VkResult Present(Swapchain& swapchain, uint32_t imageIndex, Semaphore* pWaitSemaphores);
         VkResult Present(Swapchain& swapchain, uint32_t imageIndex, std::span<Semaphore*> waitSemaphores = {});
 
@@ -63,6 +85,13 @@ namespace vkn
         Queue& Create(Device* pOwner, VkQueue queue, uint32_t familyIndex);
         Queue& Destroy();
 
+        Queue& Submit(std::span<CmdBuffer*> cmdBuffers, Fence* pFinishFence, 
+            std::span<QueueSyncData> waitSemaphores, 
+            std::span<QueueSyncData> signalSemaphores,
+            std::span<QueueTimelineSyncData> waitTimelines, 
+            std::span<QueueTimelineSyncData> signalTimelines
+        );
+
     private:
         Device* m_pOwner = nullptr;
 
@@ -125,12 +154,25 @@ namespace vkn
         const Queue& GetQueue() const;
         Queue& GetQueue();
 
+        // Return the main queue if device doesn't have dedicated one
+        const Queue& GetTransferQueue() const;
+        Queue& GetTransferQueue();
+
+        const Queue& GetComputeQueue() const;
+        Queue& GetComputeQueue();
+
+        bool HasDedicatedTransferQueue() const;
+        bool HasAsyncComputeQueue() const;
+
     private:
         Device() = default;
 
     private:
         PhysicalDevice* m_pPhysDevice = nullptr;
+        
         Queue m_queue;
+        Queue m_transferQueue;
+        Queue m_computeQueue;
     };
 
 
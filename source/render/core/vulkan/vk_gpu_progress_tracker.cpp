@@ -0,0 +1,102 @@
+#include "pch.h"
+
+#include "vk_gpu_progress_tracker.h"
+
+
+namespace vkn
+{
+    GPUProgressTracker::~GPUProgressTracker()
+    {
+        Destroy();
+    }
+
+
+    GPUProgressTracker& GPUProgressTracker::Create(Device* pDevice)
+    {
+        if (IsCreated()) {
+            VK_LOG_WARN("Recreation of GPU progress tracker %s", m_semaphore.GetDebugName().data());
+            Destroy();
+        }
+
+        m_semaphore.Create(pDevice, 0);
+        VK_ASSERT(m_semaphore.IsCreated());
+
+        m_submittedValue = 0;
+        m_completedValue = 0;
+
+        return *this;
+    }
+
+
+    GPUProgressTracker& GPUProgressTracker::Destroy()
+    {
+        m_semaphore.Destroy();
+
+        m_submittedValue = 0;
+        m_completedValue = 0;
+
+        return *this;
+    }
+
+
+    uint64_t GPUProgressTracker::AcquireSignalValue()
+    {
+        VK_ASSERT(IsCreated());
+        return ++m_submittedValue;
+    }
+
+
+    bool GPUProgressTracker::IsCompleted(uint64_t value)
+    {
+        VK_ASSERT(IsCreated());
+
+        if (value <= m_completedValue.load(std::memory_order_acquire)) {
+            return true;
+        }
+
+        return value <= GetCompletedValue();
+    }
+
+
+    uint64_t GPUProgressTracker::GetCompletedValue()
+    {
+        VK_ASSERT(IsCreated());
+
+        const uint64_t value = m_semaphore.GetValue();
+        UpdateCompletedValue(value);
+
+        return value;
+    }
+
+
+    GPUProgressTracker& GPUProgressTracker::WaitFor(uint64_t value, uint64_t timeout)
+    {
+        VK_ASSERT(IsCreated());
+        VK_ASSERT_MSG(value <= m_submittedValue, "Waiting for not submitted GPU progress value %llu (submitted: %llu)", value, m_submittedValue);
+
+        if (IsCompleted(value)) {
+            return *this;
+        }
+
+        m_semaphore.WaitFor(value, timeout);
+        UpdateCompletedValue(value);
+
+        return *this;
+    }
+
+
+    GPUProgressTracker& GPUProgressTracker::WaitIdle(uint64_t timeout)
+    {
+        return WaitFor(m_submittedValue, timeout);
+    }
+
+
+    // Several threads can query the semaphore at once, so cached value is only increased
+    void GPUProgressTracker::UpdateCompletedValue(uint64_t value)
+    {
+        uint64_t cachedValue = m_completedValue.load(std::memory_order_relaxed);
+
+        while (cachedValue < value && !m_completedValue.compare_exchange_weak(cachedValue, value, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+}
\ No newline at end of file
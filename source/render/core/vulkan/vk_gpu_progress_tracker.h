@@ -0,0 +1,51 @@
+#pragma once
+
+#include "vk_semaphore.h"
+
+#include <atomic>
+
+
+namespace vkn
+{
+    // Progress of GPU work submitted to a queue. Every tracked submission signals the next value of timeline semaphore, so subsystems
+    // keep value of their submission and check its completion later (e.g. before reuse or destruction of resources) without fence per submission.
+    // Completion queries can be done from any thread, values are acquired and submitted from the thread which submits to the queue
+    class GPUProgressTracker
+    {
+    public:
+        ENG_DECL_CLASS_NO_COPIABLE(GPUProgressTracker);
+        ENG_DECL_CLASS_NO_MOVABLE(GPUProgressTracker);
+
+        GPUProgressTracker() = default;
+        ~GPUProgressTracker();
+
+        GPUProgressTracker& Create(Device* pDevice);
+        GPUProgressTracker& Destroy();
+
+        // Value which must be signaled by the next submission. Submissions must signal acquired values in increasing order
+        uint64_t AcquireSignalValue();
+
+        bool IsCompleted(uint64_t value);
+        uint64_t GetCompletedValue();
+
+        GPUProgressTracker& WaitFor(uint64_t value, uint64_t timeout);
+        GPUProgressTracker& WaitIdle(uint64_t timeout);
+
+        // Value 0 is never signaled and is always complete, so it can be used as value of resource which wasn't submitted yet
+        uint64_t GetSubmittedValue() const { return m_submittedValue; }
+
+        TimelineSemaphore& GetSemaphore() { return m_semaphore; }
+
+        bool IsCreated() const { return m_semaphore.IsCreated(); }
+
+    private:
+        void UpdateCompletedValue(uint64_t value);
+
+    private:
+        TimelineSemaphore m_semaphore;
+
+        uint64_t m_submittedValue = 0;
+        // Cached value of the semaphore, so completion of already finished values is checked without driver call
+        std::atomic<uint64_t> m_completedValue = 0;
+    };
+}
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "vk_device.h"
 #include "vk_descriptor.h"
 
+#include "core/platform/file/file.h"
+
 
 namespace vkn
 {
@@ -380,6 +382,248 @@ namespace vkn
     }
 
 
+    // Header of on-disk cache file. Keys data by device and driver, since their pipeline cache data isn't compatible
+    struct PSOCacheFileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t dataSize;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t  pipelineCacheUUID[VK_UUID_SIZE];
+    };
+
+    static constexpr uint32_t PSO_CACHE_FILE_MAGIC = 0x43505345; // "ESPC"
+    static constexpr uint32_t PSO_CACHE_FILE_VERSION = 1;
+
+
+    static PSOCacheFileHeader MakePSOCacheFileHeader(const VkPhysicalDeviceProperties& props, size_t dataSize)
+    {
+        PSOCacheFileHeader header = {};
+        header.magic = PSO_CACHE_FILE_MAGIC;
+        header.version = PSO_CACHE_FILE_VERSION;
+        header.dataSize = dataSize;
+        header.vendorID = props.vendorID;
+        header.deviceID = props.deviceID;
+        header.driverVersion = props.driverVersion;
+        memcpy(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE);
+
+        return header;
+    }
+
+
+    // Returns span of cache data if file content is compatible with the device. Otherwise returns empty span
+    static std::span<const uint8_t> ValidatePSOCacheFileData(const VkPhysicalDeviceProperties& props, std::span<const uint8_t> fileData)
+    {
+        if (fileData.size() < sizeof(PSOCacheFileHeader)) {
+            VK_LOG_WARN("PSO cache file is too small: %zu bytes", fileData.size());
+            return {};
+        }
+
+        PSOCacheFileHeader header = {};
+        memcpy(&header, fileData.data(), sizeof(header));
+
+        if (header.magic != PSO_CACHE_FILE_MAGIC || header.version != PSO_CACHE_FILE_VERSION) {
+            VK_LOG_WARN("PSO cache file has invalid magic or version: %u", header.version);
+            return {};
+        }
+
+        if (header.dataSize != fileData.size() - sizeof(PSOCacheFileHeader)) {
+            VK_LOG_WARN("PSO cache file data size mismatch: %zu, expected: %zu", fileData.size() - sizeof(PSOCacheFileHeader), header.dataSize);
+            return {};
+        }
+
+        if (header.vendorID != props.vendorID || header.deviceID != props.deviceID || header.driverVersion != props.driverVersion ||
+            memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) != 0
+        ) {
+            VK_LOG_WARN("PSO cache file was created on another device or driver version");
+            return {};
+        }
+
+        const std::span<const uint8_t> data = fileData.subspan(sizeof(PSOCacheFileHeader));
+
+        // Data produced by the driver starts with its own header. It's checked as well, since file can be corrupted
+        VkPipelineCacheHeaderVersionOne dataHeader = {};
+
+        if (data.size() < sizeof(dataHeader)) {
+            VK_LOG_WARN("PSO cache data is too small: %zu bytes", data.size());
+            return {};
+        }
+
+        memcpy(&dataHeader, data.data(), sizeof(dataHeader));
+
+        if (dataHeader.headerSize < sizeof(dataHeader) || dataHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+            dataHeader.vendorID != props.vendorID || dataHeader.deviceID != props.deviceID ||
+            memcmp(dataHeader.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) != 0
+        ) {
+            VK_LOG_WARN("PSO cache data has invalid header");
+            return {};
+        }
+
+        return data;
+    }
+
+
+    PSOCache::PSOCache(Device* pDevice, const std::filesystem::path& filepath)
+    {
+        Create(pDevice, filepath);
+    }
+
+
+    PSOCache::~PSOCache()
+    {
+        Destroy();
+    }
+
+
+    PSOCache::PSOCache(PSOCache&& cache) noexcept
+    {
+        *this = std::move(cache);
+    }
+
+
+    PSOCache& PSOCache::operator=(PSOCache&& cache) noexcept
+    {
+        if (this == &cache) {
+            return *this;
+        }
+
+        if (IsCreated()) {
+            Destroy();
+        }
+
+        std::swap(m_pDevice, cache.m_pDevice);
+        std::swap(m_filepath, cache.m_filepath);
+
+        Base::operator=(std::move(cache));
+
+        return *this;
+    }
+
+
+    PSOCache& PSOCache::Create(Device* pDevice, const std::filesystem::path& filepath)
+    {
+        if (IsCreated()) {
+            VK_LOG_WARN("Recreation of PSO cache %s", GetDebugName().data());
+            Destroy();
+        }
+
+        VK_ASSERT(pDevice && pDevice->IsCreated());
+
+        const VkPhysicalDeviceProperties& props = pDevice->GetPhysDevice().GetProperties().properties;
+
+        std::vector<uint8_t> fileData;
+        std::span<const uint8_t> initialData = {};
+
+        if (eng::ReadFile(fileData, filepath)) {
+            initialData = ValidatePSOCacheFileData(props, fileData);
+
+            if (initialData.empty()) {
+                VK_LOG_WARN("PSO cache file %s is discarded", filepath.string().c_str());
+            }
+        }
+
+        VkPipelineCacheCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.initialDataSize = initialData.size();
+        createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+        Base::Create([pDevice, &createInfo](VkPipelineCache& cache) {
+            VK_CHECK(vkCreatePipelineCache(pDevice->Get(), &createInfo, nullptr, &cache));
+            return cache != VK_NULL_HANDLE;
+        });
+
+        VK_ASSERT(IsCreated());
+
+        m_pDevice = pDevice;
+        m_filepath = filepath;
+
+        return *this;
+    }
+
+
+    PSOCache& PSOCache::Destroy()
+    {
+        if (!IsCreated()) {
+            return *this;
+        }
+
+        Base::Destroy([pDevice = m_pDevice](VkPipelineCache& cache) {
+            vkDestroyPipelineCache(pDevice->Get(), cache, nullptr);
+        });
+
+        m_pDevice = nullptr;
+        m_filepath.clear();
+
+        return *this;
+    }
+
+
+    bool PSOCache::Save() const
+    {
+        VK_ASSERT(IsCreated());
+
+        VkDevice vkDevice = m_pDevice->Get();
+
+        size_t dataSize = 0;
+        VK_CHECK(vkGetPipelineCacheData(vkDevice, Get(), &dataSize, nullptr));
+
+        if (dataSize == 0) {
+            return false;
+        }
+
+        std::vector<uint8_t> data(dataSize);
+        VK_CHECK(vkGetPipelineCacheData(vkDevice, Get(), &dataSize, data.data()));
+
+        const PSOCacheFileHeader header = MakePSOCacheFileHeader(m_pDevice->GetPhysDevice().GetProperties().properties, dataSize);
+
+        // Data is written to temporary file first, so crash during writing doesn't leave corrupted cache
+        std::filesystem::path tmpFilepath = m_filepath;
+        tmpFilepath += ".tmp";
+
+        std::ofstream file(tmpFilepath, std::ios::binary | std::ios::trunc);
+
+        if (!file.is_open()) {
+            VK_LOG_WARN("Failed to open PSO cache file %s for writing", tmpFilepath.string().c_str());
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), dataSize);
+        file.close();
+
+        if (file.fail()) {
+            VK_LOG_WARN("Failed to write PSO cache file %s", tmpFilepath.string().c_str());
+            return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tmpFilepath, m_filepath, error);
+
+        if (error) {
+            VK_LOG_WARN("Failed to replace PSO cache file %s: %s", m_filepath.string().c_str(), error.message().c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+
+    Device& PSOCache::GetDevice() const
+    {
+        VK_ASSERT(IsCreated());
+        return *m_pDevice;
+    }
+
+
+    const std::filesystem::path& PSOCache::GetFilepath() const
+    {
+        VK_ASSERT(IsCreated());
+        return m_filepath;
+    }
+
+
     GraphicsPSOBuilder& GraphicsPSOBuilder::Reset()
     {
         m_vertexInputState = {};
@@ -431,6 +675,15 @@ namespace vkn
     }
 
 
+    GraphicsPSOBuilder& GraphicsPSOBuilder::SetCache(PSOCache* pCache)
+    {
+        VK_ASSERT(pCache == nullptr || pCache->IsCreated());
+
+        m_pCache = pCache;
+        return *this;
+    }
+
+
     GraphicsPSOBuilder& GraphicsPSOBuilder::SetLayout(PSOLayout& layout)
     {
         m_pLayout = &layout;
@@ -652,12 +905,17 @@ namespace vkn
     PSO GraphicsPSOBuilder::Build()
     {
         CORE_ASSERT_MSG(m_pLayout && m_pLayout->IsCreated(), "Graphics PSO layout is invalid");
-        CORE_ASSERT_MSG(
-            !m_colorAttachmentFormats.empty() || 
+
+        // Attachmentless PSO makes sense only if its fragment shader writes results into storage resources
+        const bool hasAttachments = !m_colorAttachmentFormats.empty() || 
             m_renderingCreateInfo.depthAttachmentFormat != VK_FORMAT_UNDEFINED || 
-            m_renderingCreateInfo.stencilAttachmentFormat != VK_FORMAT_UNDEFINED,
-            "There is no format set for any of the graphics PSO attachments"
-        );
+            m_renderingCreateInfo.stencilAttachmentFormat != VK_FORMAT_UNDEFINED;
+
+        const bool hasFragmentShader = std::any_of(m_shaderStages.cbegin(), m_shaderStages.cend(), [](const VkPipelineShaderStageCreateInfo& stage) {
+            return stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT;
+        });
+
+        CORE_ASSERT_MSG(hasAttachments || hasFragmentShader, "There is no format set for any of the graphics PSO attachments and there is no fragment shader");
 
         VkGraphicsPipelineCreateInfo psoCreateInfo = {};
         psoCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -714,7 +972,9 @@ namespace vkn
         psoCreateInfo.layout = m_pLayout->Get();
 
         VkPipeline pso = VK_NULL_HANDLE;
-        VK_CHECK(vkCreateGraphicsPipelines(GetDevice().Get(), VK_NULL_HANDLE, 1, &psoCreateInfo, nullptr, &pso));
+        VkPipelineCache cache = m_pCache ? m_pCache->Get() : VK_NULL_HANDLE;
+
+        VK_CHECK(vkCreateGraphicsPipelines(GetDevice().Get(), cache, 1, &psoCreateInfo, nullptr, &pso));
         VK_ASSERT(pso != VK_NULL_HANDLE);
 
         PSO::State state = {};
@@ -743,6 +1003,15 @@ namespace vkn
     }
 
 
+    ComputePSOBuilder& ComputePSOBuilder::SetCache(PSOCache* pCache)
+    {
+        VK_ASSERT(pCache == nullptr || pCache->IsCreated());
+
+        m_pCache = pCache;
+        return *this;
+    }
+
+
     ComputePSOBuilder& ComputePSOBuilder::SetLayout(PSOLayout& layout)
     {
         VK_ASSERT(layout.IsCreated());
@@ -773,7 +1042,9 @@ namespace vkn
         CORE_ASSERT(m_pLayout && m_pLayout->IsCreated());
 
         VkPipeline pso = VK_NULL_HANDLE;
-        VK_CHECK(vkCreateComputePipelines(GetDevice().Get(), VK_NULL_HANDLE, 1, &m_createInfo, nullptr, &pso));
+        VkPipelineCache cache = m_pCache ? m_pCache->Get() : VK_NULL_HANDLE;
+
+        VK_CHECK(vkCreateComputePipelines(GetDevice().Get(), cache, 1, &m_createInfo, nullptr, &pso));
         VK_ASSERT(pso != VK_NULL_HANDLE);
 
         PSO::State state = {};
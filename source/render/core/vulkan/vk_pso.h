@@ -129,6 +129,41 @@ namespace vkn
     };
 
 
+    // Pipeline cache which is loaded from and serialized to disk. File data is validated against the device it was created on,
+    // so stale cache after driver or GPU change is discarded instead of being passed to the driver
+    class PSOCache : public Handle<VkPipelineCache>
+    {
+    public:
+        using Base = Handle<VkPipelineCache>;
+
+    public:
+        ENG_DECL_CLASS_NO_COPIABLE(PSOCache);
+
+        PSOCache() = default;
+        PSOCache(Device* pDevice, const std::filesystem::path& filepath);
+
+        ~PSOCache();
+
+        PSOCache(PSOCache&& cache) noexcept;
+        PSOCache& operator=(PSOCache&& cache) noexcept;
+
+        PSOCache& Create(Device* pDevice, const std::filesystem::path& filepath);
+        PSOCache& Destroy();
+
+        // Writes cache data to the file it was created with. Returns false if data couldn't be retrieved or written
+        bool Save() const;
+
+        Device& GetDevice() const;
+
+        const std::filesystem::path& GetFilepath() const;
+
+    private:
+        Device* m_pDevice = nullptr;
+
+        std::filesystem::path m_filepath;
+    };
+
+
     class GraphicsPSOBuilder
     {
     public:
@@ -138,6 +173,9 @@ namespace vkn
 
         GraphicsPSOBuilder& SetFlags(VkPipelineCreateFlags flags);
 
+        // Cache isn't cleared by Reset(), so it's set once for all PSOs built with the builder
+        GraphicsPSOBuilder& SetCache(PSOCache* pCache);
+
         GraphicsPSOBuilder& SetLayout(PSOLayout& layout);
 
         GraphicsPSOBuilder& AddShader(vkn::Shader& shader);
@@ -205,6 +243,7 @@ namespace vkn
         VkPipelineColorBlendStateCreateInfo     m_colorBlendState = {};
         VkPipelineRenderingCreateInfo           m_renderingCreateInfo = {};
         PSOLayout*                              m_pLayout = nullptr;
+        PSOCache*                               m_pCache = nullptr;
         VkPipelineCreateFlags                   m_flags = {};
         std::vector<VkViewport>                 m_viewports = {};
         std::vector<VkRect2D>                   m_scissors = {};
@@ -223,6 +262,8 @@ namespace vkn
         ComputePSOBuilder& Reset();
 
         ComputePSOBuilder& SetFlags(VkPipelineCreateFlags flags);
+        // Cache isn't cleared by Reset(), so it's set once for all PSOs built with the builder
+        ComputePSOBuilder& SetCache(PSOCache* pCache);
         ComputePSOBuilder& SetLayout(PSOLayout& layout);
         ComputePSOBuilder& SetShader(Shader& shader);
 
@@ -231,5 +272,6 @@ namespace vkn
     private:
         VkComputePipelineCreateInfo m_createInfo = {};
         PSOLayout* m_pLayout = nullptr;
+        PSOCache* m_pCache = nullptr;
     };
 }
\ No newline at end of file
@@ -19,22 +19,22 @@ namespace vkn
     
     void BufferAccessTracker::Create()
     {
-        m_accessState.stageMask = VK_PIPELINE_STAGE_2_NONE;
-        m_accessState.accessMask = VK_ACCESS_2_NONE;
+        m_accessState = {};
     }
 
     
     void BufferAccessTracker::Destroy()
     {
-        m_accessState.stageMask = VK_PIPELINE_STAGE_2_NONE;
-        m_accessState.accessMask = VK_ACCESS_2_NONE;
+        m_accessState = {};
     }
 
 
-    void BufferAccessTracker::Transit(VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask)
+    void BufferAccessTracker::Transit(VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask, VkDeviceSize offset, VkDeviceSize size)
     {
         m_accessState.stageMask = dstStageMask;
         m_accessState.accessMask = dstAccessMask;
+        m_accessState.offset = offset;
+        m_accessState.size = size;
     }
 
     
@@ -16,6 +16,10 @@ namespace vkn
 
             VkPipelineStageFlags2 stageMask = VK_PIPELINE_STAGE_2_NONE;
             VkAccessFlags2        accessMask = VK_ACCESS_2_NONE;
+
+            // Range of the last transition. Accesses are made visible only inside it
+            VkDeviceSize offset = 0;
+            VkDeviceSize size = VK_WHOLE_SIZE;
         };
 
     public:
@@ -25,7 +29,7 @@ namespace vkn
         void Create();
         void Destroy();
 
-        void Transit(VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask);
+        void Transit(VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
 
         const State& GetState() const;
 
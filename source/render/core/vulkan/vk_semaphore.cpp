@@ -105,4 +105,136 @@ namespace vkn
         VK_ASSERT(IsCreated());
         return *m_pDevice;
     }
+
+
+    TimelineSemaphore::~TimelineSemaphore()
+    {
+        Destroy();
+    }
+
+
+    TimelineSemaphore::TimelineSemaphore(Device* pDevice, uint64_t initialValue)
+    {
+        Create(pDevice, initialValue);
+    }
+
+
+    TimelineSemaphore::TimelineSemaphore(TimelineSemaphore&& semaphore) noexcept
+    {
+        *this = std::move(semaphore);
+    }
+
+
+    TimelineSemaphore& TimelineSemaphore::operator=(TimelineSemaphore&& semaphore) noexcept
+    {
+        if (this == &semaphore) {
+            return *this;
+        }
+
+        if (IsCreated()) {
+            Destroy();
+        }
+
+        std::swap(m_pDevice, semaphore.m_pDevice);
+        
+        Base::operator=(std::move(semaphore));
+
+        return *this; 
+    }
+
+
+    TimelineSemaphore& TimelineSemaphore::Create(Device* pDevice, uint64_t initialValue)
+    {
+        if (IsCreated()) {
+            VK_LOG_WARN("Recreation of timeline semaphore %s", GetDebugName().data());
+            Destroy();
+        }
+
+        VK_ASSERT(pDevice && pDevice->IsCreated());
+
+        VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo = {};
+        semaphoreTypeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        semaphoreTypeCreateInfo.initialValue = initialValue;
+
+        VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
+
+        Base::Create([vkDevice = pDevice->Get(), &semaphoreCreateInfo](VkSemaphore& semaphore) {
+            VK_CHECK(vkCreateSemaphore(vkDevice, &semaphoreCreateInfo, nullptr, &semaphore));
+            return semaphore != VK_NULL_HANDLE;
+        });
+        
+        VK_ASSERT(IsCreated());
+
+        m_pDevice = pDevice;
+
+        return *this;
+    }
+
+
+    TimelineSemaphore& TimelineSemaphore::Destroy()
+    {
+        if (!IsCreated()) {
+            return *this;
+        }
+
+        Base::Destroy([device = m_pDevice->Get()](VkSemaphore& semaphore) {
+            vkDestroySemaphore(device, semaphore, nullptr);
+        });
+
+        m_pDevice = nullptr;
+
+        return *this;
+    }
+
+
+    TimelineSemaphore& TimelineSemaphore::Signal(uint64_t value)
+    {
+        VK_ASSERT(IsCreated());
+
+        VkSemaphoreSignalInfo signalInfo = {};
+        signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+        signalInfo.semaphore = Get();
+        signalInfo.value = value;
+
+        VK_CHECK(vkSignalSemaphore(m_pDevice->Get(), &signalInfo));
+
+        return *this;
+    }
+
+
+    TimelineSemaphore& TimelineSemaphore::WaitFor(uint64_t value, uint64_t timeout)
+    {
+        VK_ASSERT(IsCreated());
+
+        VkSemaphoreWaitInfo waitInfo = {};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &Get();
+        waitInfo.pValues = &value;
+
+        VK_CHECK(vkWaitSemaphores(m_pDevice->Get(), &waitInfo, timeout));
+
+        return *this;
+    }
+
+
+    uint64_t TimelineSemaphore::GetValue() const
+    {
+        VK_ASSERT(IsCreated());
+
+        uint64_t value = 0;
+        VK_CHECK(vkGetSemaphoreCounterValue(m_pDevice->Get(), Get(), &value));
+
+        return value;
+    }
+
+
+    Device& TimelineSemaphore::GetDevice() const
+    {
+        VK_ASSERT(IsCreated());
+        return *m_pDevice;
+    }
 }
\ No newline at end of file
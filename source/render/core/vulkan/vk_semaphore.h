@@ -39,4 +39,37 @@ namespace vkn
     private:
         Device* m_pDevice = nullptr;
     };
+
+
+    // Semaphore with monotonically increasing 64-bit value. Queue submissions wait for and signal specific values,
+    // so one semaphore replaces fence and binary semaphore per submission. Value can also be waited and signaled from host
+    class TimelineSemaphore : public Handle<VkSemaphore>
+    {
+    public:
+        using Base = Handle<VkSemaphore>;
+
+    public:
+        ENG_DECL_CLASS_NO_COPIABLE(TimelineSemaphore);
+
+        TimelineSemaphore() = default;
+        ~TimelineSemaphore();
+
+        TimelineSemaphore(Device* pDevice, uint64_t initialValue = 0);
+
+        TimelineSemaphore(TimelineSemaphore&& semaphore) noexcept;
+        TimelineSemaphore& operator=(TimelineSemaphore&& semaphore) noexcept;
+
+        TimelineSemaphore& Create(Device* pDevice, uint64_t initialValue = 0);
+        TimelineSemaphore& Destroy();
+
+        TimelineSemaphore& Signal(uint64_t value);
+        TimelineSemaphore& WaitFor(uint64_t value, uint64_t timeout);
+
+        uint64_t GetValue() const;
+
+        Device& GetDevice() const;
+
+    private:
+        Device* m_pDevice = nullptr;
+    };
 }
\ No newline at end of file
@@ -205,6 +205,31 @@ namespace vkn
     }
 
 
+    static VkImageCreateInfo GetImageCreateInfo(const TextureCreateInfo& info)
+    {
+        VK_ASSERT(info.mipLevels >= 1);
+        VK_ASSERT(info.arrayLayers >= 1);
+
+        VkImageCreateInfo ci = {};
+        ci.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        ci.flags = info.flags;
+        ci.imageType = info.type;
+        ci.format = info.format;
+        ci.extent = info.extent;
+        ci.mipLevels = info.mipLevels;
+        ci.arrayLayers = info.arrayLayers;
+        ci.samples = info.samples;
+        ci.tiling = info.tiling;
+        ci.usage = info.usage;
+        ci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        ci.queueFamilyIndexCount = 0;
+        ci.pQueueFamilyIndices = nullptr;
+        ci.initialLayout = info.initialLayout;
+
+        return ci;
+    }
+
+
     Texture::Texture(const TextureCreateInfo& info)
     {
         Create(info);
@@ -244,6 +269,8 @@ namespace vkn
 
         std::swap(m_accessTracker, image.m_accessTracker);
 
+        std::swap(m_isAliased, image.m_isAliased);
+
         std::swap(m_pDevice, image.m_pDevice);
 
         Base::operator=(std::move(image));
@@ -261,27 +288,9 @@ namespace vkn
 
         VK_ASSERT(info.pDevice && info.pDevice->IsCreated());
         VK_ASSERT(info.pAllocInfo);
-        VK_ASSERT(info.mipLevels >= 1);
-        VK_ASSERT(info.arrayLayers >= 1);
         VK_ASSERT(GetAllocator().IsCreated());
 
-        VkDevice vkDevice = info.pDevice->Get();
-
-        VkImageCreateInfo ci = {};
-        ci.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-        ci.flags = info.flags;
-        ci.imageType = info.type;
-        ci.format = info.format;
-        ci.extent = info.extent;
-        ci.mipLevels = info.mipLevels;
-        ci.arrayLayers = info.arrayLayers;
-        ci.samples = info.samples;
-        ci.tiling = info.tiling;
-        ci.usage = info.usage;
-        ci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        ci.queueFamilyIndexCount = 0;
-        ci.pQueueFamilyIndices = nullptr;
-        ci.initialLayout = info.initialLayout;
+        const VkImageCreateInfo ci = GetImageCreateInfo(info);
 
         VmaAllocationCreateInfo allocCI = {};
         allocCI.usage = info.pAllocInfo->usage;
@@ -295,32 +304,82 @@ namespace vkn
         VK_ASSERT_MSG(IsCreated(), "Failed to create Vulkan texture");
         VK_ASSERT_MSG(m_allocation != VK_NULL_HANDLE, "Failed to allocate Vulkan texture memory");
 
-        m_pDevice = info.pDevice;
+        InitState(info);
 
-        m_type = info.type;
-        m_extent = info.extent;
-        m_format = info.format;
-        m_mipCount = info.mipLevels;
-        m_layersCount = info.arrayLayers;
+        return *this;
+    }
 
-        m_accessTracker.Create(info.initialLayout, info.arrayLayers, info.mipLevels);
+
+    Texture& Texture::CreateAliased(const TextureCreateInfo& info, VmaAllocation allocation, VkDeviceSize allocationOffset)
+    {
+        if (IsCreated()) {
+            VK_LOG_WARN("Recreation of texture %s", GetDebugName().data());
+            Destroy();
+        }
+
+        VK_ASSERT(info.pDevice && info.pDevice->IsCreated());
+        VK_ASSERT(allocation != VK_NULL_HANDLE);
+        VK_ASSERT(GetAllocator().IsCreated());
+
+        const VkImageCreateInfo ci = GetImageCreateInfo(info);
+
+        Base::Create([&ci, allocation, allocationOffset](VkImage& dstImage) {
+            VK_CHECK(vmaCreateAliasingImage2(GetAllocator().Get(), allocation, allocationOffset, &ci, &dstImage));
+            return dstImage != VK_NULL_HANDLE;
+        });
+
+        VK_ASSERT_MSG(IsCreated(), "Failed to create aliased Vulkan texture");
+
+        // Allocation isn't owned, so only the texture memory range is kept
+        vmaGetAllocationInfo(GetAllocator().Get(), allocation, &m_allocInfo);
+        m_allocInfo.offset += allocationOffset;
+        m_allocInfo.size = GetMemoryRequirements(info).size;
+
+        m_isAliased = true;
+
+        InitState(info);
 
         return *this;
     }
 
 
+    VkMemoryRequirements Texture::GetMemoryRequirements(const TextureCreateInfo& info)
+    {
+        VK_ASSERT(info.pDevice && info.pDevice->IsCreated());
+
+        const VkImageCreateInfo ci = GetImageCreateInfo(info);
+
+        VkDeviceImageMemoryRequirements requirementsInfo = {};
+        requirementsInfo.sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS;
+        requirementsInfo.pCreateInfo = &ci;
+
+        VkMemoryRequirements2 requirements = {};
+        requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+
+        vkGetDeviceImageMemoryRequirements(info.pDevice->Get(), &requirementsInfo, &requirements);
+
+        return requirements.memoryRequirements;
+    }
+
+
     Texture& Texture::Destroy()
     {
         if (!IsCreated()) {
             return *this;
         }
 
-        Base::Destroy([&allocation = m_allocation](VkImage& image) {
-            vmaDestroyImage(GetAllocator().Get(), image, allocation);
+        Base::Destroy([&allocation = m_allocation, isAliased = m_isAliased, vkDevice = m_pDevice->Get()](VkImage& image) {
+            if (isAliased) {
+                vkDestroyImage(vkDevice, image, nullptr);
+            } else {
+                vmaDestroyImage(GetAllocator().Get(), image, allocation);
+            }
+            
             allocation = VK_NULL_HANDLE;
         });
 
         m_allocInfo = {};
+        m_isAliased = false;
 
         m_pDevice = nullptr;
 
@@ -336,6 +395,20 @@ namespace vkn
     }
 
 
+    void Texture::InitState(const TextureCreateInfo& info)
+    {
+        m_pDevice = info.pDevice;
+
+        m_type = info.type;
+        m_extent = info.extent;
+        m_format = info.format;
+        m_mipCount = info.mipLevels;
+        m_layersCount = info.arrayLayers;
+
+        m_accessTracker.Create(info.initialLayout, info.arrayLayers, info.mipLevels);
+    }
+
+
     TextureAccessTracker& Texture::GetAccessTracker()
     {
         VK_ASSERT(IsCreated());
@@ -118,8 +118,13 @@ namespace vkn
         Texture& operator=(Texture&& image) noexcept;
 
         Texture& Create(const TextureCreateInfo& info);
+        // Texture is placed into memory owned by someone else, e.g. heap shared by textures with non-overlapping lifetimes.
+        // info.pAllocInfo is ignored. Memory must outlive the texture
+        Texture& CreateAliased(const TextureCreateInfo& info, VmaAllocation allocation, VkDeviceSize allocationOffset);
         Texture& Destroy();
 
+        static VkMemoryRequirements GetMemoryRequirements(const TextureCreateInfo& info);
+
         // Check if mips from baseMip to baseMip + mipCount - 1 in layers from baseLayer to baseLayer + layerCount - 1 have same layout
         bool CheckLayoutConsistency(uint32_t baseLayer, uint32_t layerCount, uint32_t baseMip, uint32_t mipCount) const;
         // Check if mips from baseMip to baseMip + mipCount - 1 in layers from baseLayer to baseLayer + layerCount - 1 have same layout - "layout"
@@ -148,9 +153,13 @@ namespace vkn
         uint32_t GetSizeZ() const;
 
         const TextureAccessTracker& GetAccessTracker() const;
+
+        bool IsAliased() const { return m_isAliased; }
         
     private:
         TextureAccessTracker& GetAccessTracker();
+
+        void InitState(const TextureCreateInfo& info);
         
     private:
         Device* m_pDevice = nullptr;
@@ -166,6 +175,8 @@ namespace vkn
         uint32_t m_layersCount = 1;
  
         TextureAccessTracker m_accessTracker = {};
+
+        bool m_isAliased = false;
     };
 
 
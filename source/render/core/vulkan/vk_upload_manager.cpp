@@ -0,0 +1,528 @@
+#include "pch.h"
+
+#include "vk_upload_manager.h"
+#include "vk_utils.h"
+
+#include "core/engine/profiler/cpu_profiler.h"
+
+#include <numeric>
+
+
+namespace vkn
+{
+    static constexpr VkDeviceSize UPLOAD_COPY_OFFSET_ALIGNMENT = 16;
+    static constexpr uint64_t UPLOAD_WAIT_TIMEOUT = 10'000'000'000;
+
+
+    static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+
+    UploadManager::~UploadManager()
+    {
+        Destroy();
+    }
+
+
+    UploadManager& UploadManager::Create(const UploadManagerCreateInfo& info)
+    {
+        if (IsCreated()) {
+            VK_LOG_WARN("Recreation of upload manager");
+            Destroy();
+        }
+
+        VK_ASSERT(info.pDevice && info.pDevice->IsCreated());
+        VK_ASSERT(info.stagingBufferSize > 0);
+
+        m_pDevice = info.pDevice;
+        m_pQueue = info.pQueue ? info.pQueue : &m_pDevice->GetQueue();
+        m_pOwnerQueue = info.pOwnerQueue ? info.pOwnerQueue : m_pQueue;
+
+        CmdPoolCreateInfo cmdPoolCreateInfo = {};
+        cmdPoolCreateInfo.pDevice = m_pDevice;
+        cmdPoolCreateInfo.queueFamilyIndex = m_pQueue->GetFamilyIndex();
+        cmdPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        cmdPoolCreateInfo.size = BATCH_COUNT;
+
+        m_cmdPool.Create(cmdPoolCreateInfo);
+        VK_ASSERT(m_cmdPool.IsCreated());
+        m_pDevice->SetObjDebugName(m_cmdPool, "UPLOAD_CMD_POOL");
+
+        if (IsOwnershipTransferNeeded()) {
+            cmdPoolCreateInfo.queueFamilyIndex = m_pOwnerQueue->GetFamilyIndex();
+
+            m_ownerCmdPool.Create(cmdPoolCreateInfo);
+            VK_ASSERT(m_ownerCmdPool.IsCreated());
+            m_pDevice->SetObjDebugName(m_ownerCmdPool, "UPLOAD_OWNER_CMD_POOL");
+        }
+
+        for (uint32_t i = 0; i < BATCH_COUNT; ++i) {
+            Batch& batch = m_batches[i];
+
+            batch.pCmdBuffer = m_cmdPool.AllocCmdBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+            m_pDevice->SetObjDebugName(*batch.pCmdBuffer, "UPLOAD_CMD_BUFFER_%u", i);
+
+            if (IsOwnershipTransferNeeded()) {
+                batch.pOwnerCmdBuffer = m_ownerCmdPool.AllocCmdBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+                m_pDevice->SetObjDebugName(*batch.pOwnerCmdBuffer, "UPLOAD_OWNER_CMD_BUFFER_%u", i);
+            } else {
+                batch.pOwnerCmdBuffer = batch.pCmdBuffer;
+            }
+
+            batch.value = 0;
+            batch.ringEnd = 0;
+        }
+
+        if (IsOwnershipTransferNeeded()) {
+            m_copyFinishedSemaphore.Create(m_pDevice);
+            m_pDevice->SetObjDebugName(m_copyFinishedSemaphore, "UPLOAD_COPY_FINISHED_SEMAPHORE");
+        }
+
+        m_batchFinishedSemaphore.Create(m_pDevice);
+        m_pDevice->SetObjDebugName(m_batchFinishedSemaphore, "UPLOAD_BATCH_FINISHED_SEMAPHORE");
+
+        AllocationInfo stagingBufAllocInfo = {};
+        stagingBufAllocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        stagingBufAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+
+        m_stagingBuffer.Create(m_pDevice, info.stagingBufferSize, VK_BUFFER_USAGE_2_TRANSFER_SRC_BIT, stagingBufAllocInfo);
+        VK_ASSERT(m_stagingBuffer.IsCreated() && m_stagingBuffer.IsPersistentlyMapped());
+        m_pDevice->SetObjDebugName(m_stagingBuffer, "UPLOAD_STAGING_BUFFER");
+
+        m_pStagingData = static_cast<uint8_t*>(m_stagingBuffer.Map());
+
+        // Large resources are split into several chunks, so CPU can fill the next one while GPU copies the previous
+        m_maxChunkSize = std::max<VkDeviceSize>(info.stagingBufferSize / BATCH_COUNT, UPLOAD_COPY_OFFSET_ALIGNMENT);
+
+        m_head = 0;
+        m_tail = 0;
+
+        m_nextValue = 1;
+        m_completedValue = 0;
+
+        m_isBatchStarted = false;
+        m_isBatchAllocated = false;
+
+        return *this;
+    }
+
+
+    UploadManager& UploadManager::Destroy()
+    {
+        if (!IsCreated()) {
+            return *this;
+        }
+
+        WaitIdle();
+
+        m_pStagingData = nullptr;
+        m_stagingBuffer.Destroy();
+
+        for (Batch& batch : m_batches) {
+            if (IsOwnershipTransferNeeded()) {
+                m_ownerCmdPool.FreeCmdBuffer(*batch.pOwnerCmdBuffer);
+            }
+
+            m_cmdPool.FreeCmdBuffer(*batch.pCmdBuffer);
+            
+            batch.pCmdBuffer = nullptr;
+            batch.pOwnerCmdBuffer = nullptr;
+        }
+
+        m_uploadedBufferRanges.clear();
+        m_uploadedTextureSubresources.clear();
+
+        m_copyFinishedSemaphore.Destroy();
+        m_batchFinishedSemaphore.Destroy();
+
+        m_ownerCmdPool.Destroy();
+        m_cmdPool.Destroy();
+
+        m_pOwnerQueue = nullptr;
+        m_pQueue = nullptr;
+        m_pDevice = nullptr;
+
+        return *this;
+    }
+
+
+    UploadManager& UploadManager::UploadBuffer(Buffer& dstBuffer, const void* pData, VkDeviceSize size, VkDeviceSize dstOffset)
+    {
+        VK_ASSERT(IsCreated());
+        VK_ASSERT(pData != nullptr);
+        VK_ASSERT(dstOffset + size <= dstBuffer.GetMemorySize());
+
+        const uint8_t* pSrcData = static_cast<const uint8_t*>(pData);
+
+        // Makes tracked copies the source scope of the release or visibility barrier
+        GetCmdBuffer()
+            .BeginBarrierList()
+                .AddBufferBarrier(dstBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, dstOffset, size)
+            .Push();
+
+        for (VkDeviceSize copiedSize = 0; copiedSize < size;) {
+            const VkDeviceSize chunkSize = std::min(size - copiedSize, m_maxChunkSize);
+            const VkDeviceSize stagingOffset = Allocate(chunkSize, UPLOAD_COPY_OFFSET_ALIGNMENT);
+
+            memcpy(m_pStagingData + stagingOffset, pSrcData + copiedSize, chunkSize);
+
+            GetCmdBuffer().CmdCopyBuffer(m_stagingBuffer, dstBuffer, chunkSize, stagingOffset, dstOffset + copiedSize);
+
+            copiedSize += chunkSize;
+        }
+
+        if (IsOwnershipTransferNeeded()) {
+            // Copies of previous chunks could be submitted in previous batches, they're still covered by the release
+            // since it's ordered after them on the same queue
+            GetCmdBuffer()
+                .BeginBarrierList()
+                    .AddBufferReleaseBarrier(dstBuffer, *m_pOwnerQueue, dstOffset, size)
+                .Push();
+
+            GetOwnerCmdBuffer()
+                .BeginBarrierList()
+                    .AddBufferAcquireBarrier(dstBuffer, *m_pQueue, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT, dstOffset, size)
+                .Push();
+        } else {
+            AddUploadedBufferRange(dstBuffer, dstOffset, size);
+        }
+
+        return *this;
+    }
+
+
+    UploadManager& UploadManager::UploadTexture(Texture& dstTexture, const void* pData, VkDeviceSize size, uint32_t mip, uint32_t layer)
+    {
+        VK_ASSERT(IsCreated());
+        VK_ASSERT(pData != nullptr);
+        VK_ASSERT(mip < dstTexture.GetMipCount());
+        VK_ASSERT(layer < dstTexture.GetLayerCount());
+
+        const uint32_t width = std::max(dstTexture.GetSizeX() >> mip, 1u);
+        const uint32_t height = std::max(dstTexture.GetSizeY() >> mip, 1u);
+        const uint32_t depth = std::max(dstTexture.GetSizeZ() >> mip, 1u);
+
+        // Data of block compressed formats is split by rows of texel blocks instead of texel rows
+        const VkExtent2D blockExtent = utils::GetFormatBlockExtent(dstTexture.GetFormat());
+
+        const uint32_t blockCountX = (width + blockExtent.width - 1) / blockExtent.width;
+        const uint32_t blockCountY = (height + blockExtent.height - 1) / blockExtent.height;
+
+        // Rows of all depth slices are split in the same way, so only 2D subresources can be chunked
+        const uint32_t rowCount = blockCountY * depth;
+        VK_ASSERT_MSG(size % rowCount == 0, "Texture %s data size %llu is not multiple of its rows count %u",
+            dstTexture.GetDebugName().data(), size, rowCount);
+
+        const VkDeviceSize rowSize = size / rowCount;
+        VK_ASSERT_MSG(rowSize % blockCountX == 0, "Texture %s row size %llu is not multiple of its width in blocks %u",
+            dstTexture.GetDebugName().data(), rowSize, blockCountX);
+
+        const VkDeviceSize texelSize = rowSize / blockCountX;
+        const VkDeviceSize alignment = std::lcm(UPLOAD_COPY_OFFSET_ALIGNMENT, texelSize);
+
+        const uint32_t maxChunkRowCount = depth == 1 ? static_cast<uint32_t>(std::max<VkDeviceSize>(m_maxChunkSize / rowSize, 1)) : blockCountY;
+
+        const uint8_t* pSrcData = static_cast<const uint8_t*>(pData);
+
+        for (uint32_t firstRow = 0; firstRow < blockCountY;) {
+            const uint32_t chunkRowCount = std::min(blockCountY - firstRow, maxChunkRowCount);
+            const VkDeviceSize chunkSize = chunkRowCount * rowSize * depth;
+
+            const VkDeviceSize stagingOffset = Allocate(chunkSize, alignment);
+
+            memcpy(m_pStagingData + stagingOffset, pSrcData + firstRow * rowSize, chunkSize);
+
+            // Copy extent of the last chunk is clamped to the mip size, since it doesn't have to be multiple of block extent
+            const uint32_t firstTexelRow = firstRow * blockExtent.height;
+            const uint32_t chunkTexelRowCount = std::min(chunkRowCount * blockExtent.height, height - firstTexelRow);
+
+            BufferToTextureCopyInfo copyInfo = {};
+            copyInfo.bufOffset = stagingOffset;
+            copyInfo.texSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            copyInfo.texSubresource.mipLevel = mip;
+            copyInfo.texSubresource.baseArrayLayer = layer;
+            copyInfo.texSubresource.layerCount = 1;
+            copyInfo.texOffset = { 0, static_cast<int32_t>(firstTexelRow), 0 };
+            copyInfo.texExtent = { width, chunkTexelRowCount, depth };
+
+            GetCmdBuffer().CmdCopyBuffer(m_stagingBuffer, dstTexture, copyInfo);
+
+            firstRow += chunkRowCount;
+        }
+
+        if (IsOwnershipTransferNeeded()) {
+            GetCmdBuffer()
+                .BeginBarrierList()
+                    .AddTextureReleaseBarrier(dstTexture, *m_pOwnerQueue, VK_IMAGE_ASPECT_COLOR_BIT, mip, 1, layer, 1)
+                .Push();
+
+            GetOwnerCmdBuffer()
+                .BeginBarrierList()
+                    .AddTextureAcquireBarrier(dstTexture, *m_pQueue, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT, 
+                        VK_IMAGE_ASPECT_COLOR_BIT, mip, 1, layer, 1)
+                .Push();
+        } else {
+            AddUploadedTextureSubresource(dstTexture, mip, layer);
+        }
+
+        return *this;
+    }
+
+
+    CmdBuffer& UploadManager::GetCmdBuffer()
+    {
+        return *BeginBatch().pCmdBuffer;
+    }
+
+
+    CmdBuffer& UploadManager::GetOwnerCmdBuffer()
+    {
+        return *BeginBatch().pOwnerCmdBuffer;
+    }
+
+
+    UploadManager::Batch& UploadManager::BeginBatch()
+    {
+        VK_ASSERT(IsCreated());
+
+        Batch& batch = GetBatch(m_nextValue);
+
+        if (m_isBatchStarted) {
+            return batch;
+        }
+
+        // Slot is reused, so the batch submitted BATCH_COUNT values ago must be finished
+        if (m_nextValue > BATCH_COUNT) {
+            WaitFor(m_nextValue - BATCH_COUNT);
+        }
+
+        batch.pCmdBuffer->Reset();
+        batch.pCmdBuffer->Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+        if (IsOwnershipTransferNeeded()) {
+            batch.pOwnerCmdBuffer->Reset();
+            batch.pOwnerCmdBuffer->Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        }
+
+        m_isBatchStarted = true;
+
+        return batch;
+    }
+
+
+    uint64_t UploadManager::Flush()
+    {
+        VK_ASSERT(IsCreated());
+
+        if (!m_isBatchStarted) {
+            return GetSubmittedValue();
+        }
+
+        Batch& batch = GetBatch(m_nextValue);
+
+        // Makes uploaded data visible for all subsequent work submitted to the owner queue. Acquire barriers do it with ownership transfer
+        if (!IsOwnershipTransferNeeded()) {
+            PushUploadedVisibilityBarriers(*batch.pCmdBuffer);
+        }
+
+        QueueTimelineSyncData batchFinishedSyncData = {};
+        batchFinishedSyncData.pSemaphore = &m_batchFinishedSemaphore;
+        batchFinishedSyncData.value = m_nextValue;
+        batchFinishedSyncData.stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+        if (IsOwnershipTransferNeeded()) {
+            batch.pCmdBuffer->End();
+            batch.pOwnerCmdBuffer->End();
+
+            QueueTimelineSyncData copyFinishedSyncData = {};
+            copyFinishedSyncData.pSemaphore = &m_copyFinishedSemaphore;
+            copyFinishedSyncData.value = m_nextValue;
+            copyFinishedSyncData.stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+            m_pQueue->Submit(*batch.pCmdBuffer, copyFinishedSyncData);
+            m_pOwnerQueue->Submit(std::span(&batch.pOwnerCmdBuffer, 1), std::span(&copyFinishedSyncData, 1), std::span(&batchFinishedSyncData, 1));
+        } else {
+            batch.pCmdBuffer->End();
+            m_pQueue->Submit(*batch.pCmdBuffer, batchFinishedSyncData);
+        }
+
+        batch.value = m_nextValue;
+        batch.ringEnd = m_head;
+
+        ++m_nextValue;
+
+        m_isBatchStarted = false;
+        m_isBatchAllocated = false;
+
+        return batch.value;
+    }
+
+
+    UploadManager& UploadManager::WaitFor(uint64_t value)
+    {
+        VK_ASSERT(IsCreated());
+        VK_ASSERT_MSG(value <= GetSubmittedValue(), "Waiting for not submitted upload batch %llu", value);
+
+        if (m_completedValue >= value) {
+            return *this;
+        }
+
+        m_batchFinishedSemaphore.WaitFor(value, UPLOAD_WAIT_TIMEOUT);
+
+        while (m_completedValue < value) {
+            RetireBatch(m_completedValue + 1);
+        }
+
+        return *this;
+    }
+
+
+    UploadManager& UploadManager::WaitIdle()
+    {
+        return WaitFor(Flush());
+    }
+
+
+    uint64_t UploadManager::GetCompletedValue()
+    {
+        VK_ASSERT(IsCreated());
+
+        const uint64_t finishedValue = std::min(m_batchFinishedSemaphore.GetValue(), GetSubmittedValue());
+
+        while (m_completedValue < finishedValue) {
+            RetireBatch(m_completedValue + 1);
+        }
+
+        return m_completedValue;
+    }
+
+
+    void UploadManager::AddUploadedBufferRange(Buffer& buffer, VkDeviceSize offset, VkDeviceSize size)
+    {
+        auto rangeIt = std::ranges::find(m_uploadedBufferRanges, &buffer, &UploadedBufferRange::pBuffer);
+
+        if (rangeIt == m_uploadedBufferRanges.end()) {
+            m_uploadedBufferRanges.emplace_back(UploadedBufferRange{ &buffer, offset, size });
+            return;
+        }
+
+        // Ranges of the same buffer are united, since after the first barrier tracker loses copy write of the others
+        const VkDeviceSize rangeEnd = std::max(rangeIt->offset + rangeIt->size, offset + size);
+
+        rangeIt->offset = std::min(rangeIt->offset, offset);
+        rangeIt->size = rangeEnd - rangeIt->offset;
+    }
+
+
+    void UploadManager::AddUploadedTextureSubresource(Texture& texture, uint32_t mip, uint32_t layer)
+    {
+        const bool isAdded = std::ranges::any_of(m_uploadedTextureSubresources, [&](const UploadedTextureSubresource& subresource) {
+            return subresource.pTexture == &texture && subresource.mip == mip && subresource.layer == layer;
+        });
+
+        if (!isAdded) {
+            m_uploadedTextureSubresources.emplace_back(UploadedTextureSubresource{ &texture, mip, layer });
+        }
+    }
+
+
+    void UploadManager::PushUploadedVisibilityBarriers(CmdBuffer& cmdBuffer)
+    {
+        if (m_uploadedBufferRanges.empty() && m_uploadedTextureSubresources.empty()) {
+            return;
+        }
+
+        BarrierList& barrierList = cmdBuffer.BeginBarrierList();
+
+        for (const UploadedBufferRange& range : m_uploadedBufferRanges) {
+            barrierList.AddBufferBarrier(*range.pBuffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT, range.offset, range.size);
+        }
+
+        for (const UploadedTextureSubresource& subresource : m_uploadedTextureSubresources) {
+            // Layout is kept, since it can be already transited by commands recorded after upload
+            const Texture& texture = *subresource.pTexture;
+            const VkImageLayout layout = texture.GetAccessTracker().GetState(subresource.layer, subresource.mip).layout;
+
+            barrierList.AddTextureBarrier(*subresource.pTexture, layout, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT,
+                VK_IMAGE_ASPECT_COLOR_BIT, subresource.mip, 1, subresource.layer, 1);
+        }
+
+        barrierList.Push();
+
+        m_uploadedBufferRanges.clear();
+        m_uploadedTextureSubresources.clear();
+    }
+
+
+    VkDeviceSize UploadManager::Allocate(VkDeviceSize size, VkDeviceSize alignment)
+    {
+        VK_ASSERT_MSG(size <= m_stagingBuffer.GetMemorySize(), "Upload chunk size %llu is bigger than staging buffer", size);
+
+        VkDeviceSize offset = 0;
+
+        while (!TryAllocate(size, alignment, offset)) {
+            // Current batch holds part of the ring, so it has to be submitted to be able to retire it later
+            if (m_isBatchAllocated) {
+                Flush();
+            }
+
+            VK_ASSERT_MSG(m_completedValue < GetSubmittedValue(), "Upload staging buffer is exhausted without pending batches");
+
+            ENG_PROFILE_SCOPED_MARKER_C(0xff0000, "Upload_Manager_Ring_Wait");
+            WaitFor(m_completedValue + 1);
+        }
+
+        m_isBatchAllocated = true;
+
+        return offset;
+    }
+
+
+    bool UploadManager::TryAllocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset)
+    {
+        const VkDeviceSize ringSize = m_stagingBuffer.GetMemorySize();
+
+        if (IsRingEmpty()) {
+            m_head = 0;
+            m_tail = 0;
+        }
+
+        const VkDeviceSize alignedHead = AlignUp(m_head, alignment);
+
+        if (IsRingEmpty() || m_head > m_tail) {
+            if (alignedHead + size <= ringSize) {
+                offset = alignedHead;
+                m_head = alignedHead + size;
+                return true;
+            }
+
+            // Wrap around. Tail of the ring after m_head is skipped
+            if (size <= m_tail) {
+                offset = 0;
+                m_head = size;
+                return true;
+            }
+
+            return false;
+        }
+
+        if (m_head < m_tail && alignedHead + size <= m_tail) {
+            offset = alignedHead;
+            m_head = alignedHead + size;
+            return true;
+        }
+
+        return false;
+    }
+
+
+    void UploadManager::RetireBatch(uint64_t value)
+    {
+        VK_ASSERT(value == m_completedValue + 1);
+
+        m_tail = GetBatch(value).ringEnd;
+        m_completedValue = value;
+    }
+}
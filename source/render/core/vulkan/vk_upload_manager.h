@@ -0,0 +1,145 @@
+#pragma once
+
+#include "vk_cmd.h"
+#include "vk_buffer.h"
+#include "vk_texture.h"
+#include "vk_semaphore.h"
+
+#include <array>
+
+
+namespace vkn
+{
+    struct UploadManagerCreateInfo
+    {
+        Device* pDevice;
+        
+        Queue* pQueue;      // Queue which executes copies. Device main queue is used if null
+        Queue* pOwnerQueue; // Queue which uses uploaded resources. If its family differs, ownership is transferred to it. pQueue is used if null
+
+        VkDeviceSize stagingBufferSize;
+    };
+
+
+    // Sub-allocates staging memory from ring buffer and records copies of many resources into one command buffer (batch).
+    // Every submitted batch gets monotonically increasing value, which is signaled to timeline semaphore on its completion.
+    // CPU is blocked only when ring buffer or batch slots are exhausted.
+    // If owner queue belongs to other family, every uploaded resource is released on the copy queue and acquired on the owner one
+    class UploadManager
+    {
+    public:
+        ENG_DECL_CLASS_NO_COPIABLE(UploadManager);
+        ENG_DECL_CLASS_NO_MOVABLE(UploadManager);
+
+        UploadManager() = default;
+        ~UploadManager();
+
+        UploadManager& Create(const UploadManagerCreateInfo& info);
+        UploadManager& Destroy();
+
+        // Data bigger than staging chunk is split into several copies
+        UploadManager& UploadBuffer(Buffer& dstBuffer, const void* pData, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+
+        // Uploads tightly packed data of the whole texture subresource. Subresource must be transited to VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+        // layout with GetCmdBuffer() before. Data bigger than staging chunk is split by rows
+        UploadManager& UploadTexture(Texture& dstTexture, const void* pData, VkDeviceSize size, uint32_t mip = 0, uint32_t layer = 0);
+
+        // Command buffer of current batch executed on the copy queue. Can be used to record barriers and other commands ordered with uploads.
+        // Reference mustn't be cached across uploads, since they can submit current batch and start the new one
+        CmdBuffer& GetCmdBuffer();
+
+        // Command buffer of current batch executed on the owner queue after copies and ownership acquire. Should be used for commands
+        // which copy queue can't execute (e.g. mipmaps generation with blits). The same as GetCmdBuffer() without ownership transfer
+        CmdBuffer& GetOwnerCmdBuffer();
+
+        // Submits current batch. Returns value which is reached after its completion
+        uint64_t Flush();
+
+        UploadManager& WaitFor(uint64_t value);
+
+        // Submits current batch and waits for completion of all submitted ones
+        UploadManager& WaitIdle();
+
+        // Retires finished batches without blocking
+        uint64_t GetCompletedValue();
+
+        uint64_t GetSubmittedValue() const { return m_nextValue - 1; }
+
+        bool IsCreated() const { return m_pDevice != nullptr; }
+
+        bool IsOwnershipTransferNeeded() const { return m_pOwnerQueue->GetFamilyIndex() != m_pQueue->GetFamilyIndex(); }
+
+    private:
+        static inline constexpr uint32_t BATCH_COUNT = 4;
+
+        struct Batch
+        {
+            CmdBuffer* pCmdBuffer = nullptr;
+            CmdBuffer* pOwnerCmdBuffer = nullptr;
+
+            uint64_t value = 0;
+            VkDeviceSize ringEnd = 0;
+        };
+
+        struct UploadedBufferRange
+        {
+            Buffer* pBuffer;
+            VkDeviceSize offset;
+            VkDeviceSize size;
+        };
+
+        struct UploadedTextureSubresource
+        {
+            Texture* pTexture;
+            uint32_t mip;
+            uint32_t layer;
+        };
+
+    private:
+        Batch& BeginBatch();
+
+        VkDeviceSize Allocate(VkDeviceSize size, VkDeviceSize alignment);
+        bool TryAllocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+
+        void RetireBatch(uint64_t value);
+
+        void AddUploadedBufferRange(Buffer& buffer, VkDeviceSize offset, VkDeviceSize size);
+        void AddUploadedTextureSubresource(Texture& texture, uint32_t mip, uint32_t layer);
+        void PushUploadedVisibilityBarriers(CmdBuffer& cmdBuffer);
+
+        Batch& GetBatch(uint64_t value) { return m_batches[value % BATCH_COUNT]; }
+
+        bool IsRingEmpty() const { return m_completedValue == GetSubmittedValue() && !m_isBatchAllocated; }
+
+    private:
+        Device* m_pDevice = nullptr;
+        Queue* m_pQueue = nullptr;
+        Queue* m_pOwnerQueue = nullptr;
+
+        CmdPool m_cmdPool;
+        CmdPool m_ownerCmdPool;
+        std::array<Batch, BATCH_COUNT> m_batches;
+
+        // Both are signaled with batch values. Copy one orders owner queue submission after copy queue one
+        TimelineSemaphore m_copyFinishedSemaphore;
+        TimelineSemaphore m_batchFinishedSemaphore;
+
+        // Resources uploaded in current batch without ownership transfer. Their visibility barriers are pushed once on flush
+        std::vector<UploadedBufferRange> m_uploadedBufferRanges;
+        std::vector<UploadedTextureSubresource> m_uploadedTextureSubresources;
+
+        Buffer m_stagingBuffer;
+        uint8_t* m_pStagingData = nullptr;
+
+        // Live staging region is [m_tail, m_head) with wrap around
+        VkDeviceSize m_head = 0;
+        VkDeviceSize m_tail = 0;
+        VkDeviceSize m_maxChunkSize = 0;
+
+        uint64_t m_nextValue = 1;
+        uint64_t m_completedValue = 0;
+
+        bool m_isBatchStarted = false;
+        bool m_isBatchAllocated = false;
+    };
+}
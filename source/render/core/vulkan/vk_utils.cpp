@@ -40,4 +40,14 @@ namespace vkn::utils
                 return VK_IMAGE_VIEW_TYPE_MAX_ENUM;
         }
     }
+
+
+    VkExtent2D GetFormatBlockExtent(VkFormat format)
+    {
+        if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK) {
+            return { 4, 4 };
+        }
+
+        return { 1, 1 };
+    }
 }
\ No newline at end of file
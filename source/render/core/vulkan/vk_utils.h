@@ -109,4 +109,7 @@ namespace vkn::utils
     }
 
     VkImageViewType ImageTypeToViewType(VkImageType type);
+
+    // Extent of texel block in texels. It's 1x1 for uncompressed formats
+    VkExtent2D GetFormatBlockExtent(VkFormat format);
 }